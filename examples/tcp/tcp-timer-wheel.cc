@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Network topology
+//
+//       n0 ----------- n1
+//            1 Gbps
+//             1 ms
+//
+// - nFlows concurrent flows from n0 to n1 using BulkSendApplication.
+// - The simulation is run with the TCP timers scheduled as simulator
+//   events, then with the TCP timers on the TimerWheel of each node
+//   (TcpSocketBase::UseTimerWheel).  For each run, the wall-clock time,
+//   the number of simulator events and the goodput are printed.
+//
+// Example:
+//   ./waf --run "tcp-timer-wheel --nFlows=1000"
+
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/network-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpTimerWheelExample");
+
+/**
+ * Run the simulation once.
+ * \param nFlows Number of concurrent flows.
+ * \param duration Simulated time.
+ * \param useTimerWheel Whether TCP timers use the TimerWheel.
+ */
+static void
+RunOnce (uint32_t nFlows, Time duration, bool useTimerWheel)
+{
+  Config::SetDefault ("ns3::TcpSocketBase::UseTimerWheel", BooleanValue (useTimerWheel));
+
+  NodeContainer nodes;
+  nodes.Create (2);
+
+  PointToPointHelper pointToPoint;
+  pointToPoint.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  pointToPoint.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  NetDeviceContainer devices = pointToPoint.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer i = ipv4.Assign (devices);
+
+  uint16_t port = 9;
+  PacketSinkHelper sink ("ns3::TcpSocketFactory",
+                         InetSocketAddress (Ipv4Address::GetAny (), port));
+  ApplicationContainer sinkApps = sink.Install (nodes.Get (1));
+  sinkApps.Start (Seconds (0.0));
+
+  BulkSendHelper source ("ns3::TcpSocketFactory",
+                         InetSocketAddress (i.GetAddress (1), port));
+  ApplicationContainer sourceApps;
+  for (uint32_t f = 0; f < nFlows; ++f)
+    {
+      sourceApps.Add (source.Install (nodes.Get (0)));
+    }
+  sourceApps.Start (Seconds (0.0));
+  sourceApps.Stop (duration);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+  uint64_t nEvents = Simulator::GetEventCount ();
+
+  Ptr<PacketSink> sink1 = DynamicCast<PacketSink> (sinkApps.Get (0));
+  double goodput = sink1->GetTotalRx () * 8.0 / duration.GetSeconds () / 1e6;
+  Simulator::Destroy ();
+
+  std::cout << (useTimerWheel ? "timer wheel" : "events     ")
+            << "  wall " << elapsed << " ms"
+            << "  events " << nEvents
+            << "  goodput " << goodput << " Mbps" << std::endl;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t nFlows = 200;
+  Time duration = Seconds (2);
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nFlows", "Number of concurrent flows", nFlows);
+  cmd.AddValue ("duration", "Simulated time", duration);
+  cmd.Parse (argc, argv);
+
+  RunOnce (nFlows, duration, false);
+  RunOnce (nFlows, duration, true);
+  return 0;
+}
@@ -0,0 +1,173 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/buildings-module.h"
+
+/**
+ * \file
+ * \ingroup buildings
+ * Benchmark of the queries of BuildingList versus the number of buildings.
+ *
+ * City blocks of random buildings are deployed on a square area whose
+ * size grows with the number of buildings.  Random line segments, as
+ * the lines of sight checked by BuildingsChannelConditionModel, and
+ * random positions, as those checked by MobilityBuildingInfo, are
+ * queried through the index of BuildingList and with a linear scan of
+ * the list, and the queries per second of both are printed.
+ *
+ * Example:
+ *   ./waf --run "building-list-benchmark --maxBuildings=20000 --nScanQueries=1000"
+ */
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * Query random line segments and positions.
+ * \param points the random positions, also used as the ends of the line segments
+ * \param nQueries the number of queries of each kind
+ * \param linear whether to scan the list instead of using its index
+ * \param [out] segmentRate the line segments queried per second
+ * \param [out] positionRate the positions queried per second
+ * \returns the number of buildings found
+ */
+uint32_t
+TimeQueries (const std::vector<Vector> &points, uint32_t nQueries, bool linear,
+             double *segmentRate, double *positionRate)
+{
+  NS_ASSERT (points.size () >= 2 * nQueries);
+  uint32_t found = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nQueries; i++)
+    {
+      // lines of sight up to 300 m long
+      Vector l1 = points[2 * i];
+      Vector l2 = points[2 * i + 1];
+      double length = CalculateDistance (l1, l2);
+      if (length > 300)
+        {
+          l2 = l1 + Vector ((l2.x - l1.x) * 300 / length, (l2.y - l1.y) * 300 / length, 0);
+        }
+      bool blocked = false;
+      if (linear)
+        {
+          for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+            {
+              if ((*bit)->IsIntersect (l1, l2))
+                {
+                  blocked = true;
+                  break;
+                }
+            }
+        }
+      else
+        {
+          blocked = BuildingList::IsIntersectingAnyBuilding (l1, l2);
+        }
+      found += blocked ? 1 : 0;
+    }
+  *segmentRate = nQueries / (std::max<int64_t> (clock.End (), 1) * 1e-3);
+
+  std::vector<Ptr<Building> > buildings;
+  clock.Start ();
+  for (uint32_t i = 0; i < nQueries; i++)
+    {
+      if (linear)
+        {
+          for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+            {
+              if ((*bit)->IsInside (points[i]))
+                {
+                  found++;
+                }
+            }
+        }
+      else
+        {
+          BuildingList::GetBuildingsContaining (points[i], buildings);
+          found += buildings.size ();
+        }
+    }
+  *positionRate = nQueries / (std::max<int64_t> (clock.End (), 1) * 1e-3);
+  return found;
+}
+
+}  // unnamed namespace
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t minBuildings = 100;
+  uint32_t maxBuildings = 20000;
+  uint32_t nQueries = 100000;
+  uint32_t nScanQueries = 1000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("minBuildings", "Smallest number of buildings", minBuildings);
+  cmd.AddValue ("maxBuildings", "Largest number of buildings, reached from the smallest by steps of 10 times", maxBuildings);
+  cmd.AddValue ("nQueries", "Number of queries of each kind through the index", nQueries);
+  cmd.AddValue ("nScanQueries", "Number of queries of each kind with a linear scan", nScanQueries);
+  cmd.Parse (argc, argv);
+
+  std::cout << "buildings  segments/s (index)  segments/s (scan)  positions/s (index)  positions/s (scan)" << std::endl;
+  uint32_t nBuildings = minBuildings;
+  while (true)
+    {
+      // one building of 10 m to 40 m in each block of 50 m
+      uint32_t blocks = static_cast<uint32_t> (std::ceil (std::sqrt (static_cast<double> (nBuildings))));
+      double side = 50.0 * blocks;
+      Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+      random->SetStream (1);
+      for (uint32_t i = 0; i < nBuildings; i++)
+        {
+          double x = 50.0 * (i % blocks) + random->GetValue (0, 10);
+          double y = 50.0 * (i / blocks) + random->GetValue (0, 10);
+          Ptr<Building> building = CreateObject<Building> ();
+          building->SetBoundaries (Box (x, x + random->GetValue (10, 40), y, y + random->GetValue (10, 40),
+                                        0, random->GetValue (3, 30)));
+        }
+
+      std::vector<Vector> points;
+      random->SetStream (2);
+      for (uint32_t i = 0; i < 2 * std::max (nQueries, nScanQueries); i++)
+        {
+          points.push_back (Vector (random->GetValue (0, side), random->GetValue (0, side), 1.5));
+        }
+
+      double indexSegments, indexPositions, scanSegments, scanPositions, unused;
+      uint32_t scanFound = TimeQueries (points, nScanQueries, true, &scanSegments, &scanPositions);
+      uint32_t indexFound = TimeQueries (points, nScanQueries, false, &unused, &unused);
+      NS_ABORT_MSG_IF (indexFound != scanFound, "The index and the scan found different buildings");
+      TimeQueries (points, nQueries, false, &indexSegments, &indexPositions);
+
+      std::cout << nBuildings
+                << "  " << indexSegments << "  " << scanSegments
+                << "  " << indexPositions << "  " << scanPositions << std::endl;
+      Simulator::Destroy ();
+      if (nBuildings >= maxBuildings)
+        {
+          break;
+        }
+      nBuildings = std::min (10 * nBuildings, maxBuildings);
+    }
+  return 0;
+}
@@ -27,6 +27,9 @@
 #include "ns3/assert.h"
 #include "building-list.h"
 #include "building.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace ns3 {
 
@@ -48,13 +51,66 @@ public:
   Ptr<Building> GetBuilding (uint32_t n);
   uint32_t GetNBuildings (void);
 
+  /**
+   * Find the buildings intersecting a line segment.
+   * \param l1 the first point of the line segment
+   * \param l2 the second point of the line segment
+   * \param [out] found the indices of the buildings found, in increasing
+   *        order; if null, the search stops at the first building found
+   * \returns true if at least one building was found
+   */
+  bool FindIntersecting (const Vector &l1, const Vector &l2, std::vector<uint32_t> *found);
+  /**
+   * Find the buildings containing a position.
+   * \param position the position
+   * \param [out] found the indices of the buildings found, in increasing order
+   */
+  void FindContaining (const Vector &position, std::vector<uint32_t> &found);
+  /**
+   * Mark the index of the buildings as out of date.
+   */
+  void InvalidateIndex (void);
+
   static Ptr<BuildingListPriv> Get (void);
 
 private:
   virtual void DoDispose (void);
   static Ptr<BuildingListPriv> *DoGet (void);
   static void Delete (void);
+
+  /**
+   * Build the uniform grid indexing the buildings by their boundaries
+   * on the x-y plane.
+   */
+  void BuildIndex (void);
+  /**
+   * \param x a x coordinate
+   * \returns the column of the grid containing the coordinate, clamped
+   *          to the grid
+   */
+  uint32_t GetColumn (double x) const;
+  /**
+   * \param y a y coordinate
+   * \returns the row of the grid containing the coordinate, clamped
+   *          to the grid
+   */
+  uint32_t GetRow (double y) const;
+
   std::vector<Ptr<Building> > m_buildings;
+  bool m_indexValid;                      //!< whether the grid is up to date
+  double m_xMin;                          //!< lowest x of the buildings
+  double m_xMax;                          //!< highest x of the buildings
+  double m_yMin;                          //!< lowest y of the buildings
+  double m_yMax;                          //!< highest y of the buildings
+  double m_margin;                        //!< distance added to the queries to absorb rounding errors
+  double m_cellX;                         //!< width of a cell along x
+  double m_cellY;                         //!< width of a cell along y
+  uint32_t m_nColumns;                    //!< number of cells along x
+  uint32_t m_nRows;                       //!< number of cells along y
+  std::vector<uint32_t> m_cellStart;      //!< first entry of each cell in m_cellBuildings
+  std::vector<uint32_t> m_cellBuildings;  //!< indices of the buildings overlapping each cell
+  std::vector<uint32_t> m_visited;        //!< last query which checked each building
+  uint32_t m_query;                       //!< number of the current query
 };
 
 NS_OBJECT_ENSURE_REGISTERED (BuildingListPriv);
@@ -100,6 +156,8 @@ BuildingListPriv::Delete (void)
 
 
 BuildingListPriv::BuildingListPriv ()
+  : m_indexValid (false),
+    m_query (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -118,6 +176,7 @@ BuildingListPriv::DoDispose (void)
       *i = 0;
     }
   m_buildings.erase (m_buildings.begin (), m_buildings.end ());
+  InvalidateIndex ();
   Object::DoDispose ();
 }
 
@@ -127,6 +186,7 @@ BuildingListPriv::Add (Ptr<Building> building)
 {
   uint32_t index = m_buildings.size ();
   m_buildings.push_back (building);
+  m_indexValid = false;
   Simulator::ScheduleWithContext (index, TimeStep (0), &Building::Initialize, building);
   return index;
 
@@ -155,6 +215,213 @@ BuildingListPriv::GetBuilding (uint32_t n)
   return m_buildings.at (n);
 }
 
+void
+BuildingListPriv::InvalidateIndex (void)
+{
+  m_indexValid = false;
+  m_cellStart.clear ();
+  m_cellBuildings.clear ();
+  m_visited.clear ();
+}
+
+void
+BuildingListPriv::BuildIndex (void)
+{
+  NS_LOG_FUNCTION (this << m_buildings.size ());
+  uint32_t n = m_buildings.size ();
+  m_xMin = std::numeric_limits<double>::max ();
+  m_xMax = -std::numeric_limits<double>::max ();
+  m_yMin = std::numeric_limits<double>::max ();
+  m_yMax = -std::numeric_limits<double>::max ();
+  for (std::vector<Ptr<Building> >::const_iterator i = m_buildings.begin (); i != m_buildings.end (); ++i)
+    {
+      Box box = (*i)->GetBoundaries ();
+      m_xMin = std::min (m_xMin, box.xMin);
+      m_xMax = std::max (m_xMax, box.xMax);
+      m_yMin = std::min (m_yMin, box.yMin);
+      m_yMax = std::max (m_yMax, box.yMax);
+    }
+  // The exact tests of the buildings may accept a point slightly outside
+  // of a box, because of rounding errors; the queries are extended by a
+  // margin much larger than these errors.
+  m_margin = 1e-6 * (1 + std::max (std::max (std::abs (m_xMin), std::abs (m_xMax)),
+                                   std::max (std::abs (m_yMin), std::abs (m_yMax))));
+
+  // about one building per cell
+  uint32_t side = static_cast<uint32_t> (std::ceil (std::sqrt (static_cast<double> (n))));
+  side = std::min<uint32_t> (std::max<uint32_t> (side, 1), 1024);
+  m_nColumns = (m_xMax > m_xMin) ? side : 1;
+  m_nRows = (m_yMax > m_yMin) ? side : 1;
+  m_cellX = (m_xMax - m_xMin) / m_nColumns;
+  m_cellY = (m_yMax - m_yMin) / m_nRows;
+
+  // count the buildings overlapping each cell, then fill the cells
+  m_cellStart.assign (m_nColumns * m_nRows + 1, 0);
+  for (uint32_t pass = 0; pass < 2; pass++)
+    {
+      std::vector<uint32_t> next (m_cellStart.begin (), m_cellStart.end () - 1);
+      for (uint32_t b = 0; b < n; b++)
+        {
+          Box box = m_buildings[b]->GetBoundaries ();
+          uint32_t cLast = GetColumn (box.xMax);
+          uint32_t rLast = GetRow (box.yMax);
+          for (uint32_t r = GetRow (box.yMin); r <= rLast; r++)
+            {
+              for (uint32_t c = GetColumn (box.xMin); c <= cLast; c++)
+                {
+                  uint32_t cell = r * m_nColumns + c;
+                  if (pass == 0)
+                    {
+                      m_cellStart[cell + 1]++;
+                    }
+                  else
+                    {
+                      m_cellBuildings[next[cell]++] = b;
+                    }
+                }
+            }
+        }
+      if (pass == 0)
+        {
+          for (uint32_t cell = 0; cell < m_nColumns * m_nRows; cell++)
+            {
+              m_cellStart[cell + 1] += m_cellStart[cell];
+            }
+          m_cellBuildings.resize (m_cellStart.back ());
+        }
+    }
+  m_visited.assign (n, 0);
+  m_query = 0;
+  m_indexValid = true;
+  NS_LOG_LOGIC ("indexed " << n << " buildings on " << m_nColumns << "x" << m_nRows
+                << " cells with " << m_cellBuildings.size () << " entries");
+}
+
+uint32_t
+BuildingListPriv::GetColumn (double x) const
+{
+  if (m_nColumns == 1 || x <= m_xMin)
+    {
+      return 0;
+    }
+  double c = std::floor ((x - m_xMin) / m_cellX);
+  return (c >= m_nColumns) ? m_nColumns - 1 : static_cast<uint32_t> (c);
+}
+
+uint32_t
+BuildingListPriv::GetRow (double y) const
+{
+  if (m_nRows == 1 || y <= m_yMin)
+    {
+      return 0;
+    }
+  double r = std::floor ((y - m_yMin) / m_cellY);
+  return (r >= m_nRows) ? m_nRows - 1 : static_cast<uint32_t> (r);
+}
+
+bool
+BuildingListPriv::FindIntersecting (const Vector &l1, const Vector &l2, std::vector<uint32_t> *found)
+{
+  if (found != 0)
+    {
+      found->clear ();
+    }
+  if (m_buildings.empty ())
+    {
+      return false;
+    }
+  if (!m_indexValid)
+    {
+      BuildIndex ();
+    }
+  double xLo = std::min (l1.x, l2.x);
+  double xHi = std::max (l1.x, l2.x);
+  if (xHi < m_xMin - m_margin || xLo > m_xMax + m_margin
+      || std::max (l1.y, l2.y) < m_yMin - m_margin || std::min (l1.y, l2.y) > m_yMax + m_margin)
+    {
+      return false;
+    }
+  if (++m_query == 0)
+    {
+      std::fill (m_visited.begin (), m_visited.end (), 0);
+      m_query = 1;
+    }
+
+  // visit the cells crossed by the segment, column by column
+  uint32_t cFirst = GetColumn (xLo - m_margin);
+  uint32_t cLast = GetColumn (xHi + m_margin);
+  for (uint32_t c = cFirst; c <= cLast; c++)
+    {
+      double yLo = std::min (l1.y, l2.y);
+      double yHi = std::max (l1.y, l2.y);
+      if (cFirst != cLast && xHi > xLo)
+        {
+          // the part of the segment within the column
+          double xa = std::max (xLo, m_xMin + c * m_cellX - m_margin);
+          double xb = std::min (xHi, m_xMin + (c + 1) * m_cellX + m_margin);
+          double slope = (l2.y - l1.y) / (l2.x - l1.x);
+          double ya = l1.y + (xa - l1.x) * slope;
+          double yb = l1.y + (xb - l1.x) * slope;
+          yLo = std::min (ya, yb);
+          yHi = std::max (ya, yb);
+        }
+      uint32_t rLast = GetRow (yHi + m_margin);
+      for (uint32_t r = GetRow (yLo - m_margin); r <= rLast; r++)
+        {
+          uint32_t cell = r * m_nColumns + c;
+          for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; k++)
+            {
+              uint32_t b = m_cellBuildings[k];
+              if (m_visited[b] == m_query)
+                {
+                  continue;
+                }
+              m_visited[b] = m_query;
+              if (m_buildings[b]->IsIntersect (l1, l2))
+                {
+                  if (found == 0)
+                    {
+                      return true;
+                    }
+                  found->push_back (b);
+                }
+            }
+        }
+    }
+  if (found == 0)
+    {
+      return false;
+    }
+  std::sort (found->begin (), found->end ());
+  return !found->empty ();
+}
+
+void
+BuildingListPriv::FindContaining (const Vector &position, std::vector<uint32_t> &found)
+{
+  found.clear ();
+  if (m_buildings.empty ())
+    {
+      return;
+    }
+  if (!m_indexValid)
+    {
+      BuildIndex ();
+    }
+  // A building overlaps every cell between the cells of its corners, so
+  // the cell of the position holds all the buildings containing it, in
+  // increasing order.
+  uint32_t cell = GetRow (position.y) * m_nColumns + GetColumn (position.x);
+  for (uint32_t k = m_cellStart[cell]; k < m_cellStart[cell + 1]; k++)
+    {
+      uint32_t b = m_cellBuildings[k];
+      if (m_buildings[b]->IsInside (position))
+        {
+          found.push_back (b);
+        }
+    }
+}
+
 }
 
 /**
@@ -189,5 +456,41 @@ BuildingList::GetNBuildings (void)
 {
   return BuildingListPriv::Get ()->GetNBuildings ();
 }
+bool
+BuildingList::IsIntersectingAnyBuilding (const Vector &l1, const Vector &l2)
+{
+  return BuildingListPriv::Get ()->FindIntersecting (l1, l2, 0);
+}
+void
+BuildingList::GetIntersectingBuildings (const Vector &l1, const Vector &l2,
+                                        std::vector< Ptr<Building> > &buildings)
+{
+  Ptr<BuildingListPriv> priv = BuildingListPriv::Get ();
+  std::vector<uint32_t> found;
+  priv->FindIntersecting (l1, l2, &found);
+  buildings.clear ();
+  for (std::vector<uint32_t>::const_iterator i = found.begin (); i != found.end (); ++i)
+    {
+      buildings.push_back (priv->GetBuilding (*i));
+    }
+}
+void
+BuildingList::GetBuildingsContaining (const Vector &position,
+                                      std::vector< Ptr<Building> > &buildings)
+{
+  Ptr<BuildingListPriv> priv = BuildingListPriv::Get ();
+  std::vector<uint32_t> found;
+  priv->FindContaining (position, found);
+  buildings.clear ();
+  for (std::vector<uint32_t>::const_iterator i = found.begin (); i != found.end (); ++i)
+    {
+      buildings.push_back (priv->GetBuilding (*i));
+    }
+}
+void
+BuildingList::NotifyBoundariesChanged (void)
+{
+  BuildingListPriv::Get ()->InvalidateIndex ();
+}
 
 } // namespace ns3
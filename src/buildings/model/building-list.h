@@ -25,6 +25,7 @@
 
 #include <vector>
 #include "ns3/ptr.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -62,6 +63,41 @@ public:
    * \returns the number of buildings currently in the list.
    */
   static uint32_t GetNBuildings (void);
+
+  /**
+   * \param l1 the first point of the line segment
+   * \param l2 the second point of the line segment
+   * \returns true if the line segment intersects at least one building
+   *
+   * Same as calling Building::IsIntersect on each building of the
+   * list, but only the buildings close to the line segment are checked.
+   */
+  static bool IsIntersectingAnyBuilding (const Vector &l1, const Vector &l2);
+  /**
+   * \param l1 the first point of the line segment
+   * \param l2 the second point of the line segment
+   * \param [out] buildings the buildings intersecting the line segment,
+   *        i.e., for which Building::IsIntersect is true, in the order
+   *        of the list
+   */
+  static void GetIntersectingBuildings (const Vector &l1, const Vector &l2,
+                                        std::vector< Ptr<Building> > &buildings);
+  /**
+   * \param position a position
+   * \param [out] buildings the buildings containing the position, i.e.,
+   *        for which Building::IsInside is true, in the order of the list
+   */
+  static void GetBuildingsContaining (const Vector &position,
+                                      std::vector< Ptr<Building> > &buildings);
+  /**
+   * Tell the list that the boundaries of a building have changed.
+   *
+   * The buildings are indexed by their boundaries, on a uniform grid
+   * built at the first query following a change.  This method is called
+   * automatically from Building::SetBoundaries so the user has little
+   * reason to call it himself.
+   */
+  static void NotifyBoundariesChanged (void);
 };
 
 } // namespace ns3
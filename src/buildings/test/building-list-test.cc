@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/building.h"
+#include "ns3/building-list.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+/**
+ * Check that the queries of BuildingList, served by the index of the
+ * buildings, give the same results as a linear scan of the list.
+ */
+class BuildingListQueryTestCase : public TestCase
+{
+public:
+  BuildingListQueryTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the buildings intersecting a line segment.
+   * \param l1 the first point of the line segment
+   * \param l2 the second point of the line segment
+   */
+  void CheckSegment (const Vector &l1, const Vector &l2);
+  /**
+   * Check the buildings containing a position.
+   * \param position the position
+   */
+  void CheckPosition (const Vector &position);
+  /**
+   * Check random segments and positions, and the corners of the buildings.
+   * \param step the number of the check
+   */
+  void CheckAll (uint32_t step);
+
+  Ptr<UniformRandomVariable> m_random; //!< random positions
+  uint32_t m_step;                     //!< number of the current check
+};
+
+BuildingListQueryTestCase::BuildingListQueryTestCase ()
+  : TestCase ("Check the BuildingList queries against a linear scan"),
+    m_step (0)
+{
+}
+
+void
+BuildingListQueryTestCase::CheckSegment (const Vector &l1, const Vector &l2)
+{
+  std::vector<Ptr<Building> > expected;
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      if ((*bit)->IsIntersect (l1, l2))
+        {
+          expected.push_back (*bit);
+        }
+    }
+  std::vector<Ptr<Building> > buildings;
+  BuildingList::GetIntersectingBuildings (l1, l2, buildings);
+  NS_TEST_EXPECT_MSG_EQ ((buildings == expected), true,
+                         "step " << m_step << ": wrong buildings intersecting " << l1 << " - " << l2);
+  NS_TEST_EXPECT_MSG_EQ (BuildingList::IsIntersectingAnyBuilding (l1, l2), !expected.empty (),
+                         "step " << m_step << ": wrong intersection of " << l1 << " - " << l2);
+}
+
+void
+BuildingListQueryTestCase::CheckPosition (const Vector &position)
+{
+  std::vector<Ptr<Building> > expected;
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      if ((*bit)->IsInside (position))
+        {
+          expected.push_back (*bit);
+        }
+    }
+  std::vector<Ptr<Building> > buildings;
+  BuildingList::GetBuildingsContaining (position, buildings);
+  NS_TEST_EXPECT_MSG_EQ ((buildings == expected), true,
+                         "step " << m_step << ": wrong buildings containing " << position);
+}
+
+void
+BuildingListQueryTestCase::CheckAll (uint32_t step)
+{
+  m_step = step;
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      Vector l1 (m_random->GetValue (-50, 1050), m_random->GetValue (-50, 1050), m_random->GetValue (0, 20));
+      Vector l2 (m_random->GetValue (-50, 1050), m_random->GetValue (-50, 1050), m_random->GetValue (0, 20));
+      CheckSegment (l1, l2);
+      // short segments, and segments parallel to the axes
+      CheckSegment (l1, Vector (l1.x + m_random->GetValue (-10, 10), l1.y + m_random->GetValue (-10, 10), l1.z));
+      CheckSegment (l1, Vector (l1.x, l2.y, l1.z));
+      CheckSegment (l1, Vector (l2.x, l1.y, l2.z));
+      CheckSegment (l1, l1);
+      CheckPosition (l1);
+    }
+  // segments and positions on the walls of the buildings
+  for (BuildingList::Iterator bit = BuildingList::Begin (); bit != BuildingList::End (); ++bit)
+    {
+      Box box = (*bit)->GetBoundaries ();
+      Vector corner (box.xMax, box.yMax, box.zMin);
+      CheckPosition (corner);
+      CheckPosition (Vector (box.xMin, box.yMin, box.zMax));
+      CheckSegment (corner, Vector (corner.x + 100, corner.y - 100, corner.z));
+      CheckSegment (Vector (box.xMin, box.yMin - 10, 1), Vector (box.xMin, box.yMax + 10, 1));
+      CheckSegment (Vector (box.xMax + 1e-9, box.yMin - 10, 1), Vector (box.xMax + 1e-9, box.yMax + 10, 1));
+    }
+}
+
+void
+BuildingListQueryTestCase::DoRun (void)
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+
+  std::vector<Ptr<Building> > buildings;
+  for (uint32_t i = 0; i < 400; i++)
+    {
+      double x = m_random->GetValue (0, 1000);
+      double y = m_random->GetValue (0, 1000);
+      Ptr<Building> building = CreateObject<Building> ();
+      building->SetBoundaries (Box (x, x + m_random->GetValue (1, 40), y, y + m_random->GetValue (1, 40),
+                                    0, m_random->GetValue (3, 15)));
+      buildings.push_back (building);
+    }
+  // a large building and one on the edge of the grid
+  Ptr<Building> large = CreateObject<Building> ();
+  large->SetBoundaries (Box (200, 700, 450, 470, 0, 30));
+  Ptr<Building> edge = CreateObject<Building> ();
+  edge->SetBoundaries (Box (1040, 1040, 0, 1000, 0, 10));
+  CheckAll (0);
+
+  // the index follows the changes of the buildings
+  buildings[0]->SetBoundaries (Box (500, 520, 500, 520, 0, 10));
+  large->SetBoundaries (Box (-100, -90, -100, 1100, 0, 10));
+  CheckAll (1);
+  Ptr<Building> added = CreateObject<Building> ();
+  added->SetBoundaries (Box (0, 1000, 990, 1000, 0, 5));
+  CheckAll (2);
+
+  Simulator::Destroy ();
+}
+
+/**
+ * BuildingList test suite
+ */
+class BuildingListTestSuite : public TestSuite
+{
+public:
+  BuildingListTestSuite ();
+};
+
+BuildingListTestSuite::BuildingListTestSuite ()
+  : TestSuite ("building-list", UNIT)
+{
+  AddTestCase (new BuildingListQueryTestCase, TestCase::QUICK);
+}
+
+static BuildingListTestSuite g_buildingListTestSuite; //!< Static variable for test initialization
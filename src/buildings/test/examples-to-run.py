@@ -12,6 +12,7 @@ cpp_examples = [
     ("buildings-pathloss-profiler", "True", "True"),
     ("outdoor-group-mobility-example --useHelper=0", "True", "True"),
     ("outdoor-group-mobility-example --useHelper=1", "True", "True"),
+    ("building-list-benchmark --maxBuildings=1000 --nQueries=100", "True", "False"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "ns3/core-module.h"
+
+/**
+ * \file
+ * \ingroup core-examples
+ * \ingroup object
+ * Microbenchmark of the lookups of aggregated Objects.
+ *
+ * An aggregation of several Objects is built, as on a Node with its
+ * protocol stacks and mobility model, and the same Objects are looked
+ * up in turn with GetObject and PeekObject, as a Node is asked for
+ * its MobilityModel and its Ipv4 stack.
+ *
+ * Example:
+ *   ./waf --run "get-object-benchmark --nLookups=10000000"
+ */
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * An Object aggregated in the benchmark.
+ * \tparam N The index of the Object type.
+ */
+template <int N>
+class Component : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static std::string name = Name ();
+    static TypeId tid = TypeId (name.c_str ())
+      .SetParent<Object> ()
+      .SetGroupName ("Core")
+      .HideFromDocumentation ()
+      .AddConstructor<Component<N> > ();
+    return tid;
+  }
+
+private:
+  /** \return The name of this type. */
+  static std::string Name (void)
+  {
+    std::ostringstream oss;
+    oss << "ns3::GetObjectBenchmark::Component" << N;
+    return oss.str ();
+  }
+};
+
+/** The aggregated Object found last by a linear search. */
+typedef Component<7> Last;
+/** An Object type which is not aggregated. */
+typedef Component<8> Missing;
+
+/**
+ * Time lookups of two Objects in turn.
+ * \tparam T \explicit The type of the first Object.
+ * \tparam U \explicit The type of the second Object.
+ * \param name The name of the lookups.
+ * \param object An Object of the aggregation.
+ * \param nLookups The number of lookups of each Object.
+ */
+template <typename T, typename U>
+void
+TimeLookups (const std::string &name, Ptr<Object> object, uint32_t nLookups)
+{
+  uint32_t found = 0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      if (object->GetObject<T> () != 0)
+        {
+          found++;
+        }
+      if (object->GetObject<U> () != 0)
+        {
+          found++;
+        }
+    }
+  int64_t getTime = clock.End ();
+
+  clock.Start ();
+  for (uint32_t i = 0; i < nLookups; i++)
+    {
+      if (object->PeekObject<T> () != 0)
+        {
+          found++;
+        }
+      if (object->PeekObject<U> () != 0)
+        {
+          found++;
+        }
+    }
+  int64_t peekTime = clock.End ();
+
+  std::cout << name << ": GetObject " << getTime * 1e6 / (2.0 * nLookups) << " ns"
+            << ", PeekObject " << peekTime * 1e6 / (2.0 * nLookups) << " ns"
+            << " (" << found << " found)" << std::endl;
+}
+
+}  // unnamed namespace
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t nLookups = 1000000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nLookups", "Number of lookups of each Object", nLookups);
+  cmd.Parse (argc, argv);
+
+  Ptr<Object> object = CreateObject<Component<0> > ();
+  object->AggregateObject (CreateObject<Component<1> > ());
+  object->AggregateObject (CreateObject<Component<2> > ());
+  object->AggregateObject (CreateObject<Component<3> > ());
+  object->AggregateObject (CreateObject<Component<4> > ());
+  object->AggregateObject (CreateObject<Component<5> > ());
+  object->AggregateObject (CreateObject<Component<6> > ());
+  object->AggregateObject (CreateObject<Last> ());
+
+  TimeLookups<Last, Component<3> > ("aggregated", object, nLookups);
+  TimeLookups<Last, Missing> ("missing", object, nLookups);
+
+  object->Dispose ();
+  return 0;
+}
@@ -24,8 +24,11 @@
 #include "object-ptr-container.h"
 #include "names.h"
 #include "pointer.h"
+#include "trace-source-accessor.h"
 #include "log.h"
 
+#include <algorithm>
+#include <map>
 #include <sstream>
 
 /**
@@ -40,6 +43,34 @@ NS_LOG_COMPONENT_DEFINE ("Config");
 
 namespace Config {
 
+/**
+ * \ingroup config-impl
+ * Find a trace source of a TypeId.
+ *
+ * The trace sources of each TypeId are looked up once per name, instead
+ * of once per Object matching a Config path.
+ *
+ * \param [in] tid The TypeId of the Object.
+ * \param [in] name The trace source name.
+ * \returns The trace source accessor, or zero if there is none.
+ */
+static Ptr<const TraceSourceAccessor>
+LookupTraceSource (TypeId tid, const std::string &name)
+{
+  NS_LOG_FUNCTION (tid << name);
+  typedef std::map<std::pair<uint16_t, std::string>, Ptr<const TraceSourceAccessor> > Cache;
+  static Cache cache;
+  std::pair<uint16_t, std::string> key = std::make_pair (tid.GetUid (), name);
+  Cache::const_iterator it = cache.find (key);
+  if (it != cache.end ())
+    {
+      return it->second;
+    }
+  Ptr<const TraceSourceAccessor> accessor = tid.LookupTraceSourceByName (name);
+  cache[key] = accessor;
+  return accessor;
+}
+
 MatchContainer::MatchContainer ()
 {
   NS_LOG_FUNCTION (this);
@@ -131,7 +162,8 @@ MatchContainer::ConnectFailSafe (std::string name, const CallbackBase &cb)
     {
       Ptr<Object> object = m_objects[i];
       std::string ctx = m_contexts[i] + name;
-      ok |= object->TraceConnect (name, ctx, cb);
+      Ptr<const TraceSourceAccessor> accessor = LookupTraceSource (object->GetInstanceTypeId (), name);
+      ok |= (accessor != 0) && accessor->Connect (PeekPointer (object), ctx, cb);
     }
   return ok;
 }
@@ -151,7 +183,8 @@ MatchContainer::ConnectWithoutContextFailSafe (std::string name, const CallbackB
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      ok |= object->TraceConnectWithoutContext (name, cb);
+      Ptr<const TraceSourceAccessor> accessor = LookupTraceSource (object->GetInstanceTypeId (), name);
+      ok |= (accessor != 0) && accessor->ConnectWithoutContext (PeekPointer (object), cb);
     }
   return ok;
 }
@@ -164,7 +197,11 @@ MatchContainer::Disconnect (std::string name, const CallbackBase &cb)
     {
       Ptr<Object> object = m_objects[i];
       std::string ctx = m_contexts[i] + name;
-      object->TraceDisconnect (name, ctx, cb);
+      Ptr<const TraceSourceAccessor> accessor = LookupTraceSource (object->GetInstanceTypeId (), name);
+      if (accessor != 0)
+        {
+          accessor->Disconnect (PeekPointer (object), ctx, cb);
+        }
     }
 }
 void
@@ -174,7 +211,11 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
   for (Iterator tmp = Begin (); tmp != End (); ++tmp)
     {
       Ptr<Object> object = *tmp;
-      object->TraceDisconnectWithoutContext (name, cb);
+      Ptr<const TraceSourceAccessor> accessor = LookupTraceSource (object->GetInstanceTypeId (), name);
+      if (accessor != 0)
+        {
+          accessor->DisconnectWithoutContext (PeekPointer (object), cb);
+        }
     }
 }
 
@@ -182,6 +223,9 @@ MatchContainer::DisconnectWithoutContext (std::string name, const CallbackBase &
 /**
  * \ingroup config-impl
  * Helper to test if an array entry matches a config path specification.
+ *
+ * The specification is parsed once, when the matcher is constructed,
+ * so that the same matcher can be used for every entry of the array.
  */
 class ArrayMatcher
 {
@@ -199,8 +243,21 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (std::size_t i) const;
+  /**
+   * Get the indices matching the Config Path, if there are few of them.
+   *
+   * \param [out] indices The matching indices, in increasing order.
+   * \returns \c true if the matching indices could be listed.
+   */
+  bool GetIndices (std::vector<std::size_t> *indices) const;
 
 private:
+  /**
+   * Parse a Config path specification.
+   *
+   * \param [in] element The Config path specification.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -211,78 +268,112 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** Whether every index matches. */
+  bool m_all;
+  /** The ranges of matching indices, bounds included. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
+  /** The largest number of indices listed by GetIndices(). */
+  static const uint32_t MAX_INDICES = 16;
 
 };  // class ArrayMatcher
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
+  Parse (element);
 }
-bool
-ArrayMatcher::Matches (std::size_t i) const
+void
+ArrayMatcher::Parse (std::string element)
 {
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      NS_LOG_DEBUG ("Array " << i << " matches *");
-      return true;
+      m_all = true;
+      return;
     }
   std::string::size_type tmp;
-  tmp = m_element.find ("|");
+  tmp = element.find ("|");
   if (tmp != std::string::npos)
     {
-      std::string left = m_element.substr (0, tmp - 0);
-      std::string right = m_element.substr (tmp + 1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
-      return false;
+      std::string left = element.substr (0, tmp - 0);
+      std::string right = element.substr (tmp + 1, element.size () - (tmp + 1));
+      Parse (left);
+      Parse (right);
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1
       && dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min)
           && StringToUint32 (upperBound, &max)
-          && i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
-          return true;
-        }
-      else
+          && min <= max)
         {
-          NS_LOG_DEBUG ("Array " << i << " does not " << m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value)
-      && i == value)
+  if (StringToUint32 (element, &value))
+    {
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (std::size_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
     {
-      NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
+      NS_LOG_DEBUG ("Array " << i << " matches *");
       return true;
     }
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end (); ++it)
+    {
+      if (i >= it->first && i <= it->second)
+        {
+          NS_LOG_DEBUG ("Array " << i << " matches " << m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array " << i << " does not match " << m_element);
   return false;
 }
+bool
+ArrayMatcher::GetIndices (std::vector<std::size_t> *indices) const
+{
+  NS_LOG_FUNCTION (this << indices);
+  if (m_all)
+    {
+      return false;
+    }
+  indices->clear ();
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator it = m_ranges.begin ();
+       it != m_ranges.end (); ++it)
+    {
+      if (it->second - it->first >= MAX_INDICES - indices->size ())
+        {
+          return false;
+        }
+      for (std::size_t i = it->first; i <= it->second; i++)
+        {
+          indices->push_back (i);
+        }
+    }
+  std::sort (indices->begin (), indices->end ());
+  indices->erase (std::unique (indices->begin (), indices->end ()), indices->end ());
+  return true;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
@@ -294,9 +385,112 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * \ingroup config-impl
+ * An attribute holding Objects, which can be followed on a Config path.
+ */
+struct ObjectAttribute
+{
+  /** The attribute name. */
+  std::string name;
+  /** The attribute accessor. */
+  Ptr<const AttributeAccessor> accessor;
+  /** Whether the attribute can be read with the accessor. */
+  bool gettable;
+  /** \c true for an ObjectPtrContainerValue, \c false for a PointerValue. */
+  bool isContainer;
+};
+
+/**
+ * \ingroup config-impl
+ * Find the attributes holding Objects which match a Config path element.
+ *
+ * The attributes of each TypeId are looked up once per element,
+ * instead of once per Object on the path.
+ *
+ * \param [in] tid The TypeId of the Object.
+ * \param [in] item The Config path element, an attribute name or \c "*".
+ * \returns The matching attributes, in the order of the TypeId tree.
+ */
+static const std::vector<ObjectAttribute> &
+LookupObjectAttributes (TypeId tid, const std::string &item)
+{
+  NS_LOG_FUNCTION (tid << item);
+  typedef std::map<std::pair<uint16_t, std::string>, std::vector<ObjectAttribute> > Cache;
+  static Cache cache;
+  std::pair<Cache::iterator, bool> inserted =
+    cache.insert (std::make_pair (std::make_pair (tid.GetUid (), item),
+                                  std::vector<ObjectAttribute> ()));
+  std::vector<ObjectAttribute> &attributes = inserted.first->second;
+  if (!inserted.second)
+    {
+      return attributes;
+    }
+
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info;
+          info = tid.GetAttribute (i);
+          if (info.name != item && item != "*")
+            {
+              continue;
+            }
+          ObjectAttribute attribute;
+          attribute.name = info.name;
+          attribute.accessor = info.accessor;
+          attribute.gettable = (info.flags & TypeId::ATTR_GET) && info.accessor->HasGetter ();
+          // attempt to cast to a pointer checker.
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = false;
+              attributes.push_back (attribute);
+            }
+          // attempt to cast to an object vector.
+          if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.isContainer = true;
+              attributes.push_back (attribute);
+            }
+          // this could be anything else and we don't know what to do with it.
+          // So, we just ignore it.
+        }
+
+      nextTid = tid.GetParent ();
+    }
+  while (nextTid != tid);
+  return attributes;
+}
+
+/**
+ * \ingroup config-impl
+ * Get the value of an attribute holding Objects.
+ *
+ * \param [in] object The Object holding the attribute.
+ * \param [in] attribute The attribute.
+ * \param [out] value The value of the attribute.
+ */
+static void
+GetObjectAttribute (Ptr<Object> object, const ObjectAttribute &attribute, AttributeValue &value)
+{
+  NS_LOG_FUNCTION (object << attribute.name << &value);
+  if (!attribute.gettable || !attribute.accessor->Get (PeekPointer (object), value))
+    {
+      // Let ObjectBase::GetAttribute raise any errors
+      object->GetAttribute (attribute.name, value);
+    }
+}
+
 /**
  * \ingroup config-impl
  * Abstract class to parse Config paths into object references.
+ *
+ * The Config path is split into its elements once, and each element
+ * is matched against the Objects found on the path.
  */
 class Resolver
 {
@@ -325,18 +519,19 @@ private:
   /**
    * Parse the next element in the Config path.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] pos The position of the next element of the Config path.
    * \param [in] root The object corresponding to the current position
    *                  in the Config path.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolve (std::size_t pos, Ptr<Object> root);
   /**
    * Parse an index on the Config path.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] pos The position of the index element of the Config path.
+   * \param [in] root The object holding the container.
+   * \param [in] attribute The container attribute.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (std::size_t pos, Ptr<Object> root, const ObjectAttribute &attribute);
   /**
    * Handle one object found on the path.
    *
@@ -361,6 +556,10 @@ private:
   std::vector<std::string> m_workStack;
   /** The Config path. */
   std::string m_path;
+  /** The elements of the Config path. */
+  std::vector<std::string> m_items;
+  /** The matchers of the elements of the Config path. */
+  std::vector<ArrayMatcher> m_matchers;
 
 };  // class Resolver
 
@@ -369,6 +568,16 @@ Resolver::Resolver (std::string path)
 {
   NS_LOG_FUNCTION (this << path);
   Canonicalize ();
+
+  std::string::size_type cur = 0;
+  std::string::size_type next = m_path.find ("/", 1);
+  while (next != std::string::npos)
+    {
+      m_items.push_back (m_path.substr (cur + 1, next - (cur + 1)));
+      m_matchers.push_back (ArrayMatcher (m_items.back ()));
+      cur = next;
+      next = m_path.find ("/", cur + 1);
+    }
 }
 Resolver::~Resolver ()
 {
@@ -399,7 +608,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root);
 }
 
 std::string
@@ -425,13 +634,11 @@ Resolver::DoResolveOne (Ptr<Object> object)
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (std::size_t pos, Ptr<Object> root)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << pos << root);
 
-  if (next == std::string::npos)
+  if (pos == m_items.size ())
     {
       //
       // If root is zero, we're beginning to see if we can use the object name
@@ -447,8 +654,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
         }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
+  const std::string &item = m_items[pos];
 
   //
   // If root is zero, we're beginning to see if we can use the object name
@@ -459,11 +665,10 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
-      if (offset == 0)
+      if (item.compare (0, 5, "Names") == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (pos + 1, root);
           m_workStack.pop_back ();
           return;
         }
@@ -480,7 +685,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (pos + 1, namedObject);
       m_workStack.pop_back ();
       return;
     }
@@ -510,68 +715,46 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (pos + 1, object);
       m_workStack.pop_back ();
     }
   else
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      const std::vector<ObjectAttribute> &attributes =
+        LookupObjectAttributes (root->GetInstanceTypeId (), item);
       bool foundMatch = false;
 
-      do
+      for (std::vector<ObjectAttribute>::const_iterator i = attributes.begin (); i != attributes.end (); ++i)
         {
-          tid = nextTid;
-
-          for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+          const ObjectAttribute &attribute = *i;
+          if (!attribute.isContainer)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute (i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)=" << attribute.name << " on path=" << GetResolvedPath ());
+              PointerValue pValue;
+              GetObjectAttribute (root, attribute, pValue);
+              Ptr<Object> object = pValue.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\"" << item <<
+                                "\" exists on path=\"" << GetResolvedPath () << "\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *pChecker = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (pChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)=" << info.name << " on path=" << GetResolvedPath ());
-                  PointerValue pValue;
-                  root->GetAttribute (info.name, pValue);
-                  Ptr<Object> object = pValue.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\"" << item <<
-                                    "\" exists on path=\"" << GetResolvedPath () << "\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker =
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)=" << info.name << " on path=" << GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (attribute.name);
+              DoResolve (pos + 1, object);
+              m_workStack.pop_back ();
+            }
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)=" << attribute.name << " on path=" << GetResolvedPath ());
+              foundMatch = true;
+              m_workStack.push_back (attribute.name);
+              DoArrayResolve (pos + 1, root, attribute);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
         }
-      while (nextTid != tid);
 
       if (!foundMatch)
         {
@@ -582,20 +765,41 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (std::size_t pos, Ptr<Object> root, const ObjectAttribute &attribute)
 {
-  NS_LOG_FUNCTION (this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION (this << pos << root << attribute.name);
+  if (pos == m_items.size ())
+    {
+      return;
+    }
+
+  //
+  // If the path asks for a few indices, such as /NodeList/3/, get them
+  // from the container one by one instead of copying all its Objects.
+  //
+  const ArrayMatcher &matcher = m_matchers[pos];
+  const ObjectPtrContainerAccessor *accessor =
+    dynamic_cast<const ObjectPtrContainerAccessor *> (PeekPointer (attribute.accessor));
+  std::vector<std::size_t> indices;
+  if (accessor != 0 && attribute.gettable && matcher.GetIndices (&indices))
     {
+      for (std::vector<std::size_t>::const_iterator i = indices.begin (); i != indices.end (); ++i)
+        {
+          Ptr<Object> object = accessor->Find (PeekPointer (root), *i);
+          if (object != 0)
+            {
+              std::ostringstream oss;
+              oss << *i;
+              m_workStack.push_back (oss.str ());
+              DoResolve (pos + 1, object);
+              m_workStack.pop_back ();
+            }
+        }
       return;
     }
-  std::string item = path.substr (1, next - 1);
-  std::string pathLeft = path.substr (next, path.size () - next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
+  ObjectPtrContainerValue container;
+  GetObjectAttribute (root, attribute, container);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
@@ -604,7 +808,7 @@ Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &conta
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (pos + 1, (*it).second);
           m_workStack.pop_back ();
         }
     }
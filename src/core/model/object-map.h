@@ -110,6 +110,26 @@ MakeObjectMapAccessor (U T::*memberVector)
       // quiet compiler.
       return 0;
     }
+    virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const
+    {
+      const T *obj = dynamic_cast<const T *> (object);
+      if (obj == 0)
+        {
+          return 0;
+        }
+      // look the key up, rather than the position
+      typename U::key_type key = static_cast<typename U::key_type> (index);
+      if (static_cast<std::size_t> (key) != index)
+        {
+          return 0;
+        }
+      typename U::const_iterator j = (obj->*m_memberVector).find (key);
+      if (j == (obj->*m_memberVector).end ())
+        {
+          return 0;
+        }
+      return (*j).second;
+    }
     U T::*m_memberVector;
   } *spec = new MemberStdContainer ();
   spec->m_memberVector = memberVector;
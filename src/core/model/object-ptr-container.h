@@ -228,6 +228,15 @@ public:
   virtual bool Get (const ObjectBase * object, AttributeValue &value) const;
   virtual bool HasGetter (void) const;
   virtual bool HasSetter (void) const;
+  /**
+   * Get one instance of the container, without copying the others
+   * as Get() does.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the instance, as in ObjectPtrContainerValue.
+   * \returns The instance, or zero if there is none with this index.
+   */
+  Ptr<Object> Find (const ObjectBase *object, std::size_t index) const;
 
 private:
   /**
@@ -247,6 +256,16 @@ private:
    * \returns The index requested.
    */
   virtual Ptr<Object> DoGet (const ObjectBase *object, std::size_t i, std::size_t *index) const = 0;
+  /**
+   * Get the instance of the container with an index, as in
+   * ObjectPtrContainerValue.  By default, the instance at the position of
+   * the index is tried first, then all the instances in turn.
+   *
+   * \param [in] object The container object.
+   * \param [in] index The index of the instance.
+   * \returns The instance, or zero if there is none with this index.
+   */
+  virtual Ptr<Object> DoFind (const ObjectBase *object, std::size_t index) const;
 };
 
 template <typename T, typename U, typename INDEX>
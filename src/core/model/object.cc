@@ -97,11 +97,10 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
+    m_aggregates (AllocateAggregates (1)),
     m_getObjectCount (0)
 {
   NS_LOG_FUNCTION (this);
-  m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object ()
@@ -120,6 +119,8 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  // the cache may point to this object
+  std::memset (m_aggregates->cache, 0, sizeof (m_aggregates->cache));
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -132,10 +133,9 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
+    m_aggregates (AllocateAggregates (1)),
     m_getObjectCount (0)
 {
-  m_aggregates->n = 1;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -145,12 +145,40 @@ Object::Construct (const AttributeConstructionList &attributes)
   ConstructSelf (attributes);
 }
 
+struct Object::Aggregates *
+Object::AllocateAggregates (uint32_t n)
+{
+  struct Aggregates *aggregates =
+    (struct Aggregates *)std::malloc (sizeof(struct Aggregates) + (n - 1) * sizeof(Object*));
+  aggregates->n = n;
+  std::memset (aggregates->cache, 0, sizeof (aggregates->cache));
+  return aggregates;
+}
+
 Ptr<Object>
 Object::DoGetObject (TypeId tid) const
+{
+  NS_LOG_FUNCTION (this << tid);
+  return Ptr<Object> (DoPeekObject (tid));
+}
+
+Object *
+Object::DoPeekObject (TypeId tid) const
 {
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  struct Aggregates::CacheEntry &entry =
+    m_aggregates->cache[tid.GetUid () % Aggregates::CACHE_SIZE];
+  if (entry.uid == tid.GetUid ())
+    {
+      return entry.object;
+    }
+  // The result of the lookup is cached, even if there is no match,
+  // until the next change of the aggregates.
+  entry.uid = tid.GetUid ();
+  entry.object = 0;
+
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -174,6 +202,7 @@ Object::DoGetObject (TypeId tid) const
           // then, update the sort
           UpdateSortedArray (m_aggregates, i);
           // finally, return the match
+          entry.object = current;
           return const_cast<Object *> (current);
         }
     }
@@ -260,9 +289,7 @@ Object::AggregateObject (Ptr<Object> o)
   Object *other = PeekPointer (o);
   // first create the new aggregate buffer.
   uint32_t total = m_aggregates->n + other->m_aggregates->n;
-  struct Aggregates *aggregates =
-    (struct Aggregates *)std::malloc (sizeof(struct Aggregates) + (total - 1) * sizeof(Object*));
-  aggregates->n = total;
+  struct Aggregates *aggregates = AllocateAggregates (total);
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0],
@@ -274,7 +301,7 @@ Object::AggregateObject (Ptr<Object> o)
     {
       aggregates->buffer[m_aggregates->n + i] = other->m_aggregates->buffer[i];
       const TypeId typeId = other->m_aggregates->buffer[i]->GetInstanceTypeId ();
-      if (DoGetObject (typeId))
+      if (DoPeekObject (typeId))
         {
           NS_FATAL_ERROR ("Object::AggregateObject(): "
                           "Multiple aggregation of objects of type " <<
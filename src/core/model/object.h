@@ -166,6 +166,22 @@ public:
    */
   template <typename T>
   Ptr<T> GetObject (TypeId tid) const;
+  /**
+   * Get a raw pointer to the requested aggregated Object, without
+   * taking a reference.  If the type of object requested is
+   * ns3::Object, a pointer to the calling object is returned.
+   *
+   * This is the fast path of GetObject(): the lookup is served from
+   * the cache of the aggregates, indexed by the TypeId of \p T, and
+   * no reference count is updated.  The pointer is valid as long as
+   * the aggregates are alive.
+   *
+   * \tparam T \explicit The type of the aggregated Object to retrieve.
+   * \returns A pointer to the requested Object, or zero
+   *          if it could not be found.
+   */
+  template <typename T>
+  inline T * PeekObject (void) const;
   /**
    * Dispose of this Object.
    *
@@ -344,8 +360,22 @@ private:
    */
   struct Aggregates
   {
+    /** The number of entries in \c cache. */
+    static const uint32_t CACHE_SIZE = 8;
+    /** The result of a lookup. */
+    struct CacheEntry
+    {
+      uint16_t uid;   //!< The uid of the requested TypeId, 0 if unused.
+      Object *object; //!< The matching Object, 0 if there is none.
+    };
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /**
+     * The results of the recent lookups, indexed by the uid of the
+     * requested TypeId modulo CACHE_SIZE.  The cache is cleared
+     * whenever the set of Objects changes.
+     */
+    struct CacheEntry cache[CACHE_SIZE];
     /** The array of Objects. */
     Object *buffer[1];
   };
@@ -357,6 +387,21 @@ private:
    * \return The matching Object, if it is found
    */
   Ptr<Object> DoGetObject (TypeId tid) const;
+  /**
+   * Find an Object of TypeId tid in the aggregates of this Object,
+   * and cache the result.
+   *
+   * \param [in] tid The TypeId we're looking for
+   * \return The matching Object, or zero if it is not found
+   */
+  Object * DoPeekObject (TypeId tid) const;
+  /**
+   * Allocate an aggregate list with an empty cache.
+   *
+   * \param [in] n The number of Objects in the list.
+   * \return The aggregate list.
+   */
+  static struct Aggregates * AllocateAggregates (uint32_t n);
   /**
    * Verify that this Object is still live, by checking it's reference count.
    * \return \c true if the reference count is non zero.
@@ -466,23 +511,47 @@ ObjectDeleter::Delete (Object *object)
 }
 
 template <typename T>
-Ptr<T>
-Object::GetObject () const
+T *
+Object::PeekObject () const
 {
-  // This is an optimization: if the cast works (which is likely),
-  // things will be pretty fast.
+  // This is an optimization: the result of a previous lookup of T
+  // is likely in the cache, and then we do not walk the TypeIds.
+  TypeId tid = T::GetTypeId ();
+  const struct Aggregates::CacheEntry &entry =
+    m_aggregates->cache[tid.GetUid () % Aggregates::CACHE_SIZE];
+  if (entry.uid == tid.GetUid () && entry.object != 0)
+    {
+      return static_cast<T *> (entry.object);
+    }
+  // Another optimization: if the cast works, things will be pretty fast.
   T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
   if (result != 0)
     {
-      return Ptr<T> (result);
+      return result;
     }
   // if the cast does not work, we try to do a full type check.
-  Ptr<Object> found = DoGetObject (T::GetTypeId ());
-  if (found != 0)
-    {
-      return Ptr<T> (static_cast<T *> (PeekPointer (found)));
-    }
-  return 0;
+  return static_cast<T *> (DoPeekObject (tid));
+}
+
+/**
+ * Specialization of \link Object::PeekObject () \endlink for
+ * objects of type ns3::Object.
+ *
+ * \returns A pointer to the calling object.
+ */
+template
+<>
+inline Object *
+Object::PeekObject () const
+{
+  return const_cast<Object *> (this);
+}
+
+template <typename T>
+Ptr<T>
+Object::GetObject () const
+{
+  return Ptr<T> (PeekObject<T> ());
 }
 
 /**
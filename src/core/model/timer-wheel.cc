@@ -0,0 +1,290 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timer-wheel.h"
+#include "simulator.h"
+#include "uinteger.h"
+#include "abort.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+NS_OBJECT_ENSURE_REGISTERED (TimerWheel);
+
+TypeId
+TimerWheel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimerWheel")
+    .SetParent<Object> ()
+    .SetGroupName ("Core")
+    .AddConstructor<TimerWheel> ()
+    .AddAttribute ("Granularity",
+                   "The time interval covered by one slot of the wheel.",
+                   TimeValue (MilliSeconds (1)),
+                   MakeTimeAccessor (&TimerWheel::m_granularity),
+                   MakeTimeChecker (TimeStep (1)))
+    .AddAttribute ("SlotCount",
+                   "The number of slots of the wheel.",
+                   UintegerValue (512),
+                   MakeUintegerAccessor (&TimerWheel::m_nSlots),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+TimerWheel::TimerWheel ()
+  : m_pass (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+  // The slot events hold a raw pointer to this wheel, which may be
+  // released without being disposed
+  for (auto &slot : m_slots)
+    {
+      slot.event.Cancel ();
+    }
+}
+
+void
+TimerWheel::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (auto &slot : m_slots)
+    {
+      slot.event.Cancel ();
+    }
+  m_slots.clear ();
+  m_records.clear ();
+  m_free.clear ();
+  Object::DoDispose ();
+}
+
+Ptr<TimerWheel>
+TimerWheel::GetOrCreate (Ptr<Object> object)
+{
+  NS_LOG_FUNCTION (object);
+  Ptr<TimerWheel> wheel = object->GetObject<TimerWheel> ();
+  if (wheel == 0)
+    {
+      wheel = CreateObject<TimerWheel> ();
+      object->AggregateObject (wheel);
+    }
+  return wheel;
+}
+
+TimerWheel::TimerId
+TimerWheel::Create (Callback<void> cb)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_slots.empty ())
+    {
+      m_slots.resize (m_nSlots);
+    }
+
+  TimerId id;
+  if (!m_free.empty ())
+    {
+      id = m_free.back ();
+      m_free.pop_back ();
+    }
+  else
+    {
+      id = static_cast<TimerId> (m_records.size ());
+      NS_ABORT_MSG_IF (id == INVALID_TIMER, "Too many timers");
+      m_records.emplace_back ();
+    }
+
+  Record &record = m_records[id];
+  record.cb = cb;
+  record.expiry = Time ();
+  record.pass = 0;
+  record.slot = 0;
+  record.running = false;
+  record.listed = false;
+  record.allocated = true;
+  return id;
+}
+
+void
+TimerWheel::Release (TimerId id)
+{
+  NS_LOG_FUNCTION (this << id);
+  if (id >= m_records.size ())
+    {
+      // already disposed
+      return;
+    }
+  Record &record = m_records[id];
+  NS_ASSERT (record.allocated);
+  record.running = false;
+  record.allocated = false;
+  record.cb = Callback<void> ();
+  m_free.push_back (id);
+}
+
+uint32_t
+TimerWheel::GetSlotIndex (const Time &expiry) const
+{
+  return static_cast<uint32_t> ((expiry.GetTimeStep () / m_granularity.GetTimeStep ()) % m_nSlots);
+}
+
+void
+TimerWheel::Schedule (TimerId id, const Time &delay)
+{
+  NS_LOG_FUNCTION (this << id << delay);
+  NS_ASSERT (id < m_records.size () && m_records[id].allocated);
+  Record &record = m_records[id];
+  Time expiry = Simulator::Now () + delay;
+  uint32_t slotIndex = GetSlotIndex (expiry);
+
+  // A timer moving to another slot leaves a stale entry in its previous
+  // slot, which is discarded when that slot is next visited
+  if (!record.listed || record.slot != slotIndex)
+    {
+      m_slots[slotIndex].timers.push_back (id);
+      record.listed = true;
+    }
+  record.expiry = expiry;
+  record.slot = slotIndex;
+  record.running = true;
+  ArmSlot (slotIndex, expiry);
+}
+
+void
+TimerWheel::Cancel (TimerId id)
+{
+  NS_LOG_FUNCTION (this << id);
+  if (id < m_records.size ())
+    {
+      m_records[id].running = false;
+    }
+}
+
+bool
+TimerWheel::IsRunning (TimerId id) const
+{
+  return id < m_records.size () && m_records[id].running;
+}
+
+Time
+TimerWheel::GetDelayLeft (TimerId id) const
+{
+  if (!IsRunning (id))
+    {
+      return Time ();
+    }
+  return m_records[id].expiry - Simulator::Now ();
+}
+
+uint32_t
+TimerWheel::GetNScheduledEvents (void) const
+{
+  uint32_t n = 0;
+  for (const auto &slot : m_slots)
+    {
+      if (slot.event.IsRunning ())
+        {
+          ++n;
+        }
+    }
+  return n;
+}
+
+void
+TimerWheel::ArmSlot (uint32_t slotIndex, const Time &expiry)
+{
+  Slot &slot = m_slots[slotIndex];
+  if (slot.event.IsRunning () && slot.eventTime <= expiry)
+    {
+      return;
+    }
+  slot.event.Cancel ();
+  slot.event = Simulator::Schedule (expiry - Simulator::Now (), &TimerWheel::ExpireSlot, this, slotIndex);
+  slot.eventTime = expiry;
+}
+
+void
+TimerWheel::ExpireSlot (uint32_t slotIndex)
+{
+  NS_LOG_FUNCTION (this << slotIndex);
+  Time now = Simulator::Now ();
+  uint64_t pass = ++m_pass;
+
+  std::vector<TimerId> listed;
+  listed.swap (m_slots[slotIndex].timers);
+  m_slots[slotIndex].event = EventId ();
+
+  // Drop stale and duplicate entries, keep the pending ones and collect the expired ones
+  std::vector<TimerId> expired;
+  bool hasPending = false;
+  Time nextExpiry;
+  for (TimerId id : listed)
+    {
+      Record &record = m_records[id];
+      if (!record.allocated || record.slot != slotIndex || record.pass == pass)
+        {
+          continue;
+        }
+      record.pass = pass;
+      if (!record.running || record.expiry <= now)
+        {
+          record.listed = false;
+          if (record.running)
+            {
+              expired.push_back (id);
+            }
+          continue;
+        }
+      m_slots[slotIndex].timers.push_back (id);
+      if (!hasPending || record.expiry < nextExpiry)
+        {
+          nextExpiry = record.expiry;
+          hasPending = true;
+        }
+    }
+
+  if (hasPending)
+    {
+      ArmSlot (slotIndex, nextExpiry);
+    }
+
+  for (TimerId id : expired)
+    {
+      // A previous callback may have stopped, restarted or released this timer
+      Record &record = m_records[id];
+      if (!record.allocated || !record.running || record.listed)
+        {
+          continue;
+        }
+      record.running = false;
+      Callback<void> cb = record.cb;
+      cb ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,188 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "object.h"
+#include "nstime.h"
+#include "event-id.h"
+#include "callback.h"
+#include <vector>
+#include <stdint.h>
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel class declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ * \brief A hashed timer wheel which batches many timers behind few simulator events.
+ *
+ * Protocols which re-arm the same timer very often (for example, a TCP
+ * retransmission timer which is restarted by every ACK) normally cancel
+ * one event and schedule another one each time.  Cancelled events stay
+ * in the simulator queue until their expiration time, so with many
+ * concurrent flows the queue fills with dead events.
+ *
+ * A TimerWheel keeps the timers of its users itself.  Each timer is
+ * hashed by its expiration time into one of a fixed number of slots,
+ * each covering a time interval of length Granularity.  For each slot,
+ * only the earliest expiration time is scheduled in the simulator.
+ * Cancelling a timer, or moving it to a later time, does not touch the
+ * simulator queue; the slot event notices the change when it fires and
+ * re-arms itself for the next pending expiration of the slot, if any.
+ *
+ * Timers always expire at their exact expiration time; the granularity
+ * only controls how timers are grouped.  The order in which timers
+ * expiring at the same time are invoked is deterministic, but it is not
+ * necessarily the order in which they were scheduled, and the timers may
+ * expire before or after other simulator events scheduled for that time.
+ *
+ * A TimerWheel is usually aggregated to a Node, and shared by all the
+ * protocols of the node; see GetOrCreate().
+ */
+class TimerWheel : public Object
+{
+public:
+  /** Timer handle. */
+  typedef uint32_t TimerId;
+
+  /** Invalid timer handle. */
+  static const TimerId INVALID_TIMER = UINT32_MAX;
+
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  TimerWheel ();
+  virtual ~TimerWheel ();
+
+  /**
+   * Get the TimerWheel aggregated to an object, aggregating a new one if needed.
+   *
+   * \param [in] object The object, typically a Node.
+   * \return The TimerWheel aggregated to the object.
+   */
+  static Ptr<TimerWheel> GetOrCreate (Ptr<Object> object);
+
+  /**
+   * Create a new timer, not running.
+   *
+   * \param [in] cb The function to invoke when the timer expires.
+   * \return The handle of the new timer.
+   */
+  TimerId Create (Callback<void> cb);
+
+  /**
+   * Cancel a timer and release its handle.
+   *
+   * \param [in] id The timer handle, which must not be used afterwards.
+   */
+  void Release (TimerId id);
+
+  /**
+   * Start a timer, or move it to a new expiration time if it is running.
+   *
+   * \param [in] id The timer handle.
+   * \param [in] delay The delay after which the timer expires.
+   */
+  void Schedule (TimerId id, const Time &delay);
+
+  /**
+   * Stop a timer.  Stopping a timer which is not running does nothing.
+   *
+   * \param [in] id The timer handle.
+   */
+  void Cancel (TimerId id);
+
+  /**
+   * \param [in] id The timer handle.
+   * \return \c true if the timer is running.
+   */
+  bool IsRunning (TimerId id) const;
+
+  /**
+   * \param [in] id The timer handle.
+   * \return The time left until the timer expires, or zero if it is not running.
+   */
+  Time GetDelayLeft (TimerId id) const;
+
+  /**
+   * \return The number of simulator events currently scheduled by this wheel.
+   */
+  uint32_t GetNScheduledEvents (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /** A timer. */
+  struct Record
+  {
+    Callback<void> cb;      //!< The function to invoke on expiration.
+    Time expiry;            //!< The expiration time.
+    uint64_t pass;          //!< The last slot pass which visited the timer.
+    uint32_t slot;          //!< The slot of the expiration time.
+    bool running;           //!< Whether the timer is running.
+    bool listed;            //!< Whether the timer is listed in its slot.
+    bool allocated;         //!< Whether the handle is in use.
+  };
+
+  /** A wheel slot. */
+  struct Slot
+  {
+    std::vector<TimerId> timers;  //!< Timers listed in this slot, possibly stale.
+    EventId event;                //!< The simulator event for this slot.
+    Time eventTime;               //!< The time of the simulator event.
+  };
+
+  /**
+   * \param [in] expiry An expiration time.
+   * \return The slot index for the expiration time.
+   */
+  uint32_t GetSlotIndex (const Time &expiry) const;
+
+  /**
+   * Make sure the simulator event of a slot fires no later than a given time.
+   * \param [in] slotIndex The slot index.
+   * \param [in] expiry The expiration time.
+   */
+  void ArmSlot (uint32_t slotIndex, const Time &expiry);
+
+  /**
+   * Invoke the expired timers of a slot and re-arm it.
+   * \param [in] slotIndex The slot index.
+   */
+  void ExpireSlot (uint32_t slotIndex);
+
+  Time m_granularity;               //!< Time interval covered by one slot.
+  uint32_t m_nSlots;                //!< Number of slots.
+  std::vector<Slot> m_slots;        //!< The slots.
+  std::vector<Record> m_records;    //!< The timers, indexed by handle.
+  std::vector<TimerId> m_free;      //!< Released handles.
+  uint64_t m_pass;                  //!< Number of slot passes so far.
+};
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
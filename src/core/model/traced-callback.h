@@ -21,7 +21,7 @@
 #ifndef TRACED_CALLBACK_H
 #define TRACED_CALLBACK_H
 
-#include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +46,16 @@ namespace ns3 {
  * calling the \c operator() form with the appropriate
  * number of arguments.
  *
+ * The chain is stored contiguously, and invoking an empty chain only
+ * checks its size.  The arguments are still built by the caller, so
+ * the callers which copy packets or look up objects to fire a trace
+ * should check IsEmpty() first.
+ *
+ * When ns-3 is configured with \c --disable-traces, i.e., when
+ * \c NS3_TRACES_DISABLE is defined, the Callbacks can still be
+ * connected but they are never invoked, and IsEmpty() always returns
+ * true, so that the trace sources cost nothing in benchmark runs.
+ *
  * \tparam Ts \explicit Types of the functor arguments.
  */
 template<typename... Ts>
@@ -91,7 +101,12 @@ public:
   void operator() (Ts... args) const;
   /**
    * \brief Checks if the Callbacks list is empty.
-   * \return true if the Callbacks list is empty.
+   *
+   * This is the guard to use before building costly arguments for
+   * the functor.
+   *
+   * \return true if the Callbacks list is empty, or if the trace
+   * sources are compiled out.
    */
   bool IsEmpty () const;
 
@@ -112,7 +127,7 @@ private:
    *
    * \tparam Ts \deduced Types of the functor arguments.
    */
-  typedef std::list<Callback<void,Ts...> > CallbackList;
+  typedef std::vector<Callback<void,Ts...> > CallbackList;
   /** The chain of Callbacks. */
   CallbackList m_callbackList;
 };
@@ -157,18 +172,16 @@ template<typename... Ts>
 void
 TracedCallback<Ts...>::DisconnectWithoutContext (const CallbackBase & callback)
 {
+  typename CallbackList::iterator last = m_callbackList.begin ();
   for (typename CallbackList::iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); /* empty */)
+       i != m_callbackList.end (); i++)
     {
-      if ((*i).IsEqual (callback))
+      if (!(*i).IsEqual (callback))
         {
-          i = m_callbackList.erase (i);
-        }
-      else
-        {
-          i++;
+          *last++ = *i;
         }
     }
+  m_callbackList.erase (last, m_callbackList.end ());
 }
 template<typename... Ts>
 void
@@ -186,18 +199,28 @@ template<typename... Ts>
 void
 TracedCallback<Ts...>::operator() (Ts... args) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+#ifndef NS3_TRACES_DISABLE
+  if (m_callbackList.empty ())
+    {
+      return;
+    }
+  // By index, as a Callback may connect another one to this chain.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(args...);
+      m_callbackList[i](args...);
     }
+#endif /* NS3_TRACES_DISABLE */
 }
 
 template <typename... Ts>
 bool
 TracedCallback<Ts...>::IsEmpty () const
 {
+#ifdef NS3_TRACES_DISABLE
+  return true;
+#else
   return m_callbackList.empty ();
+#endif /* NS3_TRACES_DISABLE */
 }
 
 } // namespace ns3
@@ -27,6 +27,7 @@
 #include "ns3/singleton.h"
 #include "ns3/object.h"
 #include "ns3/object-vector.h"
+#include "ns3/object-map.h"
 #include "ns3/names.h"
 #include "ns3/pointer.h"
 #include "ns3/log.h"
@@ -284,6 +285,46 @@ DerivedConfigObject::GetTypeId (void)
   return tid;
 }
 
+/**
+ * \ingroup config-tests
+ * Config object holding a map of objects.
+ */
+class ConfigTestMapObject : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  /**
+   * Add node function
+   * \param key the key of the node
+   * \param node test object
+   */
+  void AddNode (uint32_t key, Ptr<ConfigTestObject> node)
+  {
+    m_nodes[key] = node;
+  }
+
+private:
+  std::map<uint32_t, Ptr<ConfigTestObject> > m_nodes; //!< Nodes attribute target.
+};
+
+TypeId
+ConfigTestMapObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ConfigTestMapObject")
+    .SetParent<Object> ()
+    .AddAttribute ("Nodes", "",
+                   ObjectMapValue (),
+                   MakeObjectMapAccessor (&ConfigTestMapObject::m_nodes),
+                   MakeObjectMapChecker<ConfigTestObject> ())
+  ;
+  return tid;
+}
+
 
 /**
  * \ingroup config-tests
@@ -840,6 +881,127 @@ SearchAttributesOfParentObjectsTestCase::DoRun (void)
 
 }
 
+/**
+ * \ingroup config-tests
+ * Test for the lookups of a few indices of containers, and of the
+ * trace sources of the matching objects.
+ */
+class ContainerIndexConfigTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  ContainerIndexConfigTestCase ();
+  /** Destructor. */
+  virtual ~ContainerIndexConfigTestCase ()
+  {}
+
+  /**
+   * Trace callback with context path.
+   * \param path The context path.
+   * \param old The old value.
+   * \param newValue The new value.
+   */
+  void TraceWithPath (std::string path, int16_t old, int16_t newValue)
+  {
+    NS_UNUSED (old);
+    m_newValue = newValue;
+    m_path = path;
+    m_count++;
+  }
+
+private:
+  virtual void DoRun (void);
+
+  int16_t m_newValue; //!< Flag to detect tracing result.
+  std::string m_path; //!< The context path.
+  uint32_t m_count;   //!< Number of trace callbacks.
+};
+
+ContainerIndexConfigTestCase::ContainerIndexConfigTestCase ()
+  : TestCase ("Check the lookups of a few indices of containers of Object")
+{}
+
+void
+ContainerIndexConfigTestCase::DoRun (void)
+{
+  m_count = 0;
+
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+
+  //
+  // A vector of 40 objects, and a map of 3 objects whose keys are not
+  // their positions.
+  //
+  std::vector<Ptr<ConfigTestObject> > objs;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      objs.push_back (CreateObject<ConfigTestObject> ());
+      a->AddNodeA (objs.back ());
+    }
+  Ptr<ConfigTestMapObject> map = CreateObject<ConfigTestMapObject> ();
+  a->AggregateObject (map);
+  map->AddNode (10, CreateObject<ConfigTestObject> ());
+  map->AddNode (20, CreateObject<ConfigTestObject> ());
+  map->AddNode (30, CreateObject<ConfigTestObject> ());
+
+  Config::MatchContainer matches = Config::LookupMatches ("/NodeA/NodesA/5");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Wrong number of matches of an index");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objs[5], "Wrong match of an index");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeA/NodesA/5/", "Wrong path of an index");
+
+  matches = Config::LookupMatches ("/NodeA/NodesA/7|3|7");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Wrong number of matches of indices");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (0), objs[3], "Matches of indices not in order");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (1), objs[7], "Matches of indices not in order");
+
+  matches = Config::LookupMatches ("/NodeA/NodesA/[10-39]");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 30, "Wrong number of matches of a large range");
+  NS_TEST_ASSERT_MSG_EQ (matches.Get (29), objs[39], "Wrong match of a large range");
+
+  matches = Config::LookupMatches ("/NodeA/NodesA/[38-45]|40");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 2, "Wrong number of matches past the end of a vector");
+
+  matches = Config::LookupMatches ("/NodeA/$ConfigTestMapObject/Nodes/20");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 1, "Wrong number of matches of a map key");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetMatchedPath (0), "/NodeA/$ConfigTestMapObject/Nodes/20/", "Wrong path of a map key");
+
+  matches = Config::LookupMatches ("/NodeA/$ConfigTestMapObject/Nodes/1|2");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 0, "Positions of a map unexpectedly matched as keys");
+
+  matches = Config::LookupMatches ("/NodeA/$ConfigTestMapObject/Nodes/*");
+  NS_TEST_ASSERT_MSG_EQ (matches.GetN (), 3, "Wrong number of matches of all map keys");
+
+  //
+  // Connect the trace sources of a few objects, twice for the same type.
+  //
+  Config::Connect ("/NodeA/NodesA/5/Source",
+                   MakeCallback (&ContainerIndexConfigTestCase::TraceWithPath, this));
+  Config::Connect ("/NodeA/NodesA/6/Source",
+                   MakeCallback (&ContainerIndexConfigTestCase::TraceWithPath, this));
+  objs[6]->SetAttribute ("Source", IntegerValue (-6));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, -6, "Trace of the second index not connected");
+  NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodesA/6/Source", "Wrong trace path");
+  objs[5]->SetAttribute ("Source", IntegerValue (-5));
+  NS_TEST_ASSERT_MSG_EQ (m_newValue, -5, "Trace of the first index not connected");
+  NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodesA/5/Source", "Wrong trace path");
+  objs[4]->SetAttribute ("Source", IntegerValue (-4));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "Trace of another index unexpectedly connected");
+
+  Config::Disconnect ("/NodeA/NodesA/5/Source",
+                      MakeCallback (&ContainerIndexConfigTestCase::TraceWithPath, this));
+  objs[5]->SetAttribute ("Source", IntegerValue (-55));
+  NS_TEST_ASSERT_MSG_EQ (m_count, 2, "Trace not disconnected");
+
+  bool ok = Config::ConnectFailSafe ("/NodeA/NodesA/5/Missing",
+                                     MakeCallback (&ContainerIndexConfigTestCase::TraceWithPath, this));
+  NS_TEST_ASSERT_MSG_EQ (ok, false, "Missing trace source unexpectedly connected");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 /**
  * \ingroup config-tests
  * The Test Suite that glues all of the Test Cases together.
@@ -858,6 +1020,7 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase);
   AddTestCase (new ObjectVectorConfigTestCase);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase);
+  AddTestCase (new ContainerIndexConfigTestCase);
 }
 
 /**
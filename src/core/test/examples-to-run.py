@@ -15,6 +15,7 @@ cpp_examples = [
     ("main-random-variable", "True", "False"),
     ("sample-random-variable", "True", "True"),
     ("test-string-value-formatting", "True", "True"),
+    ("get-object-benchmark --nLookups=1000", "True", "True"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
@@ -402,6 +402,67 @@ AggregateObjectTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (baseA, 0, "Unable to GetObject on released object");
 }
 
+/**
+ * \ingroup object-tests
+ * Test the lookups of aggregated Objects are cached correctly.
+ */
+class GetObjectCacheTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  GetObjectCacheTestCase ();
+  /** Destructor. */
+  virtual ~GetObjectCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GetObjectCacheTestCase::GetObjectCacheTestCase ()
+  : TestCase ("Check the cache of GetObject lookups")
+{}
+
+GetObjectCacheTestCase::~GetObjectCacheTestCase ()
+{}
+
+void
+GetObjectCacheTestCase::DoRun (void)
+{
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+
+  //
+  // Failed lookups are cached too, and must be forgotten when
+  // an Object is aggregated.
+  //
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB through baseA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a cached BaseB through baseA");
+  NS_TEST_ASSERT_MSG_EQ (baseA->PeekObject<DerivedB> (), 0, "Unexpectedly found a DerivedB through baseA");
+  baseA->AggregateObject (derivedB);
+  NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Cannot GetObject (through baseA) for BaseB Object");
+  NS_TEST_ASSERT_MSG_EQ (baseA->PeekObject<DerivedB> (), PeekPointer (derivedB), "Cannot PeekObject (through baseA) for DerivedB Object");
+
+  //
+  // The cached lookups must give the same results, through every
+  // Object of the aggregation.
+  //
+  for (int i = 0; i < 3; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), derivedB, "Cached GetObject (through baseA) for DerivedB returns different Ptr");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), baseA, "Cached GetObject (through derivedB) for BaseA returns different Ptr");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (), 0, "Unexpectedly found a cached DerivedA through derivedB");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseB> (DerivedB::GetTypeId ()), derivedB, "Cached GetObject by TypeId returns different Ptr");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->PeekObject<Object> (), PeekPointer (derivedB), "PeekObject for Object does not return the calling object");
+    }
+
+  //
+  // PeekObject does not take a reference.
+  //
+  uint32_t count = derivedB->GetReferenceCount ();
+  DerivedB *peeked = baseA->PeekObject<DerivedB> ();
+  NS_TEST_ASSERT_MSG_EQ (peeked->GetReferenceCount (), count, "PeekObject changed the reference count");
+}
+
 /**
  * \ingroup object-tests
  * Test an Object factory can create Objects
@@ -491,6 +552,7 @@ ObjectTestSuite::ObjectTestSuite ()
 {
   AddTestCase (new CreateObjectTestCase);
   AddTestCase (new AggregateObjectTestCase);
+  AddTestCase (new GetObjectCacheTestCase);
   AddTestCase (new ObjectFactoryTestCase);
 }
 
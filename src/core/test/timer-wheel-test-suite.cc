@@ -0,0 +1,262 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/timer-wheel.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/test.h"
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup timer
+ * \ingroup timer-tests
+ * TimerWheel test suite.
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup timer-tests
+ * Check that timers expire at their exact time, after being moved or cancelled.
+ */
+class TimerWheelExpireTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelExpireTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Function to invoke when a timer expires.
+   * \param index The index of the timer.
+   */
+  void Expire (uint32_t index);
+
+  std::vector<Time> m_expiredTime; //!< Expiration time of each timer.
+  std::vector<uint32_t> m_nExpired; //!< Number of expirations of each timer.
+};
+
+TimerWheelExpireTestCase::TimerWheelExpireTestCase ()
+  : TestCase ("Check that timers of a TimerWheel expire at the right time")
+{}
+
+void
+TimerWheelExpireTestCase::Expire (uint32_t index)
+{
+  m_expiredTime[index] = Simulator::Now ();
+  ++m_nExpired[index];
+}
+
+void
+TimerWheelExpireTestCase::DoRun (void)
+{
+  m_expiredTime.assign (5, Seconds (0));
+  m_nExpired.assign (5, 0);
+
+  Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+  wheel->SetAttribute ("Granularity", TimeValue (MilliSeconds (1)));
+  wheel->SetAttribute ("SlotCount", UintegerValue (8));
+
+  std::vector<TimerWheel::TimerId> ids;
+  for (uint32_t i = 0; i < 5; ++i)
+    {
+      ids.push_back (wheel->Create (MakeCallback (&TimerWheelExpireTestCase::Expire, this).Bind (i)));
+    }
+
+  // timer 0 is not moved
+  wheel->Schedule (ids[0], MicroSeconds (2500));
+  // timer 1 is pushed later in the same slot, then into another slot and another rotation
+  wheel->Schedule (ids[1], MicroSeconds (3100));
+  Simulator::Schedule (MicroSeconds (1000), &TimerWheel::Schedule, wheel, ids[1], MicroSeconds (2800));
+  Simulator::Schedule (MicroSeconds (2000), &TimerWheel::Schedule, wheel, ids[1], MicroSeconds (9000));
+  // timer 2 is cancelled
+  wheel->Schedule (ids[2], MicroSeconds (2500));
+  Simulator::Schedule (MicroSeconds (100), &TimerWheel::Cancel, wheel, ids[2]);
+  // timer 3 is shortened
+  wheel->Schedule (ids[3], MicroSeconds (7000));
+  Simulator::Schedule (MicroSeconds (500), &TimerWheel::Schedule, wheel, ids[3], MicroSeconds (100));
+  // timer 4 is released
+  wheel->Schedule (ids[4], MicroSeconds (4000));
+  Simulator::Schedule (MicroSeconds (200), &TimerWheel::Release, wheel, ids[4]);
+
+  NS_TEST_ASSERT_MSG_EQ (wheel->IsRunning (ids[1]), true, "Timer 1 should be running");
+  NS_TEST_ASSERT_MSG_EQ (wheel->GetDelayLeft (ids[1]), MicroSeconds (3100), "Wrong delay left");
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nExpired[0], 1, "Timer 0 should expire once");
+  NS_TEST_ASSERT_MSG_EQ (m_expiredTime[0], MicroSeconds (2500), "Timer 0 expired at the wrong time");
+  NS_TEST_ASSERT_MSG_EQ (m_nExpired[1], 1, "Timer 1 should expire once");
+  NS_TEST_ASSERT_MSG_EQ (m_expiredTime[1], MicroSeconds (11000), "Timer 1 expired at the wrong time");
+  NS_TEST_ASSERT_MSG_EQ (m_nExpired[2], 0, "Timer 2 was cancelled");
+  NS_TEST_ASSERT_MSG_EQ (m_nExpired[3], 1, "Timer 3 should expire once");
+  NS_TEST_ASSERT_MSG_EQ (m_expiredTime[3], MicroSeconds (600), "Timer 3 expired at the wrong time");
+  NS_TEST_ASSERT_MSG_EQ (m_nExpired[4], 0, "Timer 4 was released");
+  NS_TEST_ASSERT_MSG_EQ (wheel->IsRunning (ids[1]), false, "Timer 1 should not be running");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ * Check that frequently restarted timers do not keep one simulator event each.
+ */
+class TimerWheelBatchTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelBatchTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Restart all timers, as a protocol would do on each received ACK.
+   * \param wheel The wheel.
+   * \param ids The timers.
+   */
+  void Restart (Ptr<TimerWheel> wheel, std::vector<TimerWheel::TimerId> ids);
+  /** Count an expiration. */
+  void Expire (void);
+
+  uint32_t m_nExpired;       //!< Number of expirations.
+  uint32_t m_maxEvents;      //!< Max number of wheel events seen.
+};
+
+TimerWheelBatchTestCase::TimerWheelBatchTestCase ()
+  : TestCase ("Check that a TimerWheel batches timers sharing a slot")
+{}
+
+void
+TimerWheelBatchTestCase::Expire (void)
+{
+  ++m_nExpired;
+}
+
+void
+TimerWheelBatchTestCase::Restart (Ptr<TimerWheel> wheel, std::vector<TimerWheel::TimerId> ids)
+{
+  for (auto id : ids)
+    {
+      wheel->Cancel (id);
+      wheel->Schedule (id, MilliSeconds (200));
+    }
+  m_maxEvents = std::max (m_maxEvents, wheel->GetNScheduledEvents ());
+}
+
+void
+TimerWheelBatchTestCase::DoRun (void)
+{
+  m_nExpired = 0;
+  m_maxEvents = 0;
+
+  Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+  std::vector<TimerWheel::TimerId> ids;
+  for (uint32_t i = 0; i < 100; ++i)
+    {
+      ids.push_back (wheel->Create (MakeCallback (&TimerWheelBatchTestCase::Expire, this)));
+    }
+
+  // restart every timer every 10 us during 100 ms
+  for (uint32_t i = 0; i < 10000; ++i)
+    {
+      Simulator::Schedule (MicroSeconds (10 * i), &TimerWheelBatchTestCase::Restart, this, wheel, ids);
+    }
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nExpired, 100, "Every timer should expire exactly once");
+  // the pending deadlines span 200 ms, i.e., at most 201 slots of 1 ms
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (m_maxEvents, 201, "Too many simulator events");
+  NS_TEST_ASSERT_MSG_EQ (wheel->GetNScheduledEvents (), 0, "No event should be left");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ * Check that the timers of a wheel freed without being disposed do not expire.
+ */
+class TimerWheelReleaseTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  TimerWheelReleaseTestCase ();
+  virtual void DoRun (void);
+  /** Count an expiration. */
+  void Expire (void);
+
+  uint32_t m_nExpired;       //!< Number of expirations.
+};
+
+TimerWheelReleaseTestCase::TimerWheelReleaseTestCase ()
+  : TestCase ("Check that the timers of a freed TimerWheel do not expire")
+{}
+
+void
+TimerWheelReleaseTestCase::Expire (void)
+{
+  ++m_nExpired;
+}
+
+void
+TimerWheelReleaseTestCase::DoRun (void)
+{
+  m_nExpired = 0;
+
+  Ptr<TimerWheel> wheel = CreateObject<TimerWheel> ();
+  TimerWheel::TimerId id = wheel->Create (MakeCallback (&TimerWheelReleaseTestCase::Expire, this));
+  wheel->Schedule (id, MilliSeconds (10));
+  // drop the last reference without calling Dispose
+  wheel = 0;
+
+  Simulator::Run ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_nExpired, 0, "The timer of the freed wheel should not expire");
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup timer-tests
+ * TimerWheel test suite
+ */
+class TimerWheelTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  TimerWheelTestSuite ()
+    : TestSuite ("timer-wheel")
+  {
+    AddTestCase (new TimerWheelExpireTestCase ());
+    AddTestCase (new TimerWheelBatchTestCase ());
+    AddTestCase (new TimerWheelReleaseTestCase ());
+  }
+};
+
+/**
+ * \ingroup timer-tests
+ * TimerWheelTestSuite instance variable.
+ */
+static TimerWheelTestSuite g_timerWheelTestSuite;
+
+
+}    // namespace tests
+
+}  // namespace ns3
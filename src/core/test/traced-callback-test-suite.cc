@@ -113,6 +113,74 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ChainChangeTracedCallbackTestCase : public TestCase
+{
+public:
+  ChainChangeTracedCallbackTestCase ();
+  virtual ~ChainChangeTracedCallbackTestCase ()
+  {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbConnect (uint8_t a, double b);
+  void CbCount (uint8_t a, double b);
+
+  TracedCallback<uint8_t, double> m_trace;
+  uint32_t m_count;
+};
+
+ChainChangeTracedCallbackTestCase::ChainChangeTracedCallbackTestCase ()
+  : TestCase ("Check changes of the TracedCallback chain")
+{}
+
+void
+ChainChangeTracedCallbackTestCase::CbConnect (uint8_t a, double b)
+{
+  NS_UNUSED (a);
+  NS_UNUSED (b);
+  // Enough callbacks for the chain to grow while it is invoked.
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      m_trace.ConnectWithoutContext (MakeCallback (&ChainChangeTracedCallbackTestCase::CbCount, this));
+    }
+}
+
+void
+ChainChangeTracedCallbackTestCase::CbCount (uint8_t a, double b)
+{
+  NS_UNUSED (a);
+  NS_UNUSED (b);
+  m_count++;
+}
+
+void
+ChainChangeTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback not empty");
+
+  //
+  // A callback connecting others while the chain is invoked: the new
+  // callbacks are invoked too, as they are at the end of the chain.
+  //
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainChangeTracedCallbackTestCase::CbConnect, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "TracedCallback empty after connection");
+  m_count = 0;
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 10, "Callbacks connected during invocation not called");
+
+  //
+  // Disconnecting a callback removes all its connections, and only them.
+  //
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainChangeTracedCallbackTestCase::CbCount, this));
+  m_count = 0;
+  m_trace (1, 2);
+  NS_TEST_ASSERT_MSG_EQ (m_count, 10, "Disconnected callbacks called");
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainChangeTracedCallbackTestCase::CbConnect, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainChangeTracedCallbackTestCase::CbCount, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "TracedCallback not empty after disconnections");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -123,6 +191,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ChainChangeTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
@@ -40,6 +40,11 @@
 // $ ./waf --run="fd2fd-onoff"
 // $ ./waf --run="fd2fd-onoff --tcpMode=1"
 //
+// With --batchSize greater than 1, the devices read and write up to
+// batchSize frames at once (see the FdNetDevice BatchSize attribute):
+//
+// $ ./waf --run="fd2fd-onoff --batchSize=32"
+//
 
 #include <sys/socket.h>
 #include <errno.h>
@@ -61,8 +66,10 @@ main (int argc, char *argv[])
   // Command-line arguments
   //
   bool tcpMode = false;
+  uint32_t batchSize = 1;
   CommandLine cmd (__FILE__);
   cmd.AddValue ("tcpMode", "1:true, 0:false, default mode UDP",tcpMode);
+  cmd.AddValue ("batchSize", "Number of frames read or written at once", batchSize);
   cmd.Parse (argc, argv);
    
   std::string factory;
@@ -87,6 +94,7 @@ main (int argc, char *argv[])
 
   NS_LOG_INFO ("Create Device");
   FdNetDeviceHelper fd;
+  fd.SetAttribute ("BatchSize", UintegerValue (batchSize));
   NetDeviceContainer devices = fd.Install (nodes);
 
   int sv[2];
@@ -39,11 +39,23 @@
 #include <unistd.h>
 #include <arpa/inet.h>
 #include <net/ethernet.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <errno.h>
+#include <time.h>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("FdNetDevice");
 
+struct FdNetDeviceMmsgVectors
+{
+#ifdef HAVE_RECVMMSG
+  std::vector<struct mmsghdr> msgs;  //!< message headers
+  std::vector<struct iovec> iovecs;  //!< buffer descriptors
+#endif
+};
+
 FdNetDeviceFdReader::FdNetDeviceFdReader ()
   : m_bufferSize (65536) // Defaults to maximum TCP window size
 {
@@ -75,6 +87,167 @@ FdReader::Data FdNetDeviceFdReader::DoRead (void)
   return FdReader::Data (buf, len);
 }
 
+FdNetDeviceBatchFdReader::FdNetDeviceBatchFdReader ()
+  : m_nFrames (0),
+    m_frameSize (0),
+    m_batchSize (0),
+    m_head (0),
+    m_count (0),
+    m_notified (false),
+    m_isSocket (true),
+    m_mmsg (new FdNetDeviceMmsgVectors ())
+{
+}
+
+FdNetDeviceBatchFdReader::~FdNetDeviceBatchFdReader ()
+{
+}
+
+void
+FdNetDeviceBatchFdReader::SetRing (uint32_t nFrames, uint32_t frameSize, uint32_t batchSize)
+{
+  NS_LOG_FUNCTION (this << nFrames << frameSize << batchSize);
+  NS_ASSERT (nFrames > 0 && batchSize > 0);
+  m_nFrames = nFrames;
+  m_frameSize = frameSize;
+  m_batchSize = batchSize;
+  m_frames.assign (static_cast<std::size_t> (nFrames) * frameSize, 0);
+  m_lengths.assign (nFrames, 0);
+  m_head = 0;
+  m_count = 0;
+#ifdef HAVE_RECVMMSG
+  m_mmsg->msgs.resize (batchSize);
+  m_mmsg->iovecs.resize (batchSize);
+#endif
+}
+
+void
+FdNetDeviceBatchFdReader::SetNotifyCallback (Callback<void> cb)
+{
+  m_notify = cb;
+}
+
+uint32_t
+FdNetDeviceBatchFdReader::Acquire (void)
+{
+  CriticalSection cs (m_mutex);
+  m_notified = false;
+  return m_count;
+}
+
+uint8_t *
+FdNetDeviceBatchFdReader::GetFrame (uint32_t i, ssize_t &len)
+{
+  // The read thread does not modify the buffers of acquired frames
+  uint32_t index = (m_head + i) % m_nFrames;
+  len = m_lengths[index];
+  return &m_frames[static_cast<std::size_t> (index) * m_frameSize];
+}
+
+void
+FdNetDeviceBatchFdReader::Release (uint32_t n)
+{
+  CriticalSection cs (m_mutex);
+  NS_ASSERT (n <= m_count);
+  m_head = (m_head + n) % m_nFrames;
+  m_count -= n;
+}
+
+FdReader::Data FdNetDeviceBatchFdReader::DoRead (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t tail;
+  uint32_t nFree;
+  {
+    CriticalSection cs (m_mutex);
+    tail = (m_head + m_count) % m_nFrames;
+    nFree = m_nFrames - m_count;
+  }
+
+  if (nFree == 0)
+    {
+      // Leave the frames in the socket buffer until the simulation
+      // catches up
+      NS_LOG_WARN ("Frame ring full");
+      struct timespec time = {
+        0, 1000000L
+      };                                        // 1 ms
+      nanosleep (&time, NULL);
+      return FdReader::Data (0, -1);
+    }
+
+  int received = -1;
+
+#ifdef HAVE_RECVMMSG
+  if (m_isSocket)
+    {
+      // Read into contiguous buffers only, up to the end of the ring
+      uint32_t n = std::min (std::min (nFree, m_nFrames - tail), m_batchSize);
+      std::vector<struct mmsghdr> &msgs = m_mmsg->msgs;
+      std::vector<struct iovec> &iovecs = m_mmsg->iovecs;
+      for (uint32_t i = 0; i < n; i++)
+        {
+          iovecs[i].iov_base = &m_frames[static_cast<std::size_t> (tail + i) * m_frameSize];
+          iovecs[i].iov_len = m_frameSize;
+          memset (&msgs[i], 0, sizeof (struct mmsghdr));
+          msgs[i].msg_hdr.msg_iov = &iovecs[i];
+          msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+      NS_LOG_LOGIC ("Calling recvmmsg on fd " << m_fd);
+      received = recvmmsg (m_fd, &msgs[0], n, MSG_WAITFORONE, NULL);
+      if (received < 0 && errno == ENOTSOCK)
+        {
+          m_isSocket = false;
+        }
+      for (int i = 0; i < received; i++)
+        {
+          m_lengths[tail + i] = msgs[i].msg_len;
+        }
+    }
+#endif
+
+  if (!m_isSocket)
+    {
+      NS_LOG_LOGIC ("Calling read on fd " << m_fd);
+      ssize_t len = read (m_fd, &m_frames[static_cast<std::size_t> (tail) * m_frameSize], m_frameSize);
+      if (len > 0)
+        {
+          m_lengths[tail] = len;
+          received = 1;
+        }
+      else
+        {
+          received = len == 0 ? 0 : -1;
+        }
+    }
+
+  if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+      return FdReader::Data (0, -1);
+    }
+  if (received <= 0)
+    {
+      // stop reading, as the unbatched reader does
+      return FdReader::Data (0, 0);
+    }
+
+  NS_LOG_LOGIC ("Read " << received << " frames on fd " << m_fd);
+  bool notify;
+  {
+    CriticalSection cs (m_mutex);
+    m_count += received;
+    notify = !m_notified;
+    m_notified = true;
+  }
+  if (notify)
+    {
+      m_notify ();
+    }
+  // nothing for the read callback
+  return FdReader::Data (0, -1);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (FdNetDevice);
 
 TypeId
@@ -115,6 +288,16 @@ FdNetDevice::GetTypeId (void)
                    UintegerValue (1000),
                    MakeUintegerAccessor (&FdNetDevice::m_maxPendingReads),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BatchSize",
+                   "The maximum number of frames read or written at once.  "
+                   "If greater than 1, frames are received into a preallocated "
+                   "ring of RxQueueSize frames and processed together, and the "
+                   "frames sent at a same simulation time are written together, "
+                   "using recvmmsg/sendmmsg when the file descriptor is a socket. "
+                   "Subclasses with their own reader ignore this attribute.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&FdNetDevice::m_batchSize),
+                   MakeUintegerChecker<uint32_t> (1))
     //
     // Trace sources at the "top" of the net device, where packets transition
     // to/from higher layers.  These points do not really correspond to the
@@ -174,6 +357,10 @@ FdNetDevice::FdNetDevice ()
     m_fdReader (0),
     m_isBroadcast (true),
     m_isMulticast (false),
+    m_batchMode (false),
+    m_txFrameSize (0),
+    m_txIsSocket (true),
+    m_txMmsg (new FdNetDeviceMmsgVectors ()),
     m_startEvent (),
     m_stopEvent ()
 {
@@ -261,6 +448,26 @@ FdNetDevice::DoCreateFdReader (void)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_batchSize > 1)
+    {
+      // Set up the batched I/O path, both for reading and writing
+      m_batchMode = true;
+      Ptr<FdNetDeviceBatchFdReader> fdReader = Create<FdNetDeviceBatchFdReader> ();
+      fdReader->SetRing (std::max (m_maxPendingReads, m_batchSize), m_mtu + 22, m_batchSize);
+      fdReader->SetNotifyCallback (MakeCallback (&FdNetDevice::NotifyFramesReady, this));
+
+      // 4 more bytes for the PI header
+      m_txFrameSize = m_mtu + 22 + 4;
+      m_txFrames.assign (static_cast<std::size_t> (m_batchSize) * m_txFrameSize, 0);
+      m_txLengths.clear ();
+      m_txPackets.clear ();
+#ifdef HAVE_RECVMMSG
+      m_txMmsg->msgs.resize (m_batchSize);
+      m_txMmsg->iovecs.resize (m_batchSize);
+#endif
+      return fdReader;
+    }
+
   Ptr<FdNetDeviceFdReader> fdReader = Create<FdNetDeviceFdReader> ();
   // 22 bytes covers 14 bytes Ethernet header with possible 8 bytes LLC/SNAP
   fdReader->SetBufferSize (m_mtu + 22);
@@ -292,9 +499,14 @@ FdNetDevice::StopDevice (void)
 
   if (m_fd != -1)
     {
+      if (m_batchMode)
+        {
+          FlushFrames ();
+        }
       close (m_fd);
       m_fd = -1;
     }
+  m_batchMode = false;
 
   while (!m_pendingQueue.empty ())
     {
@@ -340,22 +552,14 @@ FdNetDevice::ReceiveCallback (uint8_t *buf, ssize_t len)
 
 /**
  * \ingroup fd-net-device
- * \brief Synthesize PI header for the kernel
- * \param buf the buffer to add the header to
- * \param len the buffer length
- *
- * \todo Consider having a instance member m_packetBuffer and using memmove
- * instead of memcpy to add the PI header. It might be faster in this case
- * to use memmove and avoid the extra mallocs.
+ * \brief Write the PI header of a frame
+ * \param pi the 4 bytes to write the header to
+ * \param buf the frame
+ * \param len the frame length
  */
 static void
-AddPIHeader (uint8_t *&buf, size_t &len)
+WritePIHeader (uint8_t *pi, const uint8_t *buf, size_t len)
 {
-  // Synthesize PI header for our friend the kernel
-  uint8_t *buf2 = (uint8_t*)malloc (len + 4);
-  memcpy (buf2 + 4, buf, len);
-  len += 4;
-
   // PI = 16 bits flags (0) + 16 bits proto
   // NOTE: be careful to interpret buffer data explicitly as
   //  little-endian to be insensible to native byte ordering.
@@ -374,10 +578,30 @@ AddPIHeader (uint8_t *&buf, size_t &len)
           proto = buf[12] | (buf[13] << 8);
         }
     }
-  buf2[0] = (uint8_t)flags;
-  buf2[1] = (uint8_t)(flags >> 8);
-  buf2[2] = (uint8_t)proto;
-  buf2[3] = (uint8_t)(proto >> 8);
+  pi[0] = (uint8_t)flags;
+  pi[1] = (uint8_t)(flags >> 8);
+  pi[2] = (uint8_t)proto;
+  pi[3] = (uint8_t)(proto >> 8);
+}
+
+/**
+ * \ingroup fd-net-device
+ * \brief Synthesize PI header for the kernel
+ * \param buf the buffer to add the header to
+ * \param len the buffer length
+ *
+ * \todo Consider having a instance member m_packetBuffer and using memmove
+ * instead of memcpy to add the PI header. It might be faster in this case
+ * to use memmove and avoid the extra mallocs.
+ */
+static void
+AddPIHeader (uint8_t *&buf, size_t &len)
+{
+  // Synthesize PI header for our friend the kernel
+  uint8_t *buf2 = (uint8_t*)malloc (len + 4);
+  memcpy (buf2 + 4, buf, len);
+  WritePIHeader (buf2, buf, len);
+  len += 4;
 
   // swap buffer
   free (buf);
@@ -452,6 +676,55 @@ FdNetDevice::ForwardUp (void)
   FreeBuffer (buf);
   buf = 0;
 
+  DoForwardUp (packet);
+}
+
+void
+FdNetDevice::NotifyFramesReady (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::ScheduleWithContext (m_nodeId, Time (0), MakeEvent (&FdNetDevice::ForwardUpBatch, this));
+}
+
+void
+FdNetDevice::ForwardUpBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_fdReader == 0)
+    {
+      NS_LOG_LOGIC ("no reader, probably the device is stopped.");
+      return;
+    }
+
+  // Hold the reader, in case a receive callback stops the device
+  Ptr<FdNetDeviceBatchFdReader> reader = StaticCast<FdNetDeviceBatchFdReader> (m_fdReader);
+  uint32_t n = reader->Acquire ();
+  NS_LOG_LOGIC ("forwarding " << n << " frames");
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      ssize_t len;
+      uint8_t *buf = reader->GetFrame (i, len);
+
+      // We need to remove the PI header and ignore it
+      if (m_encapMode == DIXPI && len >= 4)
+        {
+          buf += 4;
+          len -= 4;
+        }
+
+      DoForwardUp (Create<Packet> (reinterpret_cast<const uint8_t *> (buf), len));
+    }
+
+  reader->Release (n);
+}
+
+void
+FdNetDevice::DoForwardUp (Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+
   //
   // Trace sinks will expect complete packets, not packets without some of the
   // headers
@@ -614,6 +887,12 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
   m_promiscSnifferTrace (packet);
   m_snifferTrace (packet);
 
+  if (m_batchMode)
+    {
+      EnqueueFrame (packet);
+      return true;
+    }
+
   NS_LOG_LOGIC ("calling write");
 
 
@@ -645,6 +924,95 @@ FdNetDevice::SendFrom (Ptr<Packet> packet, const Address& src, const Address& de
   return true;
 }
 
+void
+FdNetDevice::EnqueueFrame (Ptr<Packet> packet)
+{
+  NS_LOG_FUNCTION (this << packet);
+
+  size_t len = packet->GetSize ();
+  NS_ASSERT (len + 4 <= m_txFrameSize);
+  uint8_t *buffer = &m_txFrames[m_txPackets.size () * m_txFrameSize];
+  packet->CopyData (buffer + 4, len);
+
+  // We need to add the PI header
+  if (m_encapMode == DIXPI)
+    {
+      WritePIHeader (buffer, buffer + 4, len);
+      len += 4;
+    }
+
+  m_txLengths.push_back (len);
+  m_txPackets.push_back (packet);
+
+  if (m_txPackets.size () == m_batchSize)
+    {
+      Simulator::Cancel (m_txFlushEvent);
+      FlushFrames ();
+    }
+  else if (!m_txFlushEvent.IsRunning ())
+    {
+      // Write the frames sent at this time together
+      m_txFlushEvent = Simulator::ScheduleNow (&FdNetDevice::FlushFrames, this);
+    }
+}
+
+void
+FdNetDevice::FlushFrames (void)
+{
+  NS_LOG_FUNCTION (this << m_txPackets.size ());
+
+  uint32_t nFrames = m_txPackets.size ();
+  // PI header included or not
+  uint32_t offset = (m_encapMode == DIXPI) ? 0 : 4;
+  uint32_t sent = 0;
+
+  while (sent < nFrames)
+    {
+      int written = -1;
+#ifdef HAVE_RECVMMSG
+      if (m_txIsSocket)
+        {
+          std::vector<struct mmsghdr> &msgs = m_txMmsg->msgs;
+          std::vector<struct iovec> &iovecs = m_txMmsg->iovecs;
+          for (uint32_t i = sent; i < nFrames; i++)
+            {
+              iovecs[i].iov_base = &m_txFrames[i * m_txFrameSize + offset];
+              iovecs[i].iov_len = m_txLengths[i];
+              memset (&msgs[i], 0, sizeof (struct mmsghdr));
+              msgs[i].msg_hdr.msg_iov = &iovecs[i];
+              msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+          NS_LOG_LOGIC ("calling sendmmsg");
+          written = sendmmsg (m_fd, &msgs[sent], nFrames - sent, 0);
+          if (written < 0 && errno == ENOTSOCK)
+            {
+              m_txIsSocket = false;
+            }
+        }
+#else
+      m_txIsSocket = false;
+#endif
+
+      if (!m_txIsSocket)
+        {
+          NS_LOG_LOGIC ("calling write");
+          ssize_t len = Write (&m_txFrames[sent * m_txFrameSize + offset], m_txLengths[sent]);
+          written = (len != -1 && (size_t) len == m_txLengths[sent]) ? 1 : -1;
+        }
+
+      if (written <= 0)
+        {
+          // Drop the first frame which could not be written
+          m_macTxDropTrace (m_txPackets[sent]);
+          written = 1;
+        }
+      sent += written;
+    }
+
+  m_txLengths.clear ();
+  m_txPackets.clear ();
+}
+
 ssize_t
 FdNetDevice::Write (uint8_t *buffer, size_t length)
 {
@@ -36,8 +36,10 @@
 #include "ns3/unix-fd-reader.h"
 #include "ns3/system-mutex.h"
 
+#include <memory>
 #include <utility>
 #include <queue>
+#include <vector>
 
 namespace ns3 {
 
@@ -68,6 +70,86 @@ private:
   uint32_t m_bufferSize; //!< size of the read buffer
 };
 
+/**
+ * \ingroup fd-net-device
+ * \brief Message headers and buffer descriptors for recvmmsg () and
+ * sendmmsg ().
+ *
+ * Defined in fd-net-device.cc only, where the system headers tell
+ * whether these calls exist, so that the layout of the classes below
+ * does not depend on it.
+ */
+struct FdNetDeviceMmsgVectors;
+
+/**
+ * \ingroup fd-net-device
+ * \brief This class reads frames from the sockets in batches, into a ring
+ * of preallocated frame buffers.
+ *
+ * Frames are read with recvmmsg () when the file descriptor is a socket
+ * and the system provides it, one at a time with read () otherwise.  The
+ * simulation thread is notified when frames become available, and
+ * processes all the available frames at once.
+ */
+class FdNetDeviceBatchFdReader : public FdReader
+{
+public:
+  FdNetDeviceBatchFdReader ();
+  ~FdNetDeviceBatchFdReader ();
+
+  /**
+   * Allocate the ring of frame buffers.
+   * \param nFrames the number of frame buffers
+   * \param frameSize the size of a frame buffer
+   * \param batchSize the maximum number of frames read at once
+   */
+  void SetRing (uint32_t nFrames, uint32_t frameSize, uint32_t batchSize);
+
+  /**
+   * Set the callback invoked in the read thread when frames become
+   * available and the previous ones were acquired already.
+   * \param cb the callback
+   */
+  void SetNotifyCallback (Callback<void> cb);
+
+  /**
+   * Get the frames waiting to be processed.  Frames read from now on
+   * trigger a new notification.
+   * \return the number of frames that can be passed to GetFrame
+   */
+  uint32_t Acquire (void);
+
+  /**
+   * Get an acquired frame.
+   * \param i the index of the frame, among the acquired ones
+   * \param [out] len the length of the frame
+   * \return the frame buffer
+   */
+  uint8_t * GetFrame (uint32_t i, ssize_t &len);
+
+  /**
+   * Give the buffers of the oldest frames back to the read thread.
+   * \param n the number of frames
+   */
+  void Release (uint32_t n);
+
+private:
+  FdReader::Data DoRead (void);
+
+  SystemMutex m_mutex;            //!< protects m_head, m_count and m_notified
+  std::vector<uint8_t> m_frames;  //!< the frame buffers
+  std::vector<ssize_t> m_lengths; //!< the length of the frame in each buffer
+  uint32_t m_nFrames;             //!< number of frame buffers
+  uint32_t m_frameSize;           //!< size of a frame buffer
+  uint32_t m_batchSize;           //!< maximum number of frames read at once
+  uint32_t m_head;                //!< buffer of the oldest frame
+  uint32_t m_count;               //!< number of frames read and not released
+  bool m_notified;                //!< whether frames were notified and not acquired yet
+  bool m_isSocket;                //!< whether recvmmsg () can be used on the file descriptor
+  Callback<void> m_notify;        //!< the notification callback
+  std::unique_ptr<FdNetDeviceMmsgVectors> m_mmsg; //!< message headers for recvmmsg ()
+};
+
 class Node;
 
 /**
@@ -274,6 +356,34 @@ private:
    */
   void ForwardUp (void);
 
+  /**
+   * Forward a received frame to the appropriate callback for processing
+   * \param packet the frame
+   */
+  void DoForwardUp (Ptr<Packet> packet);
+
+  /**
+   * Schedule the processing of the frames of the batch reader.  Invoked
+   * in the read thread.
+   */
+  void NotifyFramesReady (void);
+
+  /**
+   * Forward all the frames of the batch reader
+   */
+  void ForwardUpBatch (void);
+
+  /**
+   * Store a frame to be written with the next batch
+   * \param packet the frame
+   */
+  void EnqueueFrame (Ptr<Packet> packet);
+
+  /**
+   * Write the stored frames to the file descriptor
+   */
+  void FlushFrames (void);
+
   /**
    * Start Sending a Packet Down the Wire.
    * @param p packet to send
@@ -356,6 +466,51 @@ private:
    */
   uint32_t m_maxPendingReads;
 
+  /**
+   * Maximum number of frames read or written at once (1 if not batched).
+   */
+  uint32_t m_batchSize;
+
+  /**
+   * Flag indicating whether frames are read and written in batches.
+   */
+  bool m_batchMode;
+
+  /**
+   * Frames waiting to be written, each stored after room for a PI header.
+   */
+  std::vector<uint8_t> m_txFrames;
+
+  /**
+   * Size of a buffer of m_txFrames.
+   */
+  uint32_t m_txFrameSize;
+
+  /**
+   * Length of the frames waiting to be written, PI header included.
+   */
+  std::vector<size_t> m_txLengths;
+
+  /**
+   * Frames waiting to be written, for the drop trace.
+   */
+  std::vector<Ptr<Packet> > m_txPackets;
+
+  /**
+   * Flag indicating whether sendmmsg () can be used on the file descriptor.
+   */
+  bool m_txIsSocket;
+
+  /**
+   * Event writing the frames waiting to be written.
+   */
+  EventId m_txFlushEvent;
+
+  /**
+   * Message headers for sendmmsg ().
+   */
+  std::unique_ptr<FdNetDeviceMmsgVectors> m_txMmsg;
+
   /**
    * Time to start spinning up the device
    */
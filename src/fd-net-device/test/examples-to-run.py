@@ -14,6 +14,7 @@ cpp_examples = [
     ("fd-emu-udp-echo", "False", "True"),
     ("realtime-dummy-network", "False", "True"),
     ("fd2fd-onoff", "True", "True"),
+    ("fd2fd-onoff --batchSize=32", "True", "True"),
     ("fd-tap-ping", "False", "True"),
     ("realtime-fd2fd-onoff", "False", "True"),
 ]
@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/mac48-address.h"
+#include "ns3/fd-net-device.h"
+
+#include <sys/socket.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup fd-net-device
+ * \defgroup fd-net-device-test FdNetDevice module tests
+ */
+
+/**
+ * \ingroup fd-net-device-test
+ * \ingroup tests
+ *
+ * \brief Test case checking that two FdNetDevices connected by a socket
+ * pair exchange frames, in order and unchanged, with a given batch size.
+ */
+class FdNetDeviceBatchTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param batchSize the BatchSize attribute of the devices
+   */
+  FdNetDeviceBatchTestCase (uint32_t batchSize);
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Send the frames, all at the same time.
+   * \param device the sending device
+   * \param to the address of the receiving device
+   */
+  void SendFrames (Ptr<NetDevice> device, Address to);
+
+  /**
+   * Receive a frame.
+   * \param device the receiving device
+   * \param packet the frame payload
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  /**
+   * \param i the index of a frame
+   * \return the size of the payload of the frame
+   */
+  static uint32_t GetFrameSize (uint32_t i);
+
+  uint32_t m_batchSize; //!< the BatchSize attribute of the devices
+  uint32_t m_received;  //!< number of frames received
+};
+
+/// Number of frames sent
+static const uint32_t N_FRAMES = 50;
+
+FdNetDeviceBatchTestCase::FdNetDeviceBatchTestCase (uint32_t batchSize)
+  : TestCase ("Exchange frames through a socket pair with BatchSize=" + std::to_string (batchSize)),
+    m_batchSize (batchSize),
+    m_received (0)
+{
+}
+
+void
+FdNetDeviceBatchTestCase::DoSetup (void)
+{
+  // the frames are read from the socket in a separate thread
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::RealtimeSimulatorImpl"));
+}
+
+void
+FdNetDeviceBatchTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+uint32_t
+FdNetDeviceBatchTestCase::GetFrameSize (uint32_t i)
+{
+  return 100 + (i * 137) % 1300;
+}
+
+void
+FdNetDeviceBatchTestCase::SendFrames (Ptr<NetDevice> device, Address to)
+{
+  for (uint32_t i = 0; i < N_FRAMES; i++)
+    {
+      std::vector<uint8_t> payload (GetFrameSize (i));
+      for (uint32_t j = 0; j < payload.size (); j++)
+        {
+          payload[j] = static_cast<uint8_t> (i + j);
+        }
+      Ptr<Packet> p = Create<Packet> (payload.data (), payload.size ());
+      NS_TEST_EXPECT_MSG_EQ (device->Send (p, to, 0x0800), true, "frame " << i << " not sent");
+    }
+}
+
+bool
+FdNetDeviceBatchTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  uint32_t i = m_received++;
+  NS_TEST_EXPECT_MSG_EQ (protocol, 0x0800, "wrong protocol of frame " << i);
+  NS_TEST_EXPECT_MSG_EQ (packet->GetSize (), GetFrameSize (i), "wrong size of frame " << i);
+  std::vector<uint8_t> payload (packet->GetSize ());
+  packet->CopyData (payload.data (), payload.size ());
+  bool same = true;
+  for (uint32_t j = 0; j < payload.size (); j++)
+    {
+      same = same && (payload[j] == static_cast<uint8_t> (i + j));
+    }
+  NS_TEST_EXPECT_MSG_EQ (same, true, "wrong payload of frame " << i);
+  if (m_received == N_FRAMES)
+    {
+      Simulator::Stop ();
+    }
+  return true;
+}
+
+void
+FdNetDeviceBatchTestCase::DoRun (void)
+{
+  int sv[2];
+  NS_TEST_ASSERT_MSG_EQ (socketpair (AF_UNIX, SOCK_DGRAM, 0, sv), 0, "socketpair failed");
+  // room for all the frames sent at once
+  int size = 1 << 20;
+  setsockopt (sv[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof (size));
+  setsockopt (sv[1], SOL_SOCKET, SO_RCVBUF, &size, sizeof (size));
+
+  Ptr<FdNetDevice> devices[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<Node> node = CreateObject<Node> ();
+      devices[i] = CreateObject<FdNetDevice> ();
+      devices[i]->SetAttribute ("BatchSize", UintegerValue (m_batchSize));
+      devices[i]->SetAddress (Mac48Address::Allocate ());
+      devices[i]->SetFileDescriptor (sv[i]);
+      node->AddDevice (devices[i]);
+    }
+  devices[1]->SetReceiveCallback (MakeCallback (&FdNetDeviceBatchTestCase::Receive, this));
+
+  Simulator::Schedule (Seconds (0.1), &FdNetDeviceBatchTestCase::SendFrames, this,
+                       devices[0], devices[1]->GetAddress ());
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, N_FRAMES, "wrong number of frames received");
+}
+
+/**
+ * \ingroup fd-net-device-test
+ * \ingroup tests
+ *
+ * \brief FdNetDevice batched I/O test suite
+ */
+class FdNetDeviceBatchTestSuite : public TestSuite
+{
+public:
+  FdNetDeviceBatchTestSuite ();
+};
+
+FdNetDeviceBatchTestSuite::FdNetDeviceBatchTestSuite ()
+  : TestSuite ("fd-net-device-batch", UNIT)
+{
+  AddTestCase (new FdNetDeviceBatchTestCase (1), TestCase::QUICK);
+  AddTestCase (new FdNetDeviceBatchTestCase (8), TestCase::QUICK);
+  AddTestCase (new FdNetDeviceBatchTestCase (64), TestCase::QUICK);
+}
+
+static FdNetDeviceBatchTestSuite g_fdNetDeviceBatchTestSuite; ///< the test suite
@@ -153,6 +153,13 @@ TcpSocketBase::GetTypeId (void)
                    MakeEnumChecker (TcpSocketState::Off, "Off",
                                     TcpSocketState::On, "On",
                                     TcpSocketState::AcceptOnly, "AcceptOnly"))
+    .AddAttribute ("UseTimerWheel",
+                   "Run the retransmission and delayed ACK timers on the "
+                   "TimerWheel of the node instead of scheduling one "
+                   "simulator event per restart",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_useTimerWheel),
+                   MakeBooleanChecker ())
     .AddTraceSource ("RTO",
                      "Retransmission timeout",
                      MakeTraceSourceAccessor (&TcpSocketBase::m_rto),
@@ -309,6 +316,7 @@ TcpSocketBase::TcpSocketBase (void)
 TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
   : TcpSocket (sock),
     //copy object::m_tid and socket::callbacks
+    m_useTimerWheel (sock.m_useTimerWheel),
     m_dupAckCount (sock.m_dupAckCount),
     m_delAckCount (0),
     m_delAckMaxCount (sock.m_delAckMaxCount),
@@ -467,6 +475,39 @@ TcpSocketBase::~TcpSocketBase (void)
     }
   m_tcp = 0;
   CancelAllTimers ();
+  if (m_retxTimer != TimerWheel::INVALID_TIMER)
+    {
+      m_timerWheel->Release (m_retxTimer);
+    }
+  if (m_delAckTimer != TimerWheel::INVALID_TIMER)
+    {
+      m_timerWheel->Release (m_delAckTimer);
+    }
+}
+
+void
+TcpSocketBase::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_timerWheel != nullptr)
+    {
+      if (m_retxTimer != TimerWheel::INVALID_TIMER)
+        {
+          m_timerWheel->Release (m_retxTimer);
+          m_retxTimer = TimerWheel::INVALID_TIMER;
+        }
+      if (m_delAckTimer != TimerWheel::INVALID_TIMER)
+        {
+          m_timerWheel->Release (m_delAckTimer);
+          m_delAckTimer = TimerWheel::INVALID_TIMER;
+        }
+      if (m_ownTimerWheel)
+        {
+          m_timerWheel->Dispose ();
+        }
+      m_timerWheel = nullptr;
+    }
+  TcpSocket::DoDispose ();
 }
 
 /* Associate a node with this TCP socket */
@@ -1375,8 +1416,8 @@ TcpSocketBase::DoForwardUp (Ptr<Packet> packet, const Address &fromAddress,
     { // Zero window: Enter persist state to send 1 byte to probe
       NS_LOG_LOGIC (this << " Enter zerowindow persist state");
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + GetRetxDelayLeft ()).GetSeconds ());
+      CancelRetxTimer ();
       NS_LOG_LOGIC ("Schedule persist timeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_persistTimeout).GetSeconds ());
@@ -2223,7 +2264,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       m_tcb->m_congState = TcpSocketState::CA_OPEN;
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      CancelRetxTimer ();
       m_delAckCount = m_delAckMaxCount;
       ReceivedData (packet, tcpHeader);
       Simulator::ScheduleNow (&TcpSocketBase::ConnectionSucceeded, this);
@@ -2262,7 +2303,7 @@ TcpSocketBase::ProcessSynSent (Ptr<Packet> packet, const TcpHeader& tcpHeader)
       m_tcb->m_congState = TcpSocketState::CA_OPEN;
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      CancelRetxTimer ();
       m_tcb->m_rxBuffer->SetNextRxSequence (tcpHeader.GetSequenceNumber () + SequenceNumber32 (1));
       m_tcb->m_highTxMark = ++m_tcb->m_nextTxSequence;
       m_txBuffer->SetHeadSequence (m_tcb->m_nextTxSequence);
@@ -2323,7 +2364,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       m_tcb->m_congState = TcpSocketState::CA_OPEN;
       m_state = ESTABLISHED;
       m_connected = true;
-      m_retxEvent.Cancel ();
+      CancelRetxTimer ();
       m_tcb->m_highTxMark = ++m_tcb->m_nextTxSequence;
       m_txBuffer->SetHeadSequence (m_tcb->m_nextTxSequence);
       if (m_endPoint)
@@ -2373,7 +2414,7 @@ TcpSocketBase::ProcessSynRcvd (Ptr<Packet> packet, const TcpHeader& tcpHeader,
       if (tcpHeader.GetSequenceNumber () == m_tcb->m_rxBuffer->NextRxSequence ())
         { // In-sequence FIN before connection complete. Set up connection and close.
           m_connected = true;
-          m_retxEvent.Cancel ();
+          CancelRetxTimer ();
           m_tcb->m_highTxMark = ++m_tcb->m_nextTxSequence;
           m_txBuffer->SetHeadSequence (m_tcb->m_nextTxSequence);
           if (m_endPoint)
@@ -2641,7 +2682,7 @@ TcpSocketBase::Destroy (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + GetRetxDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2657,7 +2698,7 @@ TcpSocketBase::Destroy6 (void)
       m_tcp->RemoveSocket (this);
     }
   NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
+                (Simulator::Now () + GetRetxDelayLeft ()).GetSeconds ());
   CancelAllTimers ();
 }
 
@@ -2753,7 +2794,7 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
 
   if (flags & TcpHeader::ACK)
     { // If sending an ACK, cancel the delay ACK as well
-      m_delAckEvent.Cancel ();
+      CancelDelAckTimer ();
       m_delAckCount = 0;
       if (m_highTxAck < header.GetAckNumber ())
         {
@@ -2780,7 +2821,7 @@ TcpSocketBase::SendEmptyPacket (uint8_t flags)
     }
 
 
-  if (m_retxEvent.IsExpired () && (hasSyn || hasFin) && !isAck )
+  if (!IsRetxTimerRunning () && (hasSyn || hasFin) && !isAck )
     { // Retransmit SYN / SYN+ACK / FIN / FIN+ACK to guard against lost
       NS_LOG_LOGIC ("Schedule retransmission timeout at time "
                     << Simulator::Now ().GetSeconds () << " to expire at time "
@@ -3075,7 +3116,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   if (withAck)
     {
-      m_delAckEvent.Cancel ();
+      CancelDelAckTimer ();
       m_delAckCount = 0;
     }
 
@@ -3121,14 +3162,14 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
   header.SetWindowSize (AdvertisedWindowSize ());
   AddOptions (header);
 
-  if (m_retxEvent.IsExpired ())
+  if (!IsRetxTimerRunning ())
     {
       // Schedules retransmit timeout. m_rto should be already doubled.
 
       NS_LOG_LOGIC (this << " SendDataPacket Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds () );
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      ScheduleRetxTimeout ();
     }
 
   m_txTrace (p, header, this);
@@ -3491,7 +3532,7 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
     { // In-sequence packet: ACK if delayed ack count allows
       if (++m_delAckCount >= m_delAckMaxCount)
         {
-          m_delAckEvent.Cancel ();
+          CancelDelAckTimer ();
           m_delAckCount = 0;
           m_congestionControl->CwndEvent (m_tcb, TcpSocketState::CA_EVENT_NON_DELAYED_ACK);
           if (m_tcb->m_ecnState == TcpSocketState::ECN_CE_RCVD || m_tcb->m_ecnState == TcpSocketState::ECN_SENDING_ECE)
@@ -3506,17 +3547,16 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
               SendEmptyPacket (TcpHeader::ACK);
             }
         }
-      else if (!m_delAckEvent.IsExpired ())
+      else if (IsDelAckTimerRunning ())
         {
           m_congestionControl->CwndEvent (m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
         }
-      else if (m_delAckEvent.IsExpired ())
+      else
         {
           m_congestionControl->CwndEvent (m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
-          m_delAckEvent = Simulator::Schedule (m_delAckTimeout,
-                                               &TcpSocketBase::DelAckTimeout, this);
+          ScheduleDelAckTimeout ();
           NS_LOG_LOGIC (this << " scheduled delayed ACK at " <<
-                        (Simulator::Now () + Simulator::GetDelayLeft (m_delAckEvent)).GetSeconds ());
+                        (Simulator::Now () + m_delAckTimeout).GetSeconds ());
         }
     }
 }
@@ -3589,8 +3629,8 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_state != SYN_RCVD && resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + GetRetxDelayLeft ()).GetSeconds ());
+      CancelRetxTimer ();
       // On receiving a "New" ack we restart retransmission timer .. RFC 6298
       // RFC 6298, clause 2.4
       m_rto = Max (m_rtt->GetEstimate () + Max (m_clockGranularity, m_rtt->GetVariation () * 4), m_minRto);
@@ -3598,7 +3638,7 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
       NS_LOG_LOGIC (this << " Schedule ReTxTimeout at time " <<
                     Simulator::Now ().GetSeconds () << " to expire at time " <<
                     (Simulator::Now () + m_rto.Get ()).GetSeconds ());
-      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      ScheduleRetxTimeout ();
     }
 
   // Note the highest ACK and tell app to send more
@@ -3616,8 +3656,8 @@ TcpSocketBase::NewAck (SequenceNumber32 const& ack, bool resetRTO)
   if (m_txBuffer->Size () == 0 && m_state != FIN_WAIT_1 && m_state != CLOSING)
     { // No retransmit timer if no data to retransmit
       NS_LOG_LOGIC (this << " Cancelled ReTxTimeout event which was set to expire at " <<
-                    (Simulator::Now () + Simulator::GetDelayLeft (m_retxEvent)).GetSeconds ());
-      m_retxEvent.Cancel ();
+                    (Simulator::Now () + GetRetxDelayLeft ()).GetSeconds ());
+      CancelRetxTimer ();
     }
 }
 
@@ -3880,12 +3920,103 @@ TcpSocketBase::DoRetransmit ()
   NS_ASSERT (sz > 0);
 }
 
+bool
+TcpSocketBase::IsRetxTimerRunning (void) const
+{
+  return m_retxEvent.IsRunning ()
+         || (m_retxTimer != TimerWheel::INVALID_TIMER && m_timerWheel->IsRunning (m_retxTimer));
+}
+
+Time
+TcpSocketBase::GetRetxDelayLeft (void) const
+{
+  if (m_retxEvent.IsRunning ())
+    {
+      return Simulator::GetDelayLeft (m_retxEvent);
+    }
+  if (m_retxTimer != TimerWheel::INVALID_TIMER)
+    {
+      return m_timerWheel->GetDelayLeft (m_retxTimer);
+    }
+  return Time ();
+}
+
 void
-TcpSocketBase::CancelAllTimers ()
+TcpSocketBase::ScheduleRetxTimeout (void)
+{
+  if (!m_useTimerWheel)
+    {
+      m_retxEvent = Simulator::Schedule (m_rto, &TcpSocketBase::ReTxTimeout, this);
+      return;
+    }
+  if (m_retxTimer == TimerWheel::INVALID_TIMER)
+    {
+      m_retxTimer = GetTimerWheel ()->Create (MakeCallback (&TcpSocketBase::ReTxTimeout, this));
+    }
+  m_timerWheel->Schedule (m_retxTimer, m_rto);
+}
+
+void
+TcpSocketBase::CancelRetxTimer (void)
 {
   m_retxEvent.Cancel ();
-  m_persistEvent.Cancel ();
+  if (m_retxTimer != TimerWheel::INVALID_TIMER)
+    {
+      m_timerWheel->Cancel (m_retxTimer);
+    }
+}
+
+bool
+TcpSocketBase::IsDelAckTimerRunning (void) const
+{
+  return m_delAckEvent.IsRunning ()
+         || (m_delAckTimer != TimerWheel::INVALID_TIMER && m_timerWheel->IsRunning (m_delAckTimer));
+}
+
+void
+TcpSocketBase::ScheduleDelAckTimeout (void)
+{
+  if (!m_useTimerWheel)
+    {
+      m_delAckEvent = Simulator::Schedule (m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
+      return;
+    }
+  if (m_delAckTimer == TimerWheel::INVALID_TIMER)
+    {
+      m_delAckTimer = GetTimerWheel ()->Create (MakeCallback (&TcpSocketBase::DelAckTimeout, this));
+    }
+  m_timerWheel->Schedule (m_delAckTimer, m_delAckTimeout);
+}
+
+void
+TcpSocketBase::CancelDelAckTimer (void)
+{
   m_delAckEvent.Cancel ();
+  if (m_delAckTimer != TimerWheel::INVALID_TIMER)
+    {
+      m_timerWheel->Cancel (m_delAckTimer);
+    }
+}
+
+Ptr<TimerWheel>
+TcpSocketBase::GetTimerWheel (void)
+{
+  if (m_timerWheel == nullptr)
+    {
+      // Sockets created without a node (e.g., in unit tests) use their own wheel
+      m_ownTimerWheel = (m_node == nullptr);
+      m_timerWheel = m_node != nullptr ? TimerWheel::GetOrCreate (m_node)
+                                       : CreateObject<TimerWheel> ();
+    }
+  return m_timerWheel;
+}
+
+void
+TcpSocketBase::CancelAllTimers ()
+{
+  CancelRetxTimer ();
+  m_persistEvent.Cancel ();
+  CancelDelAckTimer ();
   m_lastAckEvent.Cancel ();
   m_timewaitEvent.Cancel ();
   m_sendPendingDataEvent.Cancel ();
@@ -28,6 +28,7 @@
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/sequence-number.h"
 #include "ns3/data-rate.h"
 #include "ns3/node.h"
@@ -605,6 +606,8 @@ public:
                                          const Ptr<const TcpSocketBase> socket);
 
 protected:
+  virtual void DoDispose (void);
+
   // Implementing ns3::TcpSocket -- Attribute get/set
   // inherited, no need to doc
 
@@ -855,6 +858,53 @@ protected:
    */
   void CancelAllTimers (void);
 
+  /**
+   * \brief Check whether the retransmission timer is running
+   * \return true if the retransmission timer is running
+   */
+  bool IsRetxTimerRunning (void) const;
+
+  /**
+   * \brief Get the time left before the retransmission timer expires
+   * \return the time left, or zero if the timer is not running
+   */
+  Time GetRetxDelayLeft (void) const;
+
+  /**
+   * \brief Start the retransmission timer to expire after m_rto
+   *
+   * The timer runs on the node TimerWheel if UseTimerWheel is set, and as
+   * a simulator event otherwise.
+   */
+  void ScheduleRetxTimeout (void);
+
+  /**
+   * \brief Stop the retransmission timer
+   */
+  void CancelRetxTimer (void);
+
+  /**
+   * \brief Check whether the delayed ACK timer is running
+   * \return true if the delayed ACK timer is running
+   */
+  bool IsDelAckTimerRunning (void) const;
+
+  /**
+   * \brief Start the delayed ACK timer to expire after m_delAckTimeout
+   */
+  void ScheduleDelAckTimeout (void);
+
+  /**
+   * \brief Stop the delayed ACK timer
+   */
+  void CancelDelAckTimer (void);
+
+  /**
+   * \brief Get the TimerWheel of the node, creating it if needed
+   * \return the TimerWheel used by this socket
+   */
+  Ptr<TimerWheel> GetTimerWheel (void);
+
   /**
    * \brief Move from CLOSING or FIN_WAIT_2 to TIME_WAIT state
    */
@@ -1249,6 +1299,13 @@ protected:
   EventId           m_persistEvent  {}; //!< Persist event: Send 1 byte to probe for a non-zero Rx window
   EventId           m_timewaitEvent {}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
 
+  // Timers run on the node TimerWheel, if enabled
+  bool                  m_useTimerWheel {false}; //!< Run the data retransmission and delayed ACK timers on a TimerWheel
+  Ptr<TimerWheel>       m_timerWheel    {nullptr}; //!< The TimerWheel of the node
+  bool                  m_ownTimerWheel {false};   //!< Whether m_timerWheel was created for this socket only
+  TimerWheel::TimerId   m_retxTimer     {TimerWheel::INVALID_TIMER}; //!< Data retransmission timer on the TimerWheel
+  TimerWheel::TimerId   m_delAckTimer   {TimerWheel::INVALID_TIMER}; //!< Delayed ACK timer on the TimerWheel
+
   // ACK management
   uint32_t          m_dupAckCount {0};     //!< Dupack counter
   uint32_t          m_delAckCount {0};     //!< Delayed ACK counter
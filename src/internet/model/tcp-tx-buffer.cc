@@ -173,7 +173,9 @@ TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
 
   // if you change the head with data already sent, something bad will happen
   NS_ASSERT (m_sentList.size () == 0);
-  m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_highestSack = SequenceNumber32 (0);
+  m_highestSackValid = false;
+  ResetScoreboardMarks ();
 }
 
 bool
@@ -310,13 +312,13 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
   NS_ASSERT (numBytes <= m_sentSize);
   NS_ASSERT (m_sentList.size () >= 1);
 
-  auto it = m_sentList.begin ();
+  auto it = FindSentItem (seq);
   bool listEdited = false;
   uint32_t s = numBytes;
 
   // Avoid to merge different packet for this retransmission if flags are
   // different.
-  for (; it != m_sentList.end(); ++it)
+  if (it != m_sentList.end ())
     {
       if ((*it)->m_startSeq == seq)
         {
@@ -339,7 +341,6 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
             {
               s = std::min(s, (*it)->m_packet->GetSize ());
             }
-          break;
         }
     }
 
@@ -437,11 +438,23 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
   PacketList::iterator it = list.begin ();
   SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+  if (&list == &m_sentList && seq > listStartFrom)
+    {
+      // Items of the sent list know their sequence number: jump to the
+      // last item starting at or before seq
+      it = std::upper_bound (list.begin (), list.end (), seq,
+                             [] (const SequenceNumber32 &s, const TcpTxItem *item)
+                             { return s < item->m_startSeq; });
+      NS_ASSERT (it != list.begin ());
+      --it;
+      beginOfCurrentPacket = (*it)->m_startSeq;
+    }
+
   while (it != list.end ())
     {
       currentItem = *it;
       currentPacket = currentItem->m_packet;
-      NS_ASSERT_MSG (list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+      NS_ASSERT_MSG (&list != &m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
                      "start: " << m_firstByteSeq << " currentItem start: " <<
                      currentItem->m_startSeq);
 
@@ -604,6 +617,7 @@ TcpTxBuffer::MergeItems (TcpTxItem *t1, TcpTxItem *t2) const
           TcpTxBuffer *self = const_cast<TcpTxBuffer*> (this);
           self->m_retrans -= t1->m_packet->GetSize ();
           t1->m_retrans = false;
+          m_retransUpTo = std::min (m_retransUpTo, t1->m_startSeq);
         }
       else
         {
@@ -611,6 +625,7 @@ TcpTxBuffer::MergeItems (TcpTxItem *t1, TcpTxItem *t2) const
           TcpTxBuffer *self = const_cast<TcpTxBuffer*> (this);
           self->m_retrans -= t2->m_packet->GetSize ();
           t2->m_retrans = false;
+          m_retransUpTo = std::min (m_retransUpTo, t1->m_startSeq);
         }
     }
 
@@ -650,16 +665,15 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked (const SequenceNumber32& ack) const
 {
   NS_LOG_FUNCTION (this);
-  for (const auto &it : m_sentList)
-     {
-       TcpTxItem *item = it;
-       Ptr<Packet> p = item->m_packet;
-       if (item->m_startSeq + p->GetSize () == ack && !item->m_sacked && item->m_retrans)
-         {
-           return true;
-         }
-     }
-  return false;
+  // The only candidate is the item just before the one starting at ack
+  auto it = FindSentItem (ack);
+  if (it == m_sentList.begin ())
+    {
+      return false;
+    }
+  const TcpTxItem *item = *(--it);
+  return item->m_startSeq + item->m_packet->GetSize () == ack
+         && !item->m_sacked && item->m_retrans;
 }
 
 void
@@ -757,6 +771,7 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
           // when adding Reno dupacks in the count.
           head->m_sacked = false;
           m_sackedOut -= head->m_packet->GetSize ();
+          ResetScoreboardMarks ();
           NS_LOG_INFO ("Moving the SACK flag from the HEAD to another segment");
           AddRenoSack ();
           MarkHeadAsLost ();
@@ -767,10 +782,13 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
                      m_firstByteSeq << " this is the result: " << *this);
     }
 
-  if (m_highestSack.second <= m_firstByteSeq)
+  if (m_highestSack <= m_firstByteSeq)
     {
-      m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+      m_highestSack = SequenceNumber32 (0);
+      m_highestSackValid = false;
     }
+  m_lostUpTo = std::max (m_lostUpTo, m_firstByteSeq.Get ());
+  m_retransUpTo = std::max (m_retransUpTo, m_firstByteSeq.Get ());
 
   NS_LOG_DEBUG ("Discarded up to " << seq << " lost: " << m_lostOut <<
                 " retrans: " << m_retrans << " sacked: " << m_sackedOut);
@@ -791,18 +809,19 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
 
   for (auto option_it = list.begin (); option_it != list.end (); ++option_it)
     {
-      PacketList::iterator item_it = m_sentList.begin ();
-      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
       if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
           NS_LOG_INFO ("Not updating scoreboard, the option block is outside the sent list");
           return bytesSacked;
         }
 
+      // Items starting before the block cannot be covered by it
+      PacketList::const_iterator item_it = FindSentItem ((*option_it).first);
+
       while (item_it != m_sentList.end ())
         {
           uint32_t pktSize = (*item_it)->m_packet->GetSize ();
+          SequenceNumber32 beginOfCurrentPacket = (*item_it)->m_startSeq;
 
           // Check the boundary of this packet ... only mark as sacked if
           // it is precisely mapped over the option. It means that if the receiver
@@ -831,16 +850,17 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
                   m_sackedOut += (*item_it)->m_packet->GetSize ();
                   bytesSacked += (*item_it)->m_packet->GetSize ();
 
-                  if (m_highestSack.first == m_sentList.end()
-                      || m_highestSack.second <= beginOfCurrentPacket + pktSize)
+                  if (!m_highestSackValid
+                      || m_highestSack <= beginOfCurrentPacket + pktSize)
                     {
-                      m_highestSack = std::make_pair (item_it, beginOfCurrentPacket);
+                      m_highestSack = beginOfCurrentPacket;
+                      m_highestSackValid = true;
                     }
 
                   NS_LOG_INFO ("Received block " << *option_it <<
                                ", checking sentList for block " << *(*item_it) <<
                                ", found in the sackboard, sacking, current highSack: " <<
-                               m_highestSack.second);
+                               m_highestSack);
 
                   if (!sackedCb.IsNull ())
                     {
@@ -857,14 +877,13 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
               break;
             }
 
-          beginOfCurrentPacket += pktSize;
           ++item_it;
         }
     }
 
   if (bytesSacked > 0)
     {
-      NS_ASSERT_MSG (m_highestSack.first != m_sentList.end(), "Buffer status: " << *this);
+      NS_ASSERT_MSG (m_highestSackValid, "Buffer status: " << *this);
       UpdateLostCount ();
     }
 
@@ -880,20 +899,17 @@ void
 TcpTxBuffer::UpdateLostCount ()
 {
   NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_highestSackValid);
+  auto highestSacked = FindSentItem (m_highestSack);
+  NS_ASSERT (highestSacked != m_sentList.end () && (*highestSacked)->m_startSeq == m_highestSack);
+  NS_LOG_INFO ("Status before the update: " << *this <<
+               ", will start from item " << *(*highestSacked));
+
   uint32_t sacked = 0;
-  SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
-  if (m_highestSack.first == m_sentList.end ())
-    {
-      NS_LOG_INFO ("Status before the update: " << *this <<
-                   ", will start from the latest sent item");
-    }
-  else
-    {
-      NS_LOG_INFO ("Status before the update: " << *this <<
-                   ", will start from item " << *(*m_highestSack.first));
-    }
+  bool thresholdReached = false;
+  SequenceNumber32 thresholdSeq;
 
-  for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+  for (auto it = highestSacked; it != m_sentList.begin(); --it)
     {
       TcpTxItem *item = *it;
       if (item->m_sacked)
@@ -903,13 +919,22 @@ TcpTxBuffer::UpdateLostCount ()
 
       if (sacked >= m_dupAckThresh)
         {
+          if (!thresholdReached)
+            {
+              thresholdReached = true;
+              thresholdSeq = item->m_startSeq;
+            }
+          if (item->m_startSeq < m_lostUpTo)
+            {
+              // The items below have been marked by a previous update
+              break;
+            }
           if (!item->m_sacked && !item->m_lost)
             {
               item->m_lost = true;
               m_lostOut += item->m_packet->GetSize ();
             }
         }
-      beginOfCurrentPacket -= item->m_packet->GetSize ();
     }
 
   if (sacked >= m_dupAckThresh)
@@ -920,6 +945,10 @@ TcpTxBuffer::UpdateLostCount ()
           item->m_lost = true;
           m_lostOut += item->m_packet->GetSize ();
         }
+      if (thresholdReached)
+        {
+          m_lostUpTo = std::max (m_lostUpTo, thresholdSeq);
+        }
     }
   NS_LOG_INFO ("Status after the update: " << *this);
   ConsistencyCheck ();
@@ -930,35 +959,24 @@ TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
 {
   NS_LOG_FUNCTION (this << seq);
 
-  SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-  PacketList::const_iterator it;
-
-  if (seq >= m_highestSack.second)
+  if (seq >= m_highestSack)
     {
       return false;
     }
 
-  // In theory, using a map and hints when inserting elements can improve
-  // performance
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  for (auto it = FindSentItem (seq); it != m_sentList.end (); ++it)
     {
-      // Search for the right iterator before calling IsLost()
-      if (beginOfCurrentPacket >= seq)
+      if ((*it)->m_lost == true)
         {
-          if ((*it)->m_lost == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
-              return true;
-            }
-
-          if ((*it)->m_sacked == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
-              return false;
-            }
+          NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
+          return true;
         }
 
-      beginOfCurrentPacket += (*it)->m_packet->GetSize ();
+      if ((*it)->m_sacked == true)
+        {
+          NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
+          return false;
+        }
     }
 
   return false;
@@ -986,15 +1004,23 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, SequenceNumber32 *seqHigh, bool isR
   TcpTxItem *item;
   SequenceNumber32 seqPerRule3;
   bool isSeqPerRule3Valid = false;
-  SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+  bool isFirstCandidate = true;
 
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // Items before m_retransUpTo are SACKed or retransmitted already
+  for (it = FindSentItem (m_retransUpTo); it != m_sentList.end (); ++it)
     {
       item = *it;
+      SequenceNumber32 beginOfCurrentPkt = item->m_startSeq;
 
       // Condition 1.a , 1.b , and 1.c
       if (item->m_retrans == false && item->m_sacked == false)
         {
+          if (isFirstCandidate)
+            {
+              m_retransUpTo = beginOfCurrentPkt;
+              isFirstCandidate = false;
+            }
+
           if (item->m_lost)
             {
               NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
@@ -1009,9 +1035,11 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, SequenceNumber32 *seqHigh, bool isR
               seqPerRule3 = beginOfCurrentPkt;
             }
         }
+    }
 
-      // Nothing found, iterate
-      beginOfCurrentPkt += item->m_packet->GetSize ();
+  if (isFirstCandidate)
+    {
+      m_retransUpTo = m_firstByteSeq + m_sentSize;
     }
 
   /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1195,7 +1223,7 @@ TcpTxBuffer::IsLostRFC (const SequenceNumber32 &seq, const PacketList::const_ite
             }
         }
 
-      if (beginOfCurrentPacket >= m_highestSack.second)
+      if (beginOfCurrentPacket >= m_highestSack)
         {
           if (item->m_lost && !item->m_retrans)
             return true;
@@ -1206,9 +1234,9 @@ TcpTxBuffer::IsLostRFC (const SequenceNumber32 &seq, const PacketList::const_ite
 
       beginOfCurrentPacket += current->GetSize ();
     }
-  if (it == m_highestSack.first)
+  if (it == m_sentList.end ())
     {
-      NS_LOG_INFO ("seq=" << seq << " is not lost because there are no sacked segment ahead " << m_highestSack.second);
+      NS_LOG_INFO ("seq=" << seq << " is not lost because there are no sacked segment ahead " << m_highestSack);
     }
   return false;
 }
@@ -1224,7 +1252,9 @@ TcpTxBuffer::ResetRenoSack ()
       (*it)->m_sacked = false;
     }
 
-  m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_highestSack = SequenceNumber32 (0);
+  m_highestSackValid = false;
+  ResetScoreboardMarks ();
 }
 
 void
@@ -1253,7 +1283,9 @@ TcpTxBuffer::ResetSentList ()
   m_lostOut = 0;
   m_retrans = 0;
   m_sackedOut = 0;
-  m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_highestSack = SequenceNumber32 (0);
+  m_highestSackValid = false;
+  ResetScoreboardMarks ();
 }
 
 void
@@ -1270,6 +1302,8 @@ TcpTxBuffer::ResetLastSegmentSent ()
         {
           m_retrans -= item->m_packet->GetSize ();
         }
+      m_lostUpTo = std::min (m_lostUpTo, item->m_startSeq);
+      m_retransUpTo = std::min (m_retransUpTo, item->m_startSeq);
       m_appList.insert (m_appList.begin (), item);
     }
   ConsistencyCheck ();
@@ -1285,7 +1319,8 @@ TcpTxBuffer::SetSentListLost (bool resetSack)
     {
       m_sackedOut = 0;
       m_lostOut = m_sentSize;
-      m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+      m_highestSack = SequenceNumber32 (0);
+      m_highestSackValid = false;
     }
   else
     {
@@ -1316,6 +1351,7 @@ TcpTxBuffer::SetSentListLost (bool resetSack)
 
       (*it)->m_retrans = false;
     }
+  ResetScoreboardMarks ();
 
   NS_LOG_INFO ("Set sent list lost, status: " << *this);
   NS_ASSERT_MSG (m_sentSize >= m_sackedOut + m_lostOut, *this);
@@ -1349,6 +1385,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead ()
     {
       m_sentList.front ()->m_retrans = false;
       m_retrans -= m_sentList.front ()->m_packet->GetSize ();
+      ResetScoreboardMarks ();
     }
   ConsistencyCheck ();
 }
@@ -1365,12 +1402,14 @@ TcpTxBuffer::MarkHeadAsLost ()
         {
           m_sentList.front ()->m_sacked = false;
           m_sackedOut -= m_sentList.front ()->m_packet->GetSize ();
+          ResetScoreboardMarks ();
         }
 
       if (m_sentList.front ()->m_retrans)
         {
           m_sentList.front ()->m_retrans = false;
           m_retrans -= m_sentList.front ()->m_packet->GetSize ();
+          ResetScoreboardMarks ();
         }
 
       if (! m_sentList.front()->m_lost)
@@ -1412,7 +1451,8 @@ TcpTxBuffer::AddRenoSack (void)
     {
       (*it)->m_sacked = true;
       m_sackedOut += (*it)->m_packet->GetSize ();
-      m_highestSack = std::make_pair (it, (*it)->m_startSeq);
+      m_highestSack = (*it)->m_startSeq;
+      m_highestSackValid = true;
       NS_LOG_INFO ("Added a Reno SACK, status: " << *this);
     }
   else
@@ -1424,6 +1464,21 @@ TcpTxBuffer::AddRenoSack (void)
   ConsistencyCheck ();
 }
 
+TcpTxBuffer::PacketList::const_iterator
+TcpTxBuffer::FindSentItem (const SequenceNumber32 &seq) const
+{
+  return std::lower_bound (m_sentList.begin (), m_sentList.end (), seq,
+                           [] (const TcpTxItem *item, const SequenceNumber32 &s)
+                           { return item->m_startSeq < s; });
+}
+
+void
+TcpTxBuffer::ResetScoreboardMarks ()
+{
+  m_lostUpTo = m_firstByteSeq;
+  m_retransUpTo = m_firstByteSeq;
+}
+
 void
 TcpTxBuffer::ConsistencyCheck () const
 {
@@ -28,6 +28,8 @@
 #include "ns3/tcp-option-sack.h"
 #include "ns3/tcp-tx-item.h"
 
+#include <deque>
+
 namespace ns3 {
 class Packet;
 
@@ -73,6 +75,14 @@ class Packet;
  * documentation) and maintaining the scoreboard is a matter of travelling the
  * list and set the SACK flag on the corresponding segment sent.
  *
+ * The items of the SentList are stored contiguously, ordered by their
+ * starting sequence number, so the item holding a given sequence number is
+ * found with a binary search. SACK blocks, IsLost() and the search of
+ * retransmitted data do not walk the list from SND.UNA. The buffer also
+ * remembers up to which sequence number every unSACKed item is already
+ * marked lost, or already retransmitted, so that UpdateLostCount() and
+ * NextSeg() do not visit the same items again at each call.
+ *
  * Item properties
  * ---------------
  *
@@ -410,7 +420,7 @@ public:
 private:
   friend std::ostream & operator<< (std::ostream & os, TcpTxBuffer const & tcpTxBuf);
 
-  typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+  typedef std::deque<TcpTxItem*> PacketList; //!< container for data stored in the buffer
 
   /**
    * \brief Update the lost count
@@ -427,12 +437,27 @@ private:
    * The {New}Reno cases, for now, are managed in TcpSocketBase through the
    * call to MarkHeadAsLost.
    * This function is, therefore, called after a SACK option has been received,
-   * and updates the lost count. It can be probably optimized by not walking
-   * the entire list, but a subset.
+   * and updates the lost count. The walk stops at m_lostUpTo, below which
+   * every item is already SACKed or marked lost.
    *
    */
   void UpdateLostCount ();
 
+  /**
+   * \brief Find the first sent item starting at or after a sequence number
+   * \param seq Sequence
+   * \return an iterator to the item, or the end of the SentList
+   */
+  PacketList::const_iterator FindSentItem (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Forget how far the SentList is known to be lost or retransmitted
+   *
+   * To be called each time a sent item loses its SACKed, lost, or
+   * retransmitted flag.
+   */
+  void ResetScoreboardMarks ();
+
   /**
    * \brief Remove the size specified from the lostOut, retrans, sacked count
    *
@@ -608,7 +633,10 @@ private:
   Callback<uint32_t> m_rWndCallback; //!< Callback to obtain RCV.WND value
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
-  std::pair <PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
+  SequenceNumber32 m_highestSack  {0};     //!< Start of the highest SACKed item
+  bool     m_highestSackValid {false};     //!< Indicates if an item is SACKed
+  SequenceNumber32 m_lostUpTo     {0};     //!< Every sent item starting before it is SACKed or lost
+  mutable SequenceNumber32 m_retransUpTo {0}; //!< Every sent item starting before it is SACKed or retransmitted
 
   uint32_t m_lostOut   {0}; //!< Number of lost bytes
   uint32_t m_sackedOut {0}; //!< Number of sacked bytes
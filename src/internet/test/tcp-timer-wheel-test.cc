@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-socket-base.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpSocketBase giving access to its delayed ACK timer.
+ */
+class TcpTimerWheelTestSocket : public TcpSocketBase
+{
+public:
+  TcpTimerWheelTestSocket ()
+  {
+    s_destroyed = false;
+  }
+  virtual ~TcpTimerWheelTestSocket ()
+  {
+    s_destroyed = true;
+  }
+
+  /// Start the delayed ACK timer
+  void StartDelAckTimer (void)
+  {
+    ScheduleDelAckTimeout ();
+  }
+  /// \return true if the delayed ACK timer is running
+  bool IsDelAckRunning (void) const
+  {
+    return IsDelAckTimerRunning ();
+  }
+
+  static bool s_destroyed; //!< Whether the last socket created was destroyed
+};
+
+bool TcpTimerWheelTestSocket::s_destroyed = false;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the timers of a socket without a node, which run on a
+ * TimerWheel of its own, do not fire once the socket is disposed or freed.
+ *
+ * NOTE: a timer firing on a freed socket is reported by valgrind.
+ */
+class TcpTimerWheelReleaseTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param dispose whether to dispose the socket before releasing it
+   */
+  TcpTimerWheelReleaseTestCase (bool dispose);
+
+private:
+  virtual void DoRun (void);
+
+  bool m_dispose; //!< Whether to dispose the socket before releasing it
+};
+
+TcpTimerWheelReleaseTestCase::TcpTimerWheelReleaseTestCase (bool dispose)
+  : TestCase (dispose ? "Dispose a node-less socket with a pending TimerWheel timer"
+                      : "Free a node-less socket with a pending TimerWheel timer"),
+    m_dispose (dispose)
+{
+}
+
+void
+TcpTimerWheelReleaseTestCase::DoRun (void)
+{
+  Ptr<TcpTimerWheelTestSocket> socket = CreateObject<TcpTimerWheelTestSocket> ();
+  socket->SetAttribute ("UseTimerWheel", BooleanValue (true));
+  socket->StartDelAckTimer ();
+  NS_TEST_ASSERT_MSG_EQ (socket->IsDelAckRunning (), true, "delayed ACK timer not started");
+
+  if (m_dispose)
+    {
+      socket->Dispose ();
+      NS_TEST_EXPECT_MSG_EQ (socket->IsDelAckRunning (), false, "delayed ACK timer still running");
+    }
+  socket = 0;
+  NS_TEST_ASSERT_MSG_EQ (TcpTimerWheelTestSocket::s_destroyed, true, "socket not freed");
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP TimerWheel test suite
+ */
+class TcpTimerWheelTestSuite : public TestSuite
+{
+public:
+  TcpTimerWheelTestSuite ();
+};
+
+TcpTimerWheelTestSuite::TcpTimerWheelTestSuite ()
+  : TestSuite ("tcp-timer-wheel", UNIT)
+{
+  AddTestCase (new TcpTimerWheelReleaseTestCase (false), TestCase::QUICK);
+  AddTestCase (new TcpTimerWheelReleaseTestCase (true), TestCase::QUICK);
+}
+
+static TcpTimerWheelTestSuite g_tcpTimerWheelTestSuite; //!< Static variable for test initialization
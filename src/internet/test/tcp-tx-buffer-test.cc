@@ -53,6 +53,8 @@ private:
   /** \brief Test the logic of merging items in GetTransmittedSegment()
    * which is triggered by CopyFromSequence()*/
   void TestMergeItemsWhenGetTransmittedSegment ();
+  /** \brief Test the scoreboard with many segments and SACK blocks */
+  void TestLargeScoreboard ();
   /**
    * \brief Callback to provide a value of receiver window
    * \returns the receiver window size
@@ -101,6 +103,14 @@ TcpTxBufferTestCase::DoRun ()
   Simulator::Schedule (Seconds (0.0),
                          &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment, this);
 
+  /*
+   * Case for a large window:
+   *  -> every other segment is SACKed, one block per ACK
+   *  -> lost segments are returned by NextSeg in order, once
+   */
+  Simulator::Schedule (Seconds (0.0),
+                       &TcpTxBufferTestCase::TestLargeScoreboard, this);
+
   Simulator::Run ();
   Simulator::Destroy ();
 }
@@ -385,6 +395,76 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment ()
   txBuf.CopyFromSequence (2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLargeScoreboard ()
+{
+  Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer> ();
+  txBuf->SetRWndCallback (MakeCallback (&TcpTxBufferTestCase::GetRWnd, this));
+  SequenceNumber32 head (1);
+  txBuf->SetHeadSequence (head);
+  txBuf->SetSegmentSize (1000);
+  txBuf->SetDupAckThresh (3);
+  txBuf->SetMaxBufferSize (2000 * 1000);
+  SequenceNumber32 ret;
+  SequenceNumber32 retHigh;
+  const uint32_t nSegments = 2000;
+
+  txBuf->Add (Create<Packet> (nSegments * 1000));
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      txBuf->CopyFromSequence (1000, head + (i * 1000));
+    }
+
+  // SACK the odd segments, one block per ACK
+  Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack> ();
+  uint32_t nSacked = 0;
+  for (uint32_t i = 1; i < nSegments; i += 2)
+    {
+      sack->ClearSackList ();
+      sack->AddSackBlock (TcpOptionSack::SackBlock (head + (i * 1000), head + ((i + 1) * 1000)));
+      NS_TEST_ASSERT_MSG_EQ (txBuf->Update (sack->GetSackList ()), 1000,
+                             "Each block SACKs one segment");
+      ++nSacked;
+      // The even segments below the third highest SACKed one are lost
+      uint32_t nLost = nSacked >= 3 ? nSacked - 2 : 0;
+      NS_TEST_ASSERT_MSG_EQ (txBuf->GetLost (), nLost * 1000, "Wrong lost count");
+      NS_TEST_ASSERT_MSG_EQ (txBuf->GetSacked (), nSacked * 1000, "Wrong sacked count");
+    }
+
+  // A duplicate block changes nothing
+  NS_TEST_ASSERT_MSG_EQ (txBuf->Update (sack->GetSackList ()), 0, "Block already SACKed");
+
+  uint32_t nLost = nSegments / 2 - 2;
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsLost (head), true, "The head is lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsLost (head + ((nLost - 1) * 2 * 1000)), true,
+                         "The highest lost segment is lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsLost (head + (nLost * 2 * 1000)), false,
+                         "Segment below only two SACKed segments is not lost");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 2000, "Wrong bytes in flight");
+
+  // Retransmit the lost segments; each is returned once, in order
+  for (uint32_t i = 0; i < nLost; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txBuf->NextSeg (&ret, &retHigh, false), true,
+                             "A lost segment should be returned");
+      NS_TEST_ASSERT_MSG_EQ (ret, head + (i * 2 * 1000), "Wrong lost segment returned");
+      txBuf->CopyFromSequence (1000, ret);
+      NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 2000 + (i + 1) * 1000,
+                             "Wrong bytes in flight after a retransmission");
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetRetransmitsCount (), nLost * 1000, "Wrong retransmitted count");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextSeg (&ret, &retHigh, true), true,
+                         "Rule 3 should return a segment in recovery");
+  NS_TEST_ASSERT_MSG_EQ (ret, head + (nLost * 2 * 1000), "Wrong segment returned by rule 3");
+
+  // The cumulative ACK of the retransmitted head
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsRetransmittedDataAcked (head + 1000), true,
+                         "The head was retransmitted");
+  txBuf->DiscardUpTo (head + 2000);
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLost (), (nLost - 1) * 1000, "Wrong lost count after ACK");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSacked (), (nSacked - 1) * 1000, "Wrong sacked count after ACK");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock ()
 {
@@ -27,6 +27,9 @@
 #include <ns3/pointer.h>
 #include <ns3/packet.h>
 #include <ns3/simulator.h>
+#include <ns3/global-value.h>
+#include <ns3/uinteger.h>
+#include <ns3/core-config.h>
 
 #include "lte-amc.h"
 #include "lte-control-messages.h"
@@ -41,6 +44,13 @@
 #include "ns3/lte-enb-cmac-sap.h"
 #include <ns3/lte-common.h>
 
+#include <functional>
+#ifdef HAVE_PTHREAD_H
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif /* HAVE_PTHREAD_H */
+
 
 namespace ns3 {
 
@@ -48,6 +58,178 @@ NS_LOG_COMPONENT_DEFINE ("LteEnbMac");
 
 NS_OBJECT_ENSURE_REGISTERED (LteEnbMac);
 
+/**
+ * \ingroup lte
+ * Number of threads running the FF MAC schedulers of the eNBs.
+ *
+ * With 0, the scheduler of each eNB MAC is run by the subframe
+ * indication of its PHY.  Otherwise, the DL and UL trigger requests of
+ * all the subframes indicated at the same time are deferred to the end
+ * of that time, and run in parallel by this number of threads; the
+ * scheduler indications are then processed on the simulation thread in
+ * the order of the subframe indications, so that the results do not
+ * depend on the number of threads.  The requests of the RRC and RLC
+ * received in the meantime are handled after the subframe is scheduled,
+ * as they are when the subframe indication runs the scheduler.
+ */
+static GlobalValue g_schedulerThreads ("LteEnbMacSchedulerThreads",
+                                       "Number of threads running the FF MAC schedulers of the eNBs "
+                                       "whose subframes start at the same time (0 to run each one in its "
+                                       "subframe indication)",
+                                       UintegerValue (0),
+                                       MakeUintegerChecker<uint32_t> ());
+
+namespace {
+
+/**
+ * Pool of threads running the jobs of RunParallelDlSchedulers and
+ * RunParallelUlSchedulers.  The threads are started when first needed,
+ * and never stopped.
+ */
+class SchedulerThreadPool
+{
+public:
+  /// \return the pool
+  static SchedulerThreadPool & Get (void);
+
+  /**
+   * Run jobs on the calling thread and on worker threads, and wait for
+   * them to complete.
+   * \param nThreads the number of threads, including the calling thread
+   * \param nJobs the number of jobs
+   * \param job the job, called with the index of each job
+   */
+  void Run (uint32_t nThreads, uint32_t nJobs, const std::function<void (uint32_t)> &job);
+
+private:
+  SchedulerThreadPool ();
+
+  /// Loop of the worker threads
+  void Work (void);
+
+#ifdef HAVE_PTHREAD_H
+  std::mutex m_mutex;                             //!< protects the members below
+  std::condition_variable m_jobsAdded;            //!< notified when jobs are added
+  std::condition_variable m_jobsDone;             //!< notified when the jobs are completed
+  const std::function<void (uint32_t)> *m_job;    //!< the job
+  uint32_t m_nJobs;                               //!< number of jobs
+  uint32_t m_nextJob;                             //!< index of the next job to run
+  uint32_t m_pendingJobs;                         //!< number of jobs not completed yet
+  uint32_t m_nWorkers;                            //!< number of worker threads started
+#endif /* HAVE_PTHREAD_H */
+};
+
+SchedulerThreadPool &
+SchedulerThreadPool::Get (void)
+{
+  // Never destroyed, since the worker threads are never stopped
+  static SchedulerThreadPool *pool = new SchedulerThreadPool ();
+  return *pool;
+}
+
+#ifdef HAVE_PTHREAD_H
+
+SchedulerThreadPool::SchedulerThreadPool ()
+  : m_job (0),
+    m_nJobs (0),
+    m_nextJob (0),
+    m_pendingJobs (0),
+    m_nWorkers (0)
+{
+}
+
+void
+SchedulerThreadPool::Run (uint32_t nThreads, uint32_t nJobs, const std::function<void (uint32_t)> &job)
+{
+  if (nThreads <= 1 || nJobs <= 1)
+    {
+      for (uint32_t i = 0; i < nJobs; i++)
+        {
+          job (i);
+        }
+      return;
+    }
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (m_nWorkers < nThreads - 1)
+    {
+      std::thread (&SchedulerThreadPool::Work, this).detach ();
+      m_nWorkers++;
+    }
+  m_job = &job;
+  m_nJobs = nJobs;
+  m_nextJob = 0;
+  m_pendingJobs = nJobs;
+  m_jobsAdded.notify_all ();
+  while (m_nextJob < m_nJobs)
+    {
+      uint32_t i = m_nextJob++;
+      lock.unlock ();
+      job (i);
+      lock.lock ();
+      m_pendingJobs--;
+    }
+  while (m_pendingJobs > 0)
+    {
+      m_jobsDone.wait (lock);
+    }
+  m_job = 0;
+  m_nJobs = 0;
+  m_nextJob = 0;
+}
+
+void
+SchedulerThreadPool::Work (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      while (m_nextJob >= m_nJobs)
+        {
+          m_jobsAdded.wait (lock);
+        }
+      uint32_t i = m_nextJob++;
+      const std::function<void (uint32_t)> *job = m_job;
+      lock.unlock ();
+      (*job) (i);
+      lock.lock ();
+      if (--m_pendingJobs == 0)
+        {
+          m_jobsDone.notify_all ();
+        }
+    }
+}
+
+#else /* HAVE_PTHREAD_H */
+
+SchedulerThreadPool::SchedulerThreadPool ()
+{
+}
+
+void
+SchedulerThreadPool::Run (uint32_t nThreads, uint32_t nJobs, const std::function<void (uint32_t)> &job)
+{
+  for (uint32_t i = 0; i < nJobs; i++)
+    {
+      job (i);
+    }
+}
+
+void
+SchedulerThreadPool::Work (void)
+{
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+/// eNB MAC whose subframe is scheduled in parallel, and context of its subframe indication
+typedef std::pair<Ptr<LteEnbMac>, uint32_t> ParallelSubframe;
+
+std::vector<ParallelSubframe> g_parallelDlSubframes; //!< subframes waiting for RunParallelDlSchedulers
+std::vector<ParallelSubframe> g_parallelUlSubframes; //!< subframes waiting for RunParallelUlSchedulers
+bool g_parallelSchedulingClearScheduled = false;     //!< whether ClearParallelScheduling is scheduled
+
+} // unnamed namespace
+
 
 
 // //////////////////////////////////////
@@ -380,6 +562,8 @@ LteEnbMac::GetTypeId (void)
 
 
 LteEnbMac::LteEnbMac ():
+m_deferSchedConfigInd (false),
+m_deferRequests (false),
 m_ccmMacSapUser (0)
 {
   NS_LOG_FUNCTION (this);
@@ -406,6 +590,11 @@ LteEnbMac::DoDispose ()
   m_ulCeReceived.clear ();
   m_dlInfoListReceived.clear ();
   m_ulInfoListReceived.clear ();
+  m_ulCqiInfoReqs.clear ();
+  m_ulCeInfoReqs.clear ();
+  m_deferredDlConfigInd.clear ();
+  m_deferredUlConfigInd.clear ();
+  m_deferredRequests.clear ();
   m_miDlHarqProcessesPackets.clear ();
   delete m_macSapProvider;
   delete m_cmacSapProvider;
@@ -574,22 +763,20 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     {
       dlSchedSubframeNo = dlSchedSubframeNo + m_macChTtiDelay;
     }
-  FfMacSchedSapProvider::SchedDlTriggerReqParameters dlparams;
-  dlparams.m_sfnSf = ((0x3FF & dlSchedFrameNo) << 4) | (0xF & dlSchedSubframeNo);
+  m_dlTriggerReq = FfMacSchedSapProvider::SchedDlTriggerReqParameters ();
+  m_dlTriggerReq.m_sfnSf = ((0x3FF & dlSchedFrameNo) << 4) | (0xF & dlSchedSubframeNo);
 
   // Forward DL HARQ feebacks collected during last TTI
   if (m_dlInfoListReceived.size () > 0)
     {
-      dlparams.m_dlInfoList = m_dlInfoListReceived;
+      m_dlTriggerReq.m_dlInfoList = m_dlInfoListReceived;
       // empty local buffer
       m_dlInfoListReceived.clear ();
     }
 
-  m_schedSapProvider->SchedDlTriggerReq (dlparams);
-
 
   // --- UPLINK ---
-  // Send UL-CQI info to the scheduler
+  // UL-CQI info to be sent to the scheduler
   for (uint16_t i = 0; i < m_ulCqiReceived.size (); i++)
     {
       if (subframeNo > 1)
@@ -600,20 +787,13 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
         {
           m_ulCqiReceived.at (i).m_sfnSf = ((0x3FF & (frameNo - 1)) << 4) | (0xF & 10);
         }
-      m_schedSapProvider->SchedUlCqiInfoReq (m_ulCqiReceived.at (i));
-    }
-    m_ulCqiReceived.clear ();
-  
-  // Send BSR reports to the scheduler
-  if (m_ulCeReceived.size () > 0)
-    {
-      FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters ulMacReq;
-      ulMacReq.m_sfnSf = ((0x3FF & frameNo) << 4) | (0xF & subframeNo);
-      ulMacReq.m_macCeList.insert (ulMacReq.m_macCeList.begin (), m_ulCeReceived.begin (), m_ulCeReceived.end ());
-      m_ulCeReceived.erase (m_ulCeReceived.begin (), m_ulCeReceived.end ());
-      m_schedSapProvider->SchedUlMacCtrlInfoReq (ulMacReq);
     }
+  m_ulCqiInfoReqs.swap (m_ulCqiReceived);
+  m_ulCqiReceived.clear ();
 
+  // BSR reports to be sent to the scheduler
+  m_ulCeInfoReqs.swap (m_ulCeReceived);
+  m_ulCeReceived.clear ();
 
   // Get uplink transmission opportunities
   uint32_t ulSchedFrameNo = m_frameNo;
@@ -628,19 +808,192 @@ LteEnbMac::DoSubframeIndication (uint32_t frameNo, uint32_t subframeNo)
     {
       ulSchedSubframeNo = ulSchedSubframeNo + (m_macChTtiDelay + UL_PUSCH_TTIS_DELAY);
     }
-  FfMacSchedSapProvider::SchedUlTriggerReqParameters ulparams;
-  ulparams.m_sfnSf = ((0x3FF & ulSchedFrameNo) << 4) | (0xF & ulSchedSubframeNo);
+  m_ulTriggerReq = FfMacSchedSapProvider::SchedUlTriggerReqParameters ();
+  m_ulTriggerReq.m_sfnSf = ((0x3FF & ulSchedFrameNo) << 4) | (0xF & ulSchedSubframeNo);
 
   // Forward DL HARQ feebacks collected during last TTI
   if (m_ulInfoListReceived.size () > 0)
     {
-     ulparams.m_ulInfoList = m_ulInfoListReceived;
+      m_ulTriggerReq.m_ulInfoList = m_ulInfoListReceived;
       // empty local buffer
       m_ulInfoListReceived.clear ();
     }
 
-  m_schedSapProvider->SchedUlTriggerReq (ulparams);
+  UintegerValue schedulerThreads;
+  g_schedulerThreads.GetValue (schedulerThreads);
+  if (schedulerThreads.Get () == 0)
+    {
+      SendDlTriggerReq ();
+      SendUlInfoReqs ();
+      SendUlTriggerReq ();
+    }
+  else
+    {
+      // the trigger requests of all the subframes indicated now are run
+      // in parallel by the next event at the current time
+      if (g_parallelDlSubframes.empty ())
+        {
+          Simulator::ScheduleNow (&LteEnbMac::RunParallelDlSchedulers);
+          if (!g_parallelSchedulingClearScheduled)
+            {
+              Simulator::ScheduleDestroy (&LteEnbMac::ClearParallelScheduling);
+              g_parallelSchedulingClearScheduled = true;
+            }
+        }
+      g_parallelDlSubframes.push_back (ParallelSubframe (Ptr<LteEnbMac> (this), Simulator::GetContext ()));
+      m_deferRequests = true;
+    }
+}
+
+void
+LteEnbMac::SendDlTriggerReq (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_schedSapProvider->SchedDlTriggerReq (m_dlTriggerReq);
+}
+
+void
+LteEnbMac::SendUlInfoReqs (void)
+{
+  NS_LOG_FUNCTION (this);
+  // Send UL-CQI info to the scheduler
+  for (uint16_t i = 0; i < m_ulCqiInfoReqs.size (); i++)
+    {
+      m_schedSapProvider->SchedUlCqiInfoReq (m_ulCqiInfoReqs.at (i));
+    }
+  m_ulCqiInfoReqs.clear ();
+
+  // Send BSR reports to the scheduler
+  if (m_ulCeInfoReqs.size () > 0)
+    {
+      FfMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters ulMacReq;
+      ulMacReq.m_sfnSf = ((0x3FF & m_frameNo) << 4) | (0xF & m_subframeNo);
+      ulMacReq.m_macCeList.swap (m_ulCeInfoReqs);
+      m_schedSapProvider->SchedUlMacCtrlInfoReq (ulMacReq);
+    }
+  m_ulCeInfoReqs.clear ();
+}
+
+void
+LteEnbMac::SendUlTriggerReq (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_schedSapProvider->SchedUlTriggerReq (m_ulTriggerReq);
+}
+
+void
+LteEnbMac::DeliverSchedConfigInd (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_deferSchedConfigInd = false;
+  for (uint32_t i = 0; i < m_deferredDlConfigInd.size (); i++)
+    {
+      DoSchedDlConfigInd (m_deferredDlConfigInd.at (i));
+    }
+  m_deferredDlConfigInd.clear ();
+  for (uint32_t i = 0; i < m_deferredUlConfigInd.size (); i++)
+    {
+      DoSchedUlConfigInd (m_deferredUlConfigInd.at (i));
+    }
+  m_deferredUlConfigInd.clear ();
+}
+
+bool
+LteEnbMac::DeferRequest (const std::function<void ()> &request)
+{
+  if (!m_deferRequests)
+    {
+      return false;
+    }
+  NS_LOG_LOGIC (this << " request deferred until the subframe is scheduled");
+  m_deferredRequests.push_back (request);
+  return true;
+}
+
+void
+LteEnbMac::EndParallelDlScheduling (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the requests made while processing the indications are not deferred,
+  // as in the subframe indication
+  m_deferRequests = false;
+  DeliverSchedConfigInd ();
+  SendUlInfoReqs ();
+  m_deferRequests = true;
+}
+
+void
+LteEnbMac::EndParallelUlScheduling (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_deferRequests = false;
+  DeliverSchedConfigInd ();
+  std::vector <std::function<void ()> > requests;
+  requests.swap (m_deferredRequests);
+  for (uint32_t i = 0; i < requests.size (); i++)
+    {
+      requests.at (i) ();
+    }
+}
+
+void
+LteEnbMac::RunParallelDlSchedulers (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::vector<ParallelSubframe> subframes;
+  subframes.swap (g_parallelDlSubframes);
+  for (uint32_t i = 0; i < subframes.size (); i++)
+    {
+      subframes[i].first->m_deferSchedConfigInd = true;
+    }
+  UintegerValue schedulerThreads;
+  g_schedulerThreads.GetValue (schedulerThreads);
+  SchedulerThreadPool::Get ().Run (schedulerThreads.Get (), subframes.size (),
+                                   [&subframes] (uint32_t i) { subframes[i].first->SendDlTriggerReq (); });
+
+  // the indications are processed in the order of the subframe
+  // indications, each in the context of its eNB, and followed by
+  // the UL trigger requests
+  for (uint32_t i = 0; i < subframes.size (); i++)
+    {
+      Simulator::ScheduleWithContext (subframes[i].second, Seconds (0),
+                                      &LteEnbMac::EndParallelDlScheduling, subframes[i].first);
+    }
+  if (!subframes.empty ())
+    {
+      Simulator::ScheduleNow (&LteEnbMac::RunParallelUlSchedulers);
+    }
+  g_parallelUlSubframes.insert (g_parallelUlSubframes.end (), subframes.begin (), subframes.end ());
+}
+
+void
+LteEnbMac::RunParallelUlSchedulers (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::vector<ParallelSubframe> subframes;
+  subframes.swap (g_parallelUlSubframes);
+  for (uint32_t i = 0; i < subframes.size (); i++)
+    {
+      subframes[i].first->m_deferSchedConfigInd = true;
+    }
+  UintegerValue schedulerThreads;
+  g_schedulerThreads.GetValue (schedulerThreads);
+  SchedulerThreadPool::Get ().Run (schedulerThreads.Get (), subframes.size (),
+                                   [&subframes] (uint32_t i) { subframes[i].first->SendUlTriggerReq (); });
+  for (uint32_t i = 0; i < subframes.size (); i++)
+    {
+      Simulator::ScheduleWithContext (subframes[i].second, Seconds (0),
+                                      &LteEnbMac::EndParallelUlScheduling, subframes[i].first);
+    }
+}
 
+void
+LteEnbMac::ClearParallelScheduling (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  g_parallelDlSubframes.clear ();
+  g_parallelUlSubframes.clear ();
+  g_parallelSchedulingClearScheduled = false;
 }
 
 
@@ -806,6 +1159,10 @@ void
 LteEnbMac::DoAddUe (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << " rnti=" << rnti);
+  if (DeferRequest ([this, rnti] () { DoAddUe (rnti); }))
+    {
+      return;
+    }
   std::map<uint8_t, LteMacSapUser*> empty;
   std::pair <std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> >::iterator, bool> 
     ret = m_rlcAttached.insert (std::pair <uint16_t,  std::map<uint8_t, LteMacSapUser*> > 
@@ -843,6 +1200,10 @@ void
 LteEnbMac::DoRemoveUe (uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << " rnti=" << rnti);
+  if (DeferRequest ([this, rnti] () { DoRemoveUe (rnti); }))
+    {
+      return;
+    }
   FfMacCschedSapProvider::CschedUeReleaseReqParameters params;
   params.m_rnti = rnti;
   m_cschedSapProvider->CschedUeReleaseReq (params);
@@ -887,6 +1248,10 @@ void
 LteEnbMac::DoAddLc (LteEnbCmacSapProvider::LcInfo lcinfo, LteMacSapUser* msu)
 {
   NS_LOG_FUNCTION (this << lcinfo.rnti << (uint16_t) lcinfo.lcId);
+  if (DeferRequest ([this, lcinfo, msu] () { DoAddLc (lcinfo, msu); }))
+    {
+      return;
+    }
 
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
   
@@ -940,6 +1305,10 @@ void
 LteEnbMac::DoReleaseLc (uint16_t rnti, uint8_t lcid)
 {
   NS_LOG_FUNCTION (this);
+  if (DeferRequest ([this, rnti, lcid] () { DoReleaseLc (rnti, lcid); }))
+    {
+      return;
+    }
 
   //Find user based on rnti and then erase lcid stored against the same
   std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> >::iterator rntiIt = m_rlcAttached.find (rnti);
@@ -955,6 +1324,10 @@ void
 LteEnbMac::DoUeUpdateConfigurationReq (LteEnbCmacSapProvider::UeConfig params)
 {
   NS_LOG_FUNCTION (this);
+  if (DeferRequest ([this, params] () { DoUeUpdateConfigurationReq (params); }))
+    {
+      return;
+    }
 
   // propagates to scheduler
   FfMacCschedSapProvider::CschedUeConfigReqParameters req;
@@ -1061,6 +1434,10 @@ void
 LteEnbMac::DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters params)
 {
   NS_LOG_FUNCTION (this);
+  if (DeferRequest ([this, params] () { DoReportBufferStatus (params); }))
+    {
+      return;
+    }
   FfMacSchedSapProvider::SchedDlRlcBufferReqParameters req;
   req.m_rnti = params.rnti;
   req.m_logicalChannelIdentity = params.lcid;
@@ -1084,6 +1461,12 @@ void
 LteEnbMac::DoSchedDlConfigInd (FfMacSchedSapUser::SchedDlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (m_deferSchedConfigInd)
+    {
+      // called by the scheduler running in a worker thread
+      m_deferredDlConfigInd.push_back (ind);
+      return;
+    }
   // Create DL PHY PDU
   Ptr<PacketBurst> pb = CreateObject<PacketBurst> ();
   std::map <LteFlowId_t, LteMacSapUser* >::iterator it;
@@ -1226,6 +1609,12 @@ void
 LteEnbMac::DoSchedUlConfigInd (FfMacSchedSapUser::SchedUlConfigIndParameters ind)
 {
   NS_LOG_FUNCTION (this);
+  if (m_deferSchedConfigInd)
+    {
+      // called by the scheduler running in a worker thread
+      m_deferredUlConfigInd.push_back (ind);
+      return;
+    }
 
   for (unsigned int i = 0; i < ind.m_dciList.size (); i++)
     {
@@ -28,6 +28,7 @@
 
 #include <map>
 #include <vector>
+#include <functional>
 #include <ns3/lte-common.h>
 #include <ns3/lte-mac-sap.h>
 #include <ns3/lte-enb-cmac-sap.h>
@@ -374,6 +375,57 @@ private:
   */
   void DoDlInfoListElementHarqFeeback (DlInfoListElement_s params);
 
+  /**
+   * \brief Send the DL trigger request of the current subframe to the scheduler
+   */
+  void SendDlTriggerReq (void);
+  /**
+   * \brief Send the UL-CQI and BSR reports of the current subframe to the scheduler
+   */
+  void SendUlInfoReqs (void);
+  /**
+   * \brief Send the UL trigger request of the current subframe to the scheduler
+   */
+  void SendUlTriggerReq (void);
+  /**
+   * \brief Process the scheduler indications stored while the scheduler
+   * was running in a worker thread
+   */
+  void DeliverSchedConfigInd (void);
+  /**
+   * \brief Store a request of the RRC or RLC received while the current
+   * subframe is scheduled in parallel, so that it reaches the scheduler
+   * after the trigger requests, as when the subframe indication runs them
+   * \param request the request
+   * \return true if the request was stored
+   */
+  bool DeferRequest (const std::function<void ()> &request);
+  /**
+   * \brief Process the DL scheduler indications of the current subframe,
+   * and send the UL information to the scheduler
+   */
+  void EndParallelDlScheduling (void);
+  /**
+   * \brief Process the UL scheduler indications of the current subframe,
+   * then the requests stored since the subframe indication
+   */
+  void EndParallelUlScheduling (void);
+  /**
+   * \brief Run the DL trigger requests of the subframes indicated at the
+   * current time in parallel
+   */
+  static void RunParallelDlSchedulers (void);
+  /**
+   * \brief Run the UL trigger requests of the subframes indicated at the
+   * current time in parallel
+   */
+  static void RunParallelUlSchedulers (void);
+  /**
+   * \brief Forget the subframes waiting to be scheduled in parallel, when
+   * the simulation is destroyed
+   */
+  static void ClearParallelScheduling (void);
+
   /// RNTI, LC ID, SAP of the RLC instance
   std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> > m_rlcAttached;
 
@@ -385,6 +437,17 @@ private:
 
   std::vector <UlInfoListElement_s> m_ulInfoListReceived; ///< UL HARQ feedback received
 
+  FfMacSchedSapProvider::SchedDlTriggerReqParameters m_dlTriggerReq; ///< DL trigger request of the current subframe
+  std::vector <FfMacSchedSapProvider::SchedUlCqiInfoReqParameters> m_ulCqiInfoReqs; ///< UL-CQI of the current subframe
+  std::vector <MacCeListElement_s> m_ulCeInfoReqs; ///< BSRs of the current subframe
+  FfMacSchedSapProvider::SchedUlTriggerReqParameters m_ulTriggerReq; ///< UL trigger request of the current subframe
+
+  bool m_deferSchedConfigInd; ///< whether the scheduler indications are stored for DeliverSchedConfigInd
+  std::vector <FfMacSchedSapUser::SchedDlConfigIndParameters> m_deferredDlConfigInd; ///< DL scheduler indications stored
+  std::vector <FfMacSchedSapUser::SchedUlConfigIndParameters> m_deferredUlConfigInd; ///< UL scheduler indications stored
+  bool m_deferRequests; ///< whether the requests of the RRC and RLC are stored for EndParallelUlScheduling
+  std::vector <std::function<void ()> > m_deferredRequests; ///< requests of the RRC and RLC stored
+
 
   /*
   * Map of UE's info element (see 4.3.12 of FF MAC Scheduler API)
@@ -26,6 +26,7 @@
 #include <ns3/lte-rrc-sap.h>
 #include <ns3/epc-x2-sap.h>
 #include <ns3/ff-mac-sched-sap.h>
+#include <ns3/rnti-map.h>
 #include <map>
 
 namespace ns3 {
@@ -189,7 +190,7 @@ protected:
    * \param ulCqiMap
    *
    */
-  virtual void DoReportUlCqiInfo ( std::map <uint16_t, std::vector <double> > ulCqiMap ) = 0;
+  virtual void DoReportUlCqiInfo (const RntiMap <std::vector <double> > &ulCqiMap) = 0;
 
   /**
    * \brief DoGetTpc for UE
@@ -521,7 +521,7 @@ LteFfrSoftAlgorithm::DoReportUlCqiInfo (const struct FfMacSchedSapProvider::Sche
 }
 
 void
-LteFfrSoftAlgorithm::DoReportUlCqiInfo (std::map <uint16_t, std::vector <double> > ulCqiMap)
+LteFfrSoftAlgorithm::DoReportUlCqiInfo (const RntiMap <std::vector <double> > &ulCqiMap)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_WARN ("Method should not be called, because it is empty");
@@ -431,7 +431,7 @@ LteFrSoftAlgorithm::DoReportUlCqiInfo (const struct FfMacSchedSapProvider::Sched
 }
 
 void
-LteFrSoftAlgorithm::DoReportUlCqiInfo (std::map <uint16_t, std::vector <double> > ulCqiMap)
+LteFrSoftAlgorithm::DoReportUlCqiInfo (const RntiMap <std::vector <double> > &ulCqiMap)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_WARN ("Method should not be called, because it is empty");
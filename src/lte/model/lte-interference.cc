@@ -51,8 +51,7 @@ LteInterference::DoDispose ()
   m_sinrChunkProcessorList.clear ();
   m_interfChunkProcessorList.clear ();
   m_rxSignal = 0;
-  m_allSignals = 0;
-  m_noise = 0;
+  m_signals.Clear ();
   Object::DoDispose ();
 } 
 
@@ -76,6 +75,7 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
     {
       NS_LOG_LOGIC ("first signal");
       m_rxSignal = rxPsd->Copy ();
+      m_signals.SetRxSignal (m_rxSignal);
       m_lastChangeTime = Now ();
       m_receiving = true;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_rsPowerChunkProcessorList.begin (); it != m_rsPowerChunkProcessorList.end (); ++it)
@@ -99,6 +99,7 @@ LteInterference::StartRx (Ptr<const SpectrumValue> rxPsd)
       // make sure they use orthogonal resource blocks
       NS_ASSERT (Sum ((*rxPsd) * (*m_rxSignal)) == 0.0);
       (*m_rxSignal) += (*rxPsd);
+      m_signals.SetRxSignal (m_rxSignal);
     }
 }
 
@@ -155,7 +156,7 @@ LteInterference::DoAddSignal (Ptr<const SpectrumValue> spd)
 { 
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
-  (*m_allSignals) += (*spd);
+  m_signals.AddSignal (spd);
 }
 
 void
@@ -166,7 +167,7 @@ LteInterference::DoSubtractSignal (Ptr<const SpectrumValue> spd, uint32_t signal
   int32_t deltaSignalId = signalId - m_lastSignalIdBeforeReset;
   if (deltaSignalId > 0)
     {   
-      (*m_allSignals) -= (*spd);
+      m_signals.SubtractSignal (spd);
     }
   else
     {
@@ -186,11 +187,12 @@ LteInterference::ConditionallyEvaluateChunk ()
   NS_LOG_DEBUG (this << " now "  << Now () << " last " << m_lastChangeTime);
   if (m_receiving && (Now () > m_lastChangeTime))
     {
-      NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals << " noise = " << *m_noise);
+      NS_LOG_LOGIC (this << " signal = " << *m_rxSignal << " allSignals = " << m_signals.GetAllSignals () << " noise = " << *m_signals.GetNoisePowerSpectralDensity ());
 
-      SpectrumValue interf =  (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+      // only the bands where a signal started or ended are computed again
+      const SpectrumValue &interf = m_signals.GetInterference ();
 
-      SpectrumValue sinr = (*m_rxSignal) / interf;
+      const SpectrumValue &sinr = m_signals.GetSinr ();
       Time duration = Now () - m_lastChangeTime;
       for (std::list<Ptr<LteChunkProcessor> >::const_iterator it = m_sinrChunkProcessorList.begin (); it != m_sinrChunkProcessorList.end (); ++it)
         {
@@ -213,10 +215,9 @@ LteInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd
 {
   NS_LOG_FUNCTION (this << *noisePsd);
   ConditionallyEvaluateChunk ();
-  m_noise = noisePsd;
-  // reset m_allSignals (will reset if already set previously)
+  // reset the sum of the signals (will reset if already set previously)
   // this is needed since this method can potentially change the SpectrumModel
-  m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  m_signals.SetNoisePowerSpectralDensity (noisePsd);
   if (m_receiving == true)
     {
       // abort rx
@@ -26,6 +26,7 @@
 #include <ns3/packet.h>
 #include <ns3/nstime.h>
 #include <ns3/spectrum-value.h>
+#include <ns3/spectrum-interference-accumulator.h>
 
 #include <list>
 
@@ -136,13 +137,11 @@ protected:
                                             * attempted
                                             */
 
-  Ptr<SpectrumValue> m_allSignals {nullptr}; /**< stores the spectral
-                                              * power density of the sum of incoming signals;
-                                              * does not include noise, includes the SPD of the signal being RX
+  SpectrumInterferenceAccumulator m_signals; /**< stores the spectral
+                                              * power density of the sum of incoming signals,
+                                              * the noise, and the SINR of the signal being RX
                                               */
 
-  Ptr<const SpectrumValue> m_noise {nullptr}; ///< the noise value
-
   Time m_lastChangeTime {Seconds(0)}; /**< the time of the last change in
                                        * m_TotalPower
                                        */
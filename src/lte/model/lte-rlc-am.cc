@@ -45,6 +45,7 @@ LteRlcAm::LteRlcAm ()
   m_retxBufferSize = 0;
   m_txedBuffer.resize (1024);
   m_txedBufferSize = 0;
+  m_rxonBuffer.resize (1024);
 
   m_statusPduRequested = false;
   m_statusPduBufferSize = 0;
@@ -231,7 +232,6 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
       NS_LOG_LOGIC ("Check for SNs to NACK from " << m_vrR.GetValue() << " to " << m_vrMs.GetValue());
       SequenceNumber10 sn;
       sn.SetModulusBase (m_vrR);
-      std::map<uint16_t, PduBuffer>::iterator pduIt;
       for (sn = m_vrR; sn < m_vrMs; sn++) 
         {
           NS_LOG_LOGIC ("SN = " << sn);          
@@ -240,8 +240,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
               NS_LOG_LOGIC ("Can't fit more NACKs in STATUS PDU");
               break;
             }          
-          pduIt = m_rxonBuffer.find (sn.GetValue ());
-          if (pduIt == m_rxonBuffer.end () || (!(pduIt->second.m_pduComplete)))
+          if (!m_rxonBuffer[sn.GetValue ()].m_pduComplete)
             {
               NS_LOG_LOGIC ("adding NACK_SN " << sn.GetValue ());
               rlcAmHeader.PushNack (sn.GetValue ());              
@@ -251,13 +250,11 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
       // 3GPP TS 36.322 section 6.2.2.1.4 ACK SN
       // find the  SN of the next not received RLC Data PDU 
       // which is not reported as missing in the STATUS PDU. 
-      pduIt = m_rxonBuffer.find (sn.GetValue ());
-      while ((sn < m_vrMs) && (pduIt != m_rxonBuffer.end ()) && (pduIt->second.m_pduComplete))            
+      while ((sn < m_vrMs) && (m_rxonBuffer[sn.GetValue ()].m_pduComplete))
         {
           NS_LOG_LOGIC ("SN = " << sn << " < " << m_vrMs << " = " << (sn < m_vrMs));
           sn++;
           NS_LOG_LOGIC ("SN = " << sn);
-          pduIt = m_rxonBuffer.find (sn.GetValue ());
         }
       
       NS_ASSERT_MSG (sn <= m_vrMs, "first SN not reported as missing = " << sn << ", VR(MS) = " << m_vrMs);      
@@ -463,7 +460,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
   Ptr<Packet> firstSegment = m_txonBuffer.begin ()->m_pdu->Copy ();
   m_txonBufferSize -= m_txonBuffer.begin ()->m_pdu->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txonBufferSize );
-  m_txonBuffer.erase (m_txonBuffer.begin ());
+  m_txonBuffer.pop_front ();
 
   while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
     {
@@ -511,7 +508,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
             {
               firstSegment->AddPacketTag (oldTag);
 
-              m_txonBuffer.insert (m_txonBuffer.begin (), TxPdu (firstSegment, firstSegmentTime));
+              m_txonBuffer.push_front (TxPdu (firstSegment, firstSegmentTime));
               m_txonBufferSize += m_txonBuffer.begin ()->m_pdu->GetSize ();
 
               NS_LOG_LOGIC ("    Txon buffer: Give back the remaining segment");
@@ -618,7 +615,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
           firstSegment = m_txonBuffer.begin ()->m_pdu->Copy ();
           firstSegmentTime = m_txonBuffer.begin ()->m_waitingSince;
           m_txonBufferSize -= m_txonBuffer.begin ()->m_pdu->GetSize ();
-          m_txonBuffer.erase (m_txonBuffer.begin ());
+          m_txonBuffer.pop_front ();
           NS_LOG_LOGIC ("        txBufferSize = " << m_txonBufferSize );
         }
 
@@ -901,18 +898,17 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
           //         - discard the duplicate byte segments.
           // note: re-segmentation of AMD PDU is currently not supported, 
           // so we just check that the segment was not received before
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if (it != m_rxonBuffer.end () )
+          PduBuffer &pduBuffer = m_rxonBuffer[seqNumber.GetValue ()];
+          if (!pduBuffer.m_byteSegments.empty ())
             {
-              NS_ASSERT (it->second.m_byteSegments.size () > 0);
-              NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1, "re-segmentation not supported");
+              NS_ASSERT_MSG (pduBuffer.m_byteSegments.size () == 1, "re-segmentation not supported");
               NS_LOG_LOGIC ("PDU segment already received, discarded");
             }
           else
             {
               NS_LOG_LOGIC ("Place PDU in the reception buffer ( SN = " << seqNumber << " )");
-              m_rxonBuffer[ seqNumber.GetValue () ].m_byteSegments.push_back (rxPduParams.p);
-              m_rxonBuffer[ seqNumber.GetValue () ].m_pduComplete = true;
+              pduBuffer.m_byteSegments.push_back (rxPduParams.p);
+              pduBuffer.m_pduComplete = true;
             }
 
 
@@ -935,16 +931,12 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
       //     - update VR(MS) to the SN of the first AMD PDU with SN > current VR(MS) for
       //       which not all byte segments have been received;
 
-      std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-      if ( it != m_rxonBuffer.end () &&
-           it->second.m_pduComplete )
+      if ( m_rxonBuffer[m_vrMs.GetValue ()].m_pduComplete )
         {
           int firstVrMs = m_vrMs.GetValue ();
-          while ( it != m_rxonBuffer.end () &&
-                  it->second.m_pduComplete )
+          while ( m_rxonBuffer[m_vrMs.GetValue ()].m_pduComplete )
             {
               m_vrMs++;
-              it = m_rxonBuffer.find (m_vrMs.GetValue ());
               NS_LOG_LOGIC ("Incr VR(MS) = " << m_vrMs);
 
               NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in RxonBuffer");
@@ -960,27 +952,24 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
 
       if ( seqNumber == m_vrR )
         {
-          std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (seqNumber.GetValue ());
-          if ( it != m_rxonBuffer.end () &&
-               it->second.m_pduComplete )
+          if ( m_rxonBuffer[seqNumber.GetValue ()].m_pduComplete )
             {
-              it = m_rxonBuffer.find (m_vrR.GetValue ());
               int firstVrR = m_vrR.GetValue ();
-              while ( it != m_rxonBuffer.end () &&
-                      it->second.m_pduComplete )
+              while ( m_rxonBuffer[m_vrR.GetValue ()].m_pduComplete )
                 {
                   NS_LOG_LOGIC ("Reassemble and Deliver ( SN = " << m_vrR << " )");
-                  NS_ASSERT_MSG (it->second.m_byteSegments.size () == 1,
+                  PduBuffer &pduBuffer = m_rxonBuffer[m_vrR.GetValue ()];
+                  NS_ASSERT_MSG (pduBuffer.m_byteSegments.size () == 1,
                                 "Too many segments. PDU Reassembly process didn't work");
-                  ReassembleAndDeliver (it->second.m_byteSegments.front ());
-                  m_rxonBuffer.erase (m_vrR.GetValue ());
+                  ReassembleAndDeliver (pduBuffer.m_byteSegments.front ());
+                  pduBuffer.m_byteSegments.clear ();
+                  pduBuffer.m_pduComplete = false;
 
                   m_vrR++;
                   m_vrR.SetModulusBase (m_vrR);
                   m_vrX.SetModulusBase (m_vrR);
                   m_vrMs.SetModulusBase (m_vrR);
                   m_vrH.SetModulusBase (m_vrR);
-                  it = m_rxonBuffer.find (m_vrR.GetValue ());
 
                   NS_ASSERT_MSG (firstVrR != m_vrR.GetValue (), "Infinite loop in RxonBuffer");
                 }
@@ -1673,12 +1662,9 @@ LteRlcAm::ExpireReorderingTimer (void)
 
   m_vrMs = m_vrX;
   int firstVrMs = m_vrMs.GetValue ();
-  std::map <uint16_t, PduBuffer>::iterator it = m_rxonBuffer.find (m_vrMs.GetValue ());
-  while ( it != m_rxonBuffer.end () &&
-          it->second.m_pduComplete )
+  while ( m_rxonBuffer[m_vrMs.GetValue ()].m_pduComplete )
     {
       m_vrMs++;
-      it = m_rxonBuffer.find (m_vrMs.GetValue ());
 
       NS_ASSERT_MSG (firstVrMs != m_vrMs.GetValue (), "Infinite loop in ExpireReorderingTimer");
     }
@@ -26,6 +26,7 @@
 #include <ns3/lte-rlc.h>
 
 #include <vector>
+#include <deque>
 #include <map>
 
 namespace ns3 {
@@ -128,7 +129,7 @@ private:
     Time        m_waitingSince;  ///< Layer arrival time
   };
 
-  std::vector < TxPdu > m_txonBuffer; ///< Transmission buffer
+  std::deque < TxPdu > m_txonBuffer; ///< Transmission buffer
 
   /// RetxPdu structure
   struct RetxPdu
@@ -160,7 +161,7 @@ private:
       bool      m_pduComplete; ///< PDU complete?
     };
 
-    std::map <uint16_t, PduBuffer > m_rxonBuffer; ///< Reception buffer
+    std::vector <PduBuffer> m_rxonBuffer; ///< Reception buffer, indexed by SN; a PDU not received has no byte segments
 
     Ptr<Packet> m_controlPduBuffer;               ///< Control PDU buffer (just one PDU)
 
@@ -44,6 +44,8 @@ LteRlcUm::LteRlcUm ()
 {
   NS_LOG_FUNCTION (this);
   m_reassemblingState = WAITING_S0_FULL;
+  m_rxBuffer.resize (1024);
+  m_nRxPdus = 0;
 }
 
 LteRlcUm::~LteRlcUm ()
@@ -164,7 +166,7 @@ LteRlcUm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
   NS_LOG_LOGIC ("Remove SDU from TxBuffer");
   m_txBufferSize -= firstSegment->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txBufferSize );
-  m_txBuffer.erase (m_txBuffer.begin ());
+  m_txBuffer.pop_front ();
 
   while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
     {
@@ -212,7 +214,7 @@ LteRlcUm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
             {
               firstSegment->AddPacketTag (oldTag);
 
-              m_txBuffer.insert (m_txBuffer.begin (), TxPdu (firstSegment, firstSegmentTime));
+              m_txBuffer.push_front (TxPdu (firstSegment, firstSegmentTime));
               m_txBufferSize += m_txBuffer.begin()->m_pdu->GetSize ();
 
               NS_LOG_LOGIC ("    TX buffer: Give back the remaining segment");
@@ -318,7 +320,7 @@ LteRlcUm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
           firstSegment = m_txBuffer.begin ()->m_pdu->Copy ();
           firstSegmentTime = m_txBuffer.begin ()->m_waitingSince;
           m_txBufferSize -= firstSegment->GetSize ();
-          m_txBuffer.erase (m_txBuffer.begin ());
+          m_txBuffer.pop_front ();
           NS_LOG_LOGIC ("        txBufferSize = " << m_txBufferSize );
         }
 
@@ -461,7 +463,7 @@ LteRlcUm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
   m_vrUh.SetModulusBase (m_vrUh - m_windowSize);
   seqNumber.SetModulusBase (m_vrUh - m_windowSize);
 
-  if ( ( (m_vrUr < seqNumber) && (seqNumber < m_vrUh) && (m_rxBuffer.count (seqNumber.GetValue ()) > 0) ) ||
+  if ( ( (m_vrUr < seqNumber) && (seqNumber < m_vrUh) && (m_rxBuffer[seqNumber.GetValue ()] != 0) ) ||
        ( ((m_vrUh - m_windowSize) <= seqNumber) && (seqNumber < m_vrUr) )
      )
     {
@@ -472,6 +474,10 @@ LteRlcUm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
   else
     {
       NS_LOG_LOGIC ("Place PDU in the reception buffer");
+      if (m_rxBuffer[seqNumber.GetValue ()] == 0)
+        {
+          m_nRxPdus++;
+        }
       m_rxBuffer[seqNumber.GetValue ()] = rxPduParams.p;
     }
 
@@ -510,17 +516,15 @@ LteRlcUm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
   //      so and deliver the reassembled RLC SDUs to upper layer in ascending order of the RLC SN if not delivered
   //      before;
 
-  if ( m_rxBuffer.count (m_vrUr.GetValue ()) > 0 )
+  if ( m_rxBuffer[m_vrUr.GetValue ()] != 0 )
     {
       NS_LOG_LOGIC ("Reception buffer contains SN = " << m_vrUr);
 
-      std::map <uint16_t, Ptr<Packet> >::iterator it;
       uint16_t newVrUr;
       SequenceNumber10 oldVrUr = m_vrUr;
 
-      it = m_rxBuffer.find (m_vrUr.GetValue ());
-      newVrUr = (it->first) + 1;
-      while ( m_rxBuffer.count (newVrUr) > 0 )
+      newVrUr = m_vrUr.GetValue () + 1;
+      while ( newVrUr < m_rxBuffer.size () && m_rxBuffer[newVrUr] != 0 )
         {
           newVrUr++;
         }
@@ -1069,24 +1073,27 @@ LteRlcUm::ReassembleOutsideWindow (void)
 {
   NS_LOG_LOGIC ("Reassemble Outside Window");
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
-  it = m_rxBuffer.begin ();
-
-  while ( (it != m_rxBuffer.end ()) && ! IsInsideReorderingWindow (SequenceNumber10 (it->first)) )
+  // visit the stored PDUs in increasing order of SN value, until one is inside the window
+  uint16_t sn = 0;
+  while (m_nRxPdus > 0)
     {
-      NS_LOG_LOGIC ("SN = " << it->first);
+      while (m_rxBuffer[sn] == 0)
+        {
+          sn++;
+        }
+      if (IsInsideReorderingWindow (SequenceNumber10 (sn)))
+        {
+          NS_LOG_LOGIC ("(SN = " << sn << ") is inside the reordering window");
+          break;
+        }
+      NS_LOG_LOGIC ("SN = " << sn);
 
       // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
-      ReassembleAndDeliver (it->second);
-
-      std::map <uint16_t, Ptr<Packet> >::iterator it_tmp = it;
-      ++it;
-      m_rxBuffer.erase (it_tmp);
-    }
+      ReassembleAndDeliver (m_rxBuffer[sn]);
 
-  if (it != m_rxBuffer.end ())
-    {
-      NS_LOG_LOGIC ("(SN = " << it->first << ") is inside the reordering window");
+      m_rxBuffer[sn] = 0;
+      m_nRxPdus--;
+      sn++;
     }
 }
 
@@ -1095,25 +1102,22 @@ LteRlcUm::ReassembleSnInterval (SequenceNumber10 lowSeqNumber, SequenceNumber10
 {
   NS_LOG_LOGIC ("Reassemble SN between " << lowSeqNumber << " and " << highSeqNumber);
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
-
   SequenceNumber10 reassembleSn = lowSeqNumber;
   NS_LOG_LOGIC ("reassembleSN = " << reassembleSn);
   NS_LOG_LOGIC ("highSeqNumber = " << highSeqNumber);
   while (reassembleSn < highSeqNumber)
     {
       NS_LOG_LOGIC ("reassembleSn < highSeqNumber");
-      it = m_rxBuffer.find (reassembleSn.GetValue ());
-      NS_LOG_LOGIC ("it->first  = " << it->first);
-      NS_LOG_LOGIC ("it->second = " << it->second);
-      if (it != m_rxBuffer.end () )
+      Ptr<Packet> &pdu = m_rxBuffer[reassembleSn.GetValue ()];
+      if (pdu != 0)
         {
-          NS_LOG_LOGIC ("SN = " << it->first);
+          NS_LOG_LOGIC ("SN = " << reassembleSn);
 
           // Reassemble RLC SDUs and deliver the PDCP PDU to upper layer
-          ReassembleAndDeliver (it->second);
+          ReassembleAndDeliver (pdu);
 
-          m_rxBuffer.erase (it);
+          pdu = 0;
+          m_nRxPdus--;
         }
         
       reassembleSn++;
@@ -1163,10 +1167,9 @@ LteRlcUm::ExpireReorderingTimer (void)
   //    - start t-Reordering;
   //    - set VR(UX) to VR(UH).
 
-  std::map <uint16_t, Ptr<Packet> >::iterator it;
   SequenceNumber10 newVrUr = m_vrUx;
 
-  while ( (it = m_rxBuffer.find (newVrUr.GetValue ())) != m_rxBuffer.end () )
+  while ( m_rxBuffer[newVrUr.GetValue ()] != 0 )
     {
       newVrUr++;
     }
@@ -25,6 +25,8 @@
 #include "ns3/lte-rlc.h"
 
 #include <ns3/event-id.h>
+#include <deque>
+#include <vector>
 #include <map>
 
 namespace ns3 {
@@ -118,8 +120,9 @@ private:
     Time        m_waitingSince;  ///< Layer arrival time
   };
 
-  std::vector < TxPdu > m_txBuffer; ///< Transmission buffer
-  std::map <uint16_t, Ptr<Packet> > m_rxBuffer; ///< Reception buffer
+  std::deque < TxPdu > m_txBuffer; ///< Transmission buffer
+  std::vector < Ptr<Packet> > m_rxBuffer; ///< Reception buffer, indexed by SN
+  uint32_t m_nRxPdus; ///< number of PDUs in the reception buffer
   std::vector < Ptr<Packet> > m_reasBuffer;     ///< Reassembling buffer
 
   std::list < Ptr<Packet> > m_sdusBuffer;       ///< List of SDUs in a packet
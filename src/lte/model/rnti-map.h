@@ -0,0 +1,390 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RNTI_MAP_H
+#define RNTI_MAP_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * \brief Per-UE state of a scheduler, indexed by RNTI.
+ *
+ * The states are stored in a vector of slots, and a table indexed by the
+ * RNTI gives the slot of each UE, so that finding the state of a UE does
+ * not search anything.  The table only spans the RNTIs up to the largest
+ * one stored: it grows with the insertions and shrinks when the largest
+ * RNTIs are erased.  The slots of the erased UEs are kept in a free
+ * list and reused by the next insertions.  The RNTIs in use are kept in a
+ * sorted vector, which the iterations walk.  As the eNB allocates the
+ * RNTIs incrementally, the insertions mostly append to it.
+ *
+ * The interface is the subset of std::map <uint16_t, T> used by the
+ * FF MAC schedulers, and the iterations are in increasing RNTI order
+ * as with std::map.  The iterators hold the RNTI of their element, thus
+ * they stay valid when other elements are inserted or erased.
+ */
+template <typename T>
+class RntiMap
+{
+public:
+  typedef uint16_t key_type;                 ///< RNTI
+  typedef T mapped_type;                     ///< state of a UE
+  typedef std::pair<uint16_t, T> value_type; ///< RNTI and state of a UE
+
+  /**
+   * Iterator over the UEs stored, in increasing RNTI order.
+   * \tparam M the type of the map, possibly const
+   * \tparam V the type of the values, possibly const
+   */
+  template <typename M, typename V>
+  class Iterator
+  {
+public:
+    Iterator ()
+      : m_map (0),
+        m_rnti (END),
+        m_pos (0)
+    {
+    }
+    /**
+     * Constructor
+     * \param map the map
+     * \param rnti the RNTI of the element, or END
+     * \param pos the position of the RNTI in the sorted RNTIs
+     */
+    Iterator (M *map, uint32_t rnti, uint32_t pos)
+      : m_map (map),
+        m_rnti (rnti),
+        m_pos (pos)
+    {
+    }
+    /**
+     * Conversion from an iterator to a const_iterator
+     * \param o the iterator
+     */
+    template <typename M2, typename V2>
+    Iterator (const Iterator<M2, V2> &o)
+      : m_map (o.m_map),
+        m_rnti (o.m_rnti),
+        m_pos (o.m_pos)
+    {
+    }
+    /// \return the RNTI and state of the UE
+    V & operator* () const
+    {
+      return m_map->m_slots[m_map->m_slotOf[m_rnti]];
+    }
+    /// \return the RNTI and state of the UE
+    V * operator-> () const
+    {
+      return &m_map->m_slots[m_map->m_slotOf[m_rnti]];
+    }
+    /// \return the iterator to the next UE
+    Iterator & operator++ ()
+    {
+      m_pos = m_map->Next (m_rnti, m_pos);
+      m_rnti = m_pos < m_map->m_rntis.size () ? m_map->m_rntis[m_pos] : END;
+      return *this;
+    }
+    /// \return the iterator before the increment
+    Iterator operator++ (int)
+    {
+      Iterator it = *this;
+      ++(*this);
+      return it;
+    }
+    /**
+     * \param o the other iterator
+     * \return true if both iterators refer to the same UE
+     */
+    template <typename M2, typename V2>
+    bool operator== (const Iterator<M2, V2> &o) const
+    {
+      return m_rnti == o.m_rnti;
+    }
+    /**
+     * \param o the other iterator
+     * \return true if the iterators refer to different UEs
+     */
+    template <typename M2, typename V2>
+    bool operator!= (const Iterator<M2, V2> &o) const
+    {
+      return m_rnti != o.m_rnti;
+    }
+
+private:
+    template <typename M2, typename V2> friend class Iterator;
+    friend class RntiMap;
+
+    M *m_map;         ///< the map
+    uint32_t m_rnti;  ///< the RNTI of the element, or END
+    uint32_t m_pos;   ///< the position of the RNTI when last seen
+  };
+
+  typedef Iterator<RntiMap, value_type> iterator;                   ///< iterator
+  typedef Iterator<const RntiMap, const value_type> const_iterator; ///< const iterator
+
+  /// \return an iterator to the UE with the lowest RNTI
+  iterator begin ()
+  {
+    return iterator (this, m_rntis.empty () ? END : m_rntis.front (), 0);
+  }
+  /// \return an iterator past the last UE
+  iterator end ()
+  {
+    return iterator (this, END, 0);
+  }
+  /// \return a const iterator to the UE with the lowest RNTI
+  const_iterator begin () const
+  {
+    return const_iterator (this, m_rntis.empty () ? END : m_rntis.front (), 0);
+  }
+  /// \return a const iterator past the last UE
+  const_iterator end () const
+  {
+    return const_iterator (this, END, 0);
+  }
+
+  /// \return the number of UEs stored
+  std::size_t size () const
+  {
+    return m_rntis.size ();
+  }
+  /// \return true if no UE is stored
+  bool empty () const
+  {
+    return m_rntis.empty ();
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return an iterator to the UE, or end () if not stored
+   */
+  iterator find (uint16_t rnti)
+  {
+    return Contains (rnti) ? iterator (this, rnti, Position (rnti)) : end ();
+  }
+  /**
+   * \param rnti the RNTI
+   * \return a const iterator to the UE, or end () if not stored
+   */
+  const_iterator find (uint16_t rnti) const
+  {
+    return Contains (rnti) ? const_iterator (this, rnti, Position (rnti)) : end ();
+  }
+  /**
+   * \param rnti the RNTI
+   * \return 1 if the UE is stored, 0 otherwise
+   */
+  std::size_t count (uint16_t rnti) const
+  {
+    return Contains (rnti) ? 1 : 0;
+  }
+
+  /**
+   * Store the state of a UE, unless the UE is already stored.
+   * \param v the RNTI and the state of the UE
+   * \return an iterator to the UE, and whether it was inserted
+   */
+  template <typename K, typename V>
+  std::pair<iterator, bool> insert (const std::pair<K, V> &v)
+  {
+    uint16_t rnti = v.first;
+    if (Contains (rnti))
+      {
+        return std::make_pair (iterator (this, rnti, Position (rnti)), false);
+      }
+    uint32_t pos = Use (rnti);
+    m_slots[m_slotOf[rnti]].second = v.second;
+    return std::make_pair (iterator (this, rnti, pos), true);
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return the state of the UE, stored with a default value if needed
+   */
+  T & operator[] (uint16_t rnti)
+  {
+    if (!Contains (rnti))
+      {
+        Use (rnti);
+      }
+    return m_slots[m_slotOf[rnti]].second;
+  }
+
+  /**
+   * Erase the state of a UE.
+   * \param rnti the RNTI
+   * \return the number of UEs erased
+   */
+  std::size_t erase (uint16_t rnti)
+  {
+    if (!Contains (rnti))
+      {
+        return 0;
+      }
+    Release (rnti);
+    return 1;
+  }
+  /**
+   * Erase the state of a UE.
+   * \param it the iterator to the UE
+   * \return the iterator to the next UE
+   */
+  iterator erase (iterator it)
+  {
+    uint32_t pos = Release (it.m_rnti);
+    return iterator (this, pos < m_rntis.size () ? m_rntis[pos] : END, pos);
+  }
+
+  /// Erase all the UEs
+  void clear ()
+  {
+    m_slots.clear ();
+    m_free.clear ();
+    m_slotOf.clear ();
+    m_rntis.clear ();
+  }
+
+private:
+  /// RNTI of the iterators past the last UE, beyond any RNTI
+  static constexpr uint32_t END = 0x10000;
+  /// slot of the RNTIs not stored
+  static constexpr uint32_t NONE = 0xffffffff;
+
+  /**
+   * \param rnti the RNTI
+   * \return true if the UE is stored
+   */
+  bool Contains (uint16_t rnti) const
+  {
+    return rnti < m_slotOf.size () && m_slotOf[rnti] != NONE;
+  }
+
+  /**
+   * \param rnti the RNTI
+   * \return the position of the first RNTI stored not lower than rnti
+   */
+  uint32_t Position (uint32_t rnti) const
+  {
+    return std::lower_bound (m_rntis.begin (), m_rntis.end (), rnti) - m_rntis.begin ();
+  }
+
+  /**
+   * \param rnti the RNTI of an iterator
+   * \param pos the position of the RNTI when the iterator last saw it
+   * \return the position of the first RNTI stored higher than rnti
+   */
+  uint32_t Next (uint32_t rnti, uint32_t pos) const
+  {
+    if (pos < m_rntis.size () && m_rntis[pos] == rnti)
+      {
+        return pos + 1;
+      }
+    // other UEs were inserted or erased since, or this one was erased
+    pos = Position (rnti);
+    if (pos < m_rntis.size () && m_rntis[pos] == rnti)
+      {
+        pos++;
+      }
+    return pos;
+  }
+
+  /**
+   * Give a slot to a UE.
+   * \param rnti the RNTI, not stored yet
+   * \return the position of the RNTI in the sorted RNTIs
+   */
+  uint32_t Use (uint16_t rnti)
+  {
+    if (rnti >= m_slotOf.size ())
+      {
+        m_slotOf.resize (rnti + 1u, NONE);
+      }
+    uint32_t slot;
+    if (m_free.empty ())
+      {
+        slot = m_slots.size ();
+        m_slots.push_back (value_type (rnti, T ()));
+      }
+    else
+      {
+        slot = m_free.back ();
+        m_free.pop_back ();
+        m_slots[slot].first = rnti;
+      }
+    m_slotOf[rnti] = slot;
+
+    uint32_t pos = m_rntis.size ();
+    if (m_rntis.empty () || rnti > m_rntis.back ())
+      {
+        m_rntis.push_back (rnti);
+      }
+    else
+      {
+        pos = Position (rnti);
+        m_rntis.insert (m_rntis.begin () + pos, rnti);
+      }
+    return pos;
+  }
+
+  /**
+   * Reset the slot of a UE, and put it in the free list.
+   * \param rnti the RNTI, stored
+   * \return the position of the next RNTI in the sorted RNTIs
+   */
+  uint32_t Release (uint16_t rnti)
+  {
+    uint32_t slot = m_slotOf[rnti];
+    m_slots[slot].second = T ();
+    m_free.push_back (slot);
+    m_slotOf[rnti] = NONE;
+
+    uint32_t pos = Position (rnti);
+    m_rntis.erase (m_rntis.begin () + pos);
+    if (m_rntis.empty ())
+      {
+        clear ();
+        std::vector<uint32_t> ().swap (m_slotOf);
+      }
+    else if (pos == m_rntis.size ())
+      {
+        // the largest RNTI was erased
+        m_slotOf.resize (m_rntis.back () + 1u);
+        if (m_slotOf.capacity () > 2 * m_slotOf.size ())
+          {
+            std::vector<uint32_t> (m_slotOf).swap (m_slotOf);
+          }
+      }
+    return pos;
+  }
+
+  std::vector<value_type> m_slots; ///< the RNTI and state of the UEs
+  std::vector<uint32_t> m_free;    ///< the slots not in use
+  std::vector<uint32_t> m_slotOf;  ///< the slot of each RNTI up to the largest stored, or NONE
+  std::vector<uint16_t> m_rntis;   ///< the RNTIs stored, sorted
+};
+
+} // namespace ns3
+
+#endif /* RNTI_MAP_H */
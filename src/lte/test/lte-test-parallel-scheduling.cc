@@ -0,0 +1,339 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/config.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <ns3/double.h>
+#include <ns3/string.h>
+#include <ns3/data-rate.h>
+#include <ns3/mobility-helper.h>
+#include <ns3/lte-helper.h>
+#include <ns3/point-to-point-epc-helper.h>
+#include <ns3/lte-enb-net-device.h>
+#include <ns3/lte-enb-mac.h>
+#include <ns3/lte-enb-phy.h>
+#include <ns3/lte-ue-net-device.h>
+#include <ns3/lte-ue-rrc.h>
+#include <ns3/internet-stack-helper.h>
+#include <ns3/ipv4-address-helper.h>
+#include <ns3/ipv4-static-routing-helper.h>
+#include <ns3/point-to-point-helper.h>
+#include <ns3/udp-client-server-helper.h>
+#include <ns3/packet-sink-helper.h>
+
+#include <set>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LteParallelSchedulingTest");
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test case checking that the scheduling decisions of several
+ * eNBs serving UDP traffic are the same when their schedulers run on
+ * threads as when they run in the subframe indications.
+ *
+ * Optionally, the test reports the buffer status of the UEs to the MAC
+ * of their eNB at the time of each subframe, right after the subframe
+ * indications, as an RLC may do.
+ */
+class LteParallelSchedulingTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param schedulerType the type of the FF MAC scheduler
+   * \param reportBuffers whether to report buffer status at the time of each subframe
+   */
+  LteParallelSchedulingTestCase (std::string schedulerType, bool reportBuffers);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Simulate the scenario.
+   * \param threads the number of threads running the schedulers
+   * \return the log of the DL and UL scheduling decisions of each eNB
+   */
+  std::vector<std::string> RunScenario (uint32_t threads);
+
+  /**
+   * Log a DL scheduling decision.
+   * \param log the log of the eNB
+   * \param info the scheduling decision
+   */
+  static void DlScheduling (std::ostringstream *log, DlSchedulingCallbackInfo info);
+  /**
+   * Log a UL scheduling decision.
+   * \param log the log of the eNB
+   * \param frameNo the frame number
+   * \param subframeNo the subframe number
+   * \param rnti the RNTI
+   * \param mcs the MCS
+   * \param size the size of the TB
+   * \param ccId the component carrier ID
+   */
+  static void UlScheduling (std::ostringstream *log, uint32_t frameNo, uint32_t subframeNo,
+                            uint16_t rnti, uint8_t mcs, uint16_t size, uint8_t ccId);
+
+  /**
+   * \param log the log of an eNB
+   * \param direction "DL" or "UL"
+   * \return the number of UEs scheduled in the direction
+   */
+  static uint32_t CountRntis (const std::string &log, const std::string &direction);
+
+  /**
+   * Report the buffer status of the UEs to the MAC of their eNB, after
+   * the subframe indications of the current time, once per subframe.
+   * \param params the parameters of the DL transmission of the first eNB
+   */
+  void ReportBuffers (PhyTransmissionStatParameters params);
+
+  std::string m_schedulerType;  ///< the type of the FF MAC scheduler
+  bool m_reportBuffers;         ///< whether to report buffer status at the time of each subframe
+  NetDeviceContainer m_enbDevs; ///< the eNB devices of the scenario
+  NetDeviceContainer m_ueDevs;  ///< the UE devices of the scenario
+  Time m_lastReport;            ///< the time of the last buffer status reports
+};
+
+LteParallelSchedulingTestCase::LteParallelSchedulingTestCase (std::string schedulerType, bool reportBuffers)
+  : TestCase ("Parallel scheduling of 3 eNBs with " + schedulerType
+              + (reportBuffers ? " and buffer status reports at the subframe times" : "")),
+    m_schedulerType (schedulerType),
+    m_reportBuffers (reportBuffers)
+{
+}
+
+void
+LteParallelSchedulingTestCase::DlScheduling (std::ostringstream *log, DlSchedulingCallbackInfo info)
+{
+  *log << "DL " << info.frameNo << " " << info.subframeNo << " " << info.rnti
+       << " " << (uint32_t) info.mcsTb1 << " " << info.sizeTb1
+       << " " << (uint32_t) info.mcsTb2 << " " << info.sizeTb2 << "\n";
+}
+
+void
+LteParallelSchedulingTestCase::UlScheduling (std::ostringstream *log, uint32_t frameNo, uint32_t subframeNo,
+                                             uint16_t rnti, uint8_t mcs, uint16_t size, uint8_t ccId)
+{
+  *log << "UL " << frameNo << " " << subframeNo << " " << rnti
+       << " " << (uint32_t) mcs << " " << size << "\n";
+}
+
+void
+LteParallelSchedulingTestCase::ReportBuffers (PhyTransmissionStatParameters params)
+{
+  // the UEs are connected, and their DRB configured, well before
+  if (Simulator::Now () < MilliSeconds (100) || Simulator::Now () == m_lastReport)
+    {
+      return;
+    }
+  m_lastReport = Simulator::Now ();
+  for (uint32_t j = 0; j < m_ueDevs.GetN (); j++)
+    {
+      Ptr<LteUeNetDevice> ueDev = m_ueDevs.Get (j)->GetObject<LteUeNetDevice> ();
+      Ptr<LteEnbNetDevice> enbDev = m_enbDevs.Get (j % 3)->GetObject<LteEnbNetDevice> ();
+      LteMacSapProvider::ReportBufferStatusParameters report;
+      report.rnti = ueDev->GetRrc ()->GetRnti ();
+      report.lcid = 3;
+      // a queue varying with the subframe, sometimes empty
+      report.txQueueSize = ((m_lastReport.GetMilliSeconds () + j) % 4) * 1000;
+      report.txQueueHolDelay = 0;
+      report.retxQueueSize = 0;
+      report.retxQueueHolDelay = 0;
+      report.statusPduSize = 0;
+      // the PHY of the first eNB starts its subframe before the subframe indications
+      Simulator::ScheduleWithContext (enbDev->GetNode ()->GetId (), Seconds (0),
+                                      &LteMacSapProvider::ReportBufferStatus,
+                                      enbDev->GetMac ()->GetLteMacSapProvider (), report);
+    }
+}
+
+std::vector<std::string>
+LteParallelSchedulingTestCase::RunScenario (uint32_t threads)
+{
+  Config::SetGlobal ("LteEnbMacSchedulerThreads", UintegerValue (threads));
+
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper> ();
+  lteHelper->SetEpcHelper (epcHelper);
+  lteHelper->SetAttribute ("PathlossModel", StringValue ("ns3::FriisSpectrumPropagationLossModel"));
+  lteHelper->SetSchedulerType (m_schedulerType);
+
+  NodeContainer enbNodes;
+  NodeContainer ueNodes;
+  enbNodes.Create (3);
+  ueNodes.Create (12);
+
+  // three neighbouring cells, whose UEs are at different distances
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+  for (uint32_t i = 0; i < enbNodes.GetN (); i++)
+    {
+      enbNodes.Get (i)->GetObject<MobilityModel> ()->SetPosition (Vector (1000.0 * i, 0.0, 0.0));
+    }
+  for (uint32_t j = 0; j < ueNodes.GetN (); j++)
+    {
+      ueNodes.Get (j)->GetObject<MobilityModel> ()->SetPosition (Vector (1000.0 * (j % 3), 100.0 + 50.0 * (j / 3), 0.0));
+    }
+
+  NetDeviceContainer enbDevs = lteHelper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueDevs = lteHelper->InstallUeDevice (ueNodes);
+  lteHelper->AssignStreams (enbDevs, 1);
+  lteHelper->AssignStreams (ueDevs, 1000);
+
+  // a remote host sending to each UE, and receiving from it, through the EPC
+  Ptr<Node> remoteHost = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (remoteHost);
+  internet.Install (ueNodes);
+  PointToPointHelper p2ph;
+  p2ph.SetDeviceAttribute ("DataRate", DataRateValue (DataRate ("100Gb/s")));
+  NetDeviceContainer internetDevices = p2ph.Install (epcHelper->GetPgwNode (), remoteHost);
+  Ipv4AddressHelper ipv4h;
+  ipv4h.SetBase ("1.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign (internetDevices);
+  Ipv4Address remoteHostAddr = internetIpIfaces.GetAddress (1);
+  Ipv4StaticRoutingHelper ipv4RoutingHelper;
+  ipv4RoutingHelper.GetStaticRouting (remoteHost->GetObject<Ipv4> ())
+    ->AddNetworkRouteTo (Ipv4Address ("7.0.0.0"), Ipv4Mask ("255.0.0.0"), 1);
+  Ipv4InterfaceContainer ueIpIfaces = epcHelper->AssignUeIpv4Address (ueDevs);
+
+  ApplicationContainer apps;
+  for (uint32_t j = 0; j < ueDevs.GetN (); j++)
+    {
+      ipv4RoutingHelper.GetStaticRouting (ueNodes.Get (j)->GetObject<Ipv4> ())
+        ->SetDefaultRoute (epcHelper->GetUeDefaultGatewayAddress (), 1);
+      lteHelper->Attach (ueDevs.Get (j), enbDevs.Get (j % 3));
+
+      // enough traffic, in both directions, for the UEs to compete for the RBs
+      uint16_t port = 1000 + j;
+      PacketSinkHelper sink ("ns3::UdpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+      apps.Add (sink.Install (ueNodes.Get (j)));
+      apps.Add (sink.Install (remoteHost));
+      UdpClientHelper dlClient (ueIpIfaces.GetAddress (j), port);
+      dlClient.SetAttribute ("Interval", TimeValue (MilliSeconds (1)));
+      dlClient.SetAttribute ("MaxPackets", UintegerValue (1000000));
+      dlClient.SetAttribute ("PacketSize", UintegerValue (200 + 100 * j));
+      apps.Add (dlClient.Install (remoteHost));
+      UdpClientHelper ulClient (remoteHostAddr, port);
+      ulClient.SetAttribute ("Interval", TimeValue (MilliSeconds (1)));
+      ulClient.SetAttribute ("MaxPackets", UintegerValue (1000000));
+      ulClient.SetAttribute ("PacketSize", UintegerValue (100 + 50 * j));
+      apps.Add (ulClient.Install (ueNodes.Get (j)));
+    }
+  apps.Start (MilliSeconds (50));
+
+  std::vector<std::ostringstream> logs (enbDevs.GetN ());
+  for (uint32_t i = 0; i < enbDevs.GetN (); i++)
+    {
+      Ptr<LteEnbMac> mac = enbDevs.Get (i)->GetObject<LteEnbNetDevice> ()->GetMac ();
+      mac->TraceConnectWithoutContext ("DlScheduling", MakeBoundCallback (&DlScheduling, &logs[i]));
+      mac->TraceConnectWithoutContext ("UlScheduling", MakeBoundCallback (&UlScheduling, &logs[i]));
+    }
+  if (m_reportBuffers)
+    {
+      m_enbDevs = enbDevs;
+      m_ueDevs = ueDevs;
+      m_lastReport = Seconds (0);
+      enbDevs.Get (0)->GetObject<LteEnbNetDevice> ()->GetPhy ()
+        ->TraceConnectWithoutContext ("DlPhyTransmission", MakeCallback (&LteParallelSchedulingTestCase::ReportBuffers, this));
+    }
+
+  Simulator::Stop (Seconds (0.3));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_enbDevs = NetDeviceContainer ();
+  m_ueDevs = NetDeviceContainer ();
+
+  std::vector<std::string> result;
+  for (uint32_t i = 0; i < logs.size (); i++)
+    {
+      result.push_back (logs[i].str ());
+    }
+  return result;
+}
+
+uint32_t
+LteParallelSchedulingTestCase::CountRntis (const std::string &log, const std::string &direction)
+{
+  std::set<uint16_t> rntis;
+  std::istringstream lines (log);
+  std::string line;
+  while (std::getline (lines, line))
+    {
+      std::istringstream fields (line);
+      std::string dir;
+      uint32_t frameNo, subframeNo, rnti;
+      fields >> dir >> frameNo >> subframeNo >> rnti;
+      if (dir == direction)
+        {
+          rntis.insert (rnti);
+        }
+    }
+  return rntis.size ();
+}
+
+void
+LteParallelSchedulingTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::LteHelper::UseIdealRrc", BooleanValue (true));
+
+  // the decisions taken in the subframe indications, as without threads
+  std::vector<std::string> reference = RunScenario (0);
+  std::vector<std::string> parallel = RunScenario (4);
+  Config::SetGlobal ("LteEnbMacSchedulerThreads", UintegerValue (0));
+
+  NS_TEST_ASSERT_MSG_EQ (reference.size (), parallel.size (), "wrong number of eNBs");
+  for (uint32_t i = 0; i < reference.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (CountRntis (reference[i], "DL"), 4, "not all the UEs of eNB " << i << " are scheduled in DL");
+      NS_TEST_ASSERT_MSG_EQ (CountRntis (reference[i], "UL"), 4, "not all the UEs of eNB " << i << " are scheduled in UL");
+      NS_TEST_ASSERT_MSG_EQ (parallel[i], reference[i], "different decisions of eNB " << i << " with 4 threads");
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test suite of the parallel scheduling of the eNBs
+ */
+class LteParallelSchedulingTestSuite : public TestSuite
+{
+public:
+  LteParallelSchedulingTestSuite ();
+};
+
+LteParallelSchedulingTestSuite::LteParallelSchedulingTestSuite ()
+  : TestSuite ("lte-parallel-scheduling", SYSTEM)
+{
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::PfFfMacScheduler", false), TestCase::QUICK);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::PssFfMacScheduler", false), TestCase::QUICK);
+  AddTestCase (new LteParallelSchedulingTestCase ("ns3::PfFfMacScheduler", true), TestCase::QUICK);
+}
+
+static LteParallelSchedulingTestSuite g_lteParallelSchedulingTestSuite; ///< the test suite
@@ -0,0 +1,177 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/rnti-map.h"
+#include "ns3/random-variable-stream.h"
+
+#include <map>
+
+using namespace ns3;
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Test case checking that RntiMap behaves as the std::map it
+ * replaces in the schedulers, under random insertions and erasures.
+ */
+class LteRntiMapTestCase : public TestCase
+{
+public:
+  LteRntiMapTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check that both maps hold the same UEs, in the same order.
+   * \param map the RntiMap
+   * \param ref the reference map
+   * \param step the number of the check
+   */
+  void Check (const RntiMap <uint32_t> &map, const std::map <uint16_t, uint32_t> &ref, uint32_t step);
+};
+
+LteRntiMapTestCase::LteRntiMapTestCase ()
+  : TestCase ("Check RntiMap against std::map")
+{
+}
+
+void
+LteRntiMapTestCase::Check (const RntiMap <uint32_t> &map, const std::map <uint16_t, uint32_t> &ref, uint32_t step)
+{
+  NS_TEST_ASSERT_MSG_EQ (map.size (), ref.size (), "step " << step << ": wrong size");
+  RntiMap <uint32_t>::const_iterator it = map.begin ();
+  for (std::map <uint16_t, uint32_t>::const_iterator refIt = ref.begin (); refIt != ref.end (); refIt++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((it != map.end ()), true, "step " << step << ": missing RNTI " << refIt->first);
+      NS_TEST_ASSERT_MSG_EQ (it->first, refIt->first, "step " << step << ": wrong RNTI");
+      NS_TEST_ASSERT_MSG_EQ (it->second, refIt->second, "step " << step << ": wrong value of RNTI " << refIt->first);
+      NS_TEST_ASSERT_MSG_EQ (map.count (refIt->first), 1u, "step " << step << ": RNTI " << refIt->first << " not found");
+      it++;
+    }
+  NS_TEST_ASSERT_MSG_EQ ((it == map.end ()), true, "step " << step << ": extra RNTI");
+}
+
+void
+LteRntiMapTestCase::DoRun (void)
+{
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  RntiMap <uint32_t> map;
+  std::map <uint16_t, uint32_t> ref;
+  Check (map, ref, 0);
+
+  for (uint32_t step = 1; step <= 2000; step++)
+    {
+      // RNTIs mostly allocated in a sliding range, as done by the eNB
+      uint16_t base = (step / 4) % 60000;
+      uint16_t rnti = base + random->GetInteger (0, 200);
+      uint32_t value = random->GetInteger (0, 1000);
+      switch (random->GetInteger (0, 4))
+        {
+        case 0:
+          {
+            bool inserted = map.insert (std::pair <uint16_t, uint32_t> (rnti, value)).second;
+            NS_TEST_ASSERT_MSG_EQ (inserted, ref.insert (std::pair <uint16_t, uint32_t> (rnti, value)).second,
+                                   "step " << step << ": wrong insertion of RNTI " << rnti);
+            break;
+          }
+        case 1:
+          map[rnti] = value;
+          ref[rnti] = value;
+          break;
+        case 2:
+          NS_TEST_ASSERT_MSG_EQ (map.erase (rnti), ref.erase (rnti), "step " << step << ": wrong erasure of RNTI " << rnti);
+          break;
+        case 3:
+          {
+            // erase while iterating, as the schedulers do on timeouts,
+            // and insert, before or after the current UE
+            RntiMap <uint32_t>::iterator it = map.begin ();
+            while (it != map.end ())
+              {
+                if (it->second % 3 == 0)
+                  {
+                    RntiMap <uint32_t>::iterator temp = it;
+                    it++;
+                    ref.erase (temp->first);
+                    map.erase (temp);
+                  }
+                else
+                  {
+                    if (it->second % 7 == 0)
+                      {
+                        map[rnti] = value;
+                        ref[rnti] = value;
+                      }
+                    it->second++;
+                    ref[it->first]++;
+                    it++;
+                  }
+              }
+            break;
+          }
+        default:
+          {
+            RntiMap <uint32_t>::iterator it = map.find (rnti);
+            NS_TEST_ASSERT_MSG_EQ ((it == map.end ()), (ref.find (rnti) == ref.end ()),
+                                   "step " << step << ": wrong search of RNTI " << rnti);
+            if (it != map.end ())
+              {
+                it = map.erase (it);
+                std::map <uint16_t, uint32_t>::iterator refIt = ref.erase (ref.find (rnti));
+                NS_TEST_ASSERT_MSG_EQ ((it == map.end ()), (refIt == ref.end ()), "step " << step << ": wrong next RNTI");
+                if (it != map.end ())
+                  {
+                    NS_TEST_ASSERT_MSG_EQ (it->first, refIt->first, "step " << step << ": wrong next RNTI");
+                  }
+              }
+            break;
+          }
+        }
+      Check (map, ref, step);
+    }
+
+  map.clear ();
+  ref.clear ();
+  Check (map, ref, 2001);
+  NS_TEST_ASSERT_MSG_EQ (map.empty (), true, "the map is not empty after clear");
+  map[7] = 1;
+  Check (map, std::map <uint16_t, uint32_t> {{7, 1}}, 2002);
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief RntiMap test suite
+ */
+class LteRntiMapTestSuite : public TestSuite
+{
+public:
+  LteRntiMapTestSuite ();
+};
+
+LteRntiMapTestSuite::LteRntiMapTestSuite ()
+  : TestSuite ("lte-rnti-map", UNIT)
+{
+  AddTestCase (new LteRntiMapTestCase, TestCase::QUICK);
+}
+
+static LteRntiMapTestSuite g_lteRntiMapTestSuite; ///< the test suite
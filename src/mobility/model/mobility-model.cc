@@ -21,6 +21,7 @@
 #include <cmath>
 
 #include "mobility-model.h"
+#include "mobility-snapshot.h"
 #include "ns3/trace-source-accessor.h"
 
 namespace ns3 {
@@ -53,6 +54,8 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_snapshot (0),
+    m_snapshotIndex (0)
 {
 }
 
@@ -63,6 +66,10 @@ MobilityModel::~MobilityModel ()
 Vector
 MobilityModel::GetPosition (void) const
 {
+  if (m_snapshot != 0)
+    {
+      return m_snapshot->GetPosition (m_snapshotIndex);
+    }
   return DoGetPosition ();
 }
 Vector
@@ -81,6 +88,10 @@ MobilityModel::DoGetPositionWithReference (const Vector& referencePosition) cons
 Vector
 MobilityModel::GetVelocity (void) const
 {
+  if (m_snapshot != 0)
+    {
+      return m_snapshot->GetVelocity (m_snapshotIndex);
+    }
   return DoGetVelocity ();
 }
 
@@ -88,13 +99,21 @@ void
 MobilityModel::SetPosition (const Vector &position)
 {
   DoSetPosition (position);
+  if (m_snapshot != 0)
+    {
+      m_snapshot->Invalidate (m_snapshotIndex);
+    }
 }
 
 double 
 MobilityModel::GetDistanceFrom (Ptr<const MobilityModel> other) const
 {
-  Vector oPosition = other->DoGetPosition ();
-  Vector position = DoGetPosition ();
+  if (m_snapshot != 0 && m_snapshot == other->m_snapshot)
+    {
+      return m_snapshot->GetDistance (m_snapshotIndex, other->m_snapshotIndex);
+    }
+  Vector oPosition = other->GetPosition ();
+  Vector position = GetPosition ();
   return CalculateDistance (position, oPosition);
 }
 
@@ -107,6 +126,10 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  if (m_snapshot != 0)
+    {
+      m_snapshot->Invalidate (m_snapshotIndex);
+    }
   m_courseChangeTrace (this);
 }
 
@@ -26,6 +26,8 @@
 
 namespace ns3 {
 
+class MobilitySnapshot;
+
 /**
  * \ingroup mobility
  * \brief Keep track of the current position and velocity of an object.
@@ -35,6 +37,9 @@ namespace ns3 {
  * metric international units.
  *
  * This is a base class for all specific mobility models.
+ *
+ * When the model is added to a MobilitySnapshot, the position and the
+ * velocity are served from the snapshot.
  */
 class MobilityModel : public Object
 {
@@ -108,6 +113,8 @@ protected:
    */
   void NotifyCourseChange (void) const;
 private:
+  friend class MobilitySnapshot;
+
   /**
    * \return the current position.
    *
@@ -152,6 +159,9 @@ private:
    */
   ns3::TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  MobilitySnapshot *m_snapshot; //!< the snapshot caching the position, if any
+  uint32_t m_snapshotIndex;     //!< the index of this model in the snapshot
+
 };
 
 Ptr<MobilityModel>
@@ -0,0 +1,213 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+
+#include "mobility-snapshot.h"
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilitySnapshot");
+
+NS_OBJECT_ENSURE_REGISTERED (MobilitySnapshot);
+
+TypeId
+MobilitySnapshot::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MobilitySnapshot")
+    .SetParent<Object> ()
+    .SetGroupName ("Mobility")
+    .AddConstructor<MobilitySnapshot> ()
+  ;
+  return tid;
+}
+
+MobilitySnapshot::MobilitySnapshot ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilitySnapshot::~MobilitySnapshot ()
+{
+  NS_LOG_FUNCTION (this);
+  // The models may outlive a snapshot which was not disposed
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_models.begin (); i != m_models.end (); ++i)
+    {
+      (*i)->m_snapshot = 0;
+    }
+}
+
+void
+MobilitySnapshot::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::iterator i = m_models.begin (); i != m_models.end (); ++i)
+    {
+      (*i)->m_snapshot = 0;
+    }
+  m_models.clear ();
+  m_times.clear ();
+  m_x.clear ();
+  m_y.clear ();
+  m_z.clear ();
+  m_vx.clear ();
+  m_vy.clear ();
+  m_vz.clear ();
+  Object::DoDispose ();
+}
+
+uint32_t
+MobilitySnapshot::Add (Ptr<MobilityModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  NS_ASSERT_MSG (model->m_snapshot == 0, "The mobility model is already in a snapshot");
+  uint32_t i = m_models.size ();
+  m_models.push_back (model);
+  m_times.push_back (-1);
+  m_x.push_back (0);
+  m_y.push_back (0);
+  m_z.push_back (0);
+  m_vx.push_back (0);
+  m_vy.push_back (0);
+  m_vz.push_back (0);
+  model->m_snapshot = this;
+  model->m_snapshotIndex = i;
+  return i;
+}
+
+uint32_t
+MobilitySnapshot::GetN (void) const
+{
+  return m_models.size ();
+}
+
+Ptr<MobilityModel>
+MobilitySnapshot::Get (uint32_t i) const
+{
+  NS_ASSERT (i < m_models.size ());
+  return m_models[i];
+}
+
+bool
+MobilitySnapshot::GetIndex (Ptr<const MobilityModel> model, uint32_t *index) const
+{
+  if (model->m_snapshot != this)
+    {
+      return false;
+    }
+  *index = model->m_snapshotIndex;
+  return true;
+}
+
+void
+MobilitySnapshot::Invalidate (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  m_times[i] = -1;
+}
+
+void
+MobilitySnapshot::UpdateOne (uint32_t i, int64_t now) const
+{
+  if (m_times[i] == now)
+    {
+      return;
+    }
+  NS_LOG_LOGIC ("update " << i << " at " << now);
+  const MobilityModel *model = PeekPointer (m_models[i]);
+  Vector position = model->DoGetPosition ();
+  Vector velocity = model->DoGetVelocity ();
+  m_x[i] = position.x;
+  m_y[i] = position.y;
+  m_z[i] = position.z;
+  m_vx[i] = velocity.x;
+  m_vy[i] = velocity.y;
+  m_vz[i] = velocity.z;
+  m_times[i] = now;
+}
+
+Vector
+MobilitySnapshot::GetPosition (uint32_t i) const
+{
+  NS_ASSERT (i < m_models.size ());
+  UpdateOne (i, Simulator::Now ().GetTimeStep ());
+  return Vector (m_x[i], m_y[i], m_z[i]);
+}
+
+Vector
+MobilitySnapshot::GetVelocity (uint32_t i) const
+{
+  NS_ASSERT (i < m_models.size ());
+  UpdateOne (i, Simulator::Now ().GetTimeStep ());
+  return Vector (m_vx[i], m_vy[i], m_vz[i]);
+}
+
+double
+MobilitySnapshot::GetDistance (uint32_t i, uint32_t j) const
+{
+  NS_ASSERT (i < m_models.size () && j < m_models.size ());
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  UpdateOne (i, now);
+  UpdateOne (j, now);
+  double dx = m_x[i] - m_x[j];
+  double dy = m_y[i] - m_y[j];
+  double dz = m_z[i] - m_z[j];
+  return std::sqrt (dx * dx + dy * dy + dz * dz);
+}
+
+void
+MobilitySnapshot::GetPositions (const std::vector<uint32_t> &indices,
+                                std::vector<Vector> &positions) const
+{
+  NS_LOG_FUNCTION (this << indices.size ());
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  positions.resize (indices.size ());
+  for (std::size_t k = 0; k < indices.size (); k++)
+    {
+      uint32_t i = indices[k];
+      NS_ASSERT (i < m_models.size ());
+      UpdateOne (i, now);
+      positions[k] = Vector (m_x[i], m_y[i], m_z[i]);
+    }
+}
+
+void
+MobilitySnapshot::GetPositions (std::vector<Vector> &positions) const
+{
+  NS_LOG_FUNCTION (this);
+  Update ();
+  positions.resize (m_models.size ());
+  for (std::size_t i = 0; i < m_models.size (); i++)
+    {
+      positions[i] = Vector (m_x[i], m_y[i], m_z[i]);
+    }
+}
+
+void
+MobilitySnapshot::Update (void) const
+{
+  NS_LOG_FUNCTION (this);
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      UpdateOne (i, now);
+    }
+}
+
+} // namespace ns3
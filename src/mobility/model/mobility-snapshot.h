@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_SNAPSHOT_H
+#define MOBILITY_SNAPSHOT_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/vector.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Cache of the positions and velocities of a set of mobility
+ * models, computed once per simulation time instant.
+ *
+ * Once a mobility model is added to a snapshot, MobilityModel::GetPosition,
+ * MobilityModel::GetVelocity and MobilityModel::GetDistanceFrom return
+ * the values cached in the snapshot.  The position and velocity of a
+ * model are computed by the model the first time they are requested at
+ * a given simulation time, and again only after the model notifies a
+ * course change or its position is set.  Channels which compute the
+ * distance of each pair of nodes for each frame thus compute the
+ * position of each node once per time instant, without any change.
+ *
+ * The positions and velocities are stored in arrays, by coordinate,
+ * and GetPositions returns the positions of a set of models in one
+ * pass over these arrays.
+ *
+ * The mobility models are not changed, but they must notify a course
+ * change whenever their position stops following the course computed
+ * previously, as required for the CourseChange trace source.  A mobility
+ * model can be added to one snapshot only.
+ */
+class MobilitySnapshot : public Object
+{
+public:
+  /**
+   * Register this type with the TypeId system.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MobilitySnapshot ();
+  virtual ~MobilitySnapshot ();
+
+  /**
+   * \param model the mobility model to add.
+   * \return the index of the model in the snapshot.
+   */
+  uint32_t Add (Ptr<MobilityModel> model);
+  /**
+   * \return the number of mobility models in the snapshot.
+   */
+  uint32_t GetN (void) const;
+  /**
+   * \param i the index of a mobility model.
+   * \return the mobility model.
+   */
+  Ptr<MobilityModel> Get (uint32_t i) const;
+  /**
+   * \param model a mobility model.
+   * \param [out] index the index of the model in this snapshot.
+   * \return true if the model is in this snapshot.
+   */
+  bool GetIndex (Ptr<const MobilityModel> model, uint32_t *index) const;
+
+  /**
+   * \param i the index of a mobility model.
+   * \return the current position of the model.
+   */
+  Vector GetPosition (uint32_t i) const;
+  /**
+   * \param i the index of a mobility model.
+   * \return the current velocity of the model.
+   */
+  Vector GetVelocity (uint32_t i) const;
+  /**
+   * \param i the index of a mobility model.
+   * \param j the index of another mobility model.
+   * \return the current distance between the two models. Unit is meters.
+   */
+  double GetDistance (uint32_t i, uint32_t j) const;
+  /**
+   * \brief Get the current positions of a set of mobility models.
+   * \param indices the indices of the mobility models.
+   * \param [out] positions the positions of the models, in the order
+   * of the indices.
+   */
+  void GetPositions (const std::vector<uint32_t> &indices,
+                     std::vector<Vector> &positions) const;
+  /**
+   * \brief Get the current positions of all the mobility models.
+   * \param [out] positions the positions of the models, by index.
+   */
+  void GetPositions (std::vector<Vector> &positions) const;
+
+  /**
+   * \brief Compute the current position and velocity of all the
+   * mobility models whose cached values are out of date.
+   */
+  void Update (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  friend class MobilityModel;
+
+  /**
+   * \brief Discard the cached position and velocity of a model.
+   * \param i the index of the model.
+   */
+  void Invalidate (uint32_t i);
+  /**
+   * \brief Compute the position and velocity of a model, if the
+   * cached values are out of date.
+   * \param i the index of the model.
+   * \param now the current simulation time, in time steps.
+   */
+  void UpdateOne (uint32_t i, int64_t now) const;
+
+  std::vector<Ptr<MobilityModel> > m_models; //!< the mobility models
+  mutable std::vector<int64_t> m_times;      //!< time of the cached values, -1 if none
+  mutable std::vector<double> m_x;           //!< x coordinates of the positions
+  mutable std::vector<double> m_y;           //!< y coordinates of the positions
+  mutable std::vector<double> m_z;           //!< z coordinates of the positions
+  mutable std::vector<double> m_vx;          //!< x coordinates of the velocities
+  mutable std::vector<double> m_vy;          //!< y coordinates of the velocities
+  mutable std::vector<double> m_vz;          //!< z coordinates of the velocities
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_SNAPSHOT_H */
@@ -0,0 +1,260 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/simulator.h"
+#include "ns3/mobility-snapshot.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/waypoint-mobility-model.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief MobilitySnapshot Test
+ */
+class MobilitySnapshotTestCase : public TestCase
+{
+public:
+  MobilitySnapshotTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+
+  /**
+   * Check the positions served by the snapshot.
+   * \param step the number of the check.
+   */
+  void Check (uint32_t step);
+  /**
+   * Change the course of the models, and check the snapshot serves
+   * the new positions at the same time.
+   */
+  void ChangeCourse (void);
+
+  Ptr<MobilitySnapshot> m_snapshot;                         //!< the snapshot
+  std::vector<Ptr<ConstantVelocityMobilityModel> > m_cvs;   //!< models moving at constant velocity
+  Ptr<ConstantPositionMobilityModel> m_fixed;               //!< a model which does not move
+  Ptr<WaypointMobilityModel> m_waypoint;                    //!< a model following waypoints
+  Ptr<WaypointMobilityModel> m_reference;                   //!< the same waypoints, not in the snapshot
+};
+
+MobilitySnapshotTestCase::MobilitySnapshotTestCase ()
+  : TestCase ("Check the positions served by MobilitySnapshot")
+{
+}
+
+void
+MobilitySnapshotTestCase::DoTeardown (void)
+{
+  m_snapshot = 0;
+  m_cvs.clear ();
+  m_fixed = 0;
+  m_waypoint = 0;
+  m_reference = 0;
+}
+
+void
+MobilitySnapshotTestCase::Check (uint32_t step)
+{
+  double t = Simulator::Now ().GetSeconds ();
+  for (uint32_t i = 0; i < m_cvs.size (); i++)
+    {
+      Vector expected (i + t, 2.0 * i, -t * i);
+      // twice, the second time from the cache
+      for (uint32_t k = 0; k < 2; k++)
+        {
+          Vector position = m_cvs[i]->GetPosition ();
+          NS_TEST_EXPECT_MSG_LT (CalculateDistance (position, expected), 1e-9,
+                                 "step " << step << ": wrong position of model " << i);
+        }
+      NS_TEST_EXPECT_MSG_LT (CalculateDistance (m_cvs[i]->GetVelocity (), Vector (1, 0, -1.0 * i)), 1e-9,
+                             "step " << step << ": wrong velocity of model " << i);
+      NS_TEST_EXPECT_MSG_EQ_TOL (m_cvs[i]->GetDistanceFrom (m_fixed),
+                                 CalculateDistance (expected, Vector (-5, 0, 0)), 1e-9,
+                                 "step " << step << ": wrong distance of model " << i);
+    }
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (m_waypoint->GetPosition (), m_reference->GetPosition ()), 1e-9,
+                         "step " << step << ": wrong position of the waypoint model");
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (m_waypoint->GetVelocity (), m_reference->GetVelocity ()), 1e-9,
+                         "step " << step << ": wrong velocity of the waypoint model");
+
+  // bulk positions, in the order requested
+  std::vector<uint32_t> indices;
+  for (uint32_t i = m_snapshot->GetN (); i > 0; i--)
+    {
+      indices.push_back (i - 1);
+    }
+  std::vector<Vector> positions;
+  m_snapshot->GetPositions (indices, positions);
+  NS_TEST_ASSERT_MSG_EQ (positions.size (), indices.size (), "wrong number of positions");
+  for (uint32_t k = 0; k < indices.size (); k++)
+    {
+      Vector position = m_snapshot->Get (indices[k])->GetPosition ();
+      NS_TEST_EXPECT_MSG_LT (CalculateDistance (positions[k], position), 1e-9,
+                             "step " << step << ": wrong bulk position " << k);
+    }
+  m_snapshot->GetPositions (positions);
+  NS_TEST_ASSERT_MSG_EQ (positions.size (), m_snapshot->GetN (), "wrong number of positions");
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (positions[m_snapshot->GetN () - 1], m_waypoint->GetPosition ()), 1e-9,
+                         "step " << step << ": wrong bulk position of the waypoint model");
+}
+
+void
+MobilitySnapshotTestCase::ChangeCourse (void)
+{
+  // The positions are cached at this time instant
+  Vector before = m_cvs[1]->GetPosition ();
+  m_snapshot->Update ();
+
+  m_cvs[1]->SetVelocity (Vector (0, 0, 0));
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (m_cvs[1]->GetPosition (), before), 1e-9,
+                         "position changed by a new velocity");
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (m_cvs[1]->GetVelocity (), Vector (0, 0, 0)), 1e-9,
+                         "cached velocity not updated");
+
+  m_cvs[2]->SetPosition (Vector (100, 0, 0));
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (m_cvs[2]->GetPosition (), Vector (100, 0, 0)), 1e-9,
+                         "cached position not updated");
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_cvs[2]->GetDistanceFrom (m_cvs[1]), CalculateDistance (Vector (100, 0, 0), before), 1e-9,
+                             "cached distance not updated");
+
+  // The models serve their own positions once the snapshot is disposed
+  m_snapshot->Dispose ();
+  uint32_t index;
+  NS_TEST_EXPECT_MSG_EQ (m_snapshot->GetIndex (m_cvs[2], &index), false, "model still in a disposed snapshot");
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (m_cvs[2]->GetPosition (), Vector (100, 0, 0)), 1e-9,
+                         "wrong position after disposing the snapshot");
+}
+
+void
+MobilitySnapshotTestCase::DoRun (void)
+{
+  m_snapshot = CreateObject<MobilitySnapshot> ();
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Ptr<ConstantVelocityMobilityModel> cv = CreateObject<ConstantVelocityMobilityModel> ();
+      cv->SetPosition (Vector (i, 2.0 * i, 0));
+      cv->SetVelocity (Vector (1, 0, -1.0 * i));
+      uint32_t index = m_snapshot->Add (cv);
+      NS_TEST_ASSERT_MSG_EQ (index, i, "wrong index");
+      m_cvs.push_back (cv);
+    }
+  m_fixed = CreateObject<ConstantPositionMobilityModel> ();
+  m_fixed->SetPosition (Vector (-5, 0, 0));
+  m_snapshot->Add (m_fixed);
+
+  m_waypoint = CreateObject<WaypointMobilityModel> ();
+  m_reference = CreateObject<WaypointMobilityModel> ();
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Waypoint waypoint (Seconds (i), Vector (i * i, 10.0 - i, 1));
+      m_waypoint->AddWaypoint (waypoint);
+      m_reference->AddWaypoint (waypoint);
+    }
+  m_snapshot->Add (m_waypoint);
+
+  uint32_t index;
+  NS_TEST_ASSERT_MSG_EQ (m_snapshot->GetIndex (m_fixed, &index), true, "model not found");
+  NS_TEST_ASSERT_MSG_EQ (index, 4, "wrong index");
+  NS_TEST_ASSERT_MSG_EQ (m_snapshot->GetIndex (m_reference, &index), false, "unexpected model found");
+
+  Simulator::Schedule (Seconds (0), &MobilitySnapshotTestCase::Check, this, 0);
+  Simulator::Schedule (Seconds (0.5), &MobilitySnapshotTestCase::Check, this, 1);
+  Simulator::Schedule (Seconds (1), &MobilitySnapshotTestCase::Check, this, 2);
+  Simulator::Schedule (Seconds (2.25), &MobilitySnapshotTestCase::Check, this, 3);
+  Simulator::Schedule (Seconds (7), &MobilitySnapshotTestCase::Check, this, 4);
+  Simulator::Schedule (Seconds (8), &MobilitySnapshotTestCase::ChangeCourse, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the models of a snapshot freed without being disposed
+ * compute their own position.
+ */
+class MobilitySnapshotReleaseTestCase : public TestCase
+{
+public:
+  MobilitySnapshotReleaseTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MobilitySnapshotReleaseTestCase::MobilitySnapshotReleaseTestCase ()
+  : TestCase ("Check the models of a freed MobilitySnapshot")
+{
+}
+
+void
+MobilitySnapshotReleaseTestCase::DoRun (void)
+{
+  Ptr<ConstantVelocityMobilityModel> cv = CreateObject<ConstantVelocityMobilityModel> ();
+  cv->SetPosition (Vector (1, 2, 3));
+  cv->SetVelocity (Vector (1, 0, 0));
+
+  Ptr<MobilitySnapshot> snapshot = CreateObject<MobilitySnapshot> ();
+  snapshot->Add (cv);
+  NS_TEST_ASSERT_MSG_LT (CalculateDistance (cv->GetPosition (), Vector (1, 2, 3)), 1e-9,
+                         "wrong position in the snapshot");
+  // drop the last reference without calling Dispose
+  snapshot = 0;
+
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (cv->GetVelocity (), Vector (1, 0, 0)), 1e-9,
+                         "wrong velocity after freeing the snapshot");
+  cv->SetPosition (Vector (4, 5, 6));
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (cv->GetPosition (), Vector (4, 5, 6)), 1e-9,
+                         "wrong position after freeing the snapshot");
+
+  // the model can be added to another snapshot
+  snapshot = CreateObject<MobilitySnapshot> ();
+  snapshot->Add (cv);
+  uint32_t index;
+  NS_TEST_EXPECT_MSG_EQ (snapshot->GetIndex (cv, &index), true, "model not found");
+  NS_TEST_EXPECT_MSG_LT (CalculateDistance (cv->GetPosition (), Vector (4, 5, 6)), 1e-9,
+                         "wrong position in the new snapshot");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief MobilitySnapshot Test Suite
+ */
+class MobilitySnapshotTestSuite : public TestSuite
+{
+public:
+  MobilitySnapshotTestSuite ();
+};
+
+MobilitySnapshotTestSuite::MobilitySnapshotTestSuite ()
+  : TestSuite ("mobility-snapshot", UNIT)
+{
+  AddTestCase (new MobilitySnapshotTestCase, TestCase::QUICK);
+  AddTestCase (new MobilitySnapshotReleaseTestCase, TestCase::QUICK);
+}
+
+static MobilitySnapshotTestSuite g_mobilitySnapshotTestSuite; //!< Static variable for test initialization
@@ -74,10 +74,38 @@ NamespaceInfo::getOrCreateFaceInfo(FaceId faceId)
 }
 
 void
-NamespaceInfo::extendFaceInfoLifetime(FaceInfo& info, FaceId faceId)
+NamespaceInfo::extendFaceInfoLifetime(FaceInfo& info, FaceId)
 {
-  info.m_measurementExpiration = getScheduler().schedule(AsfMeasurements::MEASUREMENTS_LIFETIME,
-                                                         [=] { m_fiMap.erase(faceId); });
+  info.m_measurementExpiry = time::steady_clock::now() + AsfMeasurements::MEASUREMENTS_LIFETIME;
+
+  // All records share the same lifetime, so a pending expiration event never fires later
+  // than the new expiry and does not need to be moved
+  if (!m_expirationEvent) {
+    m_expirationEvent = getScheduler().schedule(AsfMeasurements::MEASUREMENTS_LIFETIME,
+                                                [this] { removeExpiredFaceInfos(); });
+  }
+}
+
+void
+NamespaceInfo::removeExpiredFaceInfos()
+{
+  auto now = time::steady_clock::now();
+  auto nextExpiry = time::steady_clock::TimePoint::max();
+
+  for (auto it = m_fiMap.begin(); it != m_fiMap.end();) {
+    if (it->second.m_measurementExpiry <= now) {
+      it = m_fiMap.erase(it);
+    }
+    else {
+      nextExpiry = std::min(nextExpiry, it->second.m_measurementExpiry);
+      ++it;
+    }
+  }
+
+  if (!m_fiMap.empty()) {
+    m_expirationEvent = getScheduler().schedule(nextExpiry - now,
+                                                [this] { removeExpiredFaceInfos(); });
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -112,8 +112,8 @@ private:
   Name m_lastInterestName;
   size_t m_nTimeouts = 0;
 
-  // Timeout associated with measurement
-  scheduler::ScopedEventId m_measurementExpiration;
+  // Expiration time of measurement, enforced by the owning NamespaceInfo
+  time::steady_clock::TimePoint m_measurementExpiry;
   friend class NamespaceInfo;
 
   // RTO associated with Interest
@@ -146,6 +146,11 @@ public:
   FaceInfo&
   getOrCreateFaceInfo(FaceId faceId);
 
+  /** \brief extends the lifetime of \p info to AsfMeasurements::MEASUREMENTS_LIFETIME from now
+   *
+   *  Expired FaceInfo records of a namespace are removed by a single timer shared by all faces,
+   *  instead of one timer per face that would be rescheduled on every forwarded Interest.
+   */
   void
   extendFaceInfoLifetime(FaceInfo& info, FaceId faceId);
 
@@ -173,9 +178,14 @@ public:
     m_isFirstProbeScheduled = isScheduled;
   }
 
+private:
+  void
+  removeExpiredFaceInfos();
+
 private:
   std::unordered_map<FaceId, FaceInfo> m_fiMap;
   shared_ptr<const ndn::util::RttEstimator::Options> m_rttEstimatorOpts;
+  scheduler::ScopedEventId m_expirationEvent;
   bool m_isProbingDue = false;
   bool m_isFirstProbeScheduled = false;
 };
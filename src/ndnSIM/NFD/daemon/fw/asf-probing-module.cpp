@@ -29,6 +29,8 @@
 
 #include <ndn-cxx/util/random.hpp>
 
+#include <algorithm>
+
 namespace nfd {
 namespace fw {
 namespace asf {
@@ -67,7 +69,9 @@ Face*
 ProbingModule::getFaceToProbe(const Face& inFace, const Interest& interest,
                               const fib::Entry& fibEntry, const Face& faceUsed)
 {
-  FaceInfoFacePairSet rankedFaces;
+  auto& rankedFaces = m_rankedFaces;
+  rankedFaces.clear();
+  NamespaceInfo* namespaceInfo = nullptr;
 
   // Put eligible faces into rankedFaces. If a face does not have an RTT measurement,
   // immediately pick the face for probing
@@ -81,14 +85,17 @@ ProbingModule::getFaceToProbe(const Face& inFace, const Interest& interest,
       continue;
     }
 
-    FaceInfo* info = m_measurements.getFaceInfo(fibEntry, interest.getName(), hopFace.getId());
+    if (namespaceInfo == nullptr) {
+      namespaceInfo = &m_measurements.getOrCreateNamespaceInfo(fibEntry, interest.getName());
+    }
+
+    FaceInfo* info = namespaceInfo->getFaceInfo(hopFace.getId());
     // If no RTT has been recorded, probe this face
     if (info == nullptr || info->getLastRtt() == FaceInfo::RTT_NO_MEASUREMENT) {
       return &hopFace;
     }
 
-    // Add FaceInfo to container sorted by RTT
-    rankedFaces.insert({info, &hopFace});
+    rankedFaces.emplace_back(info, &hopFace);
   }
 
   if (rankedFaces.empty()) {
@@ -96,6 +103,13 @@ ProbingModule::getFaceToProbe(const Face& inFace, const Interest& interest,
     return nullptr;
   }
 
+  // Sort by RTT, keeping only the first of equally ranked faces
+  FaceInfoCompare compare;
+  std::stable_sort(rankedFaces.begin(), rankedFaces.end(), compare);
+  rankedFaces.erase(std::unique(rankedFaces.begin(), rankedFaces.end(),
+                                [&] (const auto& a, const auto& b) { return !compare(a, b); }),
+                    rankedFaces.end());
+
   return chooseFace(rankedFaces);
 }
 
@@ -129,7 +143,7 @@ ProbingModule::afterForwardingProbe(const fib::Entry& fibEntry, const Name& inte
 }
 
 Face*
-ProbingModule::chooseFace(const FaceInfoFacePairSet& rankedFaces)
+ProbingModule::chooseFace(const FaceInfoFacePairList& rankedFaces)
 {
   static std::uniform_real_distribution<> randDist;
   double randomNumber = randDist(ndn::random::getRandomNumberEngine());
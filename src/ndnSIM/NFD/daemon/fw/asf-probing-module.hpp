@@ -80,10 +80,11 @@ private:
     }
   };
 
-  using FaceInfoFacePairSet = std::set<FaceInfoFacePair, FaceInfoCompare>;
+  // Sorted by FaceInfoCompare, containing at most one element of each equivalence class
+  using FaceInfoFacePairList = std::vector<FaceInfoFacePair>;
 
   static Face*
-  chooseFace(const FaceInfoFacePairSet& rankedFaces);
+  chooseFace(const FaceInfoFacePairList& rankedFaces);
 
   static double
   getProbingProbability(uint64_t rank, uint64_t rankSum, uint64_t nFaces);
@@ -95,6 +96,7 @@ public:
 private:
   time::milliseconds m_probingInterval;
   AsfMeasurements& m_measurements;
+  FaceInfoFacePairList m_rankedFaces; ///< reused by getFaceToProbe to avoid allocation
 };
 
 } // namespace asf
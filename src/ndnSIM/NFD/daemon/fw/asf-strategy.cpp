@@ -305,7 +305,10 @@ AsfStrategy::getBestFaceForForwarding(const Interest& interest, const Face& inFa
                                       const fib::Entry& fibEntry, const shared_ptr<pit::Entry>& pitEntry,
                                       bool isInterestNew)
 {
-  std::set<FaceStats, FaceStatsCompare> rankedFaces;
+  // Keep the first-ranked face in a single pass; on ties the earlier nexthop wins
+  FaceStats best{nullptr, FaceInfo::RTT_NO_MEASUREMENT, FaceInfo::RTT_NO_MEASUREMENT, 0};
+  FaceStatsCompare compare;
+  NamespaceInfo* namespaceInfo = nullptr;
 
   auto now = time::steady_clock::now();
   for (const auto& nh : fibEntry.getNextHops()) {
@@ -313,18 +316,25 @@ AsfStrategy::getBestFaceForForwarding(const Interest& interest, const Face& inFa
       continue;
     }
 
-    const FaceInfo* info = m_measurements.getFaceInfo(fibEntry, interest.getName(), nh.getFace().getId());
-    if (info == nullptr) {
-      rankedFaces.insert({&nh.getFace(), FaceInfo::RTT_NO_MEASUREMENT,
-                          FaceInfo::RTT_NO_MEASUREMENT, nh.getCost()});
+    // The namespace is the same for every nexthop, look it up once
+    if (namespaceInfo == nullptr) {
+      namespaceInfo = &m_measurements.getOrCreateNamespaceInfo(fibEntry, interest.getName());
     }
-    else {
-      rankedFaces.insert({&nh.getFace(), info->getLastRtt(), info->getSrtt(), nh.getCost()});
+
+    FaceStats stats{&nh.getFace(), FaceInfo::RTT_NO_MEASUREMENT,
+                    FaceInfo::RTT_NO_MEASUREMENT, nh.getCost()};
+    const FaceInfo* info = namespaceInfo->getFaceInfo(nh.getFace().getId());
+    if (info != nullptr) {
+      stats.rtt = info->getLastRtt();
+      stats.srtt = info->getSrtt();
+    }
+
+    if (best.face == nullptr || compare(stats, best)) {
+      best = stats;
     }
   }
 
-  auto it = rankedFaces.begin();
-  return it != rankedFaces.end() ? it->face : nullptr;
+  return best.face;
 }
 
 void
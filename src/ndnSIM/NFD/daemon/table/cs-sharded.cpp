@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cs-sharded.hpp"
+#include "name-tree-hashtable.hpp"
+#include "common/logger.hpp"
+
+namespace nfd {
+namespace cs {
+
+NFD_LOG_INIT(ShardedContentStore);
+
+/** \brief computes the capacity of shard \p i when \p nMaxPackets is divided among \p nShards
+ */
+static size_t
+computeShardLimit(size_t nMaxPackets, size_t nShards, size_t i)
+{
+  return nMaxPackets / nShards + (i < nMaxPackets % nShards ? 1 : 0);
+}
+
+ShardedCs::ShardedCs(size_t nMaxPackets, size_t nShards, size_t nKeyComponents)
+  : m_nKeyComponents(nKeyComponents)
+  , m_limit(nMaxPackets)
+{
+  BOOST_ASSERT(nShards > 0);
+  m_shards.reserve(nShards);
+  for (size_t i = 0; i < nShards; ++i) {
+    m_shards.push_back(make_unique<Shard>(computeShardLimit(nMaxPackets, nShards, i)));
+  }
+}
+
+/** \brief returns the number of components of \p name excluding the implicit digest, if any
+ */
+static size_t
+getNameLength(const Name& name)
+{
+  if (!name.empty() && name[-1].isImplicitSha256Digest()) {
+    return name.size() - 1;
+  }
+  return name.size();
+}
+
+size_t
+ShardedCs::getShardIndex(const Name& name) const
+{
+  return name_tree::computeHash(name, m_nKeyComponents) % m_shards.size();
+}
+
+void
+ShardedCs::insert(const Data& data, bool isUnsolicited)
+{
+  Shard& shard = *m_shards[getShardIndex(data.getName())];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.cs.insert(data, isUnsolicited);
+}
+
+size_t
+ShardedCs::eraseImpl(const Name& prefix, size_t limit)
+{
+  auto eraseFromShard = [&prefix, limit] (Shard& shard, size_t nErased) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    size_t n = 0;
+    shard.cs.erase(prefix, limit - nErased, [&n] (size_t nErased1) { n = nErased1; });
+    return n;
+  };
+
+  if (getNameLength(prefix) >= m_nKeyComponents) {
+    return eraseFromShard(*m_shards[getShardIndex(prefix)], 0);
+  }
+
+  size_t nErased = 0;
+  for (auto& shard : m_shards) {
+    if (nErased >= limit) {
+      break;
+    }
+    nErased += eraseFromShard(*shard, nErased);
+  }
+  NFD_LOG_DEBUG("erase " << prefix << " from all shards, erased " << nErased);
+  return nErased;
+}
+
+shared_ptr<const Data>
+ShardedCs::findInShard(const Shard& shard, const Interest& interest)
+{
+  shared_ptr<const Data> match;
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.cs.find(interest,
+                [&match] (const Interest&, const Data& data) { match = data.shared_from_this(); },
+                [] (const Interest&) {});
+  return match;
+}
+
+shared_ptr<const Data>
+ShardedCs::findImpl(const Interest& interest) const
+{
+  const Name& name = interest.getName();
+  if (getNameLength(name) >= m_nKeyComponents) {
+    return findInShard(*m_shards[getShardIndex(name)], interest);
+  }
+
+  // Every shard may contain Data under a short Name. Data with the same Name are always stored
+  // in the same shard, so comparing Names is sufficient to pick the first match in Name order.
+  shared_ptr<const Data> best;
+  for (const auto& shard : m_shards) {
+    auto match = findInShard(*shard, interest);
+    if (match != nullptr && (best == nullptr || match->getName() < best->getName())) {
+      best = std::move(match);
+    }
+  }
+  return best;
+}
+
+size_t
+ShardedCs::size() const
+{
+  size_t n = 0;
+  for (const auto& shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    n += shard->cs.size();
+  }
+  return n;
+}
+
+void
+ShardedCs::setLimit(size_t nMaxPackets)
+{
+  m_limit = nMaxPackets;
+  for (size_t i = 0; i < m_shards.size(); ++i) {
+    std::lock_guard<std::mutex> lock(m_shards[i]->mutex);
+    m_shards[i]->cs.setLimit(computeShardLimit(nMaxPackets, m_shards.size(), i));
+  }
+}
+
+void
+ShardedCs::enableAdmit(bool shouldAdmit)
+{
+  for (auto& shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->cs.enableAdmit(shouldAdmit);
+  }
+}
+
+void
+ShardedCs::enableServe(bool shouldServe)
+{
+  for (auto& shard : m_shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->cs.enableServe(shouldServe);
+  }
+}
+
+} // namespace cs
+} // namespace nfd
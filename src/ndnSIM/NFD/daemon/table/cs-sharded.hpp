@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_CS_SHARDED_HPP
+#define NFD_DAEMON_TABLE_CS_SHARDED_HPP
+
+#include "cs.hpp"
+
+#include <atomic>
+#include <mutex>
+
+namespace nfd {
+namespace cs {
+
+/** \brief implements a Content Store that can be accessed from multiple threads
+ *
+ *  This Content Store is partitioned into a number of shards. Each shard is a complete \c Cs,
+ *  with its own Table and replacement policy (LRU by default), guarded by its own mutex.
+ *
+ *  A Data packet is stored in the shard selected by the hash of the first \p nKeyComponents
+ *  components of its Name. An Interest whose Name has at least that many components can only
+ *  be satisfied by Data in the same shard, so its lookup locks a single shard. An Interest with
+ *  a shorter Name is looked up in every shard, and the match that comes first in Name order is
+ *  chosen, which is the same match a single \c Cs would return.
+ *
+ *  The capacity is divided evenly among shards, and each shard evicts independently.
+ *
+ *  All public methods may be invoked concurrently. Hit, miss, and erase callbacks are invoked
+ *  after every shard lock has been released.
+ */
+class ShardedCs : noncopyable
+{
+public:
+  explicit
+  ShardedCs(size_t nMaxPackets = 10, size_t nShards = 16, size_t nKeyComponents = 2);
+
+  /** \brief inserts a Data packet
+   */
+  void
+  insert(const Data& data, bool isUnsolicited = false);
+
+  /** \brief erases entries under \p prefix
+   *  \tparam AfterEraseCallback `void f(size_t nErased)`
+   *  \param prefix name prefix of entries
+   *  \param limit max number of entries to erase
+   *  \param cb callback to receive the actual number of erased entries; must not be empty
+   */
+  template<typename AfterEraseCallback>
+  void
+  erase(const Name& prefix, size_t limit, AfterEraseCallback&& cb)
+  {
+    size_t nErased = eraseImpl(prefix, limit);
+    cb(nErased);
+  }
+
+  /** \brief finds the best matching Data packet
+   *  \tparam HitCallback `void f(const Interest&, const Data&)`
+   *  \tparam MissCallback `void f(const Interest&)`
+   *  \param interest the Interest for lookup
+   *  \param hit a callback if a match is found; must not be empty
+   *  \param miss a callback if there's no match; must not be empty
+   *  \note A lookup invokes either callback exactly once, before find() returns.
+   *        The Data passed to \p hit remains valid even if it is evicted concurrently.
+   */
+  template<typename HitCallback, typename MissCallback>
+  void
+  find(const Interest& interest, HitCallback&& hit, MissCallback&& miss) const
+  {
+    shared_ptr<const Data> match = findImpl(interest);
+    if (match == nullptr) {
+      miss(interest);
+      return;
+    }
+    hit(interest, *match);
+  }
+
+  /** \brief get number of stored packets
+   */
+  size_t
+  size() const;
+
+  /** \brief get number of shards
+   */
+  size_t
+  getNShards() const
+  {
+    return m_shards.size();
+  }
+
+public: // configuration
+  /** \brief get capacity (in number of packets)
+   */
+  size_t
+  getLimit() const
+  {
+    return m_limit;
+  }
+
+  /** \brief change capacity (in number of packets)
+   *
+   *  The capacity is divided among shards; each shard may evict entries if necessary.
+   */
+  void
+  setLimit(size_t nMaxPackets);
+
+  /** \brief set CS_ENABLE_ADMIT flag on every shard
+   */
+  void
+  enableAdmit(bool shouldAdmit);
+
+  /** \brief set CS_ENABLE_SERVE flag on every shard
+   */
+  void
+  enableServe(bool shouldServe);
+
+NFD_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /** \brief determines the shard that stores Data named \p name
+   */
+  size_t
+  getShardIndex(const Name& name) const;
+
+private:
+  struct Shard
+  {
+    explicit
+    Shard(size_t nMaxPackets)
+      : cs(nMaxPackets)
+    {
+    }
+
+    mutable std::mutex mutex;
+    Cs cs;
+  };
+
+  size_t
+  eraseImpl(const Name& prefix, size_t limit);
+
+  shared_ptr<const Data>
+  findImpl(const Interest& interest) const;
+
+  static shared_ptr<const Data>
+  findInShard(const Shard& shard, const Interest& interest);
+
+private:
+  std::vector<unique_ptr<Shard>> m_shards;
+  const size_t m_nKeyComponents;
+  std::atomic<size_t> m_limit;
+};
+
+} // namespace cs
+
+using cs::ShardedCs;
+
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_CS_SHARDED_HPP
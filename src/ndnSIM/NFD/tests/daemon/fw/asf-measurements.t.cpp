@@ -91,6 +91,33 @@ BOOST_FIXTURE_TEST_CASE(NamespaceInfo, GlobalIoTimeFixture)
   BOOST_CHECK(info.getFaceInfo(1234) == nullptr); // expired
 }
 
+BOOST_FIXTURE_TEST_CASE(NamespaceInfoExtendLifetime, GlobalIoTimeFixture)
+{
+  using asf::NamespaceInfo;
+  NamespaceInfo info(nullptr);
+
+  info.getOrCreateFaceInfo(1);
+  this->advanceClocks(1_min);
+  info.getOrCreateFaceInfo(2);
+  this->advanceClocks(1_min);
+  auto& faceInfo1 = *info.getFaceInfo(1);
+  info.extendFaceInfoLifetime(faceInfo1, 1);
+
+  // face 2 expires first, although face 1 was created earlier
+  this->advanceClocks(AsfMeasurements::MEASUREMENTS_LIFETIME - 1_min + 1_s);
+  BOOST_CHECK(info.getFaceInfo(1) == &faceInfo1);
+  BOOST_CHECK(info.getFaceInfo(2) == nullptr);
+
+  // a record created after the others expired is kept for a full lifetime
+  this->advanceClocks(1_min);
+  BOOST_CHECK(info.getFaceInfo(1) == nullptr);
+  auto& faceInfo3 = info.getOrCreateFaceInfo(3);
+  this->advanceClocks(AsfMeasurements::MEASUREMENTS_LIFETIME - 1_s);
+  BOOST_CHECK(info.getFaceInfo(3) == &faceInfo3);
+  this->advanceClocks(2_s);
+  BOOST_CHECK(info.getFaceInfo(3) == nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END() // TestAsfStrategy
 BOOST_AUTO_TEST_SUITE_END() // Fw
 
@@ -0,0 +1,186 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2021,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "table/cs-sharded.hpp"
+
+#include "tests/test-common.hpp"
+#include "tests/daemon/global-io-fixture.hpp"
+
+#include <cstring>
+#include <thread>
+
+namespace nfd {
+namespace cs {
+namespace tests {
+
+using namespace nfd::tests;
+
+class ShardedCsFixture : public GlobalIoTimeFixture
+{
+protected:
+  Name
+  insert(uint32_t id, const Name& name)
+  {
+    auto data = makeData(name);
+    data->setContent(ndn::make_span(reinterpret_cast<const uint8_t*>(&id), sizeof(id)));
+    data->wireEncode();
+    cs.insert(*data);
+    return data->getFullName();
+  }
+
+  uint32_t
+  find(const Name& name, bool canBePrefix = false)
+  {
+    uint32_t found = 0;
+    cs.find(*makeInterest(name, canBePrefix),
+            [&] (const Interest&, const Data& data) {
+              std::memcpy(&found, data.getContent().value(), sizeof(found));
+            },
+            [] (auto&&...) {});
+    return found;
+  }
+
+protected:
+  ShardedCs cs{100, 8, 2};
+};
+
+BOOST_AUTO_TEST_SUITE(Table)
+BOOST_FIXTURE_TEST_SUITE(TestShardedCs, ShardedCsFixture)
+
+BOOST_AUTO_TEST_CASE(ShardByKeyPrefix)
+{
+  BOOST_CHECK_EQUAL(cs.getNShards(), 8);
+  BOOST_CHECK_EQUAL(cs.getShardIndex("/A/B"), cs.getShardIndex("/A/B/C"));
+  BOOST_CHECK_EQUAL(cs.getShardIndex("/A/B"), cs.getShardIndex("/A/B/C/D"));
+}
+
+BOOST_AUTO_TEST_CASE(FindInOneShard)
+{
+  insert(1, "/A/B");
+  insert(2, "/A/B/C");
+  insert(3, "/A/D");
+
+  BOOST_CHECK_EQUAL(find("/A/B"), 1);
+  BOOST_CHECK_EQUAL(find("/A/B/C"), 2);
+  BOOST_CHECK_EQUAL(find("/A/D", true), 3);
+  BOOST_CHECK_EQUAL(find("/A/E"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FindFullName)
+{
+  Name n1 = insert(1, "/A");
+  Name n2 = insert(2, "/A/B/C");
+
+  BOOST_CHECK_EQUAL(find(n1), 1);
+  BOOST_CHECK_EQUAL(find(n2), 2);
+}
+
+BOOST_AUTO_TEST_CASE(FindShortNameInAllShards)
+{
+  // these are likely spread over several shards
+  insert(1, "/A/Z");
+  insert(2, "/A/C/D");
+  insert(3, "/A/B");
+  insert(4, "/B/A");
+
+  // the leftmost match in Name order is chosen, as in a single Cs
+  BOOST_CHECK_EQUAL(find("/A", true), 3);
+  BOOST_CHECK_EQUAL(find("/B", true), 4);
+  BOOST_CHECK_EQUAL(find("/C", true), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Erase)
+{
+  insert(1, "/A/B");
+  insert(2, "/A/B/C");
+  insert(3, "/A/D");
+  insert(4, "/B/C");
+
+  size_t nErased = 0;
+  cs.erase("/A/B", 10, [&] (size_t n) { nErased = n; });
+  BOOST_CHECK_EQUAL(nErased, 2);
+  BOOST_CHECK_EQUAL(cs.size(), 2);
+
+  cs.erase("/", 10, [&] (size_t n) { nErased = n; });
+  BOOST_CHECK_EQUAL(nErased, 2);
+  BOOST_CHECK_EQUAL(cs.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Limit)
+{
+  cs.setLimit(16);
+  BOOST_CHECK_EQUAL(cs.getLimit(), 16);
+
+  for (uint32_t i = 1; i <= 200; ++i) {
+    insert(i, Name("/L").appendNumber(i).append("x"));
+  }
+  BOOST_CHECK_LE(cs.size(), 16);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrentInsertFind)
+{
+  constexpr size_t N_THREADS = 4;
+  constexpr uint32_t N_PER_THREAD = 200;
+  // large enough that no shard evicts, however the names are distributed
+  cs.setLimit(N_THREADS * N_PER_THREAD * cs.getNShards());
+
+  // Data packets are prepared on the main thread, then replayed concurrently
+  std::vector<std::vector<shared_ptr<Data>>> workloads(N_THREADS);
+  for (size_t t = 0; t < N_THREADS; ++t) {
+    for (uint32_t i = 0; i < N_PER_THREAD; ++i) {
+      auto data = makeData(Name("/T").appendNumber(t).appendNumber(i));
+      data->wireEncode();
+      data->getFullName();
+      workloads[t].push_back(data);
+    }
+  }
+
+  std::vector<size_t> nHits(N_THREADS, 0);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < N_THREADS; ++t) {
+    threads.emplace_back([&, t] {
+      for (const auto& data : workloads[t]) {
+        cs.insert(*data);
+        Interest interest(data->getName());
+        cs.find(interest, [&] (auto&&...) { ++nHits[t]; }, [] (auto&&...) {});
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t t = 0; t < N_THREADS; ++t) {
+    BOOST_CHECK_EQUAL(nHits[t], N_PER_THREAD);
+  }
+  BOOST_CHECK_EQUAL(cs.size(), N_THREADS * N_PER_THREAD);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // TestShardedCs
+BOOST_AUTO_TEST_SUITE_END() // Table
+
+} // namespace tests
+} // namespace cs
+} // namespace nfd
@@ -25,8 +25,10 @@
 
 #include "benchmark-helpers.hpp"
 #include "table/cs.hpp"
+#include "table/cs-sharded.hpp"
 
 #include <iostream>
+#include <thread>
 
 #ifdef NFD_HAVE_VALGRIND
 #include <valgrind/callgrind.h>
@@ -212,5 +214,44 @@ BOOST_FIXTURE_TEST_CASE(FindCanBePrefixHit, CsBenchmarkFixture)
   std::cout << "find(CanBePrefix-hit) " << (N_INTERESTS * N_CHILDREN * REPEAT) << ": " << d << std::endl;
 }
 
+// find miss, then insert, replayed concurrently against a sharded CS
+BOOST_FIXTURE_TEST_CASE(ShardedFindMissInsert, CsBenchmarkFixture)
+{
+  constexpr size_t N_WORKLOAD = CS_CAPACITY * 2;
+  constexpr size_t N_SHARDS = 64;
+
+  auto interestWorkload = makeInterestWorkload(N_WORKLOAD);
+  auto dataWorkload = makeDataWorkload(N_WORKLOAD);
+  // compute lazily cached encodings up front, because the workload is shared among threads
+  for (size_t i = 0; i < N_WORKLOAD; ++i) {
+    interestWorkload[i]->getName().wireEncode();
+    dataWorkload[i]->getFullName();
+  }
+
+  for (size_t nThreads : {1, 2, 4, 8}) {
+    ShardedCs shardedCs(CS_CAPACITY, N_SHARDS);
+
+    // each thread replays the whole trace with its own offset
+    time::microseconds d = timedRun([&] {
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t] {
+          for (size_t k = 0; k < N_WORKLOAD; ++k) {
+            size_t i = (k + t * N_WORKLOAD / nThreads) % N_WORKLOAD;
+            shardedCs.find(*interestWorkload[i], [] (auto&&...) {}, [] (auto&&...) {});
+            shardedCs.insert(*dataWorkload[i], false);
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    });
+
+    std::cout << "sharded find(miss)-insert " << nThreads << " threads "
+              << (N_WORKLOAD * nThreads) << ": " << d << std::endl;
+  }
+}
+
 } // namespace tests
 } // namespace nfd
@@ -59,8 +59,13 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/energy-source-container.h"
+#include "ns3/netanim-config.h"
 #include "animation-interface.h"
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("AnimationInterface");
@@ -420,6 +425,10 @@ AnimationInterface::MobilityCourseChangeTrace (Ptr <const MobilityModel> mobilit
     {
       v = mobility->GetPosition ();
     }
+  if (!NodeHasMoved (n, v))
+    {
+      return; // Same position as the last one written
+    }
   UpdatePosition (n, v);
   WriteXmlUpdateNodePosition (n->GetId (), v.x, v.y);
 }
@@ -427,7 +436,12 @@ AnimationInterface::MobilityCourseChangeTrace (Ptr <const MobilityModel> mobilit
 bool
 AnimationInterface::NodeHasMoved (Ptr <Node> n, Vector newLocation)
 {
-  Vector oldLocation = GetPosition (n);
+  std::map <uint32_t, Vector>::const_iterator it = m_nodeLocation.find (n->GetId ());
+  if (it == m_nodeLocation.end ())
+    {
+      return true;
+    }
+  const Vector &oldLocation = it->second;
   bool moved = true;
   if ((ceil (oldLocation.x) == ceil (newLocation.x))
       && (ceil (oldLocation.y) == ceil (newLocation.y)))
@@ -474,15 +488,11 @@ AnimationInterface::GetMovedNodes ()
       Ptr<Node> n = *i;
       NS_ASSERT (n);
       Ptr <MobilityModel> mobility = n->GetObject <MobilityModel> ();
-      Vector newLocation;
       if (!mobility)
         {
-          newLocation = GetPosition (n);
-        }
-      else
-        {
-          newLocation = mobility->GetPosition ();
+          continue; // Location can not change
         }
+      Vector newLocation = mobility->GetPosition ();
       if (!NodeHasMoved (n, newLocation))
         {
           continue; //Location has not changed
@@ -497,7 +507,7 @@ AnimationInterface::GetMovedNodes ()
 }
 
 int
-AnimationInterface::WriteN (const std::string& st, FILE * f)
+AnimationInterface::WriteN (const std::string& st, AnimOutputFile * f)
 {
   if (!f)
     {
@@ -511,28 +521,13 @@ AnimationInterface::WriteN (const std::string& st, FILE * f)
 }
 
 int
-AnimationInterface::WriteN (const char* data, uint32_t count, FILE * f)
+AnimationInterface::WriteN (const char* data, uint32_t count, AnimOutputFile * f)
 {
   if (!f)
     {
       return 0;
     }
-  // Write count bytes to h from data
-  uint32_t    nLeft   = count;
-  const char* p       = data;
-  uint32_t    written = 0;
-  while (nLeft)
-    {
-      int n = std::fwrite (p, 1,  nLeft, f);
-      if (n <= 0)
-        {
-          return written;
-        }
-      written += n;
-      nLeft -= n;
-      p += n;
-    }
-  return written;
+  return f->Write (data, count);
 }
 
 void
@@ -810,7 +805,6 @@ AnimationInterface::GenericWirelessTxTrace (std::string context, Ptr<const Packe
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
 
   ++gAnimUid;
   NS_LOG_INFO (ProtocolTypeToString (protocolType).c_str () << " GenericWirelessTxTrace for packet:" << gAnimUid);
@@ -840,7 +834,6 @@ AnimationInterface::GenericWirelessRxTrace (std::string context, Ptr<const Packe
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
   uint64_t animUid = GetAnimUidFromPacket (p);
   NS_LOG_INFO (ProtocolTypeToString (protocolType).c_str () << " for packet:" << animUid);
   if (!IsPacketPending (animUid, protocolType))
@@ -875,7 +868,6 @@ AnimationInterface::WifiPhyTxBeginTrace (std::string context, WifiConstPsduMap p
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   Ptr<NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
 
   AnimPacketInfo pktInfo (ndev, Simulator::Now ());
   AnimUidPacketInfoMap * pendingPackets =  ProtocolTypeToPendingPackets (WIFI);
@@ -915,7 +907,6 @@ AnimationInterface::WifiPhyRxBeginTrace (std::string context, Ptr<const Packet>
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
   uint64_t animUid = GetAnimUidFromPacket (p);
   NS_LOG_INFO ("Wifi RxBeginTrace for packet: " << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::WIFI))
@@ -934,8 +925,6 @@ AnimationInterface::WifiPhyRxBeginTrace (std::string context, Ptr<const Packet>
           NS_LOG_WARN ("Transmitter Mac address " << oss.str () << " never seen before. Skipping");
           return;
         }
-      Ptr <Node> txNode = NodeList::GetNode (m_macToNodeIdMap[oss.str ()]);
-      UpdatePosition (txNode);
       AnimPacketInfo pktInfo (0, Simulator::Now (), m_macToNodeIdMap[oss.str ()]);
       AddPendingPacket (AnimationInterface::WIFI, animUid, pktInfo);
       NS_LOG_WARN ("WifiPhyRxBegin: unknown Uid, but we are adding a wifi packet");
@@ -959,8 +948,6 @@ AnimationInterface::LrWpanPhyTxBeginTrace (std::string context,
   Ptr <Node> n = ndev->GetNode ();
   NS_ASSERT (n);
 
-  UpdatePosition (n);
-
   LrWpanMacHeader hdr;
   if (!p->PeekHeader (hdr))
     {
@@ -1021,7 +1008,6 @@ AnimationInterface::LrWpanPhyRxBeginTrace (std::string context,
       NS_LOG_WARN ("LrWpanPhyRxBeginTrace: unknown Uid - most probably it's an ACK.");
     }
 
-  UpdatePosition (n);
   m_pendingLrWpanPackets[animUid].ProcessRxBegin (ndev, Simulator::Now ().GetSeconds ());
   OutputWirelessPacketRxInfo (p, m_pendingLrWpanPackets[animUid], animUid);
 }
@@ -1040,7 +1026,6 @@ AnimationInterface::WavePhyRxBeginTrace (std::string context, Ptr<const Packet>
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
   uint64_t animUid = GetAnimUidFromPacket (p);
   NS_LOG_INFO ("Wave RxBeginTrace for packet:" << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::WAVE))
@@ -1059,8 +1044,6 @@ AnimationInterface::WavePhyRxBeginTrace (std::string context, Ptr<const Packet>
           NS_LOG_WARN ("Transmitter Mac address " << oss.str () << " never seen before. Skipping");
           return;
         }
-      Ptr <Node> txNode = NodeList::GetNode (m_macToNodeIdMap[oss.str ()]);
-      UpdatePosition (txNode);
       AnimPacketInfo pktInfo (0, Simulator::Now (), m_macToNodeIdMap[oss.str ()]);
       AddPendingPacket (AnimationInterface::WAVE, animUid, pktInfo);
       NS_LOG_WARN ("WavePhyRxBegin: unknown Uid, but we are adding a wave packet");
@@ -1113,7 +1096,6 @@ AnimationInterface::LteSpectrumPhyTxStart (std::string context, Ptr<const Packet
   context = "/" + context;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
 
   std::list <Ptr <Packet> > pbList = pb->GetPackets ();
   for (std::list <Ptr <Packet> >::iterator i  = pbList.begin ();
@@ -1143,7 +1125,6 @@ AnimationInterface::LteSpectrumPhyRxStart (std::string context, Ptr<const Packet
   context = "/" + context;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
 
   std::list <Ptr <Packet> > pbList = pb->GetPackets ();
   for (std::list <Ptr <Packet> >::iterator i  = pbList.begin ();
@@ -1171,11 +1152,9 @@ AnimationInterface::CsmaPhyTxBeginTrace (std::string context, Ptr<const Packet>
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
   ++gAnimUid;
   NS_LOG_INFO ("CsmaPhyTxBeginTrace for packet:" << gAnimUid);
   AddByteTag (gAnimUid, p);
-  UpdatePosition (ndev);
   AnimPacketInfo pktInfo (ndev, Simulator::Now ());
   AddPendingPacket (AnimationInterface::CSMA, gAnimUid, pktInfo);
 
@@ -1189,7 +1168,6 @@ AnimationInterface::CsmaPhyTxEndTrace (std::string context, Ptr<const Packet> p)
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
   uint64_t animUid = GetAnimUidFromPacket (p);
   NS_LOG_INFO ("CsmaPhyTxEndTrace for packet:" << animUid);
   if (!IsPacketPending (animUid, AnimationInterface::CSMA))
@@ -1212,7 +1190,6 @@ AnimationInterface::CsmaPhyRxEndTrace (std::string context, Ptr<const Packet> p)
   CHECK_STARTED_INTIMEWINDOW_TRACKPACKETS;
   Ptr <NetDevice> ndev = GetNetDeviceFromContext (context);
   NS_ASSERT (ndev);
-  UpdatePosition (ndev);
   uint64_t animUid = GetAnimUidFromPacket (p);
   if (!IsPacketPending (animUid, AnimationInterface::CSMA))
     {
@@ -1474,7 +1451,8 @@ AnimationInterface::StopAnimation (bool onlyAnimation)
     {
       // Terminate the anim element
       WriteXmlClose ("anim");
-      std::fclose (m_f);
+      m_f->Close ();
+      delete m_f;
       m_f = 0;
     }
   if (onlyAnimation)
@@ -1484,7 +1462,8 @@ AnimationInterface::StopAnimation (bool onlyAnimation)
   if (m_routingF)
     {
       WriteXmlClose ("anim", true);
-      std::fclose (m_routingF);
+      m_routingF->Close ();
+      delete m_routingF;
       m_routingF = 0;
     }
 }
@@ -1763,14 +1742,6 @@ AnimationInterface::UpdatePosition (Ptr <Node> n, Vector v)
   return v;
 }
 
-Vector
-AnimationInterface::UpdatePosition (Ptr <NetDevice> ndev)
-{
-  Ptr <Node> n = ndev->GetNode ();
-  NS_ASSERT (n);
-  return UpdatePosition (n);
-}
-
 Vector
 AnimationInterface::GetPosition (Ptr <Node> n)
 {
@@ -2116,10 +2087,10 @@ AnimationInterface::SetOutputFile (const std::string& fn, bool routing)
     }
 
   NS_LOG_INFO ("Creating new trace file:" << fn.c_str ());
-  FILE * f = 0;
-  f = std::fopen (fn.c_str (), "w");
-  if (!f)
+  AnimOutputFile * f = new AnimOutputFile ();
+  if (!f->Open (fn))
     {
+      delete f;
       NS_FATAL_ERROR ("Unable to open output file:" << fn.c_str ());
       return; // Can't open output file
     }
@@ -2433,7 +2404,7 @@ AnimationInterface::WriteXmlAnim (bool routing)
 {
   AnimXmlElement element ("anim");
   element.AddAttribute ("ver", GetNetAnimVersion ());
-  FILE * f = m_f;
+  AnimOutputFile * f = m_f;
   if (!routing)
     {
       element.AddAttribute ("filetype", "animation");
@@ -2737,57 +2708,215 @@ AnimationInterface::WriteXmlNonP2pLinkProperties (uint32_t id, std::string ipAdd
 
 
 
+/***** AnimOutputFile *****/
+
+/// Size of the buffer of the output files, in bytes
+static const uint32_t ANIM_OUTPUT_BUFFER_SIZE = 256 * 1024;
+
+AnimationInterface::AnimOutputFile::AnimOutputFile ()
+  : m_file (0),
+    m_gzFile (0)
+{
+}
+
+AnimationInterface::AnimOutputFile::~AnimOutputFile ()
+{
+  Close ();
+}
+
+bool
+AnimationInterface::AnimOutputFile::Open (const std::string& fileName)
+{
+  Close ();
+  m_buffer.reserve (ANIM_OUTPUT_BUFFER_SIZE);
+  if (fileName.size () > 3 && fileName.compare (fileName.size () - 3, 3, ".gz") == 0)
+    {
+#ifdef HAVE_ZLIB
+      m_gzFile = gzopen (fileName.c_str (), "wb");
+      return m_gzFile != 0;
+#else
+      NS_FATAL_ERROR ("Compressed trace file " << fileName << " requires ns-3 to be built with zlib");
+      return false;
+#endif
+    }
+  m_file = std::fopen (fileName.c_str (), "w");
+  return m_file != 0;
+}
+
+uint32_t
+AnimationInterface::AnimOutputFile::Write (const char* data, uint32_t count)
+{
+  if (m_buffer.size () + count > ANIM_OUTPUT_BUFFER_SIZE && !Flush ())
+    {
+      return 0;
+    }
+  m_buffer.append (data, count);
+  return count;
+}
+
+bool
+AnimationInterface::AnimOutputFile::Flush (void)
+{
+  bool written = true;
+  if (m_file)
+    {
+      written = (std::fwrite (m_buffer.data (), 1, m_buffer.size (), m_file) == m_buffer.size ());
+    }
+#ifdef HAVE_ZLIB
+  else if (m_gzFile && !m_buffer.empty ())
+    {
+      int size = m_buffer.size ();
+      written = (gzwrite (static_cast<gzFile> (m_gzFile), m_buffer.data (), size) == size);
+    }
+#endif
+  m_buffer.clear ();
+  return written;
+}
+
+void
+AnimationInterface::AnimOutputFile::Close (void)
+{
+  Flush ();
+  if (m_file)
+    {
+      std::fclose (m_file);
+      m_file = 0;
+    }
+#ifdef HAVE_ZLIB
+  if (m_gzFile)
+    {
+      gzclose (static_cast<gzFile> (m_gzFile));
+      m_gzFile = 0;
+    }
+#endif
+}
+
+
+
 /***** AnimXmlElement  *****/
 
+/**
+ * Append a value of an attribute to a string, as an output stream with
+ * a precision of 10 digits would print it.
+ * \param s the string
+ * \param value the value
+ */
+template <typename T>
+static void
+AppendAttributeValue (std::string &s, const T &value)
+{
+  std::ostringstream oss;
+  oss << std::setprecision (10);
+  oss << value;
+  s += oss.str ();
+}
+
+/**
+ * Append a string value of an attribute to a string.
+ * \param s the string
+ * \param value the value
+ */
+static void
+AppendAttributeValue (std::string &s, const std::string &value)
+{
+  s += value;
+}
+
+/**
+ * Append a string value of an attribute to a string.
+ * \param s the string
+ * \param value the value
+ */
+static void
+AppendAttributeValue (std::string &s, const char *value)
+{
+  s += value;
+}
+
+/**
+ * Append an integer value of an attribute to a string.
+ * \param s the string
+ * \param value the value
+ */
+static void
+AppendAttributeValue (std::string &s, uint32_t value)
+{
+  char buffer[16];
+  s.append (buffer, std::snprintf (buffer, sizeof (buffer), "%u", value));
+}
+
+/**
+ * Append an integer value of an attribute to a string.
+ * \param s the string
+ * \param value the value
+ */
+static void
+AppendAttributeValue (std::string &s, uint64_t value)
+{
+  char buffer[32];
+  s.append (buffer, std::snprintf (buffer, sizeof (buffer), "%llu", static_cast<unsigned long long> (value)));
+}
+
+/**
+ * Append a real value of an attribute to a string, with 10 significant
+ * digits as std::setprecision (10).
+ * \param s the string
+ * \param value the value
+ */
+static void
+AppendAttributeValue (std::string &s, double value)
+{
+  char buffer[32];
+  s.append (buffer, std::snprintf (buffer, sizeof (buffer), "%.10g", value));
+}
+
 AnimationInterface::AnimXmlElement::AnimXmlElement (std::string tagName, bool emptyElement)
   : m_tagName (tagName),
     m_text ("")
 {
+  m_attributes.reserve (128);
 }
 
 template <typename T>
 void
 AnimationInterface::AnimXmlElement::AddAttribute (std::string attribute, T value, bool xmlEscape)
 {
-  std::ostringstream oss;
-  oss << std::setprecision (10);
-  oss << value;
-  std::string attributeString = attribute.c_str ();
+  m_attributes += attribute;
+  m_attributes += "=\"";
   if (xmlEscape)
     {
-      attributeString += "=\"";
-      std::string valueStr = oss.str ();
+      std::string valueStr;
+      AppendAttributeValue (valueStr, value);
       for (std::string::iterator it = valueStr.begin (); it != valueStr.end (); ++it)
         {
           switch (*it)
             {
             case '&':
-              attributeString += "&amp;";
+              m_attributes += "&amp;";
               break;
             case '\"':
-              attributeString += "&quot;";
+              m_attributes += "&quot;";
               break;
             case '\'':
-              attributeString += "&apos;";
+              m_attributes += "&apos;";
               break;
             case '<':
-              attributeString += "&lt;";
+              m_attributes += "&lt;";
               break;
             case '>':
-              attributeString += "&gt;";
+              m_attributes += "&gt;";
               break;
             default:
-              attributeString += *it;
+              m_attributes += *it;
               break;
             }
         }
-      attributeString += "\" ";
     }
   else
     {
-      attributeString += "=\"" + oss.str () + "\" ";
+      AppendAttributeValue (m_attributes, value);
     }
-  m_attributes.push_back (attributeString);
+  m_attributes += "\" ";
 }
 
 void
@@ -2805,15 +2934,12 @@ AnimationInterface::AnimXmlElement::SetText (std::string text)
 std::string
 AnimationInterface::AnimXmlElement::ToString (bool autoClose)
 {
-  std::string elementString = "<" + m_tagName + " ";
-
-
-  for (std::vector<std::string>::const_iterator i = m_attributes.begin ();
-       i != m_attributes.end ();
-       ++i)
-    {
-      elementString += *i;
-    }
+  std::string elementString;
+  elementString.reserve (2 * m_tagName.size () + m_attributes.size () + m_text.size () + 8);
+  elementString += "<";
+  elementString += m_tagName;
+  elementString += " ";
+  elementString += m_attributes;
   if (m_children.empty () && m_text.empty ())
     {
       if (autoClose)
@@ -2835,7 +2961,8 @@ AnimationInterface::AnimXmlElement::ToString (bool autoClose)
                i != m_children.end ();
                ++i)
             {
-              elementString += *i + "\n";
+              elementString += *i;
+              elementString += "\n";
             }
 
         }
@@ -2844,9 +2971,11 @@ AnimationInterface::AnimXmlElement::ToString (bool autoClose)
           elementString += "</" + m_tagName + ">";
         }
     }
-
-
-  return elementString + ((autoClose) ? "\n" : "");
+  if (autoClose)
+    {
+      elementString += "\n";
+    }
+  return elementString;
 }
 
 
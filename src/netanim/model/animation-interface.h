@@ -77,7 +77,8 @@ class AnimationInterface
 public:
   /**
    * \brief Constructor
-   * \param filename The Filename for the trace file used by the Animator
+   * \param filename The Filename for the trace file used by the Animator,
+   * compressed with gzip if it ends in ".gz"
    *
    */
   AnimationInterface (const std::string filename);
@@ -599,17 +600,58 @@ public:
 private:
     std::string m_tagName; ///< tag name
     std::string m_text; ///< element string
-    std::vector<std::string> m_attributes; ///< list of attributes
+    std::string m_attributes; ///< serialized attributes
     std::vector<std::string> m_children; ///< list of children
 
   };
 
 
 
+  /**
+   * \brief Output file of the traces.
+   *
+   * The elements are gathered in a large buffer, written at once when
+   * full, so that each element costs a copy rather than a call to the
+   * C library.  The file is compressed with gzip if its name ends in
+   * ".gz", which requires ns-3 to be built with zlib.
+   */
+  class AnimOutputFile
+  {
+public:
+    AnimOutputFile ();
+    ~AnimOutputFile ();
+    /**
+     * Open the file, truncating it
+     * \param fileName the file name
+     * \returns true if the file was opened
+     */
+    bool Open (const std::string& fileName);
+    /**
+     * Write data to the file
+     * \param data the data to write
+     * \param count the number of bytes to write
+     * \returns the number of bytes written
+     */
+    uint32_t Write (const char* data, uint32_t count);
+    /// Flush the buffer and close the file
+    void Close (void);
+
+private:
+    /**
+     * Write the buffer to the file
+     * \returns true if the whole buffer was written
+     */
+    bool Flush (void);
+
+    std::FILE * m_file; ///< uncompressed file (0 if none)
+    void * m_gzFile; ///< gzip compressed file (0 if none)
+    std::string m_buffer; ///< data not written yet
+  };
+
   // ##### State #####
 
-  FILE * m_f; ///< File handle for output (0 if none)
-  FILE * m_routingF; ///< File handle for routing table output (0 if None);
+  AnimOutputFile * m_f; ///< File handle for output (0 if none)
+  AnimOutputFile * m_routingF; ///< File handle for routing table output (0 if None);
   Time m_mobilityPollInterval; ///< mobility poll interval
   std::string m_outputFileName; ///< output file name
   uint64_t gAnimUid;     ///< Packet unique identifier used by AnimationInterface
@@ -662,7 +704,7 @@ private:
   AnimUidPacketInfoMap m_pendingUanPackets; ///< pending UAN packets
   AnimUidPacketInfoMap m_pendingWavePackets; ///< pending WAVE packets
 
-  std::map <uint32_t, Vector> m_nodeLocation; ///< node location
+  std::map <uint32_t, Vector> m_nodeLocation; ///< node location last written to the trace
   std::map <std::string, uint32_t> m_macToNodeIdMap; ///< MAC to node ID map
   std::map <std::string, uint32_t> m_ipv4ToNodeIdMap; ///< IPv4 to node ID map
   std::map <std::string, uint32_t> m_ipv6ToNodeIdMap; ///< IPv6 to node ID map
@@ -761,14 +803,14 @@ private:
    * \param f the file to write to
    * \returns the number of bytes written
    */
-  int WriteN (const char* data, uint32_t count, FILE * f);
+  int WriteN (const char* data, uint32_t count, AnimOutputFile * f);
   /**
    * WriteN function
    * \param st the string to output
    * \param f the file to write to
    * \returns the number of bytes written
    */
-  int WriteN (const std::string& st, FILE * f);
+  int WriteN (const std::string& st, AnimOutputFile * f);
   /**
    * Get MAC address function
    * \param nd the device
@@ -1242,17 +1284,11 @@ private:
    * \returns the position vector
    */
   Vector UpdatePosition (Ptr <Node> n, Vector v);
-  /**
-   * Update position function
-   * \param ndev the device
-   * \returns the position vector
-   */
-  Vector UpdatePosition (Ptr <NetDevice> ndev);
   /**
    * Node has moved function
    * \param n the node
    * \param newLocation the new location vector
-   * \returns true if the node has moved
+   * \returns true if the node has moved since its position was last written
    */
   bool NodeHasMoved (Ptr <Node> n, Vector newLocation);
   /**
@@ -18,6 +18,8 @@
  */
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include "unistd.h"
 
 #include "ns3/core-module.h"
@@ -27,8 +29,14 @@
 #include "ns3/netanim-module.h"
 #include "ns3/applications-module.h"
 #include "ns3/point-to-point-layout-module.h"
+#include "ns3/mobility-model.h"
 #include "ns3/basic-energy-source.h"
 #include "ns3/simple-device-energy-model.h"
+#include "ns3/netanim-config.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace ns3;
 
@@ -68,6 +76,7 @@ protected:
 
   NodeContainer m_nodes; ///< the nodes
   AnimationInterface* m_anim; ///< animation
+  const char* m_traceFileName; ///< trace file name
 
 private:
 
@@ -79,8 +88,6 @@ private:
 
   /// Check file existence
   virtual void CheckFileExistence ();
-
-  const char* m_traceFileName; ///< trace file name
 };
 
 AbstractAnimationInterfaceTestCase::AbstractAnimationInterfaceTestCase (std::string name) :
@@ -253,6 +260,150 @@ AnimationRemainingEnergyTestCase::CheckLogic (void)
                             "Wrong remaining energy value was traced");
 }
 
+/**
+ * \ingroup netanim-test
+ * \ingroup tests
+ *
+ * \brief Animation Position Test Case
+ */
+class AnimationPositionTestCase : public AbstractAnimationInterfaceTestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  AnimationPositionTestCase ();
+
+private:
+
+  virtual void
+  PrepareNetwork ();
+
+  virtual void
+  CheckLogic ();
+
+};
+
+AnimationPositionTestCase::AnimationPositionTestCase () :
+  AbstractAnimationInterfaceTestCase ("Verify node position updates")
+{
+}
+
+void
+AnimationPositionTestCase::PrepareNetwork (void)
+{
+  m_nodes.Create (2);
+  AnimationInterface::SetConstantPosition (m_nodes.Get (0), 0, 10);
+  AnimationInterface::SetConstantPosition (m_nodes.Get (1), 1, 10);
+
+  // the second move of node 1 rounds to the same position as the first
+  Ptr<MobilityModel> mobility = m_nodes.Get (1)->GetObject<MobilityModel> ();
+  Simulator::Schedule (Seconds (1), &MobilityModel::SetPosition, mobility, Vector (50.2, 10.2, 0));
+  Simulator::Schedule (Seconds (2), &MobilityModel::SetPosition, mobility, Vector (50.7, 10.9, 0));
+  Simulator::Schedule (Seconds (3), &MobilityModel::SetPosition, mobility, Vector (80, 10, 0));
+  Simulator::Stop (Seconds (4));
+}
+
+void
+AnimationPositionTestCase::CheckLogic (void)
+{
+  // close the trace file
+  delete m_anim;
+  m_anim = 0;
+
+  std::ifstream file (m_traceFileName);
+  std::ostringstream oss;
+  oss << file.rdbuf ();
+  std::string trace = oss.str ();
+
+  uint32_t updates = 0;
+  for (std::string::size_type pos = trace.find ("<nu p=\"p\""); pos != std::string::npos; pos = trace.find ("<nu p=\"p\"", pos + 1))
+    {
+      updates++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (updates, 2, "Expected 2 position updates");
+  NS_TEST_ASSERT_MSG_NE (trace.find ("<nu p=\"p\" t=\"1\" id=\"1\" x=\"50.2\" y=\"10.2\" />\n"), std::string::npos,
+                         "Missing position update at 1 s");
+  NS_TEST_ASSERT_MSG_NE (trace.find ("<nu p=\"p\" t=\"3\" id=\"1\" x=\"80\" y=\"10\" />\n"), std::string::npos,
+                         "Missing position update at 3 s");
+  NS_TEST_ASSERT_MSG_EQ ((trace.size () > 8 && trace.compare (trace.size () - 8, 8, "</anim>\n") == 0), true,
+                         "Trace file not terminated");
+}
+
+#ifdef HAVE_ZLIB
+/**
+ * \ingroup netanim-test
+ * \ingroup tests
+ *
+ * \brief Animation Compressed Trace Test Case
+ */
+class AnimationCompressedTraceTestCase : public AbstractAnimationInterfaceTestCase
+{
+public:
+  /**
+   * \brief Constructor.
+   */
+  AnimationCompressedTraceTestCase ();
+
+private:
+
+  virtual void
+  PrepareNetwork ();
+
+  virtual void
+  CheckLogic ();
+
+};
+
+AnimationCompressedTraceTestCase::AnimationCompressedTraceTestCase () :
+  AbstractAnimationInterfaceTestCase ("Verify compressed trace files")
+{
+  m_traceFileName = "netanim-test.xml.gz";
+}
+
+void
+AnimationCompressedTraceTestCase::PrepareNetwork (void)
+{
+  m_nodes.Create (2);
+  AnimationInterface::SetConstantPosition (m_nodes.Get (0), 0, 10);
+  AnimationInterface::SetConstantPosition (m_nodes.Get (1), 1, 10);
+
+  Ptr<MobilityModel> mobility = m_nodes.Get (1)->GetObject<MobilityModel> ();
+  Simulator::Schedule (Seconds (1), &MobilityModel::SetPosition, mobility, Vector (80, 10, 0));
+  Simulator::Stop (Seconds (2));
+}
+
+void
+AnimationCompressedTraceTestCase::CheckLogic (void)
+{
+  // close the trace file
+  delete m_anim;
+  m_anim = 0;
+
+  std::ifstream file (m_traceFileName, std::ios::binary);
+  char magic[2] = { 0, 0 };
+  file.read (magic, 2);
+  NS_TEST_ASSERT_MSG_EQ ((magic[0] == '\x1f' && magic[1] == '\x8b'), true, "Trace file not compressed");
+
+  gzFile gz = gzopen (m_traceFileName, "rb");
+  NS_TEST_ASSERT_MSG_NE (gz, 0, "Trace file not readable");
+  std::string trace;
+  char buffer[4096];
+  int n;
+  while ((n = gzread (gz, buffer, sizeof (buffer))) > 0)
+    {
+      trace.append (buffer, n);
+    }
+  gzclose (gz);
+
+  NS_TEST_ASSERT_MSG_EQ (trace.compare (0, 6, "<anim "), 0, "Wrong start of the trace");
+  NS_TEST_ASSERT_MSG_NE (trace.find ("<nu p=\"p\" t=\"1\" id=\"1\" x=\"80\" y=\"10\" />\n"), std::string::npos,
+                         "Missing position update at 1 s");
+  NS_TEST_ASSERT_MSG_EQ ((trace.size () > 8 && trace.compare (trace.size () - 8, 8, "</anim>\n") == 0), true,
+                         "Trace file not terminated");
+}
+#endif /* HAVE_ZLIB */
+
 /**
  * \ingroup netanim-test
  * \ingroup tests
@@ -267,5 +418,9 @@ public:
   {
     AddTestCase (new AnimationInterfaceTestCase (), TestCase::QUICK);
     AddTestCase (new AnimationRemainingEnergyTestCase (), TestCase::QUICK);
+    AddTestCase (new AnimationPositionTestCase (), TestCase::QUICK);
+#ifdef HAVE_ZLIB
+    AddTestCase (new AnimationCompressedTraceTestCase (), TestCase::QUICK);
+#endif
   }
 } g_animationInterfaceTestSuite; ///< the test suite
@@ -1144,6 +1144,72 @@ DiffTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (usec, 3696, "Files are different from 2.3696 seconds");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief Test case to make sure that a PcapFile with a write buffer
+ * writes the same records as an unbuffered one.
+ */
+class BufferedWriteTestCase : public TestCase
+{
+public:
+  BufferedWriteTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BufferedWriteTestCase::BufferedWriteTestCase ()
+  : TestCase ("Check that PcapFile writes the same records with a write buffer")
+{
+}
+
+void
+BufferedWriteTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("unbuffered.pcap");
+  std::string filename2 = CreateTempDirFilename ("buffered.pcap");
+  std::string filename3 = CreateTempDirFilename ("buffered2.pcap");
+  PcapFile f, f2, f3;
+
+  f.Open (filename, std::ios::out);
+  f.Init (1, N_PACKET_BYTES);
+  f2.Open (filename2, std::ios::out);
+  // smaller than a few records, so that many buffers are handed over
+  f2.SetWriteBufferSize (256);
+  f2.Init (1, N_PACKET_BYTES);
+  NS_TEST_ASSERT_MSG_EQ (f2.Fail (), false, "Init (1, " << N_PACKET_BYTES << ") returns error");
+  f3.Open (filename3, std::ios::out);
+  f3.SetWriteBufferSize (512);
+  f3.Init (1, N_PACKET_BYTES);
+
+  for (uint32_t i = 0; i < N_KNOWN_PACKETS; ++i)
+    {
+      PacketEntry const & p = knownPackets[i];
+
+      f.Write (p.tsSec, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+      f2.Write (p.tsSec, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+      f3.Write (p.tsSec, p.tsUsec, (uint8_t const *)p.data, p.origLen);
+    }
+  // closing a file only waits for its own records
+  f3.Close ();
+  f.Flush ();
+  f2.Flush ();
+  NS_TEST_EXPECT_MSG_EQ (f2.Fail (), false, "Write must not fail");
+
+  // flushed records can be read before the file is closed
+  uint32_t sec (0), usec (0), packets (0);
+  bool diff = PcapFile::Diff (filename, filename2, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Buffered and unbuffered files must be the same");
+  NS_TEST_EXPECT_MSG_EQ (packets, N_KNOWN_PACKETS, "Wrong number of records");
+  diff = PcapFile::Diff (filename, filename3, sec, usec, packets);
+  NS_TEST_EXPECT_MSG_EQ (diff, false, "Files buffered together must be the same");
+
+  f.Close ();
+  f2.Close ();
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -1167,6 +1233,7 @@ PcapFileTestSuite::PcapFileTestSuite ()
   AddTestCase (new RecordHeaderTestCase, TestCase::QUICK);
   AddTestCase (new ReadFileTestCase, TestCase::QUICK);
   AddTestCase (new DiffTestCase, TestCase::QUICK);
+  AddTestCase (new BufferedWriteTestCase, TestCase::QUICK);
 }
 
 static PcapFileTestSuite pcapFileTestSuite; //!< Static variable for test initialization
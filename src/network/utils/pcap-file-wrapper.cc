@@ -46,6 +46,13 @@ PcapFileWrapper::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&PcapFileWrapper::m_nanosecMode),
                    MakeBooleanChecker())
+    .AddAttribute ("WriteBufferSize",
+                   "Size in bytes of the memory buffer into which packets are written "
+                   "before being handed to a background thread that writes them to the "
+                   "file. 0 writes each packet to the file directly.",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&PcapFileWrapper::m_writeBufferSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -89,11 +96,19 @@ PcapFileWrapper::Close (void)
   m_file.Close ();
 }
 
+void
+PcapFileWrapper::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_file.Flush ();
+}
+
 void
 PcapFileWrapper::Open (std::string const &filename, std::ios::openmode mode)
 {
   NS_LOG_FUNCTION (this << filename << mode);
   m_file.Open (filename, mode);
+  m_file.SetWriteBufferSize ((mode & std::ios::out) ? m_writeBufferSize : 0);
 }
 
 void
@@ -82,6 +82,13 @@ public:
    */
   void Close (void);
 
+  /**
+   * Write the buffered records to the underlying pcap file, so that they
+   * can be read while this wrapper keeps writing (see the WriteBufferSize
+   * attribute).
+   */
+  void Flush (void);
+
   /**
    * Initialize the pcap file associated with this wrapper.  This file must have
    * been previously opened with write permissions.
@@ -224,6 +231,7 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  uint32_t m_writeBufferSize; //!< size of the write buffer of the pcap file
 };
 
 } // namespace ns3
@@ -20,6 +20,14 @@
 
 #include <iostream>
 #include <cstring>
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#endif /* HAVE_PTHREAD_H */
 #include "ns3/assert.h"
 #include "ns3/packet.h"
 #include "ns3/fatal-error.h"
@@ -47,10 +55,186 @@ const uint32_t NS_SWAPPED_MAGIC = 0x4d3cb2a1; /**< Looks this way if byte swappi
 const uint16_t VERSION_MAJOR = 2;             /**< Major version of supported pcap file format */
 const uint16_t VERSION_MINOR = 4;             /**< Minor version of supported pcap file format */
 
+namespace {
+
+/**
+ * \ingroup network
+ *
+ * Background thread writing the buffers of the PcapFile objects to their
+ * file streams, in the order in which the buffers are handed over.
+ *
+ * The memory held by the buffers waiting to be written is bounded: a
+ * PcapFile handing a buffer over blocks while the bound is exceeded.
+ * Without thread support, buffers are written as they are handed over.
+ */
+class PcapFileWriter
+{
+public:
+  /**
+   * \return the writer shared by all the PcapFile objects
+   */
+  static PcapFileWriter &Get (void);
+  /**
+   * Hand a buffer over, to be written to a file stream.
+   * \param file the file stream
+   * \param data the buffer, swapped with an empty buffer
+   */
+  void Submit (std::fstream *file, std::vector<char> &data);
+  /**
+   * Wait until all the buffers handed over so far for a file stream are
+   * written.  The buffers of the other file streams are not waited for.
+   * \param file the file stream
+   */
+  void Wait (const std::fstream *file);
+
+private:
+  PcapFileWriter ();
+  /**
+   * Write the buffers handed over, forever.
+   */
+  void Run (void);
+
+  /// A buffer to write to a file stream
+  struct Job
+  {
+    std::fstream *file;       //!< the file stream
+    std::vector<char> data;   //!< the buffer
+  };
+
+  static const uint64_t MAX_PENDING_BYTES = 64 * 1024 * 1024;  //!< bound on the size of the pending buffers
+  static const std::size_t MAX_SPARE_BUFFERS = 16;             //!< number of written buffers kept for reuse
+
+#ifdef HAVE_PTHREAD_H
+  std::mutex m_mutex;                     //!< protects the members below
+  std::condition_variable m_jobAdded;     //!< notified when a buffer is handed over
+  std::condition_variable m_jobDone;      //!< notified when a buffer is written
+  std::deque<Job> m_jobs;                 //!< buffers waiting to be written
+  uint32_t m_pendingJobs;                 //!< buffers not written yet, including the one being written
+  std::map<const std::fstream *, uint32_t> m_filePendingJobs; //!< buffers not written yet of each file stream
+  uint64_t m_pendingBytes;                //!< size of the buffers not written yet
+  std::vector<std::vector<char> > m_spare; //!< written buffers, kept for reuse
+#endif /* HAVE_PTHREAD_H */
+};
+
+PcapFileWriter &
+PcapFileWriter::Get (void)
+{
+  // Never destroyed, so that files closed during the static destruction
+  // can still be written
+  static PcapFileWriter *writer = new PcapFileWriter ();
+  return *writer;
+}
+
+#ifdef HAVE_PTHREAD_H
+
+PcapFileWriter::PcapFileWriter ()
+  : m_pendingJobs (0),
+    m_pendingBytes (0)
+{
+  std::thread (&PcapFileWriter::Run, this).detach ();
+}
+
+void
+PcapFileWriter::Submit (std::fstream *file, std::vector<char> &data)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (m_pendingJobs > 0 && m_pendingBytes + data.size () > MAX_PENDING_BYTES)
+    {
+      m_jobDone.wait (lock);
+    }
+  m_jobs.push_back (Job ());
+  m_jobs.back ().file = file;
+  m_jobs.back ().data.swap (data);
+  m_pendingJobs++;
+  m_filePendingJobs[file]++;
+  m_pendingBytes += m_jobs.back ().data.size ();
+  if (!m_spare.empty ())
+    {
+      data.swap (m_spare.back ());
+      m_spare.pop_back ();
+    }
+  m_jobAdded.notify_one ();
+}
+
+void
+PcapFileWriter::Wait (const std::fstream *file)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (m_filePendingJobs.find (file) != m_filePendingJobs.end ())
+    {
+      m_jobDone.wait (lock);
+    }
+}
+
+void
+PcapFileWriter::Run (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+  while (true)
+    {
+      while (m_jobs.empty ())
+        {
+          m_jobAdded.wait (lock);
+        }
+      Job job;
+      job.file = m_jobs.front ().file;
+      job.data.swap (m_jobs.front ().data);
+      m_jobs.pop_front ();
+
+      // The owner of the file stream does not use it until the job is done
+      lock.unlock ();
+      job.file->write (job.data.data (), job.data.size ());
+      lock.lock ();
+
+      m_pendingJobs--;
+      std::map<const std::fstream *, uint32_t>::iterator it = m_filePendingJobs.find (job.file);
+      if (--it->second == 0)
+        {
+          m_filePendingJobs.erase (it);
+        }
+      m_pendingBytes -= job.data.size ();
+      if (m_spare.size () < MAX_SPARE_BUFFERS)
+        {
+          job.data.clear ();
+          m_spare.push_back (std::vector<char> ());
+          m_spare.back ().swap (job.data);
+        }
+      m_jobDone.notify_all ();
+    }
+}
+
+#else /* HAVE_PTHREAD_H */
+
+PcapFileWriter::PcapFileWriter ()
+{
+}
+
+void
+PcapFileWriter::Submit (std::fstream *file, std::vector<char> &data)
+{
+  file->write (data.data (), data.size ());
+  data.clear ();
+}
+
+void
+PcapFileWriter::Wait (const std::fstream *file)
+{
+}
+
+void
+PcapFileWriter::Run (void)
+{
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+} // unnamed namespace
+
 PcapFile::PcapFile ()
   : m_file (),
     m_swapMode (false),
-    m_nanosecMode (false)
+    m_nanosecMode (false),
+    m_writeBufferSize (0)
 {
   NS_LOG_FUNCTION (this);
   FatalImpl::RegisterStream (&m_file); 
@@ -68,18 +252,27 @@ bool
 PcapFile::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writeBufferSize > 0)
+    {
+      PcapFileWriter::Get ().Wait (&m_file);
+    }
   return m_file.fail ();
 }
 bool 
 PcapFile::Eof (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_writeBufferSize > 0)
+    {
+      PcapFileWriter::Get ().Wait (&m_file);
+    }
   return m_file.eof ();
 }
 void 
 PcapFile::Clear (void)
 {
   NS_LOG_FUNCTION (this);
+  WaitForWriter ();
   m_file.clear ();
 }
 
@@ -88,9 +281,67 @@ void
 PcapFile::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  WaitForWriter ();
   m_file.close ();
 }
 
+void
+PcapFile::SetWriteBufferSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  WaitForWriter ();
+  m_writeBufferSize = size;
+}
+
+void
+PcapFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  WaitForWriter ();
+  m_file.flush ();
+}
+
+void
+PcapFile::WaitForWriter (void)
+{
+  if (m_writeBufferSize == 0)
+    {
+      return;
+    }
+  if (!m_writeBuffer.empty ())
+    {
+      PcapFileWriter::Get ().Submit (&m_file, m_writeBuffer);
+    }
+  PcapFileWriter::Get ().Wait (&m_file);
+}
+
+void
+PcapFile::WriteBytes (const void *data, uint32_t size)
+{
+  if (m_writeBufferSize == 0)
+    {
+      m_file.write ((const char *)data, size);
+    }
+  else
+    {
+      const char *bytes = (const char *)data;
+      m_writeBuffer.insert (m_writeBuffer.end (), bytes, bytes + size);
+    }
+}
+
+void
+PcapFile::CheckWriteBuffer (void)
+{
+  if (m_writeBufferSize == 0)
+    {
+      NS_BUILD_DEBUG(m_file.flush());
+    }
+  else if (m_writeBuffer.size () >= m_writeBufferSize)
+    {
+      PcapFileWriter::Get ().Submit (&m_file, m_writeBuffer);
+    }
+}
+
 uint32_t
 PcapFile::GetMagic (void)
 {
@@ -206,6 +457,7 @@ PcapFile::WriteFileHeader (void)
   // If we're initializing the file, we need to write the pcap file header
   // at the start of the file.
   //
+  WaitForWriter ();
   m_file.seekp (0, std::ios::beg);
  
   //
@@ -403,7 +655,7 @@ uint32_t
 PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << totalLen);
-  NS_ASSERT (m_file.good ());
+  NS_ASSERT (m_writeBufferSize > 0 || m_file.good ());
 
   uint32_t inclLen = totalLen > m_fileHeader.m_snapLen ? m_fileHeader.m_snapLen : totalLen;
 
@@ -422,11 +674,10 @@ PcapFile::WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen)
   // Watch out for memory alignment differences between machines, so write
   // them all individually.
   //
-  m_file.write ((const char *)&header.m_tsSec, sizeof(header.m_tsSec));
-  m_file.write ((const char *)&header.m_tsUsec, sizeof(header.m_tsUsec));
-  m_file.write ((const char *)&header.m_inclLen, sizeof(header.m_inclLen));
-  m_file.write ((const char *)&header.m_origLen, sizeof(header.m_origLen));
-  NS_BUILD_DEBUG(m_file.flush());
+  WriteBytes (&header.m_tsSec, sizeof(header.m_tsSec));
+  WriteBytes (&header.m_tsUsec, sizeof(header.m_tsUsec));
+  WriteBytes (&header.m_inclLen, sizeof(header.m_inclLen));
+  WriteBytes (&header.m_origLen, sizeof(header.m_origLen));
   return inclLen;
 }
 
@@ -435,8 +686,8 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, uint8_t const * const data, ui
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << &data << totalLen);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, totalLen);
-  m_file.write ((const char *)data, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  WriteBytes (data, inclLen);
+  CheckWriteBuffer ();
 }
 
 void 
@@ -444,8 +695,17 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << tsSec << tsUsec << p);
   uint32_t inclLen = WritePacketHeader (tsSec, tsUsec, p->GetSize ());
-  p->CopyData (&m_file, inclLen);
-  NS_BUILD_DEBUG(m_file.flush());
+  if (m_writeBufferSize == 0)
+    {
+      p->CopyData (&m_file, inclLen);
+    }
+  else
+    {
+      std::size_t offset = m_writeBuffer.size ();
+      m_writeBuffer.resize (offset + inclLen);
+      p->CopyData ((uint8_t *)&m_writeBuffer[offset], inclLen);
+    }
+  CheckWriteBuffer ();
 }
 
 void 
@@ -460,9 +720,20 @@ PcapFile::Write (uint32_t tsSec, uint32_t tsUsec, const Header &header, Ptr<cons
   headerBuffer.AddAtStart (headerSize);
   header.Serialize (headerBuffer.Begin ());
   uint32_t toCopy = std::min (headerSize, inclLen);
-  headerBuffer.CopyData (&m_file, toCopy);
   inclLen -= toCopy;
-  p->CopyData (&m_file, inclLen);
+  if (m_writeBufferSize == 0)
+    {
+      headerBuffer.CopyData (&m_file, toCopy);
+      p->CopyData (&m_file, inclLen);
+    }
+  else
+    {
+      std::size_t offset = m_writeBuffer.size ();
+      m_writeBuffer.resize (offset + toCopy + inclLen);
+      headerBuffer.CopyData ((uint8_t *)&m_writeBuffer[offset], toCopy);
+      p->CopyData ((uint8_t *)&m_writeBuffer[offset + toCopy], inclLen);
+    }
+  CheckWriteBuffer ();
 }
 
 void
@@ -476,6 +747,7 @@ PcapFile::Read (
   uint32_t &readLen)
 {
   NS_LOG_FUNCTION (this << &data <<maxBytes << tsSec << tsUsec << inclLen << origLen << readLen);
+  WaitForWriter ();
   NS_ASSERT (m_file.good ());
 
   PcapRecordHeader header;
@@ -23,6 +23,7 @@
 
 #include <string>
 #include <fstream>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ptr.h"
 
@@ -85,6 +86,28 @@ public:
    */
   void Close (void);
 
+  /**
+   * \brief Set the size of the write buffer
+   *
+   * When the size is not null, records are serialized into a memory
+   * buffer of (about) this size, which is handed over to a background
+   * thread and written to the file once full.  Buffers are written in
+   * the order in which they are handed over.  When the size is null
+   * (the default), each record is written to the file stream directly.
+   *
+   * \param size the size of the write buffer, in bytes
+   */
+  void SetWriteBufferSize (uint32_t size);
+
+  /**
+   * \brief Write the buffered records to the file stream
+   *
+   * Return once the records written so far have been handed to the file
+   * stream and the stream has been flushed, so that another reader can
+   * read them.
+   */
+  void Flush (void);
+
   /**
    * Initialize the pcap file associated with this object.  This file must have
    * been previously opened with write permissions.
@@ -358,6 +381,22 @@ private:
    * \returns the length of the packet to write in the Pcap file
    */
   uint32_t WritePacketHeader (uint32_t tsSec, uint32_t tsUsec, uint32_t totalLen);
+  /**
+   * \brief Write bytes to the write buffer, or to the file if unbuffered
+   * \param data the bytes to write
+   * \param size the number of bytes
+   */
+  void WriteBytes (const void *data, uint32_t size);
+  /**
+   * \brief Hand the write buffer over to the background writer if it is
+   * full, or flush the file stream if unbuffered (in debug builds only)
+   */
+  void CheckWriteBuffer (void);
+  /**
+   * \brief Hand the write buffer over to the background writer and wait
+   * until all the buffers handed over so far are written to the file stream
+   */
+  void WaitForWriter (void);
 
   /**
    * \brief Read and verify a Pcap file header
@@ -369,6 +408,8 @@ private:
   PcapFileHeader m_fileHeader;  //!< file header
   bool m_swapMode;              //!< swap mode
   bool m_nanosecMode;           //!< nanosecond timestamp mode
+  uint32_t m_writeBufferSize;   //!< size of the write buffer (0 if unbuffered)
+  std::vector<char> m_writeBuffer; //!< records not handed to the background writer yet
 };
 
 } // namespace ns3
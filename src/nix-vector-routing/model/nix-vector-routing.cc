@@ -25,6 +25,7 @@
 
 #include <queue>
 #include <iomanip>
+#include <algorithm>
 
 #include "ns3/log.h"
 #include "ns3/abort.h"
@@ -44,12 +45,21 @@ NS_OBJECT_TEMPLATE_CLASS_DEFINE (NixVectorRouting, Ipv6RoutingProtocol);
 template <typename T>
 bool NixVectorRouting<T>::g_isCacheDirty = false;
 
+template <typename T>
+bool NixVectorRouting<T>::g_isAddressRemoved = false;
+
 template <typename T>
 typename NixVectorRouting<T>::IpAddressToNodeMap NixVectorRouting<T>::g_ipAddressToNodeMap;
 
 template <typename T>
 typename NixVectorRouting<T>::NetDeviceToIpInterfaceMap NixVectorRouting<T>::g_netdeviceToIpInterfaceMap;
 
+template <typename T>
+typename NixVectorRouting<T>::Adjacency NixVectorRouting<T>::g_adjacency;
+
+template <typename T>
+const uint32_t NixVectorRouting<T>::NO_NODE;
+
 template <typename T>
 TypeId 
 NixVectorRouting<T>::GetTypeId (void)
@@ -66,7 +76,8 @@ NixVectorRouting<T>::GetTypeId (void)
 
 template <typename T>
 NixVectorRouting<T>::NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_nixCacheFromBfsTree (true),
+    m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -121,6 +132,7 @@ NixVectorRouting<T>::DoDispose ()
 
   m_node = 0;
   m_ip = 0;
+  m_bfsTree = BfsTree ();
 
   T::DoDispose ();
 }
@@ -153,11 +165,106 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache (void) const
       rp->FlushNixCache ();
       rp->FlushIpRouteCache ();
       rp->m_totalNeighbors = 0;
+      rp->m_bfsTree = BfsTree ();
     }
 
   // IP address to node mapping is potentially invalid so clear it.
   // Will be repopulated in lazy evaluation when mapping is needed.
   g_ipAddressToNodeMap.clear ();
+
+  // Likewise for the adjacency of the nodes.
+  g_adjacency = Adjacency ();
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::UpdateGlobalNixRoutingCache (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  uint32_t numberOfNodes = NodeList::GetNNodes ();
+  bool addressRemoved = g_isAddressRemoved;
+  g_isAddressRemoved = false;
+  if (g_adjacency.bfsStart.size () != numberOfNodes + 1)
+    {
+      // the adjacency was not built yet, or nodes were added
+      FlushGlobalNixRoutingCache ();
+      return;
+    }
+
+  // IP address to node mapping is potentially invalid so clear it.
+  g_ipAddressToNodeMap.clear ();
+
+  Adjacency previous;
+  std::swap (previous, g_adjacency);
+  BuildAdjacency ();
+
+  // find the nodes whose neighbors changed
+  std::vector<uint32_t> bfsChanged;
+  std::vector<uint32_t> nixChanged;
+  for (uint32_t i = 0; i < numberOfNodes; i++)
+    {
+      if (!std::equal (previous.bfsNeighbors.begin () + previous.bfsStart[i],
+                       previous.bfsNeighbors.begin () + previous.bfsStart[i + 1],
+                       g_adjacency.bfsNeighbors.begin () + g_adjacency.bfsStart[i],
+                       g_adjacency.bfsNeighbors.begin () + g_adjacency.bfsStart[i + 1]))
+        {
+          bfsChanged.push_back (i);
+        }
+      if (!std::equal (previous.nixNeighbors.begin () + previous.nixStart[i],
+                       previous.nixNeighbors.begin () + previous.nixStart[i + 1],
+                       g_adjacency.nixNeighbors.begin () + g_adjacency.nixStart[i],
+                       g_adjacency.nixNeighbors.begin () + g_adjacency.nixStart[i + 1]))
+        {
+          nixChanged.push_back (i);
+        }
+    }
+  NS_LOG_LOGIC ("Neighbors changed for " << bfsChanged.size () << " nodes in BFS, "
+                << nixChanged.size () << " nodes in nix-vectors");
+
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<Node> node = *i;
+      Ptr<NixVectorRouting<T> > rp = node->GetObject<NixVectorRouting> ();
+      if (!rp)
+        {
+          continue;
+        }
+      // the routes depend on the neighbor indices of any node
+      rp->FlushIpRouteCache ();
+      rp->m_totalNeighbors = 0;
+
+      const BfsTree &tree = rp->m_bfsTree;
+      // the nix-vectors are cached by destination address
+      bool keepNixCache = rp->m_nixCacheFromBfsTree && !tree.parent.empty () && !addressRemoved;
+      if (!tree.parent.empty () && !rp->IsBfsTreeValid (bfsChanged))
+        {
+          NS_LOG_LOGIC ("Flushing BFS tree of node " << node->GetId ());
+          rp->m_bfsTree = BfsTree ();
+          keepNixCache = false;
+        }
+      // the nix-vectors depend on the neighbor indices of the nodes they go through
+      for (std::vector<uint32_t>::const_iterator j = nixChanged.begin (); keepNixCache && j != nixChanged.end (); j++)
+        {
+          uint32_t rank = tree.rank[*j];
+          if (rank == NO_NODE)
+            {
+              continue;
+            }
+          uint32_t end = (rank + 1 < tree.order.size ()) ? tree.firstChild[tree.order[rank + 1]] : tree.order.size ();
+          if (tree.firstChild[*j] < end)
+            {
+              // the node forwards to its children
+              keepNixCache = false;
+            }
+        }
+      if (!keepNixCache)
+        {
+          NS_LOG_LOGIC ("Flushing Nix cache of node " << node->GetId ());
+          rp->FlushNixCache ();
+        }
+    }
 }
 
 template <typename T>
@@ -166,6 +273,7 @@ NixVectorRouting<T>::FlushNixCache (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_nixCache.clear ();
+  m_nixCacheFromBfsTree = true;
 }
 
 template <typename T>
@@ -206,6 +314,34 @@ NixVectorRouting<T>::GetNixVector (Ptr<Node> source, IpAddress dest, Ptr<NetDevi
     {
       // otherwise proceed as normal 
       // and build the nix vector
+      if (!oif)
+        {
+          // a single BFS tree serves all the destinations of the source
+          if (g_adjacency.bfsStart.size () != NodeList::GetNNodes () + 1)
+            {
+              FlushGlobalNixRoutingCache ();
+              BuildAdjacency ();
+            }
+          BfsTree otherTree;
+          BfsTree *tree = &m_bfsTree;
+          if (source != m_node)
+            {
+              tree = &otherTree;
+              m_nixCacheFromBfsTree = false;
+            }
+          if (tree->parent.empty ())
+            {
+              BuildBfsTree (source->GetId (), *tree);
+            }
+          if (BuildNixVectorFromTree (*tree, destNode->GetId (), nixVector))
+            {
+              return nixVector;
+            }
+          NS_LOG_ERROR ("No routing path exists");
+          return 0;
+        }
+
+      m_nixCacheFromBfsTree = false;
       std::vector< Ptr<Node> > parentVector;
 
       if (BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif))
@@ -372,6 +508,190 @@ NixVectorRouting<T>::BuildNixVector (const std::vector< Ptr<Node> > & parentVect
   return true;
 }
 
+template <typename T>
+bool
+NixVectorRouting<T>::BuildNixVectorFromTree (const BfsTree & tree, uint32_t dest, Ptr<NixVector> nixVector)
+{
+  NS_LOG_FUNCTION (dest << nixVector);
+
+  if (dest >= tree.parent.size () || tree.parent[dest] == NO_NODE)
+    {
+      return false;
+    }
+
+  uint32_t source = tree.order.front ();
+  while (dest != source)
+    {
+      uint32_t parent = tree.parent[dest];
+      uint32_t first = g_adjacency.nixStart[parent];
+      uint32_t totalNeighbors = g_adjacency.nixStart[parent + 1] - first;
+
+      // as in BuildNixVector, the last neighbor index matching the node wins
+      uint32_t destId = 0;
+      for (uint32_t i = 0; i < totalNeighbors; i++)
+        {
+          if (g_adjacency.nixNeighbors[first + i] == dest)
+            {
+              destId = i;
+            }
+        }
+      NS_LOG_LOGIC ("Adding Nix: " << destId << " with "
+                                   << nixVector->BitCount (totalNeighbors) << " bits, for node " << parent);
+      nixVector->AddNeighborIndex (destId, nixVector->BitCount (totalNeighbors));
+      dest = parent;
+    }
+  return true;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildAdjacency (void) const
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  g_adjacency = Adjacency ();
+  for (NodeList::Iterator it = NodeList::Begin (); it != NodeList::End (); ++it)
+    {
+      g_adjacency.bfsStart.push_back (g_adjacency.bfsNeighbors.size ());
+      g_adjacency.nixStart.push_back (g_adjacency.nixNeighbors.size ());
+      AddNodeAdjacency (*it, g_adjacency);
+    }
+  g_adjacency.bfsStart.push_back (g_adjacency.bfsNeighbors.size ());
+  g_adjacency.nixStart.push_back (g_adjacency.nixNeighbors.size ());
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::AddNodeAdjacency (Ptr<Node> node, Adjacency & adjacency) const
+{
+  NS_LOG_FUNCTION (this << node);
+
+  Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol> ();
+  uint32_t numberOfDevices = node->GetNDevices ();
+  for (uint32_t i = 0; i < numberOfDevices; i++)
+    {
+      Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+      Ptr<Channel> channel = localNetDevice->GetChannel ();
+      if (channel == 0)
+        {
+          continue;
+        }
+
+      NetDeviceContainer netDeviceContainer;
+      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+
+      // BuildNixVector does not count the neighbors of the bridges
+      if (!localNetDevice->IsBridge ())
+        {
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              adjacency.nixNeighbors.push_back ((*iter)->GetNode ()->GetId ());
+            }
+        }
+
+      // BFS only goes through the interfaces and links up
+      if (ip)
+        {
+          int32_t interfaceIndex = ip->GetInterfaceForDevice (localNetDevice);
+          if (interfaceIndex == -1 || !(ip->IsUp (interfaceIndex)))
+            {
+              continue;
+            }
+        }
+      if (!(localNetDevice->IsLinkUp ()))
+        {
+          continue;
+        }
+      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+        {
+          Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice (*iter);
+          if (remoteIpInterface == 0 || !(remoteIpInterface->IsUp ()))
+            {
+              continue;
+            }
+          adjacency.bfsNeighbors.push_back ((*iter)->GetNode ()->GetId ());
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildBfsTree (uint32_t source, BfsTree & tree)
+{
+  NS_LOG_FUNCTION (source);
+
+  uint32_t numberOfNodes = g_adjacency.bfsStart.size () - 1;
+  tree.parent.assign (numberOfNodes, NO_NODE);
+  tree.rank.assign (numberOfNodes, NO_NODE);
+  tree.firstChild.assign (numberOfNodes, NO_NODE);
+  tree.order.clear ();
+
+  // the source is its own parent, and the nodes are explored in the order
+  // they are reached
+  tree.parent[source] = source;
+  tree.rank[source] = 0;
+  tree.order.push_back (source);
+  for (uint32_t head = 0; head < tree.order.size (); head++)
+    {
+      uint32_t currNode = tree.order[head];
+      tree.firstChild[currNode] = tree.order.size ();
+      for (uint32_t i = g_adjacency.bfsStart[currNode]; i < g_adjacency.bfsStart[currNode + 1]; i++)
+        {
+          uint32_t remoteNode = g_adjacency.bfsNeighbors[i];
+          if (tree.parent[remoteNode] == NO_NODE)
+            {
+              tree.parent[remoteNode] = currNode;
+              tree.rank[remoteNode] = tree.order.size ();
+              tree.order.push_back (remoteNode);
+            }
+        }
+    }
+  NS_LOG_LOGIC ("BFS tree of Node " << source << " reaches " << tree.order.size () << " nodes");
+}
+
+template <typename T>
+bool
+NixVectorRouting<T>::IsBfsTreeValid (const std::vector<uint32_t> & changedNodes) const
+{
+  NS_LOG_FUNCTION (this << changedNodes.size ());
+
+  const BfsTree &tree = m_bfsTree;
+  for (std::vector<uint32_t>::const_iterator it = changedNodes.begin (); it != changedNodes.end (); it++)
+    {
+      uint32_t currNode = *it;
+      if (tree.parent[currNode] == NO_NODE)
+        {
+          // the node is not reached, so its neighbors are not explored
+          continue;
+        }
+
+      // When the node is explored, the nodes ranked before firstChild are
+      // already reached.  Its new neighbors must reach the nodes ranked
+      // from firstChild to the first child of the next node, in this order.
+      uint32_t next = tree.rank[currNode] + 1;
+      uint32_t end = (next < tree.order.size ()) ? tree.firstChild[tree.order[next]] : tree.order.size ();
+      uint32_t reached = tree.firstChild[currNode];
+      for (uint32_t i = g_adjacency.bfsStart[currNode]; i < g_adjacency.bfsStart[currNode + 1]; i++)
+        {
+          uint32_t rank = tree.rank[g_adjacency.bfsNeighbors[i]];
+          if (rank < reached)
+            {
+              continue;
+            }
+          if (rank != reached)
+            {
+              return false;
+            }
+          reached++;
+        }
+      if (reached != end)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::GetAdjacentNetDevices (Ptr<NetDevice> netDevice, Ptr<Channel> channel, NetDeviceContainer & netDeviceContainer) const
@@ -1048,6 +1368,7 @@ void
 NixVectorRouting<T>::NotifyRemoveAddress (uint32_t interface, IpInterfaceAddress address)
 {
   g_isCacheDirty = true;
+  g_isAddressRemoved = true;
 }
 template <typename T>
 void
@@ -1359,7 +1680,7 @@ NixVectorRouting<T>::CheckCacheStateAndFlush (void) const
 {
   if (g_isCacheDirty)
     {
-      FlushGlobalNixRoutingCache ();
+      UpdateGlobalNixRoutingCache ();
       g_isCacheDirty = false;
     }
 }
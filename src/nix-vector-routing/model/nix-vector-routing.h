@@ -113,7 +113,7 @@ public:
   /**
    * @brief Called when run-time link topology change occurs
    * which iterates through the node list and flushes any
-   * nix vector caches
+   * nix vector caches, BFS trees and the adjacency of the nodes
    *
    * \internal
    * \c const is used here due to need to potentially flush the cache
@@ -137,6 +137,34 @@ public:
 
 private:
 
+  /// Value of a node index meaning no node
+  static const uint32_t NO_NODE = 0xffffffff;
+
+  /**
+   * Neighbors of all the nodes, in compressed rows indexed by node id.
+   * The rows of each node are the concatenation of the adjacent net
+   * devices of its net devices, as found by GetAdjacentNetDevices.
+   */
+  struct Adjacency
+  {
+    std::vector<uint32_t> bfsStart;     //!< first neighbor of each node in bfsNeighbors, plus the end
+    std::vector<uint32_t> bfsNeighbors; //!< neighbors explored by BFS, i.e., through the net devices up
+    std::vector<uint32_t> nixStart;     //!< first neighbor of each node in nixNeighbors, plus the end
+    std::vector<uint32_t> nixNeighbors; //!< neighbors in the order of their nix index
+  };
+
+  /**
+   * Tree of the shortest paths from a source node, as found by BFS
+   * without a specific output interface.
+   */
+  struct BfsTree
+  {
+    std::vector<uint32_t> parent;     //!< parent of each node, or NO_NODE if not reached
+    std::vector<uint32_t> order;      //!< nodes in the order they were reached
+    std::vector<uint32_t> rank;       //!< position of each node in order
+    std::vector<uint32_t> firstChild; //!< position in order of the first node reached from each node
+  };
+
   /**
    * Flushes the cache which stores nix-vector based on
    * destination IP
@@ -149,6 +177,43 @@ private:
    */
   void FlushIpRouteCache (void) const;
 
+  /**
+   * Upon a run-time topology change, the adjacency of the nodes is
+   * built again and compared with the previous one.  Each node keeps its
+   * BFS tree, and its nix-vectors, if the nodes whose neighbors changed
+   * leave them unchanged; the Ip route caches are flushed.
+   */
+  void UpdateGlobalNixRoutingCache (void) const;
+
+  /**
+   * Builds the adjacency of all the nodes from their net devices
+   * and channels.
+   */
+  void BuildAdjacency (void) const;
+
+  /**
+   * Appends the neighbors of a node to the adjacency.
+   * \param [in] node the node
+   * \param [out] adjacency the adjacency to fill
+   */
+  void AddNodeAdjacency (Ptr<Node> node, Adjacency & adjacency) const;
+
+  /**
+   * Checks if the BFS tree rooted at this node is still valid after the
+   * neighbors of some nodes changed, i.e., if each of these nodes still
+   * reaches the same children in the same order.
+   * \param [in] changedNodes the nodes whose neighbors explored by BFS changed
+   * \returns true if the BFS tree is still valid
+   */
+  bool IsBfsTreeValid (const std::vector<uint32_t> & changedNodes) const;
+
+  /**
+   * Builds the BFS tree rooted at a node over the adjacency of the nodes.
+   * \param [in] source Source Node index
+   * \param [out] tree the BFS tree
+   */
+  static void BuildBfsTree (uint32_t source, BfsTree & tree);
+
   /**
    * Upon a run-time topology change caches are
    * flushed and the total number of neighbors is
@@ -218,6 +283,17 @@ private:
    */
   bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector) const;
 
+  /**
+   * Walks the BFS tree from the destination up to the source and builds
+   * the nixvector, using the neighbor indices of the adjacency of the nodes.
+   * Equivalent to BuildNixVector over the parent vector of the BFS.
+   * \param [in] tree BFS tree rooted at the source
+   * \param [in] dest Destination Node index
+   * \param [out] nixVector the NixVector to be used for routing
+   * \returns true on success, false otherwise.
+   */
+  static bool BuildNixVectorFromTree (const BfsTree & tree, uint32_t dest, Ptr<NixVector> nixVector);
+
   /**
    * Special variation of BuildNixVector for when a node is sending to itself
    * \param [out] nixVector the NixVector to be used for routing
@@ -455,9 +531,27 @@ private:
    */
   static bool g_isCacheDirty;
 
+  /**
+   * Flag to mark when an address was removed since the caches were last
+   * updated, so that the nix-vectors cached for it are flushed.
+   */
+  static bool g_isAddressRemoved;
+
   /** Cache stores nix-vectors based on destination ip */
   mutable NixMap_t m_nixCache;
 
+  /**
+   * Whether all the nix-vectors in m_nixCache were built from
+   * m_bfsTree, rather than for another source node or output interface
+   */
+  mutable bool m_nixCacheFromBfsTree;
+
+  /** Adjacency of the nodes, shared by all the nodes; empty if not built */
+  static Adjacency g_adjacency;
+
+  /** BFS tree rooted at this node; empty if not built */
+  mutable BfsTree m_bfsTree;
+
   /** Cache stores IpRoutes based on destination ip */
   mutable IpRouteMap_t m_ipRouteCache;
 
@@ -34,6 +34,7 @@
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
 
 using namespace ns3;
 /**
@@ -364,6 +365,157 @@ NixVectorRoutingTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * The topology is a ring of six routers, with two chords, and a host
+ * attached to each router:
+ * \verbatim
+    h0    h1    h2
+    |     |     |
+    r0 -- r1 -- r2
+    |  \        |
+    |   \____   |
+    |        \  |
+    r5 -- r4 -- r3
+    |     |     |
+    h5    h4    h3
+   \endverbatim
+ * (r1 is also linked to r4.)
+ *
+ * The interfaces of a host and of some routers are set down one after
+ * the other.  After each change, the paths printed by every node to
+ * every host through its own routing object, which keeps the BFS tree
+ * and the nix-vectors that are still valid, must be the same as those
+ * printed after all the caches are flushed.
+ *
+ * \brief Nix-Vector Routing incremental cache update Test
+ */
+class NixVectorRoutingIncrementalTest : public TestCase
+{
+public:
+  NixVectorRoutingIncrementalTest ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Print the paths from every node to every host.
+   * \return the paths
+   */
+  std::string PrintAllPaths (void);
+
+  /**
+   * Compare the paths printed with the caches to those printed after
+   * flushing the caches.
+   * \param step the number of the check
+   */
+  void CheckPaths (uint32_t step);
+
+  NodeContainer m_nodes;                    //!< Routers and hosts
+  std::vector<Ipv4Address> m_hostAddresses; //!< Addresses of the hosts
+};
+
+NixVectorRoutingIncrementalTest::NixVectorRoutingIncrementalTest ()
+  : TestCase ("incremental update of the caches on link changes")
+{
+}
+
+std::string
+NixVectorRoutingIncrementalTest::PrintAllPaths (void)
+{
+  std::ostringstream stringStream;
+  Ptr<OutputStreamWrapper> stream = Create<OutputStreamWrapper> (&stringStream);
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<Node> source = m_nodes.Get (i);
+      Ptr<Ipv4NixVectorRouting> routing = source->GetObject<Ipv4NixVectorRouting> ();
+      for (std::vector<Ipv4Address>::const_iterator j = m_hostAddresses.begin (); j != m_hostAddresses.end (); j++)
+        {
+          routing->PrintRoutingPath (source, *j, stream, Time::S);
+        }
+    }
+  return stringStream.str ();
+}
+
+void
+NixVectorRoutingIncrementalTest::CheckPaths (uint32_t step)
+{
+  // twice, so that the second time is served by the caches
+  std::string cached = PrintAllPaths ();
+  NS_TEST_EXPECT_MSG_EQ (PrintAllPaths (), cached, "step " << step << ": the cached paths changed");
+  m_nodes.Get (0)->GetObject<Ipv4NixVectorRouting> ()->FlushGlobalNixRoutingCache ();
+  NS_TEST_EXPECT_MSG_EQ (PrintAllPaths (), cached, "step " << step << ": the paths differ from those after a flush");
+}
+
+void
+NixVectorRoutingIncrementalTest::DoRun (void)
+{
+  NodeContainer routers;
+  routers.Create (6);
+  NodeContainer hosts;
+  hosts.Create (6);
+  m_nodes = NodeContainer (routers, hosts);
+
+  Ipv4NixVectorHelper ipv4NixRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (ipv4NixRouting);
+  stack.SetIpv6StackInstall (false);
+  stack.Install (m_nodes);
+
+  SimpleNetDeviceHelper devHelper;
+  devHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.0.0", "255.255.255.0");
+  std::vector<NetDeviceContainer> links;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      links.push_back (devHelper.Install (NodeContainer (routers.Get (i), routers.Get ((i + 1) % 6))));
+      address.Assign (links.back ());
+      address.NewNetwork ();
+    }
+  links.push_back (devHelper.Install (NodeContainer (routers.Get (0), routers.Get (3))));
+  address.Assign (links.back ());
+  address.NewNetwork ();
+  links.push_back (devHelper.Install (NodeContainer (routers.Get (1), routers.Get (4))));
+  address.Assign (links.back ());
+  address.NewNetwork ();
+  std::vector<NetDeviceContainer> hostLinks;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      hostLinks.push_back (devHelper.Install (NodeContainer (routers.Get (i), hosts.Get (i))));
+      Ipv4InterfaceContainer interfaces = address.Assign (hostLinks.back ());
+      m_hostAddresses.push_back (interfaces.GetAddress (1));
+      address.NewNetwork ();
+    }
+
+  Simulator::Schedule (Seconds (1), &NixVectorRoutingIncrementalTest::CheckPaths, this, 0);
+
+  // the interface of a host
+  Ptr<Ipv4> ipv4 = hosts.Get (2)->GetObject<Ipv4> ();
+  Simulator::Schedule (Seconds (2), &Ipv4::SetDown, ipv4, ipv4->GetInterfaceForDevice (hostLinks[2].Get (1)));
+  Simulator::Schedule (Seconds (3), &NixVectorRoutingIncrementalTest::CheckPaths, this, 1);
+
+  // a chord, then a link of the ring
+  ipv4 = routers.Get (0)->GetObject<Ipv4> ();
+  Simulator::Schedule (Seconds (4), &Ipv4::SetDown, ipv4, ipv4->GetInterfaceForDevice (links[6].Get (0)));
+  Simulator::Schedule (Seconds (5), &NixVectorRoutingIncrementalTest::CheckPaths, this, 2);
+  ipv4 = routers.Get (5)->GetObject<Ipv4> ();
+  Simulator::Schedule (Seconds (6), &Ipv4::SetDown, ipv4, ipv4->GetInterfaceForDevice (links[4].Get (1)));
+  Simulator::Schedule (Seconds (7), &NixVectorRoutingIncrementalTest::CheckPaths, this, 3);
+
+  // and back up
+  Simulator::Schedule (Seconds (8), &Ipv4::SetUp, ipv4, ipv4->GetInterfaceForDevice (links[4].Get (1)));
+  ipv4 = hosts.Get (2)->GetObject<Ipv4> ();
+  Simulator::Schedule (Seconds (8), &Ipv4::SetUp, ipv4, ipv4->GetInterfaceForDevice (hostLinks[2].Get (1)));
+  Simulator::Schedule (Seconds (9), &NixVectorRoutingIncrementalTest::CheckPaths, this, 4);
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup nix-vector-routing-test
  * \ingroup tests
@@ -376,6 +528,7 @@ public:
   NixVectorRoutingTestSuite () : TestSuite ("nix-vector-routing", UNIT)
   {
     AddTestCase (new NixVectorRoutingTest (), TestCase::QUICK);
+    AddTestCase (new NixVectorRoutingIncrementalTest (), TestCase::QUICK);
   }
 };
 
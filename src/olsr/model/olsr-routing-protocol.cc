@@ -200,6 +200,8 @@ RoutingProtocol::GetTypeId (void)
 RoutingProtocol::RoutingProtocol (void)
   : m_routingTableAssociation (0),
   m_ipv4 (0),
+  m_routingTableOutdated (false),
+  m_routingTableExpiry (Time::Max ()),
   m_helloTimer (Timer::CANCEL_ON_DESTROY),
   m_tcTimer (Timer::CANCEL_ON_DESTROY),
   m_midTimer (Timer::CANCEL_ON_DESTROY),
@@ -262,6 +264,7 @@ void RoutingProtocol::DoDispose (void)
       iter->first->Close ();
     }
   m_sendSockets.clear ();
+  m_routingTableUpdate.Cancel ();
   m_table.clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
@@ -595,8 +598,9 @@ RoutingProtocol::RecvOlsr (Ptr<Socket> socket)
         }
     }
 
-  // After processing all OLSR messages, we must recompute the routing table
-  RoutingTableComputation ();
+  // After processing all OLSR messages, we must recompute the routing table,
+  // once for all the messages received in this instant
+  ScheduleRoutingTableUpdate ();
 }
 
 ///
@@ -980,6 +984,21 @@ RoutingProtocol::RoutingTableComputation  (void)
 
   // 1. All the entries from the routing table are removed.
   Clear ();
+  m_routingTableUpdate.Cancel ();
+  m_routingTableOutdated = false;
+  m_topologyRouteLastAddr.clear ();
+  m_ifaceAssocRouteDestAddr.clear ();
+
+  // The links still valid now may expire before the next computation.
+  m_routingTableExpiry = Time::Max ();
+  const LinkSet &links = m_state.GetLinks ();
+  for (LinkSet::const_iterator it = links.begin (); it != links.end (); it++)
+    {
+      if (it->time >= Simulator::Now ())
+        {
+          m_routingTableExpiry = std::min (m_routingTableExpiry, it->time);
+        }
+    }
 
   // 2. The new routing entries are added starting with the
   // symmetric neighbors (h=1) as the destination nodes.
@@ -1160,6 +1179,7 @@ RoutingProtocol::RoutingTableComputation  (void)
                         lastAddrEntry.nextAddr,
                         lastAddrEntry.interface,
                         h + 1);
+              m_topologyRouteLastAddr[topology_tuple.destAddr] = topology_tuple.lastAddr;
               added = true;
             }
           else
@@ -1203,6 +1223,7 @@ RoutingProtocol::RoutingTableComputation  (void)
                     entry1.nextAddr,
                     entry1.interface,
                     entry1.distance);
+          m_ifaceAssocRouteDestAddr.insert (tuple.ifaceAddr);
         }
     }
 
@@ -1214,7 +1235,7 @@ RoutingProtocol::RoutingTableComputation  (void)
   const AssociationSet &associationSet = m_state.GetAssociationSet ();
 
   // Clear HNA routing table
-  for (uint32_t i = 0; i < m_hnaRoutingTable->GetNRoutes (); i++)
+  while (m_hnaRoutingTable->GetNRoutes () > 0)
     {
       m_hnaRoutingTable->RemoveRoute (0);
     }
@@ -1288,6 +1309,76 @@ RoutingProtocol::RoutingTableComputation  (void)
   m_routingTableChanged (GetSize ());
 }
 
+void
+RoutingProtocol::InvalidateRoutingTable (void)
+{
+  m_routingTableOutdated = true;
+  ScheduleRoutingTableUpdate ();
+}
+
+void
+RoutingProtocol::ScheduleRoutingTableUpdate (void)
+{
+  if (!m_routingTableUpdate.IsRunning ()
+      && (m_routingTableOutdated || Simulator::Now () > m_routingTableExpiry))
+    {
+      m_routingTableUpdate = Simulator::ScheduleNow (&RoutingProtocol::UpdateRoutingTable, this);
+    }
+}
+
+void
+RoutingProtocol::UpdateRoutingTable (void)
+{
+  m_routingTableUpdate.Cancel ();
+  if (m_routingTableOutdated || Simulator::Now () > m_routingTableExpiry)
+    {
+      RoutingTableComputation ();
+    }
+}
+
+void
+RoutingProtocol::TopologyTupleChanged (const TopologyTuple &tuple, bool added)
+{
+  if (m_routingTableOutdated)
+    {
+      return;
+    }
+
+  if (added)
+    {
+      // The tuple is only used by step 3.1 if its last hop is at least
+      // 2 hops away, through a route not computed from the interface
+      // association set.  Being the last tuple of the topology set, it
+      // then loses against any route to its destination as short.
+      std::map<Ipv4Address, RoutingTableEntry>::const_iterator last = m_table.find (tuple.lastAddr);
+      if (last == m_table.end () || last->second.distance < 2
+          || m_ifaceAssocRouteDestAddr.count (tuple.lastAddr) > 0)
+        {
+          return;
+        }
+      std::map<Ipv4Address, RoutingTableEntry>::const_iterator dest = m_table.find (tuple.destAddr);
+      if (dest != m_table.end () && m_ifaceAssocRouteDestAddr.count (tuple.destAddr) == 0
+          && dest->second.distance <= last->second.distance + 1)
+        {
+          return;
+        }
+    }
+  else
+    {
+      // A tuple which did not give the route to its destination had no
+      // effect on the routing table.
+      std::map<Ipv4Address, Ipv4Address>::const_iterator route = m_topologyRouteLastAddr.find (tuple.destAddr);
+      if (route == m_topologyRouteLastAddr.end () || route->second != tuple.lastAddr)
+        {
+          return;
+        }
+    }
+
+  NS_LOG_LOGIC ("Node " << m_mainAddress << ": topology tuple " << tuple
+                        << (added ? " added" : " removed") << " => routing table outdated");
+  InvalidateRoutingTable ();
+}
+
 
 void
 RoutingProtocol::ProcessHello (const olsr::MessageHeader &msg,
@@ -1374,6 +1465,14 @@ RoutingProtocol::ProcessTc (const olsr::MessageHeader &msg,
   //    T_last_addr == originator address AND
   //    T_seq       <  ANSN
   // MUST be removed from the topology set.
+  for (TopologySet::const_iterator it = m_state.GetTopologySet ().begin ();
+       it != m_state.GetTopologySet ().end (); it++)
+    {
+      if (it->lastAddr == msg.GetOriginatorAddress () && it->sequenceNumber < tc.ansn)
+        {
+          TopologyTupleChanged (*it, false);
+        }
+    }
   m_state.EraseOlderTopologyTuples (msg.GetOriginatorAddress (), tc.ansn);
 
   // 4. For each of the advertised neighbor main address received in
@@ -1487,18 +1586,29 @@ RoutingProtocol::ProcessMid (const olsr::MessageHeader &msg,
   // 3. (not part of the RFC) iterate over all NeighborTuple's and
   // TwoHopNeighborTuples, update the neighbor addresses taking into account
   // the new MID information.
+  bool renamed = false;
   NeighborSet &neighbors = m_state.GetNeighbors ();
   for (NeighborSet::iterator neighbor = neighbors.begin (); neighbor != neighbors.end (); neighbor++)
     {
-      neighbor->neighborMainAddr = GetMainAddress (neighbor->neighborMainAddr);
+      Ipv4Address mainAddr = GetMainAddress (neighbor->neighborMainAddr);
+      renamed |= (mainAddr != neighbor->neighborMainAddr);
+      neighbor->neighborMainAddr = mainAddr;
     }
 
   TwoHopNeighborSet &twoHopNeighbors = m_state.GetTwoHopNeighbors ();
   for (TwoHopNeighborSet::iterator twoHopNeighbor = twoHopNeighbors.begin ();
        twoHopNeighbor != twoHopNeighbors.end (); twoHopNeighbor++)
     {
-      twoHopNeighbor->neighborMainAddr = GetMainAddress (twoHopNeighbor->neighborMainAddr);
-      twoHopNeighbor->twoHopNeighborAddr = GetMainAddress (twoHopNeighbor->twoHopNeighborAddr);
+      Ipv4Address neighborMainAddr = GetMainAddress (twoHopNeighbor->neighborMainAddr);
+      Ipv4Address twoHopNeighborAddr = GetMainAddress (twoHopNeighbor->twoHopNeighborAddr);
+      renamed |= (neighborMainAddr != twoHopNeighbor->neighborMainAddr
+                  || twoHopNeighborAddr != twoHopNeighbor->twoHopNeighborAddr);
+      twoHopNeighbor->neighborMainAddr = neighborMainAddr;
+      twoHopNeighbor->twoHopNeighborAddr = twoHopNeighborAddr;
+    }
+  if (renamed)
+    {
+      InvalidateRoutingTable ();
     }
   NS_LOG_DEBUG ("Node " << m_mainAddress << " ProcessMid from " << senderIface << " -> END.");
 }
@@ -1931,6 +2041,7 @@ RoutingProtocol::AddHostNetworkAssociation (Ipv4Address networkAddr, Ipv4Mask ne
   // If the tuple does not already exist, add it to the list of local HNA associations.
   NS_LOG_INFO ("Adding HNA association for network " << networkAddr << "/" << netmask << ".");
   m_state.InsertAssociation ( (Association) { networkAddr, netmask} );
+  InvalidateRoutingTable ();
 }
 
 void
@@ -1938,6 +2049,7 @@ RoutingProtocol::RemoveHostNetworkAssociation (Ipv4Address networkAddr, Ipv4Mask
 {
   NS_LOG_INFO ("Removing HNA association for network " << networkAddr << "/" << netmask << ".");
   m_state.EraseAssociation ( (Association) { networkAddr, netmask} );
+  InvalidateRoutingTable ();
 }
 
 void
@@ -2025,6 +2137,11 @@ RoutingProtocol::LinkSensing (const olsr::MessageHeader &msg,
     {
       NS_LOG_LOGIC ("Existing link tuple already exists => will update it");
       updated = true;
+      if (link_tuple->time < now)
+        {
+          // the expired link, ignored by the routing table, is valid again
+          InvalidateRoutingTable ();
+        }
     }
 
   link_tuple->asymTime = now + msg.GetVTime ();
@@ -2150,6 +2267,10 @@ RoutingProtocol::PopulateNeighborSet (const olsr::MessageHeader &msg,
   NeighborTuple *nb_tuple = m_state.FindNeighborTuple (msg.GetOriginatorAddress ());
   if (nb_tuple != NULL)
     {
+      if (nb_tuple->willingness != hello.willingness)
+        {
+          InvalidateRoutingTable ();
+        }
       nb_tuple->willingness = hello.willingness;
     }
 }
@@ -2247,6 +2368,10 @@ RoutingProtocol::PopulateTwoHopNeighborSet (const olsr::MessageHeader &msg,
                   // Address AND N_2hop_addr == main address of the
                   // 2-hop neighbor are deleted.
                   NS_LOG_LOGIC ("2-hop neighbor is NOT_NEIGH => deleting matching 2-hop neighbor state");
+                  if (m_state.FindTwoHopNeighborTuple (msg.GetOriginatorAddress (), nb2hop_addr) != NULL)
+                    {
+                      InvalidateRoutingTable ();
+                    }
                   m_state.EraseTwoHopNeighborTuples (msg.GetOriginatorAddress (), nb2hop_addr);
                 }
               else
@@ -2368,7 +2493,7 @@ RoutingProtocol::NeighborLoss (const LinkTuple &tuple)
   m_state.EraseMprSelectorTuples (GetMainAddress (tuple.neighborIfaceAddr));
 
   MprComputation ();
-  RoutingTableComputation ();
+  InvalidateRoutingTable ();
 }
 
 void
@@ -2422,6 +2547,7 @@ RoutingProtocol::RemoveLinkTuple (const LinkTuple &tuple)
 
   m_state.EraseNeighborTuple (GetMainAddress (tuple.neighborIfaceAddr));
   m_state.EraseLinkTuple (tuple);
+  InvalidateRoutingTable ();
 }
 
 void
@@ -2473,6 +2599,10 @@ RoutingProtocol::LinkTupleUpdated (const LinkTuple &tuple, uint8_t willingness)
           NS_LOG_DEBUG (*nb_tuple << "->status = STATUS_NOT_SYM; changed:"
                                   << int (statusBefore != nb_tuple->status));
         }
+      if (statusBefore != nb_tuple->status)
+        {
+          InvalidateRoutingTable ();
+        }
     }
   else
     {
@@ -2491,6 +2621,7 @@ RoutingProtocol::AddNeighborTuple (const NeighborTuple &tuple)
 
   m_state.InsertNeighborTuple (tuple);
   IncrementAnsn ();
+  InvalidateRoutingTable ();
 }
 
 void
@@ -2504,6 +2635,7 @@ RoutingProtocol::RemoveNeighborTuple (const NeighborTuple &tuple)
 
   m_state.EraseNeighborTuple (tuple);
   IncrementAnsn ();
+  InvalidateRoutingTable ();
 }
 
 void
@@ -2516,6 +2648,7 @@ RoutingProtocol::AddTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple)
 //         OLSR::node_id(tuple->twoHopNeighborAddr));
 
   m_state.InsertTwoHopNeighborTuple (tuple);
+  InvalidateRoutingTable ();
 }
 
 void
@@ -2528,6 +2661,7 @@ RoutingProtocol::RemoveTwoHopNeighborTuple (const TwoHopNeighborTuple &tuple)
 //         OLSR::node_id(tuple->twoHopNeighborAddr));
 
   m_state.EraseTwoHopNeighborTuple (tuple);
+  InvalidateRoutingTable ();
 }
 
 void
@@ -2571,6 +2705,7 @@ RoutingProtocol::AddTopologyTuple (const TopologyTuple &tuple)
 //         tuple->seq());
 
   m_state.InsertTopologyTuple (tuple);
+  TopologyTupleChanged (tuple, true);
 }
 
 void
@@ -2583,6 +2718,7 @@ RoutingProtocol::RemoveTopologyTuple (const TopologyTuple &tuple)
 //         OLSR::node_id(tuple->last_addr()),
 //         tuple->seq());
 
+  TopologyTupleChanged (tuple, false);
   m_state.EraseTopologyTuple (tuple);
 }
 
@@ -2596,6 +2732,7 @@ RoutingProtocol::AddIfaceAssocTuple (const IfaceAssocTuple &tuple)
 //         OLSR::node_id(tuple->iface_addr()));
 
   m_state.InsertIfaceAssocTuple (tuple);
+  InvalidateRoutingTable ();
 }
 
 void
@@ -2608,18 +2745,21 @@ RoutingProtocol::RemoveIfaceAssocTuple (const IfaceAssocTuple &tuple)
 //         OLSR::node_id(tuple->iface_addr()));
 
   m_state.EraseIfaceAssocTuple (tuple);
+  InvalidateRoutingTable ();
 }
 
 void
 RoutingProtocol::AddAssociationTuple (const AssociationTuple &tuple)
 {
   m_state.InsertAssociationTuple (tuple);
+  InvalidateRoutingTable ();
 }
 
 void
 RoutingProtocol::RemoveAssociationTuple (const AssociationTuple &tuple)
 {
   m_state.EraseAssociationTuple (tuple);
+  InvalidateRoutingTable ();
 }
 
 uint16_t RoutingProtocol::GetPacketSequenceNumber ()
@@ -2884,6 +3024,11 @@ Ptr<Ipv4Route>
 RoutingProtocol::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
 {
   NS_LOG_FUNCTION (this << " " << m_ipv4->GetObject<Node> ()->GetId () << " " << header.GetDestination () << " " << oif);
+  if (m_routingTableUpdate.IsRunning ())
+    {
+      // do not wait for the end of the instant to apply the last changes
+      UpdateRoutingTable ();
+    }
   Ptr<Ipv4Route> rtentry;
   RoutingTableEntry entry1, entry2;
   bool found = false;
@@ -2965,6 +3110,11 @@ bool RoutingProtocol::RouteInput  (Ptr<const Packet> p,
                                    LocalDeliverCallback lcb, ErrorCallback ecb)
 {
   NS_LOG_FUNCTION (this << " " << m_ipv4->GetObject<Node> ()->GetId () << " " << header.GetDestination ());
+  if (m_routingTableUpdate.IsRunning ())
+    {
+      // do not wait for the end of the instant to apply the last changes
+      UpdateRoutingTable ();
+    }
 
   Ipv4Address dst = header.GetDestination ();
   Ipv4Address origin = header.GetSource ();
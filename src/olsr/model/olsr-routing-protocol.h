@@ -42,9 +42,12 @@
 
 #include <vector>
 #include <map>
+#include <set>
 
 /// Testcase for MPR computation mechanism
 class OlsrMprTestCase;
+/// Testcase for the updates of the routing table
+class OlsrRoutingTableUpdateTestCase;
 
 namespace ns3 {
 namespace olsr {
@@ -84,6 +87,10 @@ public:
    * Declared friend to enable unit tests.
    */
   friend class ::OlsrMprTestCase;
+  /**
+   * Declared friend to enable unit tests.
+   */
+  friend class ::OlsrRoutingTableUpdateTestCase;
 
   static const uint16_t OLSR_PORT_NUMBER; //!< port number (698)
 
@@ -259,6 +266,14 @@ private:
   OlsrState m_state;  //!< Internal state with all needed data structs.
   Ptr<Ipv4> m_ipv4;   //!< IPv4 object the routing is linked to.
 
+  bool m_routingTableOutdated;  //!< True if the sets changed since the last routing table computation.
+  Time m_routingTableExpiry;    //!< Time after which a link used by the last computation may have expired.
+  EventId m_routingTableUpdate; //!< Pending update of the routing table at the end of the current instant.
+  /// Last hop of the routes computed from the topology set, by destination.
+  std::map<Ipv4Address, Ipv4Address> m_topologyRouteLastAddr;
+  /// Destinations of the routes computed from the interface association set.
+  std::set<Ipv4Address> m_ifaceAssocRouteDestAddr;
+
   /**
    * \brief Clears the routing table and frees the memory assigned to each one of its entries.
    */
@@ -401,6 +416,41 @@ private:
    */
   void RoutingTableComputation (void);
 
+  /**
+   * \brief Records that the sets changed in a way that may change the
+   * routing table, and schedules its update.
+   */
+  void InvalidateRoutingTable (void);
+
+  /**
+   * \brief Schedules the update of the routing table at the end of the
+   * current instant, if it may be outdated.
+   *
+   * All the changes of the sets within one instant are thus applied by a
+   * single routing table computation.
+   */
+  void ScheduleRoutingTableUpdate (void);
+
+  /**
+   * \brief Recomputes the routing table if the sets changed, or if a link
+   * used by the last computation may have expired, since then.
+   */
+  void UpdateRoutingTable (void);
+
+  /**
+   * \brief Records the addition or removal of a topology tuple.
+   *
+   * The routing table is only invalidated if the tuple changes a route:
+   * an added tuple, which is the last one of the topology set, only gives
+   * a route to its destination if it is shorter than the current one, and
+   * a removed tuple only changes the routes if it gave the route to its
+   * destination.
+   *
+   * \param tuple The topology tuple.
+   * \param added True if the tuple is added, false if it is removed.
+   */
+  void TopologyTupleChanged (const TopologyTuple &tuple, bool added);
+
 public:
   /**
    * \brief Gets the main address associated with a given interface address.
@@ -23,6 +23,15 @@
 #include "ns3/test.h"
 #include "ns3/olsr-routing-protocol.h"
 #include "ns3/ipv4-header.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/olsr-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
 
 /**
  * \ingroup olsr
@@ -178,6 +187,168 @@ OlsrMprTestCase::DoRun ()
   NS_TEST_EXPECT_MSG_EQ ((mpr.find ("10.0.0.9") == mpr.end ()), true, "Node 1 must NOT select node 8 as MPR");
 }
 
+/**
+ * \ingroup olsr-test
+ * \ingroup tests
+ *
+ * Testcase checking that the routing table, updated only when the sets
+ * change and once per instant, matches a full computation.
+ *
+ * The nodes share a channel, where links appear and break as the nodes
+ * jump to random positions on a line.
+ */
+class OlsrRoutingTableUpdateTestCase : public TestCase
+{
+public:
+  OlsrRoutingTableUpdateTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /// Move a node to a random position, and update the links accordingly.
+  void MoveNode (void);
+  /// Compare the routing table of each node with a full computation.
+  void CheckRoutingTables (void);
+  /**
+   * Count the routing table computations of the protocol.
+   * \param size the size of the routing table
+   */
+  void RoutingTableChanged (uint32_t size);
+  /**
+   * Count the packets received by the protocol.
+   * \param header the packet header
+   * \param messages the messages of the packet
+   */
+  void Rx (const PacketHeader &header, const MessageList &messages);
+
+  NodeContainer m_nodes;                    //!< The nodes.
+  NetDeviceContainer m_devices;             //!< The devices of the nodes.
+  std::vector<double> m_positions;          //!< The position of each node.
+  Ptr<UniformRandomVariable> m_random;      //!< The random positions.
+  bool m_checking;                          //!< True while checking the routing tables.
+  uint32_t m_computations;                  //!< Number of routing table computations.
+  uint32_t m_receptions;                    //!< Number of OLSR packets received.
+  uint32_t m_routes;                        //!< Number of routes checked.
+};
+
+OlsrRoutingTableUpdateTestCase::OlsrRoutingTableUpdateTestCase ()
+  : TestCase ("Check the updates of the OLSR routing table against a full computation"),
+    m_checking (false),
+    m_computations (0),
+    m_receptions (0),
+    m_routes (0)
+{
+}
+
+void
+OlsrRoutingTableUpdateTestCase::MoveNode (void)
+{
+  m_positions[m_random->GetInteger (0, m_nodes.GetN () - 1)] = m_random->GetValue (0, 1000);
+  Ptr<SimpleChannel> channel = DynamicCast<SimpleChannel> (m_devices.Get (0)->GetChannel ());
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      for (uint32_t j = 0; j < m_nodes.GetN (); j++)
+        {
+          Ptr<SimpleNetDevice> from = DynamicCast<SimpleNetDevice> (m_devices.Get (i));
+          Ptr<SimpleNetDevice> to = DynamicCast<SimpleNetDevice> (m_devices.Get (j));
+          if (i != j && std::abs (m_positions[i] - m_positions[j]) > 150)
+            {
+              channel->BlackList (from, to);
+            }
+          else
+            {
+              channel->UnBlackList (from, to);
+            }
+        }
+    }
+  Simulator::Schedule (Seconds (10), &OlsrRoutingTableUpdateTestCase::MoveNode, this);
+}
+
+void
+OlsrRoutingTableUpdateTestCase::CheckRoutingTables (void)
+{
+  m_checking = true;
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<RoutingProtocol> protocol = m_nodes.Get (i)->GetObject<RoutingProtocol> ();
+      protocol->UpdateRoutingTable ();
+      std::map<Ipv4Address, RoutingTableEntry> table = protocol->m_table;
+      protocol->RoutingTableComputation ();
+      NS_TEST_ASSERT_MSG_EQ (table.size (), protocol->m_table.size (),
+                             "node " << i << " at " << Simulator::Now ().As (Time::S) << ": wrong number of routes");
+      for (std::map<Ipv4Address, RoutingTableEntry>::const_iterator it = table.begin (); it != table.end (); it++)
+        {
+          RoutingTableEntry entry;
+          NS_TEST_ASSERT_MSG_EQ (protocol->Lookup (it->first, entry), true,
+                                 "node " << i << " at " << Simulator::Now ().As (Time::S) << ": extra route to " << it->first);
+          NS_TEST_ASSERT_MSG_EQ (it->second.nextAddr, entry.nextAddr, "node " << i << ": wrong next hop to " << it->first);
+          NS_TEST_ASSERT_MSG_EQ (it->second.interface, entry.interface, "node " << i << ": wrong interface to " << it->first);
+          NS_TEST_ASSERT_MSG_EQ (it->second.distance, entry.distance, "node " << i << ": wrong distance to " << it->first);
+          m_routes++;
+        }
+    }
+  m_checking = false;
+  Simulator::Schedule (Seconds (0.5), &OlsrRoutingTableUpdateTestCase::CheckRoutingTables, this);
+}
+
+void
+OlsrRoutingTableUpdateTestCase::RoutingTableChanged (uint32_t size)
+{
+  if (!m_checking)
+    {
+      m_computations++;
+    }
+}
+
+void
+OlsrRoutingTableUpdateTestCase::Rx (const PacketHeader &header, const MessageList &messages)
+{
+  m_receptions++;
+}
+
+void
+OlsrRoutingTableUpdateTestCase::DoRun ()
+{
+  m_nodes.Create (16);
+  OlsrHelper olsr;
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (olsr);
+  internet.Install (m_nodes);
+  olsr.AssignStreams (m_nodes, 0);
+
+  SimpleNetDeviceHelper simpleNetHelper;
+  simpleNetHelper.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simpleNetHelper.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  m_devices = simpleNetHelper.Install (m_nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (m_devices);
+
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      Ptr<RoutingProtocol> protocol = m_nodes.Get (i)->GetObject<RoutingProtocol> ();
+      protocol->TraceConnectWithoutContext ("RoutingTableChanged",
+                                            MakeCallback (&OlsrRoutingTableUpdateTestCase::RoutingTableChanged, this));
+      protocol->TraceConnectWithoutContext ("Rx", MakeCallback (&OlsrRoutingTableUpdateTestCase::Rx, this));
+    }
+
+  // a chain of nodes, one of which jumps elsewhere every 10 seconds
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  for (uint32_t i = 0; i < m_nodes.GetN (); i++)
+    {
+      m_positions.push_back (100.0 * i);
+    }
+  MoveNode ();
+  Simulator::Schedule (Seconds (0.25), &OlsrRoutingTableUpdateTestCase::CheckRoutingTables, this);
+
+  Simulator::Stop (Seconds (120));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_GT (m_routes, 10000, "Too few routes checked");
+  NS_TEST_EXPECT_MSG_LT (2 * m_computations, m_receptions, "The routing table is recomputed too often");
+}
+
 /**
  * \ingroup olsr-test
  * \ingroup tests
@@ -194,6 +365,7 @@ OlsrProtocolTestSuite::OlsrProtocolTestSuite ()
   : TestSuite ("routing-olsr", UNIT)
 {
   AddTestCase (new OlsrMprTestCase (), TestCase::QUICK);
+  AddTestCase (new OlsrRoutingTableUpdateTestCase (), TestCase::QUICK);
 }
 
 static OlsrProtocolTestSuite g_olsrProtocolTestSuite; //!< Static variable for test initialization
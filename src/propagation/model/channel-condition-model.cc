@@ -25,6 +25,7 @@
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
 namespace ns3 {
 
@@ -287,8 +288,15 @@ ThreeGppChannelConditionModel::GetTypeId (void)
     .SetGroupName ("Propagation")
     .AddAttribute ("UpdatePeriod", "Specifies the time period after which the channel condition is recomputed. If set to 0, the channel condition is never updated.",
                    TimeValue (MilliSeconds (0)),
-                   MakeTimeAccessor (&ThreeGppChannelConditionModel::m_updatePeriod),
+                   MakeTimeAccessor (&ThreeGppChannelConditionModel::SetUpdatePeriod,
+                                     &ThreeGppChannelConditionModel::GetUpdatePeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("CacheSize", "The maximum number of node pairs whose channel condition is kept; "
+                   "when full, the least recently used pair is discarded. 0 means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppChannelConditionModel::SetCacheSize,
+                                         &ThreeGppChannelConditionModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -306,8 +314,32 @@ ThreeGppChannelConditionModel::~ThreeGppChannelConditionModel ()
 
 void ThreeGppChannelConditionModel::DoDispose ()
 {
-  m_channelConditionMap.clear ();
-  m_updatePeriod = Seconds (0.0);
+  m_channelConditionCache.Clear ();
+  m_channelConditionCache.SetLifetime (Seconds (0.0));
+}
+
+void
+ThreeGppChannelConditionModel::SetCacheSize (uint32_t size)
+{
+  m_channelConditionCache.SetMaxSize (size);
+}
+
+uint32_t
+ThreeGppChannelConditionModel::GetCacheSize (void) const
+{
+  return m_channelConditionCache.GetMaxSize ();
+}
+
+void
+ThreeGppChannelConditionModel::SetUpdatePeriod (Time period)
+{
+  m_channelConditionCache.SetLifetime (period);
+}
+
+Time
+ThreeGppChannelConditionModel::GetUpdatePeriod (void) const
+{
+  return m_channelConditionCache.GetLifetime ();
 }
 
 Ptr<ChannelCondition>
@@ -316,43 +348,25 @@ ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
 {
   Ptr<ChannelCondition> cond;
 
-  // get the key for this channel
-  uint32_t key = GetKey (a, b);
-
-  bool notFound = false; // indicates if the channel condition is not present in the map
-  bool update = false; // indicates if the channel condition has to be updated
+  // the channel is identified by the node IDs, in any order
+  uint32_t idA = a->GetObject<Node> ()->GetId ();
+  uint32_t idB = b->GetObject<Node> ()->GetId ();
 
-  // look for the channel condition in m_channelConditionMap
-  auto mapItem = m_channelConditionMap.find (key);
-  if (mapItem != m_channelConditionMap.end ())
+  // look for the channel condition in m_channelConditionCache. The
+  // conditions generated more than "UpdatePeriod" ago are not returned.
+  Ptr<ChannelCondition> *cached = m_channelConditionCache.Find (idA, idB);
+  if (cached != 0)
     {
-      NS_LOG_DEBUG ("found the channel condition in the map");
-      cond = mapItem->second.m_condition;
-
-      // check if it has to be updated
-      if (!m_updatePeriod.IsZero () && Simulator::Now () - mapItem->second.m_generatedTime > m_updatePeriod)
-        {
-          NS_LOG_DEBUG ("it has to be updated");
-          update = true;
-        }
+      NS_LOG_DEBUG ("found the channel condition in the cache");
+      cond = *cached;
     }
   else
     {
-      NS_LOG_DEBUG ("channel condition not found");
-      notFound = true;
-    }
-
-  // if the channel condition was not found or if it has to be updated
-  // generate a new channel condition
-  if (notFound || update)
-    {
+      // the channel condition was not found or has to be updated,
+      // generate a new channel condition
+      NS_LOG_DEBUG ("channel condition not found or to be updated");
       cond = ComputeChannelCondition (a, b);
-      // store the channel condition in m_channelConditionMap, used as cache.
-      // For this reason you see a const_cast.
-      Item mapItem;
-      mapItem.m_condition = cond;
-      mapItem.m_generatedTime = Simulator::Now ();
-      const_cast<ThreeGppChannelConditionModel*> (this)->m_channelConditionMap [key] = mapItem;
+      m_channelConditionCache.Insert (idA, idB, cond);
     }
 
   return cond;
@@ -420,20 +434,6 @@ ThreeGppChannelConditionModel::Calculate2dDistance (const Vector &a, const Vecto
   return distance2D;
 }
 
-uint32_t
-ThreeGppChannelConditionModel::GetKey (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b)
-{
-  // use the nodes ids to obtain a unique key for the channel between a and b
-  // sort the nodes ids so that the key is reciprocal
-  uint32_t x1 = std::min (a->GetObject<Node> ()->GetId (), b->GetObject<Node> ()->GetId ());
-  uint32_t x2 = std::max (a->GetObject<Node> ()->GetId (), b->GetObject<Node> ()->GetId ());
-
-  // use the cantor function to obtain the key
-  uint32_t key = (((x1 + x2) * (x1 + x2 + 1)) / 2) + x2;
-
-  return key;
-}
-
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (ThreeGppRmaChannelConditionModel);
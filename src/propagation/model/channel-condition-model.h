@@ -24,6 +24,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/vector.h"
 #include "ns3/nstime.h"
+#include "ns3/propagation-cache.h"
 #include <unordered_map>
 
 namespace ns3 {
@@ -487,6 +488,19 @@ public:
    */
   virtual int64_t AssignStreams (int64_t stream) override;
 
+  /**
+   * \brief Set the maximum number of node pairs whose channel condition is
+   *        kept. When the cache is full, the least recently used pair is discarded.
+   * \param size the maximum number of node pairs, 0 for no limit
+   */
+  void SetCacheSize (uint32_t size);
+
+  /**
+   * \brief Return the maximum number of node pairs whose channel condition is kept
+   * \return the maximum number of node pairs, 0 for no limit
+   */
+  uint32_t GetCacheSize (void) const;
+
 protected:
   virtual void DoDispose () override;
   
@@ -541,24 +555,19 @@ private:
   virtual double ComputePnlos (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
 
   /**
-   * \brief Returns a unique and reciprocal key for the channel between a and b.
-   * \param a tx mobility model
-   * \param b rx mobility model
-   * \return channel key
+   * \brief Set the period after which the channel conditions are recomputed
+   * \param period the update period, 0 to never update the conditions
    */
-  static uint32_t GetKey (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b);
+  void SetUpdatePeriod (Time period);
 
   /**
-   * Struct to store the channel condition in the m_channelConditionMap
+   * \brief Return the period after which the channel conditions are recomputed
+   * \return the update period
    */
-  struct Item
-  {
-    Ptr<ChannelCondition> m_condition; //!< the channel condition
-    Time m_generatedTime; //!< the time when the condition was generated
-  };
+  Time GetUpdatePeriod (void) const;
 
-  std::unordered_map<uint32_t, Item> m_channelConditionMap; //!< map to store the channel conditions
-  Time m_updatePeriod; //!< the update period for the channel condition
+  /// Cache of the channel conditions, by pair of node IDs, expiring after the update period
+  mutable PropagationPairCache<Ptr<ChannelCondition> > m_channelConditionCache;
 };
 
 /**
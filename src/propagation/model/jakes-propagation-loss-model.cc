@@ -20,6 +20,7 @@
 
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "ns3/log.h"
 
 namespace ns3
@@ -47,6 +48,14 @@ JakesPropagationLossModel::GetTypeId ()
     .SetParent<PropagationLossModel> ()
     .SetGroupName ("Propagation")
     .AddConstructor<JakesPropagationLossModel> ()
+    .AddAttribute ("CacheSize",
+                   "The maximum number of paths whose fading process is kept; "
+                   "when full, the least recently used path is discarded. "
+                   "0 means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::SetCacheSize,
+                                         &JakesPropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -66,6 +75,18 @@ JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + pathData->GetChannelGainDb ();
 }
 
+void
+JakesPropagationLossModel::SetCacheSize (uint32_t size)
+{
+  m_propagationCache.SetMaxSize (size);
+}
+
+uint32_t
+JakesPropagationLossModel::GetCacheSize (void) const
+{
+  return m_propagationCache.GetMaxSize ();
+}
+
 Ptr<UniformRandomVariable>
 JakesPropagationLossModel::GetUniformRandomVariable () const
 {
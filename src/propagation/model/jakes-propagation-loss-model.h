@@ -71,6 +71,15 @@ private:
    */
   Ptr<UniformRandomVariable> GetUniformRandomVariable () const;
 
+  /**
+   * \param size the maximum number of paths in the cache, 0 for no limit
+   */
+  void SetCacheSize (uint32_t size);
+  /**
+   * \return the maximum number of paths in the cache, 0 for no limit
+   */
+  uint32_t GetCacheSize (void) const;
+
   Ptr<UniformRandomVariable> m_uniformVariable; //!< random stream
   mutable PropagationCache<JakesProcess> m_propagationCache; //!< Propagation cache
 };
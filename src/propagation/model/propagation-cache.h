@@ -21,10 +21,224 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
-#include <map>
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
+#include <list>
+#include <unordered_map>
 
 namespace ns3
 {
+/**
+ * \ingroup propagation
+ * \brief Cache of values associated to the propagation path between two
+ * nodes, bounded in size and in lifetime.
+ *
+ * A path is identified by the identifiers of its two ends and by a
+ * model UID.  Paths are symmetrical: the path a-->b and the path b-->a
+ * share the same value.  The values are kept in a hash table, and the
+ * paths are ordered by their last use.
+ *
+ * When a maximum size is set, the least recently used path is discarded
+ * when a new path is added to a full cache.  When a lifetime is set, the
+ * value of a path is discarded once it was added more than lifetime ago.
+ * Paths not used for longer than the lifetime are also discarded when new
+ * paths are added, so the cache only holds the paths in use.
+ */
+template<class V>
+class PropagationPairCache
+{
+public:
+  PropagationPairCache ()
+    : m_maxSize (0),
+      m_lifetime (Seconds (0))
+  {};
+  ~PropagationPairCache () {};
+
+  /**
+   * \param maxSize the maximum number of paths in the cache, 0 for no limit
+   */
+  void SetMaxSize (uint32_t maxSize)
+  {
+    m_maxSize = maxSize;
+    Trim ();
+  };
+  /**
+   * \return the maximum number of paths in the cache, 0 for no limit
+   */
+  uint32_t GetMaxSize (void) const
+  {
+    return m_maxSize;
+  };
+  /**
+   * \param lifetime the lifetime of the values in the cache, 0 for no limit
+   */
+  void SetLifetime (Time lifetime)
+  {
+    m_lifetime = lifetime;
+  };
+  /**
+   * \return the lifetime of the values in the cache, 0 for no limit
+   */
+  Time GetLifetime (void) const
+  {
+    return m_lifetime;
+  };
+  /**
+   * \return the number of paths in the cache
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_entries.size ();
+  };
+  /// Discard all the paths
+  void Clear (void)
+  {
+    m_index.clear ();
+    m_entries.clear ();
+  };
+
+  /**
+   * Get the value associated to a path, and mark the path as used.
+   * An expired value is discarded.
+   * \param a identifier of the 1st end of the path
+   * \param b identifier of the 2nd end of the path
+   * \param modelUid model UID
+   * \return the value, or 0 if the path is not in the cache
+   */
+  V * Find (uint64_t a, uint64_t b, uint32_t modelUid = 0)
+  {
+    typename Index::iterator it = m_index.find (Key (a, b, modelUid));
+    if (it == m_index.end ())
+      {
+        return 0;
+      }
+    typename Entries::iterator entry = it->second;
+    Time now = Simulator::Now ();
+    if (!m_lifetime.IsZero () && now - entry->m_added > m_lifetime)
+      {
+        m_entries.erase (entry);
+        m_index.erase (it);
+        return 0;
+      }
+    entry->m_used = now;
+    m_entries.splice (m_entries.begin (), m_entries, entry);
+    return &entry->m_value;
+  };
+
+  /**
+   * Associate a value to a path, replacing the previous value if any.
+   * \param a identifier of the 1st end of the path
+   * \param b identifier of the 2nd end of the path
+   * \param value the value
+   * \param modelUid model UID
+   * \return the value stored in the cache
+   */
+  V & Insert (uint64_t a, uint64_t b, const V &value, uint32_t modelUid = 0)
+  {
+    Key key (a, b, modelUid);
+    Time now = Simulator::Now ();
+    typename Index::iterator it = m_index.find (key);
+    if (it != m_index.end ())
+      {
+        m_entries.erase (it->second);
+        m_index.erase (it);
+      }
+    m_entries.push_front (Entry (key, value, now));
+    m_index[key] = m_entries.begin ();
+    Trim ();
+    return m_entries.front ().m_value;
+  };
+
+private:
+  /// Each path is identified by
+  struct Key
+  {
+    /**
+     * Constructor
+     * \param a identifier of the 1st end of the path
+     * \param b identifier of the 2nd end of the path
+     * \param modelUid model UID
+     */
+    Key (uint64_t a, uint64_t b, uint32_t modelUid)
+      : m_first (std::min (a, b)),
+        m_second (std::max (a, b)),
+        m_modelUid (modelUid)
+    {};
+    uint64_t m_first;    //!< smallest identifier
+    uint64_t m_second;   //!< largest identifier
+    uint32_t m_modelUid; //!< model UID
+
+    /**
+     * \param other the other key
+     * \return true if the keys identify the same path
+     */
+    bool operator == (const Key &other) const
+    {
+      return m_first == other.m_first && m_second == other.m_second && m_modelUid == other.m_modelUid;
+    };
+  };
+
+  /// Hash function of the keys
+  struct KeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    std::size_t operator () (const Key &key) const
+    {
+      uint64_t h = key.m_first * 0x9e3779b97f4a7c15ULL;
+      h ^= (key.m_second + 0x7f4a7c15ULL + (h << 6) + (h >> 2)) * 0xbf58476d1ce4e5b9ULL;
+      h ^= key.m_modelUid + (h >> 31);
+      return static_cast<std::size_t> (h);
+    };
+  };
+
+  /// A path in the cache
+  struct Entry
+  {
+    /**
+     * Constructor
+     * \param key the path
+     * \param value the value associated to the path
+     * \param now the current time
+     */
+    Entry (const Key &key, const V &value, Time now)
+      : m_key (key),
+        m_value (value),
+        m_added (now),
+        m_used (now)
+    {};
+    Key m_key;     //!< the path
+    V m_value;     //!< the value associated to the path
+    Time m_added;  //!< the time the value was added
+    Time m_used;   //!< the time the path was last used
+  };
+
+  /// Paths, most recently used first
+  typedef std::list<Entry> Entries;
+  /// Index of the paths
+  typedef std::unordered_map<Key, typename Entries::iterator, KeyHash> Index;
+
+  /// Discard the paths beyond the maximum size, and the paths unused for longer than the lifetime
+  void Trim (void)
+  {
+    Time now = Simulator::Now ();
+    while (!m_entries.empty ()
+           && ((m_maxSize != 0 && m_entries.size () > m_maxSize)
+               || (!m_lifetime.IsZero () && now - m_entries.back ().m_used > m_lifetime)))
+      {
+        m_index.erase (m_entries.back ().m_key);
+        m_entries.pop_back ();
+      }
+  };
+
+  Entries m_entries;  //!< paths, most recently used first
+  Index m_index;      //!< index of the paths
+  uint32_t m_maxSize; //!< maximum number of paths, 0 for no limit
+  Time m_lifetime;    //!< lifetime of the values, 0 for no limit
+};
+
 /**
  * \ingroup propagation
  * \brief Constructs a cache of objects, where each object is responsible for a single propagation path loss calculations.
@@ -47,13 +261,12 @@ public:
    */
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    typename PathCache::iterator it = m_pathCache.find (key);
-    if (it == m_pathCache.end ())
+    PathData *data = m_pathCache.Find (GetId (a), GetId (b), modelUid);
+    if (data == 0)
       {
         return 0;
       }
-    return it->second;
+    return data->m_data;
   };
 
   /**
@@ -65,62 +278,54 @@ public:
    */
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
-    NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    NS_ASSERT (m_pathCache.Find (GetId (a), GetId (b), modelUid) == 0);
+    m_pathCache.Insert (GetId (a), GetId (b), PathData (data, a, b), modelUid);
+  };
+
+  /**
+   * \param maxSize the maximum number of paths in the cache, 0 for no limit.
+   * The least recently used path is discarded first.
+   */
+  void SetMaxSize (uint32_t maxSize)
+  {
+    m_pathCache.SetMaxSize (maxSize);
+  };
+  /**
+   * \return the maximum number of paths in the cache, 0 for no limit
+   */
+  uint32_t GetMaxSize (void) const
+  {
+    return m_pathCache.GetMaxSize ();
   };
 private:
-  /// Each path is identified by
-  struct PropagationPathIdentifier
+  /// The model associated with a path
+  struct PathData
   {
     /**
      * Constructor
-     * @param a 1st node mobility model
-     * @param b 2nd node mobility model
-     * @param modelUid model UID
+     * \param data the model
+     * \param a 1st node mobility model
+     * \param b 2nd node mobility model
      */
-    PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
-      m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
+    PathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) :
+      m_data (data), m_srcMobility (a), m_dstMobility (b)
     {};
+    Ptr<T> m_data; //!< the model
+    // The mobility models are held so that their addresses identify the path
     Ptr<const MobilityModel> m_srcMobility; //!< 1st node mobility model
     Ptr<const MobilityModel> m_dstMobility; //!< 2nd node mobility model
-    uint32_t m_spectrumModelUid; //!< model UID
+  };
 
-    /**
-     * Less-than operator.
-     *
-     * The goal of this operator is just to provide a stable comparison
-     * to be used in containers requiring a order (of any kind).
-     *
-     * If the models are different, the comparison is based on their Uid.
-     * Otherwise, the comparison is based on the pointers of the Mobility models.
-     *
-     * \param other Right value of the operator.
-     * \returns True if the Left value is less than the Right value.
-     */
-    bool operator < (const PropagationPathIdentifier & other) const
-    {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
-    }
-  };
-
-  /// Typedef: PropagationPathIdentifier, Ptr<T>
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
-private:
-  PathCache m_pathCache; //!< Path cache
+  /**
+   * \param mobility a mobility model
+   * \return the identifier of the mobility model in the cache
+   */
+  static uint64_t GetId (Ptr<const MobilityModel> mobility)
+  {
+    return reinterpret_cast<uintptr_t> (PeekPointer (mobility));
+  };
+
+  PropagationPairCache<PathData> m_pathCache; //!< Path cache
 };
 } // namespace ns3
 
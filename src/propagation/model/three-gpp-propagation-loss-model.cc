@@ -24,6 +24,7 @@
 #include "ns3/double.h"
 #include "ns3/boolean.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include <cmath>
 #include "ns3/node.h"
 #include "ns3/simulator.h"
@@ -58,6 +59,12 @@ ThreeGppPropagationLossModel::GetTypeId (void)
                    MakePointerAccessor (&ThreeGppPropagationLossModel::SetChannelConditionModel,
                                         &ThreeGppPropagationLossModel::GetChannelConditionModel),
                    MakePointerChecker<ChannelConditionModel> ())
+    .AddAttribute ("CacheSize", "The maximum number of node pairs whose shadowing is kept; "
+                   "when full, the least recently used pair is discarded. 0 means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppPropagationLossModel::SetCacheSize,
+                                         &ThreeGppPropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -83,7 +90,7 @@ ThreeGppPropagationLossModel::DoDispose ()
 {
   m_channelConditionModel->Dispose ();
   m_channelConditionModel = nullptr;
-  m_shadowingMap.clear ();
+  m_shadowingCache.Clear ();
 }
 
 void
@@ -115,6 +122,20 @@ ThreeGppPropagationLossModel::GetFrequency () const
   return m_frequency;
 }
 
+void
+ThreeGppPropagationLossModel::SetCacheSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_shadowingCache.SetMaxSize (size);
+}
+
+uint32_t
+ThreeGppPropagationLossModel::GetCacheSize () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_shadowingCache.GetMaxSize ();
+}
+
 double
 ThreeGppPropagationLossModel::DoCalcRxPower (double txPowerDbm,
                                              Ptr<MobilityModel> a,
@@ -189,27 +210,26 @@ ThreeGppPropagationLossModel::GetShadowing (Ptr<MobilityModel> a, Ptr<MobilityMo
 
   double shadowingValue;
 
-  // compute the channel key
-  uint32_t key = GetKey (a, b);
+  // the channel is identified by the node IDs, in any order
+  uint32_t idA = a->GetObject<Node> ()->GetId ();
+  uint32_t idB = b->GetObject<Node> ()->GetId ();
 
   bool notFound = false; // indicates if the shadowing value has not been computed yet
   bool newCondition = false; // indicates if the channel condition has changed
   Vector newDistance; // the distance vector, that is not a distance but a difference
-  auto it = m_shadowingMap.end (); // the shadowing map iterator
-  if (m_shadowingMap.find (key) != m_shadowingMap.end ())
+  ShadowingMapItem *item = m_shadowingCache.Find (idA, idB);
+  if (item != 0)
     {
-      // found the shadowing value in the map
-      it = m_shadowingMap.find (key);
+      // found the shadowing value in the cache
       newDistance = GetVectorDifference (a, b);
-      newCondition = (it->second.m_condition != cond); // true if the condition changed
+      newCondition = (item->m_condition != cond); // true if the condition changed
     }
   else
     {
       notFound = true;
 
-      // add a new entry in the map and update the iterator
-      ShadowingMapItem newItem;
-      it = m_shadowingMap.insert (it, std::make_pair (key, newItem));
+      // add a new entry in the cache
+      item = &m_shadowingCache.Insert (idA, idB, ShadowingMapItem ());
     }
 
   if (notFound || newCondition)
@@ -220,15 +240,15 @@ ThreeGppPropagationLossModel::GetShadowing (Ptr<MobilityModel> a, Ptr<MobilityMo
   else
     {
       // compute a new correlated shadowing loss
-      Vector2D displacement (newDistance.x - it->second.m_distance.x, newDistance.y - it->second.m_distance.y);
+      Vector2D displacement (newDistance.x - item->m_distance.x, newDistance.y - item->m_distance.y);
       double R = exp (-1 * displacement.GetLength () / GetShadowingCorrelationDistance (cond));
-      shadowingValue =  R * it->second.m_shadowing + sqrt (1 - R * R) * m_normRandomVariable->GetValue () * GetShadowingStd (a, b, cond);
+      shadowingValue =  R * item->m_shadowing + sqrt (1 - R * R) * m_normRandomVariable->GetValue () * GetShadowingStd (a, b, cond);
     }
 
-  // update the entry in the map
-  it->second.m_shadowing = shadowingValue;
-  it->second.m_distance = newDistance; // Save the (0,0,0) vector in case it's the first time we are calculating this value
-  it->second.m_condition = cond;
+  // update the entry in the cache
+  item->m_shadowing = shadowingValue;
+  item->m_distance = newDistance; // Save the (0,0,0) vector in case it's the first time we are calculating this value
+  item->m_condition = cond;
 
   return shadowingValue;
 }
@@ -263,20 +283,6 @@ ThreeGppPropagationLossModel::Calculate2dDistance (Vector a, Vector b)
   return distance2D;
 }
 
-uint32_t
-ThreeGppPropagationLossModel::GetKey (Ptr<MobilityModel> a, Ptr<MobilityModel> b)
-{
-  // use the nodes ids to obtain an unique key for the channel between a and b
-  // sort the nodes ids so that the key is reciprocal
-  uint32_t x1 = std::min (a->GetObject<Node> ()->GetId (), b->GetObject<Node> ()->GetId ());
-  uint32_t x2 = std::max (a->GetObject<Node> ()->GetId (), b->GetObject<Node> ()->GetId ());
-
-  // use the cantor function to obtain the key
-  uint32_t key = (((x1 + x2) * (x1 + x2 + 1)) / 2) + x2;
-
-  return key;
-}
-
 Vector
 ThreeGppPropagationLossModel::GetVectorDifference (Ptr<MobilityModel> a, Ptr<MobilityModel> b)
 {
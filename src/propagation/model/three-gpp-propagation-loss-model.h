@@ -22,6 +22,7 @@
 
 #include "ns3/propagation-loss-model.h"
 #include "ns3/channel-condition-model.h"
+#include "ns3/propagation-cache.h"
 
 namespace ns3 {
 
@@ -72,6 +73,19 @@ public:
    */
   double GetFrequency (void) const;
 
+  /**
+   * \brief Set the maximum number of node pairs whose shadowing is kept.
+   *        When the cache is full, the least recently used pair is discarded.
+   * \param size the maximum number of node pairs, 0 for no limit
+   */
+  void SetCacheSize (uint32_t size);
+
+  /**
+   * \brief Return the maximum number of node pairs whose shadowing is kept
+   * \return the maximum number of node pairs, 0 for no limit
+   */
+  uint32_t GetCacheSize (void) const;
+
   /**
    * \brief Copy constructor
    *
@@ -168,7 +182,7 @@ private:
   virtual std::pair<double, double> GetUtAndBsHeights (double za, double zb) const;
 
   /**
-   * \brief Retrieves the shadowing value by looking at m_shadowingMap.
+   * \brief Retrieves the shadowing value by looking at m_shadowingCache.
    *        If not found or if the channel condition changed it generates a new
    *        independent realization and stores it in the map, otherwise it correlates
    *        the new value with the previous one using the autocorrelation function
@@ -196,19 +210,6 @@ private:
    */
   virtual double GetShadowingCorrelationDistance (ChannelCondition::LosConditionValue cond) const = 0;
 
-  /**
-   * \brief Returns an unique key for the channel between a and b.
-   *
-   * The key is the value of the Cantor function calculated by using as
-   * first parameter the lowest node ID, and as a second parameter the highest
-   * node ID.
-   *
-   * \param a tx mobility model
-   * \param b rx mobility model
-   * \return channel key
-   */
-  static uint32_t GetKey (Ptr<MobilityModel> a, Ptr<MobilityModel> b);
-
   /**
    * \brief Get the difference between the node position
    *
@@ -237,7 +238,7 @@ protected:
   bool m_shadowingEnabled; //!< enable/disable shadowing
   Ptr<NormalRandomVariable> m_normRandomVariable; //!< normal random variable
 
-  /** Define a struct for the m_shadowingMap entries */
+  /** Define a struct for the m_shadowingCache entries */
   struct ShadowingMapItem
   {
     double m_shadowing; //!< the shadowing loss in dB
@@ -245,7 +246,7 @@ protected:
     Vector m_distance; //!< the vector AB
   };
 
-  mutable std::unordered_map<uint32_t, ShadowingMapItem> m_shadowingMap; //!< map to store the shadowing values
+  mutable PropagationPairCache<ShadowingMapItem> m_shadowingCache; //!< cache of the shadowing values, by pair of node IDs
 };
 
 /**
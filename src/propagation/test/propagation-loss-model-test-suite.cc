@@ -22,6 +22,7 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/propagation-cache.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +437,97 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class PropagationCacheTestCase : public TestCase
+{
+public:
+  PropagationCacheTestCase ();
+  virtual ~PropagationCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// Use a path and add another one, at 1 s
+  void UsePaths (void);
+  /// Check the expiry of the values, at 1.5 s
+  void CheckLifetime (void);
+  /// Check the unused paths are discarded, at 2.6 s
+  void CheckUnused (void);
+
+  PropagationPairCache<int> m_cache; //!< the cache being tested
+};
+
+PropagationCacheTestCase::PropagationCacheTestCase ()
+  : TestCase ("Test PropagationPairCache")
+{
+}
+
+PropagationCacheTestCase::~PropagationCacheTestCase ()
+{
+}
+
+void
+PropagationCacheTestCase::UsePaths (void)
+{
+  NS_TEST_EXPECT_MSG_EQ ((m_cache.Find (1, 2) == 0), false, "Value expired too early");
+  m_cache.Insert (1, 3, 13);
+}
+
+void
+PropagationCacheTestCase::CheckLifetime (void)
+{
+  // path 1-2 was added at 0 s, path 1-3 at 1 s
+  NS_TEST_EXPECT_MSG_EQ ((m_cache.Find (1, 2) == 0), true, "Expired value returned");
+  NS_TEST_EXPECT_MSG_EQ ((m_cache.Find (3, 1) == 0), false, "Value expired too early");
+}
+
+void
+PropagationCacheTestCase::CheckUnused (void)
+{
+  // path 1-3 has not been used since 1.5 s
+  m_cache.Insert (4, 5, 45);
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetSize (), 1, "Unused path not discarded");
+  NS_TEST_EXPECT_MSG_EQ (*m_cache.Find (5, 4), 45, "Wrong value");
+}
+
+void
+PropagationCacheTestCase::DoRun (void)
+{
+  // paths are symmetrical, and identified by the model UID too
+  m_cache.Insert (1, 2, 12);
+  m_cache.Insert (2, 1, 21, 7);
+  NS_TEST_ASSERT_MSG_EQ (m_cache.GetSize (), 2, "Wrong number of paths");
+  NS_TEST_ASSERT_MSG_EQ ((m_cache.Find (2, 1) == 0), false, "Path not found");
+  NS_TEST_EXPECT_MSG_EQ (*m_cache.Find (2, 1), 12, "Wrong value");
+  NS_TEST_EXPECT_MSG_EQ (*m_cache.Find (1, 2, 7), 21, "Wrong value");
+  NS_TEST_EXPECT_MSG_EQ ((m_cache.Find (1, 3) == 0), true, "Unexpected path found");
+  m_cache.Insert (2, 1, 120);
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetSize (), 2, "Value not replaced");
+  NS_TEST_EXPECT_MSG_EQ (*m_cache.Find (1, 2), 120, "Value not replaced");
+
+  // the least recently used path is discarded first
+  m_cache.SetMaxSize (3);
+  m_cache.Insert (1, 3, 13);
+  m_cache.Find (1, 2, 7);
+  m_cache.Insert (1, 4, 14);
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetSize (), 3, "Maximum size exceeded");
+  NS_TEST_EXPECT_MSG_EQ ((m_cache.Find (1, 2) == 0), true, "Least recently used path kept");
+  NS_TEST_EXPECT_MSG_EQ ((m_cache.Find (1, 2, 7) == 0), false, "Recently used path discarded");
+  m_cache.SetMaxSize (1);
+  NS_TEST_EXPECT_MSG_EQ (m_cache.GetSize (), 1, "Cache not trimmed");
+  NS_TEST_EXPECT_MSG_EQ ((m_cache.Find (1, 2, 7) == 0), false, "Recently used path discarded");
+
+  // values expire after the lifetime, from the time they are added
+  m_cache.Clear ();
+  m_cache.SetMaxSize (0);
+  m_cache.SetLifetime (Seconds (1));
+  m_cache.Insert (1, 2, 12);
+  Simulator::Schedule (Seconds (1), &PropagationCacheTestCase::UsePaths, this);
+  Simulator::Schedule (Seconds (1.5), &PropagationCacheTestCase::CheckLifetime, this);
+  Simulator::Schedule (Seconds (2.6), &PropagationCacheTestCase::CheckUnused, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +542,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationCacheTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spectrum-interference-accumulator.h"
+
+#include <ns3/assert.h>
+#include <ns3/log.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SpectrumInterferenceAccumulator");
+
+SpectrumInterferenceAccumulator::SpectrumInterferenceAccumulator ()
+  : m_firstInvalid (1),
+    m_lastInvalid (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+SpectrumInterferenceAccumulator::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd)
+{
+  NS_LOG_FUNCTION (this << noisePsd);
+  m_noise = noisePsd;
+  // the signals are reset with the spectrum model of the noise
+  Ptr<const SpectrumModel> sm = noisePsd->GetSpectrumModel ();
+  m_allSignals = Create<SpectrumValue> (sm);
+  m_interference = Create<SpectrumValue> (sm);
+  m_sinr = Create<SpectrumValue> (sm);
+  m_firstInvalid = 1;
+  m_lastInvalid = 0;
+  Invalidate (0, noisePsd->GetValuesN () - 1);
+}
+
+Ptr<const SpectrumValue>
+SpectrumInterferenceAccumulator::GetNoisePowerSpectralDensity () const
+{
+  return m_noise;
+}
+
+void
+SpectrumInterferenceAccumulator::SetRxSignal (Ptr<const SpectrumValue> rxPsd)
+{
+  NS_LOG_FUNCTION (this << rxPsd);
+  NS_ASSERT (m_allSignals != 0);
+  NS_ASSERT (rxPsd->GetSpectrumModelUid () == m_allSignals->GetSpectrumModelUid ());
+  m_rxSignal = rxPsd;
+  Invalidate (0, rxPsd->GetValuesN () - 1);
+}
+
+Ptr<const SpectrumValue>
+SpectrumInterferenceAccumulator::GetRxSignal () const
+{
+  return m_rxSignal;
+}
+
+void
+SpectrumInterferenceAccumulator::AddSignal (Ptr<const SpectrumValue> psd)
+{
+  NS_LOG_FUNCTION (this << psd);
+  NS_ASSERT (psd->GetSpectrumModelUid () == m_allSignals->GetSpectrumModelUid ());
+  uint32_t first;
+  uint32_t last;
+  if (GetOccupiedBands (*psd, &first, &last))
+    {
+      for (uint32_t i = first; i <= last; i++)
+        {
+          (*m_allSignals)[i] += (*psd)[i];
+        }
+      Invalidate (first, last);
+    }
+}
+
+void
+SpectrumInterferenceAccumulator::SubtractSignal (Ptr<const SpectrumValue> psd)
+{
+  NS_LOG_FUNCTION (this << psd);
+  NS_ASSERT (psd->GetSpectrumModelUid () == m_allSignals->GetSpectrumModelUid ());
+  uint32_t first;
+  uint32_t last;
+  if (GetOccupiedBands (*psd, &first, &last))
+    {
+      for (uint32_t i = first; i <= last; i++)
+        {
+          (*m_allSignals)[i] -= (*psd)[i];
+        }
+      Invalidate (first, last);
+    }
+}
+
+const SpectrumValue &
+SpectrumInterferenceAccumulator::GetAllSignals () const
+{
+  return *m_allSignals;
+}
+
+const SpectrumValue &
+SpectrumInterferenceAccumulator::GetInterference ()
+{
+  Update ();
+  return *m_interference;
+}
+
+const SpectrumValue &
+SpectrumInterferenceAccumulator::GetSinr ()
+{
+  Update ();
+  return *m_sinr;
+}
+
+void
+SpectrumInterferenceAccumulator::Clear ()
+{
+  NS_LOG_FUNCTION (this);
+  m_noise = 0;
+  m_rxSignal = 0;
+  m_allSignals = 0;
+  m_interference = 0;
+  m_sinr = 0;
+  m_firstInvalid = 1;
+  m_lastInvalid = 0;
+}
+
+bool
+SpectrumInterferenceAccumulator::GetOccupiedBands (const SpectrumValue &psd, uint32_t *first, uint32_t *last)
+{
+  uint32_t n = psd.GetValuesN ();
+  uint32_t i = 0;
+  while (i < n && psd[i] == 0)
+    {
+      i++;
+    }
+  if (i == n)
+    {
+      return false;
+    }
+  uint32_t j = n - 1;
+  while (psd[j] == 0)
+    {
+      j--;
+    }
+  *first = i;
+  *last = j;
+  return true;
+}
+
+void
+SpectrumInterferenceAccumulator::Invalidate (uint32_t first, uint32_t last)
+{
+  if (m_firstInvalid > m_lastInvalid)
+    {
+      m_firstInvalid = first;
+      m_lastInvalid = last;
+    }
+  else
+    {
+      m_firstInvalid = std::min (m_firstInvalid, first);
+      m_lastInvalid = std::max (m_lastInvalid, last);
+    }
+}
+
+void
+SpectrumInterferenceAccumulator::Update ()
+{
+  NS_ASSERT_MSG (m_rxSignal != 0, "no signal being received");
+  if (m_firstInvalid > m_lastInvalid)
+    {
+      return;
+    }
+  NS_LOG_LOGIC (this << " update bands " << m_firstInvalid << " to " << m_lastInvalid);
+  for (uint32_t i = m_firstInvalid; i <= m_lastInvalid; i++)
+    {
+      double interference = (*m_allSignals)[i] - (*m_rxSignal)[i] + (*m_noise)[i];
+      (*m_interference)[i] = interference;
+      (*m_sinr)[i] = (*m_rxSignal)[i] / interference;
+    }
+  m_firstInvalid = 1;
+  m_lastInvalid = 0;
+}
+
+} // namespace ns3
@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPECTRUM_INTERFERENCE_ACCUMULATOR_H
+#define SPECTRUM_INTERFERENCE_ACCUMULATOR_H
+
+#include <ns3/ptr.h>
+#include <ns3/spectrum-value.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Sum of the power spectral densities of the signals perceived
+ * in the medium, and SINR of the signal being received, updated
+ * incrementally.
+ *
+ * Each signal is added to and subtracted from the sum over the bands
+ * it occupies only, without allocating any SpectrumValue.  The
+ * interference and the SINR of the signal being received are cached,
+ * and computed again only over the bands where a signal started or
+ * ended since they were last requested.  The values are the same as
+ * those computed over the whole spectrum, i.e.:
+ *
+ *   interference = allSignals - rxSignal + noise
+ *   sinr = rxSignal / interference
+ *
+ * This class is used by the interference models of the PHYs based on
+ * SpectrumValue, such as SpectrumInterference and LteInterference.
+ */
+class SpectrumInterferenceAccumulator
+{
+public:
+  SpectrumInterferenceAccumulator ();
+
+  /**
+   * Set the noise power spectral density, and reset the sum of the
+   * signals. The signals must use the same SpectrumModel as the noise.
+   *
+   * \param noisePsd the noise power spectral density
+   */
+  void SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd);
+
+  /**
+   * \return the noise power spectral density
+   */
+  Ptr<const SpectrumValue> GetNoisePowerSpectralDensity () const;
+
+  /**
+   * Set the power spectral density of the signal being received.
+   *
+   * \param rxPsd the power spectral density of the signal being received.
+   * It must not be changed afterwards, unless it is set again.
+   */
+  void SetRxSignal (Ptr<const SpectrumValue> rxPsd);
+
+  /**
+   * \return the power spectral density of the signal being received
+   */
+  Ptr<const SpectrumValue> GetRxSignal () const;
+
+  /**
+   * Add a signal perceived in the medium.
+   *
+   * \param psd the power spectral density of the signal
+   */
+  void AddSignal (Ptr<const SpectrumValue> psd);
+
+  /**
+   * Remove a signal previously added.
+   *
+   * \param psd the power spectral density of the signal
+   */
+  void SubtractSignal (Ptr<const SpectrumValue> psd);
+
+  /**
+   * \return the sum of the power spectral densities of the signals,
+   * including the signal being received, without noise
+   */
+  const SpectrumValue & GetAllSignals () const;
+
+  /**
+   * \return the power spectral density of the interference and noise
+   * perceived by the signal being received
+   */
+  const SpectrumValue & GetInterference ();
+
+  /**
+   * \return the SINR of the signal being received
+   */
+  const SpectrumValue & GetSinr ();
+
+  /**
+   * Release the power spectral densities.
+   */
+  void Clear ();
+
+private:
+  /**
+   * Find the bands occupied by a signal, i.e., where its power spectral
+   * density is not null.
+   *
+   * \param psd the power spectral density of the signal
+   * \param [out] first the first occupied band
+   * \param [out] last the last occupied band
+   * \return false if the signal occupies no band
+   */
+  static bool GetOccupiedBands (const SpectrumValue &psd, uint32_t *first, uint32_t *last);
+
+  /**
+   * Mark the interference and SINR of some bands as out of date.
+   *
+   * \param first the first band
+   * \param last the last band
+   */
+  void Invalidate (uint32_t first, uint32_t last);
+
+  /**
+   * Compute the interference and SINR of the bands out of date.
+   */
+  void Update ();
+
+  Ptr<const SpectrumValue> m_noise;     //!< noise power spectral density
+  Ptr<const SpectrumValue> m_rxSignal;  //!< power spectral density of the signal being received
+  Ptr<SpectrumValue> m_allSignals;      //!< sum of the signals, without noise
+  Ptr<SpectrumValue> m_interference;    //!< cached interference and noise
+  Ptr<SpectrumValue> m_sinr;            //!< cached SINR
+  uint32_t m_firstInvalid;              //!< first band out of date
+  uint32_t m_lastInvalid;               //!< last band out of date, less than m_firstInvalid if none
+};
+
+} // namespace ns3
+
+#endif /* SPECTRUM_INTERFERENCE_ACCUMULATOR_H */
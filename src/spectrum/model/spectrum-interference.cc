@@ -32,9 +32,6 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumInterference");
 
 SpectrumInterference::SpectrumInterference ()
   : m_receiving (false),
-    m_rxSignal (0),
-    m_allSignals (0),
-    m_noise (0),
     m_errorModel (0)
 {
   NS_LOG_FUNCTION (this);
@@ -60,9 +57,7 @@ void
 SpectrumInterference::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_rxSignal = 0;
-  m_allSignals = 0;
-  m_noise = 0;
+  m_signals.Clear ();
   m_errorModel = 0;
   Object::DoDispose ();
 }
@@ -71,7 +66,7 @@ void
 SpectrumInterference::StartRx (Ptr<const Packet> p, Ptr<const SpectrumValue> rxPsd)
 {
   NS_LOG_FUNCTION (this << p << *rxPsd);
-  m_rxSignal = rxPsd;
+  m_signals.SetRxSignal (rxPsd);
   m_lastChangeTime = Now ();
   m_receiving = true;
   m_errorModel->StartRx (p);
@@ -107,7 +102,7 @@ SpectrumInterference::DoAddSignal  (Ptr<const SpectrumValue> spd)
 {
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
-  (*m_allSignals) += (*spd);
+  m_signals.AddSignal (spd);
   m_lastChangeTime = Now ();
 }
 
@@ -116,7 +111,7 @@ SpectrumInterference::DoSubtractSignal  (Ptr<const SpectrumValue> spd)
 {
   NS_LOG_FUNCTION (this << *spd);
   ConditionallyEvaluateChunk ();
-  (*m_allSignals) -= (*spd);
+  m_signals.SubtractSignal (spd);
   m_lastChangeTime = Now ();
 }
 
@@ -131,10 +126,9 @@ SpectrumInterference::ConditionallyEvaluateChunk ()
   NS_LOG_LOGIC ("if condition: " << condition);
   if (condition)
     {
-      SpectrumValue sinr = (*m_rxSignal) / ((*m_allSignals) - (*m_rxSignal) + (*m_noise));
       Time duration = Now () - m_lastChangeTime;
       NS_LOG_LOGIC ("calling m_errorModel->EvaluateChunk (sinr, duration)");
-      m_errorModel->EvaluateChunk (sinr, duration);
+      m_errorModel->EvaluateChunk (m_signals.GetSinr (), duration);
     }
 }
 
@@ -142,12 +136,10 @@ void
 SpectrumInterference::SetNoisePowerSpectralDensity (Ptr<const SpectrumValue> noisePsd)
 {
   NS_LOG_FUNCTION (this << noisePsd);
-  m_noise = noisePsd;
-  // we can initialize m_allSignal only now, because earlier we
-  // didn't know what spectrum model was going to be used.
-  // we'll now create a zeroed SpectrumValue using the same
-  // SpectrumModel which is being specified for the noise.
-  m_allSignals = Create<SpectrumValue> (noisePsd->GetSpectrumModel ());
+  // we can initialize the sum of the signals only now, because earlier
+  // we didn't know what spectrum model was going to be used.
+  // The accumulator uses the SpectrumModel specified for the noise.
+  m_signals.SetNoisePowerSpectralDensity (noisePsd);
 }
 
 void
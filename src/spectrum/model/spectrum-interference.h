@@ -26,6 +26,7 @@
 #include <ns3/packet.h>
 #include <ns3/nstime.h>
 #include <ns3/spectrum-value.h>
+#include <ns3/spectrum-interference-accumulator.h>
 
 namespace ns3 {
 
@@ -42,6 +43,9 @@ class SpectrumErrorModel;
  * This class implements a gaussian interference model, i.e., all
  * incoming signals are added to the total interference.
  *
+ * The signals are summed by a SpectrumInterferenceAccumulator, which
+ * updates the sum and the SINR over the bands occupied by each signal only.
+ *
  */
 class SpectrumInterference : public Object
 {
@@ -131,17 +135,10 @@ private:
   bool m_receiving; //!< True if in Rx status
 
   /**
-   * Stores the power spectral density of the signal whose RX is being attempted
+   * Sum of the power spectral densities of the incoming signals, noise,
+   * and power spectral density of the signal whose RX is being attempted
    */
-  Ptr<const SpectrumValue> m_rxSignal;
-
-  /**
-   * Stores the spectral power density of the sum of incoming signals;
-   * does not include noise, includes the SPD of the signal being RX
-   */
-  Ptr<SpectrumValue> m_allSignals;
-
-  Ptr<const SpectrumValue> m_noise; //!< Noise spectral power density
+  SpectrumInterferenceAccumulator m_signals;
 
   Time m_lastChangeTime;     //!< the time of the last change in m_TotalPower
 
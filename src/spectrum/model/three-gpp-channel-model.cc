@@ -27,6 +27,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/integer.h"
+#include "ns3/uinteger.h"
 #include <algorithm>
 #include <random>
 #include "ns3/log.h"
@@ -180,7 +181,7 @@ void
 ThreeGppChannelModel::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
-  m_channelMap.clear ();
+  m_channelCache.Clear ();
   if (m_channelConditionModel)
     {
       m_channelConditionModel->Dispose ();
@@ -217,8 +218,16 @@ ThreeGppChannelModel::GetTypeId (void)
     .AddAttribute ("UpdatePeriod",
                    "Specify the channel coherence time",
                    TimeValue (MilliSeconds (0)),
-                   MakeTimeAccessor (&ThreeGppChannelModel::m_updatePeriod),
+                   MakeTimeAccessor (&ThreeGppChannelModel::SetUpdatePeriod,
+                                     &ThreeGppChannelModel::GetUpdatePeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("CacheSize",
+                   "The maximum number of node pairs whose channel matrix is kept; "
+                   "when full, the least recently used pair is discarded. 0 means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::SetCacheSize,
+                                         &ThreeGppChannelModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
     // attributes for the blockage model
     .AddAttribute ("Blockage",
                    "Enable blockage model A (sec 7.6.4.1)",
@@ -292,6 +301,35 @@ ThreeGppChannelModel::GetScenario () const
   return m_scenario;
 }
 
+void
+ThreeGppChannelModel::SetCacheSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_channelCache.SetMaxSize (size);
+}
+
+uint32_t
+ThreeGppChannelModel::GetCacheSize () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_channelCache.GetMaxSize ();
+}
+
+void
+ThreeGppChannelModel::SetUpdatePeriod (Time period)
+{
+  NS_LOG_FUNCTION (this << period);
+  m_updatePeriod = period;
+  m_channelCache.SetLifetime (period);
+}
+
+Time
+ThreeGppChannelModel::GetUpdatePeriod () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_updatePeriod;
+}
+
 Ptr<const ThreeGppChannelModel::ParamsTable>
 ThreeGppChannelModel::GetThreeGppTable (Ptr<const ChannelCondition> channelCondition, double hBS, double hUT, double distance2D) const
 {
@@ -979,24 +1017,25 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
 {
   NS_LOG_FUNCTION (this);
 
-  // Compute the channel key. The key is reciprocal, i.e., key (a, b) = key (b, a)
-  uint32_t x1 = std::min (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
-  uint32_t x2 = std::max (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
-  uint32_t channelId = GetKey (x1, x2);
+  // The channel is identified by the node IDs, in any order
+  uint32_t idA = aMob->GetObject<Node> ()->GetId ();
+  uint32_t idB = bMob->GetObject<Node> ()->GetId ();
 
   // retrieve the channel condition
   Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (aMob, bMob);
 
-  // Check if the channel is present in the map and return it, otherwise
-  // generate a new channel
+  // Check if the channel is present in the cache and return it, otherwise
+  // generate a new channel. The channels generated more than "UpdatePeriod"
+  // ago are not returned.
   bool update = false;
   bool notFound = false;
   Ptr<ThreeGppChannelMatrix> channelMatrix;
-  if (m_channelMap.find (channelId) != m_channelMap.end ())
+  Ptr<ThreeGppChannelMatrix> *cached = m_channelCache.Find (idA, idB);
+  if (cached != 0)
     {
-      // channel matrix present in the map
-      NS_LOG_DEBUG ("channel matrix present in the map");
-      channelMatrix = m_channelMap[channelId];
+      // channel matrix present in the cache
+      NS_LOG_DEBUG ("channel matrix present in the cache");
+      channelMatrix = *cached;
 
       // check if it has to be updated
       update = ChannelMatrixNeedsUpdate (channelMatrix, condition);
@@ -1007,7 +1046,7 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
       notFound = true;
     }
 
-  // If the channel is not present in the map or if it has to be updated
+  // If the channel is not present in the cache or if it has to be updated
   // generate a new realization
   if (notFound || update)
     {
@@ -1031,10 +1070,10 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
       Vector locUt = Vector (0.0, 0.0, 0.0);
 
       channelMatrix = GetNewChannel (locUt, condition, aAntenna, bAntenna, rxAngle, txAngle, distance2D, hBs, hUt);
-      channelMatrix->m_nodeIds = std::make_pair (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
+      channelMatrix->m_nodeIds = std::make_pair (idA, idB);
 
-      // store or replace the channel matrix in the channel map
-      m_channelMap[channelId] = channelMatrix;
+      // store or replace the channel matrix in the channel cache
+      m_channelCache.Insert (idA, idB, channelMatrix);
     }
 
   return channelMatrix;
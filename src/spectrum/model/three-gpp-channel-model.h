@@ -31,6 +31,7 @@
 #include <unordered_map>
 #include <ns3/channel-condition-model.h>
 #include <ns3/matrix-based-channel-model.h>
+#include <ns3/propagation-cache.h>
 
 namespace ns3 {
 
@@ -103,6 +104,19 @@ public:
    */
   std::string GetScenario (void) const;
 
+  /**
+   * Sets the maximum number of node pairs whose channel matrix is kept.
+   * When the cache is full, the least recently used pair is discarded.
+   * \param size the maximum number of node pairs, 0 for no limit
+   */
+  void SetCacheSize (uint32_t size);
+
+  /**
+   * Returns the maximum number of node pairs whose channel matrix is kept
+   * \return the maximum number of node pairs, 0 for no limit
+   */
+  uint32_t GetCacheSize (void) const;
+
   /**
    * Looks for the channel matrix associated to the aMob and bMob pair in m_channelMap.
    * If found, it checks if it has to be updated. If not found or if it has to
@@ -255,7 +269,20 @@ private:
    */
   bool ChannelMatrixNeedsUpdate (Ptr<const ThreeGppChannelMatrix> channelMatrix, Ptr<const ChannelCondition> channelCondition) const;
 
-  std::unordered_map<uint32_t, Ptr<ThreeGppChannelMatrix> > m_channelMap; //!< map containing the channel realizations
+  /**
+   * Sets the channel coherence time
+   * \param period the channel update period, 0 to never update the channels
+   */
+  void SetUpdatePeriod (Time period);
+
+  /**
+   * Returns the channel coherence time
+   * \return the channel update period
+   */
+  Time GetUpdatePeriod (void) const;
+
+  /// Cache of the channel realizations, by pair of node IDs, expiring after the update period
+  PropagationPairCache<Ptr<ThreeGppChannelMatrix> > m_channelCache;
   Time m_updatePeriod; //!< the channel update period
   double m_frequency; //!< the operating frequency
   std::string m_scenario; //!< the 3GPP scenario
@@ -30,6 +30,7 @@
 #include "ns3/string.h"
 #include "ns3/simulator.h"
 #include "ns3/pointer.h"
+#include "ns3/uinteger.h"
 #include <map>
 
 namespace ns3 {
@@ -53,7 +54,7 @@ void
 ThreeGppSpectrumPropagationLossModel::DoDispose ()
 {
   m_deviceAntennaMap.clear ();
-  m_longTermMap.clear ();
+  m_longTermCache.Clear ();
   m_channelModel->Dispose ();
   m_channelModel = nullptr;
 }
@@ -78,6 +79,13 @@ ThreeGppSpectrumPropagationLossModel::GetTypeId (void)
                    DoubleValue (0.0),
                    MakeDoubleAccessor (&ThreeGppSpectrumPropagationLossModel::m_vScatt),
                    MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("CacheSize",
+                   "The maximum number of node pairs whose long term component is kept; "
+                   "when full, the least recently used pair is discarded. 0 means no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&ThreeGppSpectrumPropagationLossModel::SetCacheSize,
+                                         &ThreeGppSpectrumPropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
     ;
   return tid;
 }
@@ -86,6 +94,7 @@ void
 ThreeGppSpectrumPropagationLossModel::SetChannelModel (Ptr<MatrixBasedChannelModel> channel)
 {
   m_channelModel = channel;
+  SetLongTermLifetime ();
 }
 
 Ptr<MatrixBasedChannelModel>
@@ -113,6 +122,36 @@ void
 ThreeGppSpectrumPropagationLossModel::SetChannelModelAttribute (const std::string &name, const AttributeValue &value)
 {
   m_channelModel->SetAttribute (name, value);
+  SetLongTermLifetime ();
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::SetLongTermLifetime (void)
+{
+  // a long term component is only valid with its channel matrix
+  TimeValue period;
+  if (m_channelModel != nullptr && m_channelModel->GetAttributeFailSafe ("UpdatePeriod", period))
+    {
+      m_longTermCache.SetLifetime (period.Get ());
+    }
+  else
+    {
+      m_longTermCache.SetLifetime (Seconds (0));
+    }
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::SetCacheSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  m_longTermCache.SetMaxSize (size);
+}
+
+uint32_t
+ThreeGppSpectrumPropagationLossModel::GetCacheSize () const
+{
+  NS_LOG_FUNCTION (this);
+  return m_longTermCache.GetMaxSize ();
 }
 
 void
@@ -248,26 +287,22 @@ ThreeGppSpectrumPropagationLossModel::GetLongTerm (uint32_t aId, uint32_t bId,
     uW = aW;
   }
 
-  // compute the long term key, the key is unique for each tx-rx pair
-  uint32_t x1 = std::min (aId, bId);
-  uint32_t x2 = std::max (aId, bId);
-  uint32_t longTermId = MatrixBasedChannelModel::GetKey (x1, x2);
-
   bool update = false; // indicates whether the long term has to be updated
   bool notFound = false; // indicates if the long term has not been computed yet
 
-  // look for the long term in the map and check if it is valid
-  if (m_longTermMap.find (longTermId) != m_longTermMap.end ())
+  // look for the long term of the tx-rx pair in the cache and check if it is valid
+  Ptr<const LongTerm> *cached = m_longTermCache.Find (aId, bId);
+  if (cached != 0)
   {
-    NS_LOG_DEBUG ("found the long term component in the map");
-    longTerm = m_longTermMap[longTermId]->m_longTerm;
+    NS_LOG_DEBUG ("found the long term component in the cache");
+    longTerm = (*cached)->m_longTerm;
 
     // check if the channel matrix has been updated
     // or the s beam has been changed
     // or the u beam has been changed
-    update = (m_longTermMap[longTermId]->m_channel->m_generatedTime != channelMatrix->m_generatedTime
-              || m_longTermMap[longTermId]->m_sW != sW
-              || m_longTermMap[longTermId]->m_uW != uW);
+    update = ((*cached)->m_channel->m_generatedTime != channelMatrix->m_generatedTime
+              || (*cached)->m_sW != sW
+              || (*cached)->m_uW != uW);
 
   }
   else
@@ -289,7 +324,7 @@ ThreeGppSpectrumPropagationLossModel::GetLongTerm (uint32_t aId, uint32_t bId,
       longTermItem->m_sW = sW;
       longTermItem->m_uW = uW;
 
-      m_longTermMap[longTermId] = longTermItem;
+      m_longTermCache.Insert (aId, bId, longTermItem);
     }
 
   return longTerm;
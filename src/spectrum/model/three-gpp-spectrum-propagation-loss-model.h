@@ -28,6 +28,7 @@
 #include <unordered_map>
 #include "ns3/matrix-based-channel-model.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/propagation-cache.h"
 
 namespace ns3 {
 
@@ -106,6 +107,19 @@ public:
    */
   void GetChannelModelAttribute (const std::string &name, AttributeValue &value) const;
 
+  /**
+   * Sets the maximum number of node pairs whose long term component is kept.
+   * When the cache is full, the least recently used pair is discarded.
+   * \param size the maximum number of node pairs, 0 for no limit
+   */
+  void SetCacheSize (uint32_t size);
+
+  /**
+   * Returns the maximum number of node pairs whose long term component is kept
+   * \return the maximum number of node pairs, 0 for no limit
+   */
+  uint32_t GetCacheSize (void) const;
+
   /**
    * \brief Computes the received PSD.
    *
@@ -149,7 +163,13 @@ private:
   double GetFrequency () const;
 
   /**
-   * Looks for the long term component in m_longTermMap. If found, checks
+   * Discard the long term components with the channel matrices they were
+   * computed from, i.e., after the "UpdatePeriod" of the channel model, if any.
+   */
+  void SetLongTermLifetime (void);
+
+  /**
+   * Looks for the long term component in m_longTermCache. If found, checks
    * whether it has to be updated. If not found or if it has to be updated,
    * calls the method CalcLongTerm to compute it.
    * \param aId id of the first node
@@ -189,7 +209,8 @@ private:
                                           const Vector &sSpeed, const Vector &uSpeed) const;
 
   std::unordered_map <uint32_t, Ptr<const PhasedArrayModel> > m_deviceAntennaMap; //!< map containig the <node, antenna> associations
-  mutable std::unordered_map < uint32_t, Ptr<const LongTerm> > m_longTermMap; //!< map containing the long term components
+  /// Cache of the long term components, by pair of node IDs, expiring with the channel matrices
+  mutable PropagationPairCache<Ptr<const LongTerm> > m_longTermCache;
   Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
   
   // Variable used to compute the additional Doppler contribution for the delayed 
@@ -20,6 +20,7 @@
 
 #include <ns3/object.h>
 #include <ns3/spectrum-interference.h>
+#include <ns3/spectrum-interference-accumulator.h>
 #include <ns3/spectrum-error-model.h>
 #include <ns3/log.h>
 #include <ns3/test.h>
@@ -130,6 +131,120 @@ SpectrumInterferenceTestCase::RetrieveTestResult (SpectrumInterference* si)
 
 
 
+class SpectrumInterferenceAccumulatorTestCase : public TestCase
+{
+public:
+  SpectrumInterferenceAccumulatorTestCase ();
+  virtual ~SpectrumInterferenceAccumulatorTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Check the accumulated values against the values computed over the
+   * whole spectrum
+   * \param acc the accumulator
+   * \param allSignals the sum of the signals
+   * \param step the number of the check
+   */
+  void Check (SpectrumInterferenceAccumulator &acc, const SpectrumValue &allSignals, uint32_t step);
+
+  Ptr<const SpectrumValue> m_noise; //!< noise
+  Ptr<const SpectrumValue> m_rx;    //!< signal being received
+};
+
+SpectrumInterferenceAccumulatorTestCase::SpectrumInterferenceAccumulatorTestCase ()
+  : TestCase ("SpectrumInterferenceAccumulator")
+{
+}
+
+SpectrumInterferenceAccumulatorTestCase::~SpectrumInterferenceAccumulatorTestCase ()
+{
+}
+
+void
+SpectrumInterferenceAccumulatorTestCase::Check (SpectrumInterferenceAccumulator &acc, const SpectrumValue &allSignals, uint32_t step)
+{
+  SpectrumValue interf = allSignals - (*m_rx) + (*m_noise);
+  SpectrumValue sinr = (*m_rx) / interf;
+  for (uint32_t i = 0; i < allSignals.GetValuesN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (acc.GetAllSignals ()[i], allSignals[i], "step " << step << ": wrong sum in band " << i);
+      NS_TEST_EXPECT_MSG_EQ (acc.GetInterference ()[i], interf[i], "step " << step << ": wrong interference in band " << i);
+      NS_TEST_EXPECT_MSG_EQ (acc.GetSinr ()[i], sinr[i], "step " << step << ": wrong SINR in band " << i);
+    }
+}
+
+void
+SpectrumInterferenceAccumulatorTestCase::DoRun (void)
+{
+  Bands bands;
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      BandInfo bi;
+      bi.fl = 2.400e9 + i * 1e6;
+      bi.fc = bi.fl + 0.5e6;
+      bi.fh = bi.fl + 1e6;
+      bands.push_back (bi);
+    }
+  Ptr<const SpectrumModel> m = Create<SpectrumModel> (bands);
+
+  Ptr<SpectrumValue> noise = Create<SpectrumValue> (m);
+  (*noise) = 1e-18;
+  m_noise = noise;
+  // signals occupying some bands only
+  std::vector<Ptr<SpectrumValue> > signals;
+  for (uint32_t k = 0; k < 4; k++)
+    {
+      Ptr<SpectrumValue> signal = Create<SpectrumValue> (m);
+      for (uint32_t i = 4 * k; i < 4 * k + 6 && i < 20; i++)
+        {
+          (*signal)[i] = (k + 1) * 1.3e-16 + i * 1e-17;
+        }
+      signals.push_back (signal);
+    }
+  m_rx = signals[1];
+
+  SpectrumInterferenceAccumulator acc;
+  acc.SetNoisePowerSpectralDensity (m_noise);
+  acc.SetRxSignal (m_rx);
+  SpectrumValue allSignals (m);
+  Check (acc, allSignals, 0);
+
+  // add and subtract the signals in the same order as a full computation
+  uint32_t step = 1;
+  for (uint32_t k = 0; k < signals.size (); k++)
+    {
+      acc.AddSignal (signals[k]);
+      allSignals += *signals[k];
+      Check (acc, allSignals, step++);
+    }
+  acc.SubtractSignal (signals[0]);
+  allSignals -= *signals[0];
+  Check (acc, allSignals, step++);
+  acc.AddSignal (signals[3]);
+  acc.SubtractSignal (signals[2]);
+  allSignals += *signals[3];
+  allSignals -= *signals[2];
+  Check (acc, allSignals, step++);
+  acc.AddSignal (Create<SpectrumValue> (m));
+  Check (acc, allSignals, step++);
+
+  // a new signal being received
+  m_rx = signals[3];
+  acc.SetRxSignal (m_rx);
+  Check (acc, allSignals, step++);
+
+  // a new noise resets the signals
+  noise = Create<SpectrumValue> (m);
+  (*noise) = 2e-18;
+  m_noise = noise;
+  acc.SetNoisePowerSpectralDensity (m_noise);
+  acc.AddSignal (signals[3]);
+  Check (acc, *signals[3], step++);
+}
+
+
+
 class SpectrumInterferenceTestSuite : public TestSuite
 {
 public:
@@ -189,6 +304,8 @@ SpectrumInterferenceTestSuite::SpectrumInterferenceTestSuite ()
   AddTestCase (new SpectrumInterferenceTestCase (s2, static_cast<uint32_t> (b * 1.5 + 0.5), false,   "sdBm  = [-63 -61]  tx bytes: b*1.5"), TestCase::QUICK);
   AddTestCase (new SpectrumInterferenceTestCase (s2, 0xffffffff, false,     "sdBm  = [-63 -61]  tx bytes: 2^32-1"), TestCase::QUICK);
 
+  AddTestCase (new SpectrumInterferenceAccumulatorTestCase, TestCase::QUICK);
+
 }
 
 static SpectrumInterferenceTestSuite spectrumInterferenceTestSuite;
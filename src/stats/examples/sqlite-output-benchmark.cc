@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This example inserts rows in an SQLite database with SQLiteOutput,
+// and prints the number of rows inserted per second:
+//
+// - "statement per row" prepares a statement for each row, and
+//   executes it in a transaction of its own;
+// - "cached statement" prepares the statement once;
+// - "transactions" groups the rows in transactions of
+//   transactionSize rows;
+// - "transactions, WAL" also uses a write-ahead log, and does not wait
+//   for the data to reach the disk.
+//
+// Example:
+//   ./waf --run "sqlite-output-benchmark --nRows=10000"
+
+#include <cstdio>
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/sqlite-output.h"
+
+using namespace ns3;
+
+namespace {
+
+/// The ways of inserting the rows
+enum Mode
+{
+  STATEMENT_PER_ROW,
+  CACHED_STATEMENT,
+  TRANSACTIONS,
+  TRANSACTIONS_WAL
+};
+
+/**
+ * Insert rows in a new database, and print the rows per second.
+ * \param mode the way of inserting the rows.
+ * \param nRows the number of rows.
+ * \param transactionSize the number of rows per transaction.
+ */
+void
+Run (enum Mode mode, uint32_t nRows, uint32_t transactionSize)
+{
+  std::string fileName = "sqlite-output-benchmark.db";
+  std::remove (fileName.c_str ());
+  std::remove ((fileName + "-wal").c_str ());
+  std::remove ((fileName + "-shm").c_str ());
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  {
+    Ptr<SQLiteOutput> db = Create<SQLiteOutput> (fileName, "sqlite-output-benchmark");
+    if (mode == TRANSACTIONS_WAL)
+      {
+        db->SetJournalWal ();
+        db->SetSynchronousOff ();
+      }
+    if (mode == TRANSACTIONS || mode == TRANSACTIONS_WAL)
+      {
+        db->SetTransactionSize (transactionSize);
+      }
+    db->SpinExec ("CREATE TABLE Samples (time DOUBLE, node INTEGER, value DOUBLE);");
+
+    std::string cmd = "INSERT INTO Samples VALUES (?,?,?);";
+    for (uint32_t i = 0; i < nRows; i++)
+      {
+        sqlite3_stmt *stmt;
+        if (mode == STATEMENT_PER_ROW)
+          {
+            db->SpinPrepare (&stmt, cmd);
+          }
+        else
+          {
+            db->SpinPrepareCached (&stmt, cmd);
+          }
+        db->Bind (stmt, 1, i * 0.001);
+        db->Bind (stmt, 2, i % 100);
+        db->Bind (stmt, 3, i * 1.5);
+        if (mode == STATEMENT_PER_ROW)
+          {
+            db->SpinExec (stmt);
+          }
+        else
+          {
+            db->SpinExecCached (stmt);
+          }
+      }
+  }
+  int64_t elapsed = clock.End ();
+
+  const char *names[] = { "statement per row", "cached statement",
+                          "transactions", "transactions, WAL" };
+  std::cout << names[mode] << ": " << nRows << " rows in " << elapsed << " ms, "
+            << (elapsed > 0 ? nRows * 1000 / elapsed : 0) << " rows/s" << std::endl;
+}
+
+}  // unnamed namespace
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t nRows = 1000;
+  uint32_t transactionSize = 1000;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nRows", "Number of rows", nRows);
+  cmd.AddValue ("transactionSize", "Number of rows per transaction", transactionSize);
+  cmd.Parse (argc, argv);
+
+  Run (STATEMENT_PER_ROW, nRows, transactionSize);
+  Run (CACHED_STATEMENT, nRows, transactionSize);
+  Run (TRANSACTIONS, nRows, transactionSize);
+  Run (TRANSACTIONS_WAL, nRows, transactionSize);
+
+  return 0;
+}
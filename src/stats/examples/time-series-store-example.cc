@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This example writes the same data points with a FileAggregator and
+// with a TimeSeriesStore, and prints the time taken by each one and
+// the size of the files.  The file of the TimeSeriesStore is then
+// converted to text with TimeSeriesStore::Read.
+//
+// Example:
+//   ./waf --run "time-series-store-example --nSamples=1000000"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+#include "ns3/stats-module.h"
+
+using namespace ns3;
+
+namespace {
+
+/**
+ * \param fileName the name of a file.
+ * \return the size of the file.
+ */
+std::streamoff
+FileSize (const std::string &fileName)
+{
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary | std::ios::ate);
+  return file.tellg ();
+}
+
+/**
+ * Write the data points to an aggregator.
+ * \param aggregator the aggregator.
+ * \param nContexts the number of contexts.
+ * \param nSamples the number of data points.
+ */
+template <typename T>
+void
+WriteSamples (Ptr<T> aggregator, uint32_t nContexts, uint32_t nSamples)
+{
+  std::vector<std::string> contexts;
+  for (uint32_t c = 0; c < nContexts; c++)
+    {
+      std::ostringstream oss;
+      oss << "/NodeList/" << c << "/Counter";
+      contexts.push_back (oss.str ());
+    }
+
+  aggregator->Enable ();
+  for (uint32_t i = 0; i < nSamples; i++)
+    {
+      // Periodic samples of a slowly increasing counter
+      uint32_t c = i % nContexts;
+      double time = MilliSeconds (i / nContexts).GetSeconds ();
+      aggregator->Write2d (contexts[c], time, 1000 * c + i / 1000);
+    }
+}
+
+}  // unnamed namespace
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t nSamples = 100000;
+  uint32_t nContexts = 10;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nSamples", "Number of data points", nSamples);
+  cmd.AddValue ("nContexts", "Number of contexts", nContexts);
+  cmd.Parse (argc, argv);
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  {
+    Ptr<FileAggregator> aggregator = CreateObject<FileAggregator> ("time-series-store-example.txt");
+    WriteSamples (aggregator, nContexts, nSamples);
+  }
+  int64_t fileTime = clock.End ();
+
+  clock.Start ();
+  {
+    Ptr<TimeSeriesStore> store = CreateObject<TimeSeriesStore> ("time-series-store-example.tss");
+    WriteSamples (store, nContexts, nSamples);
+  }
+  int64_t storeTime = clock.End ();
+
+  std::cout << "FileAggregator   " << fileTime << " ms  "
+            << FileSize ("time-series-store-example.txt") << " bytes" << std::endl;
+  std::cout << "TimeSeriesStore  " << storeTime << " ms  "
+            << FileSize ("time-series-store-example.tss") << " bytes" << std::endl;
+
+  Ptr<FileAggregator> converter = CreateObject<FileAggregator> ("time-series-store-example-converted.txt");
+  converter->Enable ();
+  TimeSeriesStore::Read ("time-series-store-example.tss",
+                         MakeCallback (&FileAggregator::Write2d, converter));
+
+  return 0;
+}
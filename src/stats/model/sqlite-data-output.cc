@@ -21,8 +21,10 @@
 #include "sqlite-data-output.h"
 #include <sstream>
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/nstime.h"
+#include "ns3/uinteger.h"
 
 #include "data-collector.h"
 #include "data-calculator.h"
@@ -33,7 +35,9 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("SqliteDataOutput");
 
 SqliteDataOutput::SqliteDataOutput ()
-  : DataOutputInterface ()
+  : DataOutputInterface (),
+    m_transactionSize (0),
+    m_synchronousOff (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -50,7 +54,22 @@ SqliteDataOutput::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::SqliteDataOutput")
     .SetParent<DataOutputInterface> ()
     .SetGroupName ("Stats")
-    .AddConstructor<SqliteDataOutput> ();
+    .AddConstructor<SqliteDataOutput> ()
+    .AddAttribute ("TransactionSize",
+                   "The number of rows inserted in a transaction, "
+                   "0 for a transaction per call to Output for the "
+                   "statistics.  Leave it to 0 when several simulations "
+                   "write to the same database.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&SqliteDataOutput::m_transactionSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("SynchronousOff",
+                   "Use a write-ahead log, and do not wait for the data to "
+                   "reach the disk.  The database may be corrupted if the "
+                   "system stops unexpectedly.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&SqliteDataOutput::m_synchronousOff),
+                   MakeBooleanChecker ());
   return tid;
 }
 
@@ -65,6 +84,12 @@ SqliteDataOutput::Output (DataCollector &dc)
   bool res;
 
   m_sqliteOut = new SQLiteOutput (m_dbFile, "ns-3-sqlite-data-output-sem");
+  if (m_synchronousOff)
+    {
+      m_sqliteOut->SetJournalWal ();
+      m_sqliteOut->SetSynchronousOff ();
+    }
+  m_sqliteOut->SetTransactionSize (m_transactionSize);
 
   res = m_sqliteOut->SpinExec ("CREATE TABLE IF NOT EXISTS Experiments (run, experiment, strategy, input, description text)");
   NS_ASSERT (res);
@@ -87,10 +112,9 @@ SqliteDataOutput::Output (DataCollector &dc)
   res = m_sqliteOut->Bind (stmt, 5, dc.GetDescription ());
   NS_ASSERT (res);
 
-  res = m_sqliteOut->SpinStep (stmt);
-  NS_ASSERT (res);
-  res = m_sqliteOut->SpinFinalize (stmt);
+  res = m_sqliteOut->SpinExecCached (stmt);
   NS_ASSERT (res);
+  m_sqliteOut->SpinFinalize (stmt);
 
   res = m_sqliteOut->WaitExec ("CREATE TABLE IF NOT EXISTS " \
                                "Metadata ( run text, key text, value)");
@@ -106,23 +130,32 @@ SqliteDataOutput::Output (DataCollector &dc)
        i != dc.MetadataEnd (); i++)
     {
       std::pair<std::string, std::string> blob = (*i);
-      m_sqliteOut->SpinReset (stmt);
       m_sqliteOut->Bind (stmt, 1, run);
       m_sqliteOut->Bind (stmt, 2, blob.first);
       m_sqliteOut->Bind (stmt, 3, blob.second);
-      m_sqliteOut->SpinStep (stmt);
+      m_sqliteOut->SpinExecCached (stmt);
     }
 
   m_sqliteOut->SpinFinalize (stmt);
 
-  m_sqliteOut->SpinExec ("BEGIN");
-  SqliteOutputCallback callback (m_sqliteOut, run);
-  for (DataCalculatorList::iterator i = dc.DataCalculatorBegin ();
-       i != dc.DataCalculatorEnd (); i++)
+  // Without grouping, the singletons still take a single transaction
+  if (m_transactionSize == 0)
+    {
+      m_sqliteOut->SpinExec ("BEGIN");
+    }
+  {
+    SqliteOutputCallback callback (m_sqliteOut, run);
+    for (DataCalculatorList::iterator i = dc.DataCalculatorBegin ();
+         i != dc.DataCalculatorEnd (); i++)
+      {
+        (*i)->Output (callback);
+      }
+  }
+  if (m_transactionSize == 0)
     {
-      (*i)->Output (callback);
+      m_sqliteOut->SpinExec ("COMMIT");
     }
-  m_sqliteOut->SpinExec ("COMMIT");
+  m_sqliteOut->Commit ();
   // end SqliteDataOutput::Output
 }
 
@@ -185,11 +218,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  m_db->SpinReset (m_insertSingletonStatement);
   m_db->Bind (m_insertSingletonStatement, 2, key);
   m_db->Bind (m_insertSingletonStatement, 3, variable);
   m_db->Bind (m_insertSingletonStatement, 4, val);
-  m_db->SpinStep (m_insertSingletonStatement);
+  m_db->SpinExecCached (m_insertSingletonStatement);
 }
 void
 SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
@@ -198,11 +230,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  m_db->SpinReset (m_insertSingletonStatement);
   m_db->Bind (m_insertSingletonStatement, 2, key);
   m_db->Bind (m_insertSingletonStatement, 3, variable);
   m_db->Bind (m_insertSingletonStatement, 4, val);
-  m_db->SpinStep (m_insertSingletonStatement);
+  m_db->SpinExecCached (m_insertSingletonStatement);
 }
 
 void
@@ -212,11 +243,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  m_db->SpinReset (m_insertSingletonStatement);
   m_db->Bind (m_insertSingletonStatement, 2, key);
   m_db->Bind (m_insertSingletonStatement, 3, variable);
   m_db->Bind (m_insertSingletonStatement, 4, val);
-  m_db->SpinStep (m_insertSingletonStatement);
+  m_db->SpinExecCached (m_insertSingletonStatement);
 }
 
 void
@@ -226,11 +256,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  m_db->SpinReset (m_insertSingletonStatement);
   m_db->Bind (m_insertSingletonStatement, 2, key);
   m_db->Bind (m_insertSingletonStatement, 3, variable);
   m_db->Bind (m_insertSingletonStatement, 4, val);
-  m_db->SpinStep (m_insertSingletonStatement);
+  m_db->SpinExecCached (m_insertSingletonStatement);
 }
 
 void
@@ -240,11 +269,10 @@ SqliteDataOutput::SqliteOutputCallback::OutputSingleton (std::string key,
 {
   NS_LOG_FUNCTION (this << key << variable << val);
 
-  m_db->SpinReset (m_insertSingletonStatement);
   m_db->Bind (m_insertSingletonStatement, 2, key);
   m_db->Bind (m_insertSingletonStatement, 3, variable);
   m_db->Bind (m_insertSingletonStatement, 4, val.GetTimeStep ());
-  m_db->SpinStep (m_insertSingletonStatement);
+  m_db->SpinExecCached (m_insertSingletonStatement);
 }
 
 } // namespace ns3
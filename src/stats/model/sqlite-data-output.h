@@ -37,6 +37,10 @@ class SQLiteOutput;
  * \ingroup dataoutput
  * \class SqliteDataOutput
  * \brief Outputs data in a format compatible with SQLite
+ *
+ * By default, the statistics of each call to Output are inserted in a
+ * single transaction.  With TransactionSize, all the rows are inserted in
+ * transactions of TransactionSize rows instead.
  */
 class SqliteDataOutput : public DataOutputInterface
 {
@@ -142,6 +146,8 @@ private:
   };
 
   Ptr<SQLiteOutput> m_sqliteOut; //!< Database
+  uint32_t m_transactionSize;    //!< Rows per transaction
+  bool m_synchronousOff;         //!< Whether to use WAL without waiting for the disk
 };
 
 // end namespace ns3
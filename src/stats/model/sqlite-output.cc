@@ -19,6 +19,8 @@
 #include "sqlite-output.h"
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <algorithm>
+#include <cctype>
 #include "ns3/abort.h"
 #include "ns3/unused.h"
 #include "ns3/log.h"
@@ -39,6 +41,13 @@ SQLiteOutput::~SQLiteOutput ()
 {
   int rc = SQLITE_FAIL;
 
+  Commit ();
+  for (std::map<std::string, sqlite3_stmt *>::iterator it = m_statements.begin ();
+       it != m_statements.end (); ++it)
+    {
+      SpinFinalize (it->second);
+    }
+
   rc = sqlite3_close_v2 (m_db);
   NS_ABORT_MSG_UNLESS (rc == SQLITE_OK, "Failed to close DB");
 }
@@ -50,22 +59,126 @@ SQLiteOutput::SetJournalInMemory ()
   SpinExec ("PRAGMA journal_mode = MEMORY");
 }
 
+void
+SQLiteOutput::SetJournalWal ()
+{
+  NS_LOG_FUNCTION (this);
+  // Executed directly, as the command returns a row
+  Commit ();
+  int rc = sqlite3_exec (m_db, "PRAGMA journal_mode = WAL", nullptr, nullptr, nullptr);
+  CheckError (m_db, rc, "PRAGMA journal_mode = WAL", nullptr, false);
+}
+
+void
+SQLiteOutput::SetSynchronousOff ()
+{
+  NS_LOG_FUNCTION (this);
+  SpinExec ("PRAGMA synchronous = OFF");
+}
+
+void
+SQLiteOutput::SetTransactionSize (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  if (m_groupedStatements >= size)
+    {
+      Commit ();
+    }
+  m_transactionSize = size;
+}
+
+bool
+SQLiteOutput::Commit () const
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_inTransaction)
+    {
+      return true;
+    }
+  m_inTransaction = false;
+  m_groupedStatements = 0;
+  int rc = SpinExec (m_db, "COMMIT");
+  return !CheckError (m_db, rc, "COMMIT", nullptr, false);
+}
+
+bool
+SQLiteOutput::BeginGrouped (const std::string &cmd) const
+{
+  if (m_transactionSize == 0)
+    {
+      return false;
+    }
+
+  if (!cmd.empty ())
+    {
+      // These commands cannot be executed within a transaction, or open one
+      std::string word = cmd.substr (0, cmd.find_first_of (" \t\n;"));
+      std::transform (word.begin (), word.end (), word.begin (), ::toupper);
+      if (word == "BEGIN" || word == "COMMIT" || word == "END" || word == "ROLLBACK"
+          || word == "SAVEPOINT" || word == "RELEASE" || word == "PRAGMA" || word == "VACUUM")
+        {
+          Commit ();
+          return false;
+        }
+    }
+
+  if (!m_inTransaction)
+    {
+      if (sqlite3_get_autocommit (m_db) == 0)
+        {
+          // the user opened a transaction
+          return false;
+        }
+      int rc = SpinExec (m_db, "BEGIN");
+      if (CheckError (m_db, rc, "BEGIN", nullptr, false))
+        {
+          return false;
+        }
+      m_inTransaction = true;
+      m_groupedStatements = 0;
+    }
+  return true;
+}
+
+void
+SQLiteOutput::EndGrouped () const
+{
+  if (++m_groupedStatements >= m_transactionSize)
+    {
+      Commit ();
+    }
+}
+
 bool
 SQLiteOutput::SpinExec (const std::string &cmd) const
 {
-  return (SpinExec (m_db, cmd) == SQLITE_OK);
+  bool grouped = BeginGrouped (cmd);
+  bool ret = (SpinExec (m_db, cmd) == SQLITE_OK);
+  if (grouped)
+    {
+      EndGrouped ();
+    }
+  return ret;
 }
 
 bool
 SQLiteOutput::SpinExec (sqlite3_stmt *stmt) const
 {
+  bool grouped = BeginGrouped ("");
   int rc = SpinExec (m_db, stmt);
+  if (grouped)
+    {
+      EndGrouped ();
+    }
   return !CheckError (m_db, rc, "", nullptr, false);
 }
 
 bool
 SQLiteOutput::WaitExec (const std::string &cmd) const
 {
+  // Never grouped: a transaction left open by a process holding no
+  // semaphore would block the other processes waiting on it
+  Commit ();
   int rc = WaitExec (m_db, cmd);
   return !CheckError (m_db, rc, cmd, nullptr, false);
 }
@@ -73,7 +186,41 @@ SQLiteOutput::WaitExec (const std::string &cmd) const
 bool
 SQLiteOutput::WaitExec (sqlite3_stmt *stmt) const
 {
-  return (WaitExec (m_db, stmt) == SQLITE_OK);
+  Commit ();
+  int rc = WaitExec (m_db, stmt);
+  return (rc == SQLITE_OK);
+}
+
+bool
+SQLiteOutput::SpinPrepareCached (sqlite3_stmt **stmt, const std::string &cmd) const
+{
+  std::map<std::string, sqlite3_stmt *>::const_iterator it = m_statements.find (cmd);
+  if (it != m_statements.end ())
+    {
+      *stmt = it->second;
+      return true;
+    }
+
+  if (SpinPrepare (m_db, stmt, cmd) != SQLITE_OK)
+    {
+      return false;
+    }
+  m_statements[cmd] = *stmt;
+  return true;
+}
+
+bool
+SQLiteOutput::SpinExecCached (sqlite3_stmt *stmt) const
+{
+  bool grouped = BeginGrouped ("");
+  int rc = SpinStep (stmt);
+  bool ret = !CheckError (m_db, rc, "", nullptr, false);
+  SpinReset (stmt);
+  if (grouped)
+    {
+      EndGrouped ();
+    }
+  return ret;
 }
 
 bool
@@ -21,6 +21,7 @@
 
 #include "ns3/simple-ref-count.h"
 #include <sqlite3.h>
+#include <map>
 #include <string>
 #include <semaphore.h>
 
@@ -40,6 +41,14 @@ namespace ns3 {
  * recommended to use the "Wait" prefixed methods. Otherwise, if the access to
  * the database is unique, using "Spin" methods will speed up database access.
  *
+ * By default, each statement is a transaction of its own, which is
+ * written to the disk before the next statement is executed. With
+ * SetTransactionSize, the statements executed by the "Spin" methods are
+ * grouped in transactions instead. The "Wait" methods are never grouped,
+ * as the database stays locked until the transaction is committed.
+ * Statements executed many times should be prepared once with
+ * SpinPrepareCached and executed with SpinExecCached.
+ *
  * The database is opened in the constructor, and closed in the deconstructor.
  */
 class SQLiteOutput : public SimpleRefCount <SQLiteOutput>
@@ -62,6 +71,43 @@ public:
    */
   void SetJournalInMemory ();
 
+  /**
+   * \brief Instruct SQLite to use a write-ahead log as journal. Readers and
+   * the writer do not block each other, and a transaction takes a single write.
+   */
+  void SetJournalWal ();
+
+  /**
+   * \brief Instruct SQLite not to wait for the data to reach the disk. The
+   * database may be corrupted if the system (not the program) stops
+   * unexpectedly, which is often acceptable for simulation outputs.
+   */
+  void SetSynchronousOff ();
+
+  /**
+   * \brief Group the statements executed in transactions
+   *
+   * The statements executed by the "Spin" methods are grouped in
+   * transactions of at most size statements. The last transaction is
+   * committed by Commit, or when the database is closed. Commands
+   * controlling transactions, PRAGMA, VACUUM and the statements executed by
+   * the "Wait" methods commit the current transaction first, and the
+   * statements executed in a transaction opened by the user are not grouped.
+   *
+   * Do not group the statements when other processes write to the same
+   * database: they cannot write until the transaction is committed.
+   *
+   * \param size number of statements per transaction, 0 to have a
+   * transaction per statement (the default)
+   */
+  void SetTransactionSize (uint32_t size);
+
+  /**
+   * \brief Commit the transaction grouping the last statements, if any
+   * \return true in case of success
+   */
+  bool Commit () const;
+
   /**
    * \brief Execute a command until the return value is OK or an ERROR
    *
@@ -80,6 +126,9 @@ public:
   bool SpinExec (sqlite3_stmt *stmt) const;
   /**
    * \brief Execute a command, waiting on a system semaphore
+   *
+   * The statements grouped in a transaction are committed first.
+   *
    * \param cmd Command to be executed
    * \return true in case of success
    */
@@ -87,6 +136,9 @@ public:
 
   /**
    * \brief Execute a command, waiting on a system semaphore
+   *
+   * The statements grouped in a transaction are committed first.
+   *
    * \param stmt Sqlite3 statement to be executed
    * \return true in case of success
    */
@@ -108,6 +160,29 @@ public:
    */
   bool SpinPrepare (sqlite3_stmt **stmt, const std::string &cmd) const;
 
+  /**
+   * \brief Get a prepared statement for a command, preparing it the first time
+   *
+   * The statement belongs to this object and is finalized when the database
+   * is closed: execute it with SpinExecCached, which does not finalize it.
+   *
+   * \param stmt Sqlite statement
+   * \param cmd Command to prepare inside the statement
+   * \return true in case of success
+   */
+  bool SpinPrepareCached (sqlite3_stmt **stmt, const std::string &cmd) const;
+
+  /**
+   * \brief Execute a statement which does not return rows, and reset it, so
+   * that it can be executed again
+   *
+   * The values bound to the statement are kept.
+   *
+   * \param stmt Sqlite statement
+   * \return true in case of success
+   */
+  bool SpinExecCached (sqlite3_stmt *stmt) const;
+
   /**
    * \brief Bind a value to a sqlite statement
    * \param stmt Sqlite statement
@@ -213,12 +288,34 @@ protected:
   static bool CheckError (sqlite3 *db, int rc, const std::string &cmd,
                           sem_t *sem, bool hardExit);
 
+  /**
+   * \brief Open the transaction grouping statements, if needed
+   * \param cmd Command to be executed, or empty for a prepared statement
+   * \return true if the statement is part of the transaction
+   */
+  bool BeginGrouped (const std::string &cmd) const;
+
+  /**
+   * \brief Count a statement of the transaction, and commit it when it is full
+   */
+  void EndGrouped () const;
+
 private:
   std::string m_dBname;      //!< Database name
   std::string m_semName;     //!< System semaphore name
   sqlite3 *m_db {
     nullptr
   };                         //!< Database pointer
+  uint32_t m_transactionSize {
+    0
+  };                         //!< Statements per transaction, 0 for no grouping
+  mutable uint32_t m_groupedStatements {
+    0
+  };                         //!< Statements executed in the grouping transaction
+  mutable bool m_inTransaction {
+    false
+  };                         //!< Whether a grouping transaction is open
+  mutable std::map<std::string, sqlite3_stmt *> m_statements; //!< Cached statements
 };
 
 } // namespace ns3
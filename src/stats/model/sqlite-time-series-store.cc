@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "sqlite-time-series-store.h"
+#include "sqlite-output.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("SQLiteTimeSeriesStore");
+
+NS_OBJECT_ENSURE_REGISTERED (SQLiteTimeSeriesStore);
+
+TypeId
+SQLiteTimeSeriesStore::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::SQLiteTimeSeriesStore")
+    .SetParent<TimeSeriesStore> ()
+    .SetGroupName ("Stats")
+  ;
+
+  return tid;
+}
+
+SQLiteTimeSeriesStore::SQLiteTimeSeriesStore (Ptr<SQLiteOutput> db, const std::string &tableName)
+  : m_db (db),
+    m_tableName (tableName),
+    m_stmt (nullptr)
+{
+  NS_LOG_FUNCTION (this << tableName);
+
+  bool ret = m_db->WaitExec ("CREATE TABLE IF NOT EXISTS " + m_tableName +
+                             " (context TEXT NOT NULL, time DOUBLE NOT NULL, value DOUBLE NOT NULL);");
+  NS_ABORT_UNLESS (ret);
+}
+
+SQLiteTimeSeriesStore::~SQLiteTimeSeriesStore ()
+{
+  NS_LOG_FUNCTION (this);
+  // The base class destructor would not call the methods of this class
+  Flush ();
+}
+
+void
+SQLiteTimeSeriesStore::DoStartFlush (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  bool ret = m_db->SpinExec ("BEGIN");
+  NS_ABORT_UNLESS (ret);
+  ret = m_db->SpinPrepareCached (&m_stmt, "INSERT INTO " + m_tableName + " VALUES (?,?,?);");
+  NS_ABORT_UNLESS (ret);
+}
+
+void
+SQLiteTimeSeriesStore::DoWriteChunk (const std::string &context,
+                                     const TimeSeriesChunk &chunk)
+{
+  NS_LOG_FUNCTION (this << context << chunk.GetCount ());
+
+  m_times.clear ();
+  m_values.clear ();
+  bool ret = TimeSeriesChunk::Decode (chunk.GetData ().data (), chunk.GetData ().size (),
+                                      chunk.GetCount (), m_times, m_values);
+  NS_ABORT_UNLESS (ret);
+
+  for (std::size_t i = 0; i < m_times.size (); i++)
+    {
+      ret = m_db->Bind (m_stmt, 1, context);
+      NS_ABORT_UNLESS (ret);
+      ret = m_db->Bind (m_stmt, 2, m_times[i]);
+      NS_ABORT_UNLESS (ret);
+      ret = m_db->Bind (m_stmt, 3, m_values[i]);
+      NS_ABORT_UNLESS (ret);
+      ret = m_db->SpinExecCached (m_stmt);
+      NS_ABORT_MSG_UNLESS (ret, "Failed to insert into " << m_tableName);
+    }
+}
+
+void
+SQLiteTimeSeriesStore::DoEndFlush (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  bool ret = m_db->SpinExec ("COMMIT");
+  NS_ABORT_UNLESS (ret);
+}
+
+} // namespace ns3
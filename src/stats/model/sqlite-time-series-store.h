@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SQLITE_TIME_SERIES_STORE_H
+#define SQLITE_TIME_SERIES_STORE_H
+
+#include "ns3/time-series-store.h"
+#include "ns3/ptr.h"
+
+struct sqlite3_stmt;
+
+namespace ns3 {
+
+class SQLiteOutput;
+
+/**
+ * \ingroup aggregator
+ *
+ * \brief A TimeSeriesStore writing the values to a table of an SQLite
+ * database.
+ *
+ * The table has the columns context (TEXT), time (DOUBLE) and value
+ * (DOUBLE).  The values of the chunks written together are inserted
+ * in a single transaction.
+ */
+class SQLiteTimeSeriesStore : public TimeSeriesStore
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \param db the database.
+   * \param tableName the table, created if it does not exist.
+   */
+  SQLiteTimeSeriesStore (Ptr<SQLiteOutput> db, const std::string &tableName);
+
+  virtual ~SQLiteTimeSeriesStore ();
+
+protected:
+  virtual void DoStartFlush (void);
+  virtual void DoWriteChunk (const std::string &context,
+                             const TimeSeriesChunk &chunk);
+  virtual void DoEndFlush (void);
+
+private:
+  Ptr<SQLiteOutput> m_db;    //!< the database
+  std::string m_tableName;   //!< the table
+  sqlite3_stmt *m_stmt;      //!< the insert statement
+  std::vector<double> m_times;  //!< decoded times
+  std::vector<double> m_values; //!< decoded values
+};
+
+} // namespace ns3
+
+#endif // SQLITE_TIME_SERIES_STORE_H
@@ -0,0 +1,682 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+
+#include "time-series-store.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimeSeriesStore");
+
+namespace {
+
+/// Magic number at the start of the files written by TimeSeriesStore
+const char FILE_MAGIC[8] = { 'n', 's', '3', 't', 's', 's', 0, 1 };
+
+/// Times not smaller than this, in seconds, are not converted to nanoseconds
+const double MAX_TICKS_SECONDS = 1e9;
+
+/**
+ * \param time a time, in seconds.
+ * \return the time in nanoseconds, or 0 if it is too large.
+ */
+int64_t
+ToTicks (double time)
+{
+  if (std::fabs (time) < MAX_TICKS_SECONDS)
+    {
+      return std::llround (time * 1e9);
+    }
+  return 0;
+}
+
+/**
+ * \param ticks a time, in nanoseconds.
+ * \return the time in seconds.
+ */
+double
+FromTicks (int64_t ticks)
+{
+  return ticks / 1e9;
+}
+
+/**
+ * \param value a double.
+ * \return the bits of the double.
+ */
+uint64_t
+DoubleToBits (double value)
+{
+  uint64_t bits;
+  std::memcpy (&bits, &value, sizeof (bits));
+  return bits;
+}
+
+/**
+ * \param bits the bits of a double.
+ * \return the double.
+ */
+double
+BitsToDouble (uint64_t bits)
+{
+  double value;
+  std::memcpy (&value, &bits, sizeof (value));
+  return value;
+}
+
+/**
+ * \param v a non zero value.
+ * \return the number of leading zero bits.
+ */
+uint32_t
+LeadingZeros (uint64_t v)
+{
+  uint32_t n = 0;
+  while ((v & (uint64_t (1) << 63)) == 0)
+    {
+      v <<= 1;
+      n++;
+    }
+  return n;
+}
+
+/**
+ * \param v a non zero value.
+ * \return the number of trailing zero bits.
+ */
+uint32_t
+TrailingZeros (uint64_t v)
+{
+  uint32_t n = 0;
+  while ((v & 1) == 0)
+    {
+      v >>= 1;
+      n++;
+    }
+  return n;
+}
+
+/**
+ * \param v the value, in the least significant bits.
+ * \param nBits the number of bits of the value.
+ * \return the sign extended value.
+ */
+int64_t
+SignExtend (uint64_t v, uint32_t nBits)
+{
+  uint64_t sign = uint64_t (1) << (nBits - 1);
+  return static_cast<int64_t> ((v ^ sign) - sign);
+}
+
+/**
+ * Reads the bits written by TimeSeriesChunk::WriteBits.
+ */
+class BitReader
+{
+public:
+  /**
+   * \param data the bits.
+   * \param size the size of the data, in bytes.
+   */
+  BitReader (const uint8_t *data, std::size_t size)
+    : m_data (data),
+      m_size (size * 8),
+      m_pos (0)
+  {
+  }
+
+  /**
+   * \param nBits the number of bits to read, at most 64.
+   * \param [out] bits the bits read, in the least significant bits.
+   * \return false if there are not enough bits left.
+   */
+  bool Read (uint32_t nBits, uint64_t &bits)
+  {
+    if (m_pos + nBits > m_size)
+      {
+        return false;
+      }
+    bits = 0;
+    while (nBits > 0)
+      {
+        uint32_t offset = m_pos % 8;
+        uint32_t n = std::min (8 - offset, nBits);
+        uint8_t byte = m_data[m_pos / 8];
+        bits = (bits << n) | ((byte >> (8 - offset - n)) & ((1u << n) - 1));
+        m_pos += n;
+        nBits -= n;
+      }
+    return true;
+  }
+
+private:
+  const uint8_t *m_data; //!< the bits
+  std::size_t m_size;    //!< the number of bits
+  std::size_t m_pos;     //!< the number of bits read
+};
+
+} // unnamed namespace
+
+TimeSeriesChunk::TimeSeriesChunk ()
+  : m_bitPos (0),
+    m_count (0),
+    m_ticks (0),
+    m_delta (0),
+    m_value (0),
+    m_leading (64),
+    m_trailing (64)
+{
+}
+
+void
+TimeSeriesChunk::WriteBits (uint64_t bits, uint32_t nBits)
+{
+  while (nBits > 0)
+    {
+      if (m_bitPos == 0)
+        {
+          m_data.push_back (0);
+        }
+      uint32_t free = 8 - m_bitPos;
+      uint32_t n = std::min (free, nBits);
+      uint8_t chunk = (bits >> (nBits - n)) & ((1u << n) - 1);
+      m_data.back () |= chunk << (free - n);
+      m_bitPos = (m_bitPos + n) % 8;
+      nBits -= n;
+    }
+}
+
+void
+TimeSeriesChunk::Append (double time, double value)
+{
+  uint64_t valueBits = DoubleToBits (value);
+  int64_t ticks = ToTicks (time);
+
+  if (m_count == 0)
+    {
+      WriteBits (DoubleToBits (time), 64);
+      WriteBits (valueBits, 64);
+      m_delta = 0;
+    }
+  else
+    {
+      // Time: delta-of-delta of the nanoseconds, with a variable length
+      // prefix telling the size of the delta-of-delta, then the bits
+      // differing from the time in nanoseconds
+      int64_t delta = ticks - m_ticks;
+      int64_t dod = delta - m_delta;
+      bool raw = false;
+      if (dod == 0)
+        {
+          WriteBits (0, 1);
+        }
+      else if (dod >= -64 && dod < 64)
+        {
+          WriteBits (0x2, 2);
+          WriteBits (dod, 7);
+        }
+      else if (dod >= -256 && dod < 256)
+        {
+          WriteBits (0x6, 3);
+          WriteBits (dod, 9);
+        }
+      else if (dod >= -2048 && dod < 2048)
+        {
+          WriteBits (0xe, 4);
+          WriteBits (dod, 12);
+        }
+      else if (dod >= INT32_MIN && dod <= INT32_MAX)
+        {
+          WriteBits (0x1e, 5);
+          WriteBits (dod, 32);
+        }
+      else
+        {
+          WriteBits (0x1f, 5);
+          WriteBits (DoubleToBits (time), 64);
+          raw = true;
+        }
+      m_delta = delta;
+
+      if (!raw)
+        {
+          // The time may not be a whole number of nanoseconds, or be
+          // rounded differently
+          uint64_t residual = DoubleToBits (time) ^ DoubleToBits (FromTicks (ticks));
+          if (residual == 0)
+            {
+              WriteBits (0, 1);
+            }
+          else
+            {
+              uint32_t length = 64 - LeadingZeros (residual);
+              WriteBits (1, 1);
+              WriteBits (length - 1, 6);
+              WriteBits (residual, length);
+            }
+        }
+
+      // Value: XOR with the previous value.  The meaningful bits are
+      // written within the previous window when they fit in it.
+      uint64_t x = valueBits ^ m_value;
+      if (x == 0)
+        {
+          WriteBits (0, 1);
+        }
+      else
+        {
+          uint32_t leading = std::min (LeadingZeros (x), 31u);
+          uint32_t trailing = TrailingZeros (x);
+          if (leading >= m_leading && trailing >= m_trailing)
+            {
+              WriteBits (0x2, 2);
+              WriteBits (x >> m_trailing, 64 - m_leading - m_trailing);
+            }
+          else
+            {
+              uint32_t length = 64 - leading - trailing;
+              WriteBits (0x3, 2);
+              WriteBits (leading, 5);
+              WriteBits (length - 1, 6);
+              WriteBits (x >> trailing, length);
+              m_leading = leading;
+              m_trailing = trailing;
+            }
+        }
+    }
+
+  m_ticks = ticks;
+  m_value = valueBits;
+  m_count++;
+}
+
+uint32_t
+TimeSeriesChunk::GetCount (void) const
+{
+  return m_count;
+}
+
+const std::vector<uint8_t> &
+TimeSeriesChunk::GetData (void) const
+{
+  return m_data;
+}
+
+bool
+TimeSeriesChunk::Decode (const uint8_t *data, std::size_t size, uint32_t count,
+                         std::vector<double> &times, std::vector<double> &values)
+{
+  BitReader reader (data, size);
+  int64_t ticks = 0;
+  int64_t delta = 0;
+  uint64_t value = 0;
+  uint32_t leading = 0;
+  uint32_t trailing = 0;
+  uint64_t bits;
+
+  for (uint32_t i = 0; i < count; i++)
+    {
+      double time;
+      if (i == 0)
+        {
+          if (!reader.Read (64, bits))
+            {
+              return false;
+            }
+          time = BitsToDouble (bits);
+          if (!reader.Read (64, value))
+            {
+              return false;
+            }
+          ticks = ToTicks (time);
+          times.push_back (time);
+          values.push_back (BitsToDouble (value));
+          continue;
+        }
+
+      uint32_t ones = 0;
+      while (ones < 5)
+        {
+          if (!reader.Read (1, bits))
+            {
+              return false;
+            }
+          if (bits == 0)
+            {
+              break;
+            }
+          ones++;
+        }
+      static const uint32_t dodBits[] = { 0, 7, 9, 12, 32 };
+      if (ones == 5)
+        {
+          if (!reader.Read (64, bits))
+            {
+              return false;
+            }
+          time = BitsToDouble (bits);
+          int64_t newTicks = ToTicks (time);
+          delta = newTicks - ticks;
+          ticks = newTicks;
+        }
+      else
+        {
+          int64_t dod = 0;
+          if (ones > 0)
+            {
+              if (!reader.Read (dodBits[ones], bits))
+                {
+                  return false;
+                }
+              dod = SignExtend (bits, dodBits[ones]);
+            }
+          delta += dod;
+          ticks += delta;
+
+          uint64_t residual = 0;
+          if (!reader.Read (1, bits))
+            {
+              return false;
+            }
+          if (bits == 1)
+            {
+              uint64_t length;
+              if (!reader.Read (6, length) || !reader.Read (length + 1, residual))
+                {
+                  return false;
+                }
+            }
+          time = BitsToDouble (DoubleToBits (FromTicks (ticks)) ^ residual);
+        }
+
+      if (!reader.Read (1, bits))
+        {
+          return false;
+        }
+      if (bits == 1)
+        {
+          if (!reader.Read (1, bits))
+            {
+              return false;
+            }
+          if (bits == 1)
+            {
+              uint64_t length;
+              if (!reader.Read (5, bits) || !reader.Read (6, length))
+                {
+                  return false;
+                }
+              leading = static_cast<uint32_t> (bits);
+              trailing = 64 - leading - static_cast<uint32_t> (length + 1);
+            }
+          if (!reader.Read (64 - leading - trailing, bits))
+            {
+              return false;
+            }
+          value ^= bits << trailing;
+        }
+
+      times.push_back (time);
+      values.push_back (BitsToDouble (value));
+    }
+  return true;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (TimeSeriesStore);
+
+TypeId
+TimeSeriesStore::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::TimeSeriesStore")
+    .SetParent<DataCollectionObject> ()
+    .SetGroupName ("Stats")
+    .AddAttribute ("ChunkSize",
+                   "The number of values of a context compressed together.",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&TimeSeriesStore::m_chunkSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("FlushThreshold",
+                   "The number of bytes held in full chunks before they "
+                   "are written.",
+                   UintegerValue (4 * 1024 * 1024),
+                   MakeUintegerAccessor (&TimeSeriesStore::m_flushThreshold),
+                   MakeUintegerChecker<uint64_t> ())
+  ;
+
+  return tid;
+}
+
+TimeSeriesStore::TimeSeriesStore ()
+  : m_lastSeries (0),
+    m_fullBytes (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TimeSeriesStore::TimeSeriesStore (const std::string &outputFileName)
+  : m_lastSeries (0),
+    m_fullBytes (0),
+    m_outputFileName (outputFileName)
+{
+  NS_LOG_FUNCTION (this << outputFileName);
+
+  m_file.open (m_outputFileName.c_str (), std::ios::out | std::ios::binary);
+  m_file.write (FILE_MAGIC, sizeof (FILE_MAGIC));
+}
+
+TimeSeriesStore::~TimeSeriesStore ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+  m_file.close ();
+}
+
+void
+TimeSeriesStore::Write2d (std::string context,
+                          double time,
+                          double value)
+{
+  NS_LOG_FUNCTION (this << context << time << value);
+
+  if (!m_enabled)
+    {
+      return;
+    }
+
+  // Values tend to come in runs from the same context
+  if (m_lastSeries >= m_series.size () || m_series[m_lastSeries].context != context)
+    {
+      std::map<std::string, uint32_t>::const_iterator it = m_seriesIndex.find (context);
+      if (it == m_seriesIndex.end ())
+        {
+          m_lastSeries = m_series.size ();
+          m_seriesIndex[context] = m_lastSeries;
+          m_series.push_back (Series ());
+          m_series.back ().context = context;
+        }
+      else
+        {
+          m_lastSeries = it->second;
+        }
+    }
+
+  Series &series = m_series[m_lastSeries];
+  series.current.Append (time, value);
+
+  if (series.current.GetCount () >= m_chunkSize)
+    {
+      m_fullBytes += series.current.GetData ().size ();
+      series.full.push_back (TimeSeriesChunk ());
+      std::swap (series.full.back (), series.current);
+      if (m_fullBytes >= m_flushThreshold)
+        {
+          WriteChunks (false);
+        }
+    }
+}
+
+void
+TimeSeriesStore::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  WriteChunks (true);
+}
+
+void
+TimeSeriesStore::WriteChunks (bool all)
+{
+  NS_LOG_FUNCTION (this << all << m_fullBytes);
+
+  bool empty = true;
+  for (std::vector<Series>::const_iterator it = m_series.begin (); it != m_series.end () && empty; ++it)
+    {
+      empty = it->full.empty () && (!all || it->current.GetCount () == 0);
+    }
+  if (empty)
+    {
+      return;
+    }
+
+  DoStartFlush ();
+  for (std::vector<Series>::iterator it = m_series.begin (); it != m_series.end (); ++it)
+    {
+      for (std::vector<TimeSeriesChunk>::const_iterator chunk = it->full.begin (); chunk != it->full.end (); ++chunk)
+        {
+          DoWriteChunk (it->context, *chunk);
+        }
+      it->full.clear ();
+      if (all && it->current.GetCount () > 0)
+        {
+          DoWriteChunk (it->context, it->current);
+          it->current = TimeSeriesChunk ();
+        }
+    }
+  DoEndFlush ();
+  m_fullBytes = 0;
+}
+
+void
+TimeSeriesStore::DoStartFlush (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+TimeSeriesStore::DoWriteChunk (const std::string &context,
+                               const TimeSeriesChunk &chunk)
+{
+  NS_LOG_FUNCTION (this << context << chunk.GetCount ());
+
+  if (!m_file.is_open ())
+    {
+      return;
+    }
+
+  // Chunk record: context length, context, value count, data size and
+  // data, in little endian
+  uint32_t header[3] = { static_cast<uint32_t> (context.size ()),
+                         chunk.GetCount (),
+                         static_cast<uint32_t> (chunk.GetData ().size ()) };
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      uint8_t bytes[4] = { static_cast<uint8_t> (header[i]),
+                           static_cast<uint8_t> (header[i] >> 8),
+                           static_cast<uint8_t> (header[i] >> 16),
+                           static_cast<uint8_t> (header[i] >> 24) };
+      m_file.write (reinterpret_cast<const char *> (bytes), 4);
+      if (i == 0)
+        {
+          m_file.write (context.data (), context.size ());
+        }
+    }
+  m_file.write (reinterpret_cast<const char *> (chunk.GetData ().data ()), chunk.GetData ().size ());
+}
+
+void
+TimeSeriesStore::DoEndFlush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file.is_open ())
+    {
+      m_file.flush ();
+    }
+}
+
+bool
+TimeSeriesStore::Read (const std::string &fileName,
+                       Callback<void, std::string, double, double> sink)
+{
+  NS_LOG_FUNCTION (fileName);
+
+  std::ifstream file (fileName.c_str (), std::ios::in | std::ios::binary);
+  char magic[sizeof (FILE_MAGIC)];
+  if (!file.read (magic, sizeof (magic))
+      || std::memcmp (magic, FILE_MAGIC, sizeof (magic)) != 0)
+    {
+      NS_LOG_WARN ("Not a time series store file: " << fileName);
+      return false;
+    }
+
+  std::string context;
+  std::vector<uint8_t> data;
+  std::vector<double> times;
+  std::vector<double> values;
+  while (file.peek () != std::ifstream::traits_type::eof ())
+    {
+      uint32_t header[3];
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          uint8_t bytes[4];
+          if (!file.read (reinterpret_cast<char *> (bytes), 4))
+            {
+              return false;
+            }
+          header[i] = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t (bytes[3]) << 24);
+          if (i == 0)
+            {
+              context.resize (header[0]);
+              if (!file.read (&context[0], header[0]))
+                {
+                  return false;
+                }
+            }
+        }
+      data.resize (header[2]);
+      if (!file.read (reinterpret_cast<char *> (data.data ()), header[2]))
+        {
+          return false;
+        }
+
+      times.clear ();
+      values.clear ();
+      if (!TimeSeriesChunk::Decode (data.data (), data.size (), header[1], times, values))
+        {
+          NS_LOG_WARN ("Corrupted chunk in " << fileName);
+          return false;
+        }
+      for (std::size_t i = 0; i < times.size (); i++)
+        {
+          sink (context, times[i], values[i]);
+        }
+    }
+  return true;
+}
+
+} // namespace ns3
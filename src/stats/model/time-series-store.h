@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIME_SERIES_STORE_H
+#define TIME_SERIES_STORE_H
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/callback.h"
+#include "ns3/data-collection-object.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup aggregator
+ *
+ * \brief A compressed chunk of (time, value) samples.
+ *
+ * The times are stored as delta-of-delta of nanoseconds, and the
+ * values as the XOR with the previous value, keeping only the
+ * meaningful bits (as in Facebook's Gorilla).  Regularly spaced
+ * samples of slowly changing values take a few bits each.  The bits of
+ * the times which differ from a whole number of nanoseconds are stored
+ * too, so that any double is stored without loss.
+ */
+class TimeSeriesChunk
+{
+public:
+  TimeSeriesChunk ();
+
+  /**
+   * \brief Append a sample to the chunk.
+   * \param time the time of the sample.
+   * \param value the value of the sample.
+   */
+  void Append (double time, double value);
+
+  /// \return the number of samples in the chunk.
+  uint32_t GetCount (void) const;
+
+  /// \return the encoded samples.
+  const std::vector<uint8_t> & GetData (void) const;
+
+  /**
+   * \brief Decode the samples of a chunk.
+   * \param data the encoded samples.
+   * \param size the size of the encoded samples, in bytes.
+   * \param count the number of samples.
+   * \param [out] times the times of the samples are appended to this vector.
+   * \param [out] values the values of the samples are appended to this vector.
+   * \return false if the data is too short for count samples.
+   */
+  static bool Decode (const uint8_t *data, std::size_t size, uint32_t count,
+                      std::vector<double> &times, std::vector<double> &values);
+
+private:
+  /**
+   * \brief Append bits to the data.
+   * \param bits the bits, in the least significant bits.
+   * \param nBits the number of bits.
+   */
+  void WriteBits (uint64_t bits, uint32_t nBits);
+
+  std::vector<uint8_t> m_data; //!< encoded samples
+  uint32_t m_bitPos;           //!< number of bits used in the last byte
+  uint32_t m_count;            //!< number of samples
+  int64_t m_ticks;             //!< time of the last sample, in nanoseconds
+  int64_t m_delta;             //!< difference of the last two times, in nanoseconds
+  uint64_t m_value;            //!< bits of the last value
+  uint32_t m_leading;          //!< leading zeros of the last XOR window
+  uint32_t m_trailing;         //!< trailing zeros of the last XOR window
+};
+
+/**
+ * \ingroup aggregator
+ *
+ * \brief This aggregator stores the values it receives in compressed
+ * chunks in memory, and writes them in bulk.
+ *
+ * Unlike FileAggregator, which formats each value as text when it is
+ * received, the values are appended to a TimeSeriesChunk per context.
+ * The chunks holding ChunkSize values are written when they hold
+ * FlushThreshold bytes together, and all the chunks are written when
+ * Flush is called or the aggregator is destroyed.
+ *
+ * The chunks are written to a binary file, which can be read back with
+ * Read.  Subclasses write the chunks elsewhere by overriding
+ * DoStartFlush, DoWriteChunk and DoEndFlush.
+ */
+class TimeSeriesStore : public DataCollectionObject
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId ();
+
+  /**
+   * \param outputFileName name of the file to write.
+   *
+   * Constructs a time series store that will create a binary file
+   * named outputFileName.
+   */
+  TimeSeriesStore (const std::string &outputFileName);
+
+  virtual ~TimeSeriesStore ();
+
+  // Below are hooked to connectors exporting data
+
+  /**
+   * \param context specifies the dataset these values came from.
+   * \param time the time of the data point.
+   * \param value the value of the data point.
+   *
+   * \brief Stores a data point.  The signature matches
+   * FileAggregator::Write2d and GnuplotAggregator::Write2d.
+   */
+  void Write2d (std::string context,
+                double time,
+                double value);
+
+  /**
+   * \brief Write all the stored values.
+   */
+  void Flush (void);
+
+  /**
+   * \param fileName the name of a file written by a TimeSeriesStore.
+   * \param sink the callback invoked for each data point, with the
+   * context, the time and the value.
+   * \return false if the file could not be read.
+   *
+   * \brief Read the data points of a file, in the order the chunks
+   * were written.  For example, passing FileAggregator::Write2d as
+   * the sink converts the file to text.
+   */
+  static bool Read (const std::string &fileName,
+                    Callback<void, std::string, double, double> sink);
+
+protected:
+  /// Constructs a time series store which does not write to a file.
+  TimeSeriesStore ();
+
+  /**
+   * \brief Invoked before the chunks are written.
+   */
+  virtual void DoStartFlush (void);
+
+  /**
+   * \param context the dataset of the chunk.
+   * \param chunk the chunk.
+   *
+   * \brief Write a chunk.
+   */
+  virtual void DoWriteChunk (const std::string &context,
+                             const TimeSeriesChunk &chunk);
+
+  /**
+   * \brief Invoked after the chunks are written.
+   */
+  virtual void DoEndFlush (void);
+
+private:
+  /// The chunks of a context.
+  struct Series
+  {
+    std::string context;                  //!< the dataset
+    TimeSeriesChunk current;              //!< the chunk being filled
+    std::vector<TimeSeriesChunk> full;    //!< the full chunks not written yet
+  };
+
+  /**
+   * \brief Write the full chunks.
+   * \param all whether to write the chunks being filled too.
+   */
+  void WriteChunks (bool all);
+
+  std::vector<Series> m_series;                 //!< the series, in order of creation
+  std::map<std::string, uint32_t> m_seriesIndex; //!< index in m_series of each context
+  uint32_t m_lastSeries;                        //!< index of the last series used
+  uint32_t m_chunkSize;                         //!< number of values in a full chunk
+  uint64_t m_flushThreshold;                    //!< bytes held in full chunks before writing them
+  uint64_t m_fullBytes;                         //!< bytes held in full chunks
+  std::string m_outputFileName;                 //!< name of the output file
+  std::ofstream m_file;                         //!< the output file
+};
+
+} // namespace ns3
+
+#endif // TIME_SERIES_STORE_H
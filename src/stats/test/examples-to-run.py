@@ -14,6 +14,7 @@ cpp_examples = [
     ("gnuplot-aggregator-example", "True", "True"),
     ("gnuplot-example", "False", "False"),
     ("gnuplot-helper-example", "True", "True"),
+    ("time-series-store-example", "True", "True"),
 ]
 
 # A list of Python examples to run in order to ensure that they remain
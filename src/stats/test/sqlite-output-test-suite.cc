@@ -0,0 +1,233 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+
+#include "ns3/basic-data-calculators.h"
+#include "ns3/data-collector.h"
+#include "ns3/ptr.h"
+#include "ns3/sqlite-data-output.h"
+#include "ns3/sqlite-output.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup stats-test
+ * \ingroup tests
+ *
+ * \brief SQLiteOutput grouped transactions test
+ */
+class SQLiteOutputTransactionTestCase : public TestCase
+{
+public:
+  SQLiteOutputTransactionTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Count the rows of the test table.
+   * \param db the database.
+   * \return the number of rows.
+   */
+  int CountRows (Ptr<SQLiteOutput> db);
+};
+
+SQLiteOutputTransactionTestCase::SQLiteOutputTransactionTestCase ()
+  : TestCase ("Check the statements grouped in transactions")
+{
+}
+
+int
+SQLiteOutputTransactionTestCase::CountRows (Ptr<SQLiteOutput> db)
+{
+  sqlite3_stmt *stmt;
+  db->SpinPrepare (&stmt, "SELECT COUNT(*) FROM Samples;");
+  int count = -1;
+  if (SQLiteOutput::SpinStep (stmt) == SQLITE_ROW)
+    {
+      count = db->RetrieveColumn<int> (stmt, 0);
+    }
+  SQLiteOutput::SpinFinalize (stmt);
+  return count;
+}
+
+void
+SQLiteOutputTransactionTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("sqlite-output-test.db");
+  std::remove (fileName.c_str ());
+
+  Ptr<SQLiteOutput> db = Create<SQLiteOutput> (fileName, "sqlite-output-test");
+  // A second connection only sees the committed rows
+  Ptr<SQLiteOutput> reader = Create<SQLiteOutput> (fileName, "sqlite-output-test");
+
+  db->SetJournalWal ();
+  db->SetSynchronousOff ();
+  db->SetTransactionSize (10);
+  bool ok = db->SpinExec ("CREATE TABLE Samples (time DOUBLE, value INTEGER);");
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "table creation failed");
+
+  sqlite3_stmt *stmt;
+  sqlite3_stmt *other;
+  std::string cmd = "INSERT INTO Samples VALUES (?,?);";
+  ok = db->SpinPrepareCached (&stmt, cmd);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "statement preparation failed");
+  ok = db->SpinPrepareCached (&other, cmd);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "statement preparation failed");
+  NS_TEST_EXPECT_MSG_EQ (other, stmt, "the statement is not cached");
+
+  // The create statement was grouped with the first 9 rows
+  for (int i = 0; i < 25; i++)
+    {
+      db->Bind (stmt, 1, i * 0.5);
+      db->Bind (stmt, 2, i);
+      ok = db->SpinExecCached (stmt);
+      NS_TEST_ASSERT_MSG_EQ (ok, true, "insertion " << i << " failed");
+      if (i == 8)
+        {
+          NS_TEST_EXPECT_MSG_EQ (CountRows (reader), 9, "the first transaction is not committed");
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (CountRows (db), 25, "the writer does not see its rows");
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader), 19, "wrong number of committed rows");
+
+  ok = db->Commit ();
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "commit failed");
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader), 25, "the last rows are not committed");
+
+  // Transactions opened by the user are left alone
+  db->Bind (stmt, 1, 100.0);
+  db->SpinExecCached (stmt);
+  ok = db->SpinExec ("BEGIN");
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "user transaction not opened");
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader), 26, "the grouped row is not committed");
+  for (int i = 0; i < 20; i++)
+    {
+      db->SpinExecCached (stmt);
+    }
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader), 26, "the user transaction is committed");
+  ok = db->SpinExec ("COMMIT");
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "user transaction not committed");
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader), 46, "wrong number of committed rows");
+
+  // The "Wait" methods commit the grouped rows, and are not grouped
+  db->SpinExecCached (stmt);
+  ok = db->WaitExec ("INSERT INTO Samples VALUES (200.0, 0);");
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "insertion failed");
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader), 48, "the Wait statement is grouped");
+
+  // Rows are committed when the database is closed
+  db->SpinExecCached (stmt);
+  db = 0;
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader), 49, "rows not committed when closing");
+}
+
+/**
+ * \ingroup stats-test
+ * \ingroup tests
+ *
+ * \brief SqliteDataOutput test, with the default attributes
+ */
+class SqliteDataOutputTestCase : public TestCase
+{
+public:
+  SqliteDataOutputTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Count the rows of a table.
+   * \param db the database.
+   * \param table the table.
+   * \return the number of rows.
+   */
+  int CountRows (Ptr<SQLiteOutput> db, const std::string &table);
+};
+
+SqliteDataOutputTestCase::SqliteDataOutputTestCase ()
+  : TestCase ("Check the rows written by SqliteDataOutput")
+{
+}
+
+int
+SqliteDataOutputTestCase::CountRows (Ptr<SQLiteOutput> db, const std::string &table)
+{
+  sqlite3_stmt *stmt;
+  db->SpinPrepare (&stmt, "SELECT COUNT(*) FROM " + table + ";");
+  int count = -1;
+  if (SQLiteOutput::SpinStep (stmt) == SQLITE_ROW)
+    {
+      count = db->RetrieveColumn<int> (stmt, 0);
+    }
+  SQLiteOutput::SpinFinalize (stmt);
+  return count;
+}
+
+void
+SqliteDataOutputTestCase::DoRun (void)
+{
+  std::string prefix = CreateTempDirFilename ("sqlite-data-output-test");
+  std::remove ((prefix + ".db").c_str ());
+
+  Ptr<DataCollector> dc = CreateObject<DataCollector> ();
+  dc->DescribeRun ("experiment", "strategy", "input", "run");
+  dc->AddMetadata ("key1", "value1");
+  dc->AddMetadata ("key2", 2.0);
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<CounterCalculator<> > counter = CreateObject<CounterCalculator<> > ();
+      counter->SetKey ("counter" + std::to_string (i));
+      counter->Update (i + 1);
+      dc->AddDataCalculator (counter);
+    }
+
+  Ptr<SqliteDataOutput> output = CreateObject<SqliteDataOutput> ();
+  output->SetFilePrefix (prefix);
+  output->Output (*dc);
+  output->Output (*dc);
+  output = 0;
+
+  Ptr<SQLiteOutput> reader = Create<SQLiteOutput> (prefix + ".db", "sqlite-data-output-test");
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader, "Experiments"), 2, "wrong number of experiments");
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader, "Metadata"), 4, "wrong number of metadata");
+  NS_TEST_EXPECT_MSG_EQ (CountRows (reader, "Singletons"), 40, "wrong number of singletons");
+  reader = 0;
+  std::remove ((prefix + ".db").c_str ());
+}
+
+/**
+ * \ingroup stats-test
+ * \ingroup tests
+ *
+ * \brief SQLiteOutput test suite
+ */
+class SQLiteOutputTestSuite : public TestSuite
+{
+public:
+  SQLiteOutputTestSuite ();
+};
+
+SQLiteOutputTestSuite::SQLiteOutputTestSuite ()
+  : TestSuite ("sqlite-output", UNIT)
+{
+  AddTestCase (new SQLiteOutputTransactionTestCase, TestCase::QUICK);
+  AddTestCase (new SqliteDataOutputTestCase, TestCase::QUICK);
+}
+
+static SQLiteOutputTestSuite sqliteOutputTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include "ns3/time-series-store.h"
+#include "ns3/nstime.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/uinteger.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup stats-test
+ * \ingroup tests
+ *
+ * \brief TimeSeriesChunk encoding and decoding test
+ */
+class TimeSeriesChunkTestCase : public TestCase
+{
+public:
+  TimeSeriesChunkTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Encode and decode samples, and check they are unchanged.
+   * \param name the name of the samples.
+   * \param times the times.
+   * \param values the values.
+   * \return the size of the encoded samples, in bytes.
+   */
+  std::size_t Check (const std::string &name,
+                     const std::vector<double> &times,
+                     const std::vector<double> &values);
+};
+
+TimeSeriesChunkTestCase::TimeSeriesChunkTestCase ()
+  : TestCase ("Check the encoding and decoding of time series chunks")
+{
+}
+
+std::size_t
+TimeSeriesChunkTestCase::Check (const std::string &name,
+                                const std::vector<double> &times,
+                                const std::vector<double> &values)
+{
+  TimeSeriesChunk chunk;
+  for (std::size_t i = 0; i < times.size (); i++)
+    {
+      chunk.Append (times[i], values[i]);
+    }
+  NS_TEST_EXPECT_MSG_EQ (chunk.GetCount (), times.size (), name << ": wrong count");
+
+  std::vector<double> decodedTimes;
+  std::vector<double> decodedValues;
+  bool ok = TimeSeriesChunk::Decode (chunk.GetData ().data (), chunk.GetData ().size (),
+                                     chunk.GetCount (), decodedTimes, decodedValues);
+  NS_TEST_EXPECT_MSG_EQ (ok, true, name << ": decoding failed");
+  NS_TEST_EXPECT_MSG_EQ (decodedTimes.size (), times.size (), name << ": wrong number of times");
+  NS_TEST_EXPECT_MSG_EQ (decodedValues.size (), values.size (), name << ": wrong number of values");
+  for (std::size_t i = 0; i < times.size () && i < decodedTimes.size () && i < decodedValues.size (); i++)
+    {
+      // compare the bits, NaNs included
+      NS_TEST_EXPECT_MSG_EQ (std::memcmp (&decodedTimes[i], &times[i], sizeof (double)), 0,
+                             name << ": time " << i << " is " << decodedTimes[i] << " instead of " << times[i]);
+      NS_TEST_EXPECT_MSG_EQ (std::memcmp (&decodedValues[i], &values[i], sizeof (double)), 0,
+                             name << ": value " << i << " is " << decodedValues[i] << " instead of " << values[i]);
+    }
+
+  if (chunk.GetData ().size () > 0)
+    {
+      // Decoding fails instead of reading past the data
+      decodedTimes.clear ();
+      decodedValues.clear ();
+      ok = TimeSeriesChunk::Decode (chunk.GetData ().data (), chunk.GetData ().size () - 1,
+                                    chunk.GetCount (), decodedTimes, decodedValues);
+      NS_TEST_EXPECT_MSG_EQ (ok, false, name << ": decoding truncated data did not fail");
+    }
+  return chunk.GetData ().size ();
+}
+
+void
+TimeSeriesChunkTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+
+  std::vector<double> times;
+  std::vector<double> values;
+
+  // Periodic samples of a constant, as the times of TimeSeriesAdaptor
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      times.push_back (MilliSeconds (100 * i).GetSeconds ());
+      values.push_back (42);
+    }
+  std::size_t size = Check ("periodic constant", times, values);
+  // 3 bits per sample
+  NS_TEST_EXPECT_MSG_LT (size, 400, "periodic constant samples not compressed");
+
+  // Slowly increasing counter, with jitter
+  times.clear ();
+  values.clear ();
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      times.push_back (NanoSeconds (1000000 * i + rv->GetInteger (0, 100)).GetSeconds ());
+      values.push_back (1000 + i / 10);
+    }
+  size = Check ("jittered counter", times, values);
+  NS_TEST_EXPECT_MSG_LT (size, 4000, "jittered counter samples not compressed");
+
+  // Random times and values, and a single sample
+  times.clear ();
+  values.clear ();
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      times.push_back (rv->GetValue (-1e3, 1e3));
+      values.push_back (rv->GetValue (-1e10, 1e10));
+    }
+  Check ("random", times, values);
+  Check ("single", std::vector<double> (1, 1.5), std::vector<double> (1, -2.5));
+  Check ("empty", std::vector<double> (), std::vector<double> ());
+
+  // Special values, and times too large for nanoseconds
+  times.clear ();
+  values.clear ();
+  double specials[] = { 0.0, -0.0, 1e300, -1e-300,
+                        std::numeric_limits<double>::infinity (),
+                        std::numeric_limits<double>::quiet_NaN (),
+                        std::numeric_limits<double>::denorm_min (),
+                        1e12, 1e9, -1e9, 1.0 / 3, 0.1};
+  for (uint32_t i = 0; i < 12; i++)
+    {
+      for (uint32_t j = 0; j < 12; j++)
+        {
+          times.push_back (specials[i]);
+          values.push_back (specials[j]);
+        }
+    }
+  Check ("special", times, values);
+}
+
+/**
+ * \ingroup stats-test
+ * \ingroup tests
+ *
+ * \brief TimeSeriesStore file test
+ */
+class TimeSeriesStoreTestCase : public TestCase
+{
+public:
+  TimeSeriesStoreTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Store a data point read from the file.
+   * \param context the context.
+   * \param time the time.
+   * \param value the value.
+   */
+  void ReadSink (std::string context, double time, double value);
+
+  /// data points read, for each context
+  std::map<std::string, std::vector<std::pair<double, double> > > m_read;
+};
+
+TimeSeriesStoreTestCase::TimeSeriesStoreTestCase ()
+  : TestCase ("Check that TimeSeriesStore files hold the data points written")
+{
+}
+
+void
+TimeSeriesStoreTestCase::ReadSink (std::string context, double time, double value)
+{
+  m_read[context].push_back (std::make_pair (time, value));
+}
+
+void
+TimeSeriesStoreTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("time-series-store.tss");
+
+  std::map<std::string, std::vector<std::pair<double, double> > > written;
+  Ptr<TimeSeriesStore> store = CreateObject<TimeSeriesStore> (fileName);
+  store->SetAttribute ("ChunkSize", UintegerValue (100));
+  store->SetAttribute ("FlushThreshold", UintegerValue (1000));
+  store->Enable ();
+  for (uint32_t i = 0; i < 3000; i++)
+    {
+      // Runs of data points of a context, and interleaved data points
+      std::string context = (i < 1000) ? "A" : (i % 2) ? "B" : "C/Context";
+      double time = i * 0.01;
+      double value = std::sin (i);
+      store->Write2d (context, time, value);
+      written[context].push_back (std::make_pair (time, value));
+    }
+  store->Disable ();
+  store->Write2d ("A", 1, 1);
+  store->Flush ();
+
+  // Data points written after a flush go to the same file
+  store->Enable ();
+  store->Write2d ("A", 100, 1);
+  written["A"].push_back (std::make_pair (100, 1));
+  store = 0;
+
+  bool ok = TimeSeriesStore::Read (fileName, MakeCallback (&TimeSeriesStoreTestCase::ReadSink, this));
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "reading the file failed");
+  NS_TEST_ASSERT_MSG_EQ (m_read.size (), written.size (), "wrong number of contexts");
+  for (std::map<std::string, std::vector<std::pair<double, double> > >::const_iterator it = written.begin ();
+       it != written.end (); ++it)
+    {
+      NS_TEST_EXPECT_MSG_EQ ((m_read[it->first] == it->second), true,
+                             "wrong data points for context " << it->first);
+    }
+
+  ok = TimeSeriesStore::Read (CreateTempDirFilename ("missing.tss"),
+                              MakeCallback (&TimeSeriesStoreTestCase::ReadSink, this));
+  NS_TEST_EXPECT_MSG_EQ (ok, false, "reading a missing file did not fail");
+}
+
+/**
+ * \ingroup stats-test
+ * \ingroup tests
+ *
+ * \brief TimeSeriesStore test suite
+ */
+class TimeSeriesStoreTestSuite : public TestSuite
+{
+public:
+  TimeSeriesStoreTestSuite ();
+};
+
+TimeSeriesStoreTestSuite::TimeSeriesStoreTestSuite ()
+  : TestSuite ("time-series-store", UNIT)
+{
+  AddTestCase (new TimeSeriesChunkTestCase, TestCase::QUICK);
+  AddTestCase (new TimeSeriesStoreTestCase, TestCase::QUICK);
+}
+
+static TimeSeriesStoreTestSuite timeSeriesStoreTestSuite; //!< Static variable for test initialization
@@ -45,6 +45,173 @@ Bar::Bar (Ptr<const WifiMacQueueItem> bar, uint8_t tid, bool skipIfNoDataQueued)
   NS_LOG_FUNCTION (this << *bar << +tid << skipIfNoDataQueued);
 }
 
+BlockAckManager::PacketQueue::PacketQueue ()
+{
+}
+
+BlockAckManager::PacketQueue::PacketQueue (const PacketQueue& other)
+  : m_mpdus (other.m_mpdus)
+{
+  // the slots point to the MPDUs of the other queue
+  Resize (other.m_slots.size ());
+}
+
+BlockAckManager::PacketQueue&
+BlockAckManager::PacketQueue::operator= (const PacketQueue& other)
+{
+  if (this != &other)
+    {
+      m_mpdus = other.m_mpdus;
+      Resize (other.m_slots.size ());
+    }
+  return *this;
+}
+
+BlockAckManager::PacketQueueI
+BlockAckManager::PacketQueue::begin (void)
+{
+  return m_mpdus.begin ();
+}
+
+BlockAckManager::PacketQueueI
+BlockAckManager::PacketQueue::end (void)
+{
+  return m_mpdus.end ();
+}
+
+std::size_t
+BlockAckManager::PacketQueue::size (void) const
+{
+  return m_mpdus.size ();
+}
+
+BlockAckManager::PacketQueueI
+BlockAckManager::PacketQueue::erase (PacketQueueI it)
+{
+  uint16_t seq = (*it)->GetHeader ().GetSequenceNumber ();
+  std::size_t slot = seq & (m_slots.size () - 1);
+  if (m_slots[slot] == it)
+    {
+      // the slot points to the next fragment, if any
+      PacketQueueI next = std::next (it);
+      m_slots[slot] = (next != m_mpdus.end () && (*next)->GetHeader ().GetSequenceNumber () == seq
+                       ? next : m_mpdus.end ());
+    }
+  return m_mpdus.erase (it);
+}
+
+BlockAckManager::PacketQueueI
+BlockAckManager::PacketQueue::Find (uint16_t seq)
+{
+  if (m_slots.empty ())
+    {
+      return m_mpdus.end ();
+    }
+  PacketQueueI it = m_slots[seq & (m_slots.size () - 1)];
+  if (it != m_mpdus.end () && (*it)->GetHeader ().GetSequenceNumber () == seq)
+    {
+      return it;
+    }
+  return m_mpdus.end ();
+}
+
+BlockAckManager::PacketQueueI
+BlockAckManager::PacketQueue::Insert (Ptr<WifiMacQueueItem> mpdu, const OriginatorBlockAckAgreement& agreement)
+{
+  const WifiMacHeader& hdr = mpdu->GetHeader ();
+  uint16_t seq = hdr.GetSequenceNumber ();
+  std::size_t mpduDist = agreement.GetDistance (seq);
+  NS_ASSERT (mpduDist < SEQNO_SPACE_HALF_SIZE);
+
+  std::size_t nSlots = 64;
+  while (nSlots < agreement.GetBufferSize ())
+    {
+      nSlots <<= 1;
+    }
+  if (m_slots.size () < nSlots)
+    {
+      Resize (nSlots);
+    }
+
+  PacketQueueI first = Find (seq);
+  PacketQueueI it = m_mpdus.end ();
+
+  if (first != m_mpdus.end ())
+    {
+      // look for the position among the fragments with the same sequence number
+      for (it = first; it != m_mpdus.end () && (*it)->GetHeader ().GetSequenceNumber () == seq; it++)
+        {
+          if (hdr.GetSequenceControl () == (*it)->GetHeader ().GetSequenceControl ())
+            {
+              return m_mpdus.end ();
+            }
+          if (hdr.GetFragmentNumber () < (*it)->GetHeader ().GetFragmentNumber ())
+            {
+              break;
+            }
+        }
+    }
+  else if (!m_mpdus.empty ())
+    {
+      std::size_t backDist = agreement.GetDistance (m_mpdus.back ()->GetHeader ().GetSequenceNumber ());
+      if (agreement.GetDistance (m_mpdus.front ()->GetHeader ().GetSequenceNumber ()) > mpduDist)
+        {
+          it = m_mpdus.begin ();
+        }
+      else if (backDist > mpduDist)
+        {
+          // the MPDU precedes the first MPDU found in the following slots
+          for (std::size_t dist = mpduDist + 1; dist <= backDist; dist++)
+            {
+              it = Find ((seq + dist - mpduDist) % SEQNO_SPACE_SIZE);
+              if (it != m_mpdus.end ())
+                {
+                  break;
+                }
+            }
+        }
+      // otherwise, the MPDU follows all the others (the common case)
+
+      // make room for a sequence number sharing the slot with another one
+      while (m_slots[seq & (m_slots.size () - 1)] != m_mpdus.end ())
+        {
+          Resize (m_slots.size () * 2);
+        }
+    }
+
+  PacketQueueI mpduIt = m_mpdus.insert (it, mpdu);
+  if (first == m_mpdus.end () || it == first)
+    {
+      m_slots[seq & (m_slots.size () - 1)] = mpduIt;
+    }
+  return mpduIt;
+}
+
+void
+BlockAckManager::PacketQueue::Resize (std::size_t nSlots)
+{
+  bool shared = true;
+  while (shared && nSlots > 0)
+    {
+      shared = false;
+      m_slots.assign (nSlots, m_mpdus.end ());
+      for (PacketQueueI it = m_mpdus.begin (); it != m_mpdus.end () && !shared; it++)
+        {
+          uint16_t seq = (*it)->GetHeader ().GetSequenceNumber ();
+          PacketQueueI& slot = m_slots[seq & (nSlots - 1)];
+          if (slot == m_mpdus.end ())
+            {
+              slot = it;
+            }
+          else if ((*slot)->GetHeader ().GetSequenceNumber () != seq)
+            {
+              shared = true;
+              nSlots *= 2;
+            }
+        }
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED (BlockAckManager);
 
 TypeId
@@ -236,26 +403,11 @@ BlockAckManager::StorePacket (Ptr<WifiMacQueueItem> mpdu)
 
   // store the packet and keep the list sorted in increasing order of sequence number
   // with respect to the starting sequence number
-  PacketQueueI it = agreementIt->second.second.begin ();
-  while (it != agreementIt->second.second.end ())
+  if (agreementIt->second.second.Insert (mpdu, agreementIt->second.first) == agreementIt->second.second.end ())
     {
-      if (mpdu->GetHeader ().GetSequenceControl () == (*it)->GetHeader ().GetSequenceControl ())
-        {
-          NS_LOG_DEBUG ("Packet already in the queue of the BA agreement");
-          return;
-        }
-
-      uint16_t dist = agreementIt->second.first.GetDistance ((*it)->GetHeader ().GetSequenceNumber ());
-
-      if (mpduDist < dist ||
-          (mpduDist == dist && mpdu->GetHeader ().GetFragmentNumber () < (*it)->GetHeader ().GetFragmentNumber ()))
-        {
-          break;
-        }
-
-      it++;
+      NS_LOG_DEBUG ("Packet already in the queue of the BA agreement");
+      return;
     }
-  agreementIt->second.second.insert (it, mpdu);
   agreementIt->second.first.NotifyTransmittedMpdu (mpdu);
   mpdu->SetInFlight ();
 }
@@ -445,13 +597,10 @@ BlockAckManager::NotifyGotAck (Ptr<const WifiMacQueueItem> mpdu)
   NS_ASSERT (it != m_agreements.end ());
 
   // remove the acknowledged frame from the queue of outstanding packets
-  for (auto queueIt = it->second.second.begin (); queueIt != it->second.second.end (); ++queueIt)
+  PacketQueueI queueIt = it->second.second.Find (mpdu->GetHeader ().GetSequenceNumber ());
+  if (queueIt != it->second.second.end ())
     {
-      if ((*queueIt)->GetHeader ().GetSequenceNumber () == mpdu->GetHeader ().GetSequenceNumber ())
-        {
-          HandleInFlightMpdu (queueIt, ACKNOWLEDGED, it, Simulator::Now ());
-          break;
-        }
+      HandleInFlightMpdu (queueIt, ACKNOWLEDGED, it, Simulator::Now ());
     }
 
   it->second.first.NotifyAckedMpdu (mpdu);
@@ -472,13 +621,10 @@ BlockAckManager::NotifyMissedAck (Ptr<WifiMacQueueItem> mpdu)
 
   // remove the frame from the queue of outstanding packets (it will be re-inserted
   // if retransmitted)
-  for (auto queueIt = it->second.second.begin (); queueIt != it->second.second.end (); ++queueIt)
+  PacketQueueI queueIt = it->second.second.Find (mpdu->GetHeader ().GetSequenceNumber ());
+  if (queueIt != it->second.second.end ())
     {
-      if ((*queueIt)->GetHeader ().GetSequenceNumber () == mpdu->GetHeader ().GetSequenceNumber ())
-        {
-          HandleInFlightMpdu (queueIt, TO_RETRANSMIT, it, Simulator::Now ());
-          break;
-        }
+      HandleInFlightMpdu (queueIt, TO_RETRANSMIT, it, Simulator::Now ());
     }
 }
 
@@ -22,6 +22,8 @@
 #define BLOCK_ACK_MANAGER_H
 
 #include <map>
+#include <list>
+#include <vector>
 #include "ns3/nstime.h"
 #include "ns3/traced-callback.h"
 #include "wifi-mac-header.h"
@@ -430,18 +432,82 @@ private:
    */
   void InactivityTimeout (Mac48Address recipient, uint8_t tid);
 
-  /**
-   * typedef for a list of WifiMacQueueItem.
-   */
-  typedef std::list<Ptr<WifiMacQueueItem>> PacketQueue;
   /**
    * typedef for an iterator for PacketQueue.
    */
   typedef std::list<Ptr<WifiMacQueueItem>>::iterator PacketQueueI;
+
   /**
-   * typedef for a const iterator for PacketQueue.
+   * The MPDUs in flight under a block ack agreement, kept in increasing order
+   * of sequence number with respect to the starting sequence number (and of
+   * fragment number). Besides the list, a circular buffer indexed by sequence
+   * number, whose size is the smallest power of two not less than the size of
+   * the transmit window, points to the first MPDU of each sequence number, so
+   * that MPDUs are found and stored without walking the list.
    */
-  typedef std::list<Ptr<WifiMacQueueItem>>::const_iterator PacketQueueCI;
+  class PacketQueue
+  {
+  public:
+    PacketQueue ();
+    /**
+     * Copy constructor.
+     * \param other the queue to copy
+     */
+    PacketQueue (const PacketQueue& other);
+    /**
+     * Assignment operator.
+     * \param other the queue to copy
+     * \return a reference to this queue
+     */
+    PacketQueue& operator= (const PacketQueue& other);
+
+    /**
+     * \return an iterator pointing to the first MPDU
+     */
+    PacketQueueI begin (void);
+    /**
+     * \return an iterator pointing past the last MPDU
+     */
+    PacketQueueI end (void);
+    /**
+     * \return the number of MPDUs
+     */
+    std::size_t size (void) const;
+    /**
+     * Remove an MPDU.
+     * \param it an iterator pointing to the MPDU
+     * \return an iterator pointing to the MPDU following the removed one
+     */
+    PacketQueueI erase (PacketQueueI it);
+
+    /**
+     * \param seq a sequence number
+     * \return an iterator pointing to the first MPDU with the given sequence
+     *         number, or end () if none
+     */
+    PacketQueueI Find (uint16_t seq);
+    /**
+     * Store an MPDU in its position, unless an MPDU with the same sequence
+     * control is already stored.
+     * \param mpdu the MPDU, which must not be an old MPDU for the agreement
+     * \param agreement the block ack agreement
+     * \return an iterator pointing to the stored MPDU, or end () if it was
+     *         already stored
+     */
+    PacketQueueI Insert (Ptr<WifiMacQueueItem> mpdu, const OriginatorBlockAckAgreement& agreement);
+
+  private:
+    /**
+     * Rebuild the circular buffer with (at least) the given number of slots,
+     * doubled until no two sequence numbers share a slot.
+     * \param nSlots the number of slots, a power of two
+     */
+    void Resize (std::size_t nSlots);
+
+    std::list<Ptr<WifiMacQueueItem>> m_mpdus; ///< the MPDUs
+    std::vector<PacketQueueI> m_slots;        ///< per sequence number modulo the size, the first MPDU or end ()
+  };
+
   /**
    * typedef for a map between MAC address and block ack agreement.
    */
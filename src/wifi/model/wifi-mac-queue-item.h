@@ -29,6 +29,7 @@
 #include "amsdu-subframe-header.h"
 #include "qos-utils.h"
 #include <list>
+#include <map>
 
 namespace ns3 {
 
@@ -142,6 +143,10 @@ public:
 
   /// Const iterator typedef
   typedef std::list<Ptr<WifiMacQueueItem>>::const_iterator ConstIterator;
+  /// Queued items sorted by their position in the queue
+  typedef std::map<uint64_t, ConstIterator> OrderedItems;
+  /// Queued items sorted by their timestamp
+  typedef std::multimap<Time, ConstIterator> TimestampedItems;
 
   /**
    * Return true if this item is stored in some queue, false otherwise.
@@ -209,6 +214,8 @@ private:
   Time m_tstamp;                                //!< timestamp when the packet arrived at the queue
   DeaggregatedMsdus m_msduList;                 //!< The list of aggregated MSDUs included in this MPDU
   ConstIterator m_queueIt;                      //!< Queue iterator pointing to this MPDU, if queued
+  OrderedItems::iterator m_subQueueIt;          //!< Position of this MPDU in its queue index, if queued
+  TimestampedItems::iterator m_expiryIt;        //!< Position of this MPDU in the expiry index, if queued
   AcIndex m_queueAc;                            //!< AC associated with the queue this MPDU is stored into
   bool m_inFlight;                              //!< whether the MPDU is in flight
 };
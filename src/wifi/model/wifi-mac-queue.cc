@@ -25,6 +25,9 @@
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
 #include <functional>
+#include <algorithm>
+#include <limits>
+#include <vector>
 
 namespace ns3 {
 
@@ -33,6 +36,11 @@ NS_LOG_COMPONENT_DEFINE ("WifiMacQueue");
 NS_OBJECT_ENSURE_REGISTERED (WifiMacQueue);
 NS_OBJECT_TEMPLATE_CLASS_DEFINE (Queue, WifiMacQueueItem);
 
+/// Position in the order of the queue of an item inserted into an empty queue
+static const uint64_t ORDER_START = static_cast<uint64_t> (1) << 63;
+/// Distance between the positions of an item enqueued at the end and of the previous one
+static const uint64_t ORDER_STEP = static_cast<uint64_t> (1) << 20;
+
 TypeId
 WifiMacQueue::GetTypeId (void)
 {
@@ -71,8 +79,16 @@ WifiMacQueue::WifiMacQueue (AcIndex ac)
 WifiMacQueue::~WifiMacQueue ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_nQueuedPackets.clear ();
-  m_nQueuedBytes.clear ();
+}
+
+void
+WifiMacQueue::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_qosSubQueues.clear ();
+  m_otherItems.clear ();
+  m_expiryIndex.clear ();
+  Queue<WifiMacQueueItem>::DoDispose ();
 }
 
 static std::list<Ptr<WifiMacQueueItem>> g_emptyWifiMacQueue; //!< empty Wi-Fi MAC queue
@@ -121,20 +137,23 @@ WifiMacQueue::Insert (ConstIterator pos, Ptr<WifiMacQueueItem> item)
       return DoEnqueue (pos, item);
     }
 
-  // the queue is full; scan the list in the attempt to remove stale packets
-  ConstIterator it = begin ();
+  // the queue is full; in the attempt to remove a stale packet, find the
+  // first one in the queue among those whose lifetime expired
+  ConstIterator it = end ();
   const Time now = Simulator::Now ();
-  while (it != end ())
+  for (auto expiryIt = m_expiryIndex.begin ();
+       expiryIt != m_expiryIndex.end () && now > expiryIt->first + m_maxDelay; expiryIt++)
     {
-      if (it == pos && TtlExceeded (it, now))
+      if (it == end () || GetOrder (expiryIt->second) < GetOrder (it))
         {
-          return DoEnqueue (it, item);
+          it = expiryIt->second;
         }
-      if (TtlExceeded (it, now))
-        {
-          return DoEnqueue (pos, item);
-        }
-      it++;
+    }
+  if (it != end ())
+    {
+      bool isPos = (it == pos);
+      TtlExceeded (it, now);
+      return DoEnqueue (isPos ? it : pos, item);
     }
 
   // the queue is still full, remove the oldest item if the policy is drop oldest
@@ -255,24 +274,16 @@ WifiMacQueue::ConstIterator
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest, ConstIterator pos) const
 {
   NS_LOG_FUNCTION (this << +tid << dest);
-  ConstIterator it = (pos != EMPTY ? pos : begin ());
-  const Time now = Simulator::Now ();
-  while (it != end ())
+  auto subQueueIt = m_qosSubQueues.find ({dest, tid});
+  if (subQueueIt == m_qosSubQueues.end () || pos == end ())
     {
-      // skip packets that stayed in the queue for too long. They will be
-      // actually removed from the queue by the next call to a non-const method
-      if (now <= (*it)->GetTimeStamp () + m_maxDelay)
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return it;
-            }
-        }
-      it++;
+      NS_LOG_DEBUG ("The queue is empty");
+      return end ();
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return end ();
+  // the QoS data frames having the given TID and destination are those of the
+  // sub-queue, thus we only look at the sub-queue from the given position
+  return PeekIndex (subQueueIt->second.items, (pos != EMPTY ? GetOrder (pos) : 0),
+                    Simulator::Now ());
 }
 
 WifiMacQueue::ConstIterator
@@ -292,11 +303,34 @@ WifiMacQueue::PeekFirstAvailable (const Ptr<QosBlockedDestinations> blockedPacke
             {
               return it;
             }
+          break;
         }
       it++;
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return end ();
+  if (it == end ())
+    {
+      NS_LOG_DEBUG ("The queue is empty");
+      return end ();
+    }
+
+  // the first packet is blocked: rather than scanning the packets of the
+  // blocked destinations, take the first packet among those of the sub-queues
+  // that are not blocked and of the frames other than QoS data
+  uint64_t order = GetOrder (it);
+  ConstIterator first = PeekIndex (m_otherItems, order, now);
+  for (const auto& subQueue : m_qosSubQueues)
+    {
+      if (blockedPackets->IsBlocked (subQueue.first.first, subQueue.first.second))
+        {
+          continue;
+        }
+      ConstIterator candidate = PeekIndex (subQueue.second.items, order, now);
+      if (candidate != end () && (first == end () || GetOrder (candidate) < GetOrder (first)))
+        {
+          first = candidate;
+        }
+    }
+  return first;
 }
 
 Ptr<WifiMacQueueItem>
@@ -377,19 +411,14 @@ WifiMacQueue::GetNPacketsByAddress (Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
 
-  uint32_t nPackets = 0;
-  const Time now = Simulator::Now ();
+  RemoveExpired (Simulator::Now ());
 
-  for (ConstIterator it = begin (); it != end (); )
+  uint32_t nPackets = 0;
+  for (ConstIterator it = begin (); it != end (); it++)
     {
-      if (!TtlExceeded (it, now))
+      if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
         {
-          if ((*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
-            {
-              nPackets++;
-            }
-
-          it++;
+          nPackets++;
         }
     }
   NS_LOG_DEBUG ("returns " << nPackets);
@@ -400,22 +429,9 @@ uint32_t
 WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, Mac48Address dest)
 {
   NS_LOG_FUNCTION (this << dest);
-  uint32_t nPackets = 0;
-  const Time now = Simulator::Now ();
-
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it, now))
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              nPackets++;
-            }
+  RemoveExpired (Simulator::Now ());
 
-          it++;
-        }
-    }
+  uint32_t nPackets = GetNPackets (tid, dest);
   NS_LOG_DEBUG ("returns " << nPackets);
   return nPackets;
 }
@@ -442,16 +458,9 @@ uint32_t
 WifiMacQueue::GetNPackets (void)
 {
   NS_LOG_FUNCTION (this);
-  const Time now = Simulator::Now ();
 
   // remove packets that stayed in the queue for too long
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it, now))
-        {
-          it++;
-        }
-    }
+  RemoveExpired (Simulator::Now ());
   return QueueBase::GetNPackets ();
 }
 
@@ -459,41 +468,32 @@ uint32_t
 WifiMacQueue::GetNBytes (void)
 {
   NS_LOG_FUNCTION (this);
-  const Time now = Simulator::Now ();
 
   // remove packets that stayed in the queue for too long
-  for (ConstIterator it = begin (); it != end (); )
-    {
-      if (!TtlExceeded (it, now))
-        {
-          it++;
-        }
-    }
+  RemoveExpired (Simulator::Now ());
   return QueueBase::GetNBytes ();
 }
 
 uint32_t
 WifiMacQueue::GetNPackets (uint8_t tid, Mac48Address dest) const
 {
-  WifiAddressTidPair addressTidPair (dest, tid);
-  auto it = m_nQueuedPackets.find (addressTidPair);
-  if (it == m_nQueuedPackets.end ())
+  auto it = m_qosSubQueues.find ({dest, tid});
+  if (it == m_qosSubQueues.end ())
     {
       return 0;
     }
-  return m_nQueuedPackets.at (addressTidPair);
+  return it->second.items.size ();
 }
 
 uint32_t
 WifiMacQueue::GetNBytes (uint8_t tid, Mac48Address dest) const
 {
-  WifiAddressTidPair addressTidPair (dest, tid);
-  auto it = m_nQueuedBytes.find (addressTidPair);
-  if (it == m_nQueuedBytes.end ())
+  auto it = m_qosSubQueues.find ({dest, tid});
+  if (it == m_qosSubQueues.end ())
     {
       return 0;
     }
-  return m_nQueuedBytes.at (addressTidPair);
+  return it->second.nBytes;
 }
 
 bool
@@ -502,22 +502,10 @@ WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
   Iterator ret;
   if (Queue<WifiMacQueueItem>::DoEnqueue (pos, item, ret))
     {
-      // update statistics about queued packets
-      if (item->GetHeader ().IsQosData ())
-        {
-          WifiAddressTidPair addressTidPair (item->GetHeader ().GetAddr1 (), item->GetHeader ().GetQosTid ());
-          auto it = m_nQueuedPackets.find (addressTidPair);
-          if (it == m_nQueuedPackets.end ())
-            {
-              m_nQueuedPackets[addressTidPair] = 0;
-              m_nQueuedBytes[addressTidPair] = 0;
-            }
-          m_nQueuedPackets[addressTidPair]++;
-          m_nQueuedBytes[addressTidPair] += item->GetSize ();
-        }
       // set item's information about its position in the queue
       item->m_queueAc = m_ac;
       item->m_queueIt = ret;
+      AddToIndexes (ret);
       return true;
     }
   return false;
@@ -536,20 +524,10 @@ WifiMacQueue::DoDequeue (ConstIterator pos)
 
   Ptr<WifiMacQueueItem> item = Queue<WifiMacQueueItem>::DoDequeue (pos);
 
-  if (item != 0 && item->GetHeader ().IsQosData ())
-    {
-      WifiAddressTidPair addressTidPair (item->GetHeader ().GetAddr1 (), item->GetHeader ().GetQosTid ());
-      NS_ASSERT (m_nQueuedPackets.find (addressTidPair) != m_nQueuedPackets.end ());
-      NS_ASSERT (m_nQueuedPackets[addressTidPair] >= 1);
-      NS_ASSERT (m_nQueuedBytes[addressTidPair] >= item->GetSize ());
-
-      m_nQueuedPackets[addressTidPair]--;
-      m_nQueuedBytes[addressTidPair] -= item->GetSize ();
-    }
-
   if (item != 0)
     {
       NS_ASSERT (item->IsQueued ());
+      RemoveFromIndexes (item);
       item->m_queueAc = AC_UNDEF;
     }
 
@@ -561,24 +539,186 @@ WifiMacQueue::DoRemove (ConstIterator pos)
 {
   Ptr<WifiMacQueueItem> item = Queue<WifiMacQueueItem>::DoRemove (pos);
 
-  if (item != 0 && item->GetHeader ().IsQosData ())
-    {
-      WifiAddressTidPair addressTidPair (item->GetHeader ().GetAddr1 (), item->GetHeader ().GetQosTid ());
-      NS_ASSERT (m_nQueuedPackets.find (addressTidPair) != m_nQueuedPackets.end ());
-      NS_ASSERT (m_nQueuedPackets[addressTidPair] >= 1);
-      NS_ASSERT (m_nQueuedBytes[addressTidPair] >= item->GetSize ());
-
-      m_nQueuedPackets[addressTidPair]--;
-      m_nQueuedBytes[addressTidPair] -= item->GetSize ();
-    }
-
   if (item != 0)
     {
       NS_ASSERT (item->IsQueued ());
+      RemoveFromIndexes (item);
       item->m_queueAc = AC_UNDEF;
     }
 
   return item;
 }
 
+void
+WifiMacQueue::RemoveExpired (const Time& now)
+{
+  NS_LOG_FUNCTION (this);
+
+  std::vector<ConstIterator> expired;
+  for (auto expiryIt = m_expiryIndex.begin ();
+       expiryIt != m_expiryIndex.end () && now > expiryIt->first + m_maxDelay; expiryIt++)
+    {
+      expired.push_back (expiryIt->second);
+    }
+  // drop the expired items in the order of the queue
+  std::sort (expired.begin (), expired.end (),
+             [this] (ConstIterator a, ConstIterator b) { return GetOrder (a) < GetOrder (b); });
+  for (auto it : expired)
+    {
+      TtlExceeded (it, now);
+    }
+}
+
+uint64_t
+WifiMacQueue::GetOrder (ConstIterator it) const
+{
+  return (*it)->m_subQueueIt->first;
+}
+
+uint64_t
+WifiMacQueue::GetFreeOrder (ConstIterator it)
+{
+  ConstIterator next = std::next (it);
+  bool hasPrev = (it != begin ());
+  bool hasNext = (next != end ());
+
+  if (!hasPrev && !hasNext)
+    {
+      return ORDER_START;
+    }
+  if (!hasNext)
+    {
+      uint64_t prevOrder = GetOrder (std::prev (it));
+      if (prevOrder <= std::numeric_limits<uint64_t>::max () - ORDER_STEP)
+        {
+          return prevOrder + ORDER_STEP;
+        }
+    }
+  else if (!hasPrev)
+    {
+      uint64_t nextOrder = GetOrder (next);
+      if (nextOrder >= ORDER_STEP)
+        {
+          return nextOrder - ORDER_STEP;
+        }
+    }
+  else
+    {
+      uint64_t prevOrder = GetOrder (std::prev (it));
+      uint64_t nextOrder = GetOrder (next);
+      if (nextOrder - prevOrder >= 2)
+        {
+          return prevOrder + (nextOrder - prevOrder) / 2;
+        }
+    }
+
+  // no room left between the neighbors
+  Renumber (it);
+  return GetFreeOrder (it);
+}
+
+void
+WifiMacQueue::Renumber (ConstIterator skip)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (auto& subQueue : m_qosSubQueues)
+    {
+      subQueue.second.items.clear ();
+    }
+  m_otherItems.clear ();
+
+  uint64_t order = ORDER_START / 2;
+  for (ConstIterator it = begin (); it != end (); it++)
+    {
+      if (it == skip)
+        {
+          continue;
+        }
+      WifiMacQueueItem::OrderedItems &index = GetIndex (*it);
+      (*it)->m_subQueueIt = index.emplace_hint (index.end (), order, it);
+      order += ORDER_STEP;
+    }
+  // the sub-queue of the skipped item may be left empty
+  for (auto subQueueIt = m_qosSubQueues.begin (); subQueueIt != m_qosSubQueues.end (); )
+    {
+      if (subQueueIt->second.items.empty ())
+        {
+          subQueueIt = m_qosSubQueues.erase (subQueueIt);
+        }
+      else
+        {
+          subQueueIt++;
+        }
+    }
+}
+
+WifiMacQueueItem::OrderedItems&
+WifiMacQueue::GetIndex (Ptr<const WifiMacQueueItem> item)
+{
+  if (item->GetHeader ().IsQosData ())
+    {
+      return m_qosSubQueues[{item->GetHeader ().GetAddr1 (), item->GetHeader ().GetQosTid ()}].items;
+    }
+  return m_otherItems;
+}
+
+void
+WifiMacQueue::AddToIndexes (ConstIterator it)
+{
+  Ptr<WifiMacQueueItem> item = *it;
+  uint64_t order = GetFreeOrder (it);
+  if (item->GetHeader ().IsQosData ())
+    {
+      QosSubQueue &subQueue = m_qosSubQueues[{item->GetHeader ().GetAddr1 (), item->GetHeader ().GetQosTid ()}];
+      item->m_subQueueIt = subQueue.items.emplace (order, it).first;
+      subQueue.nBytes += item->GetSize ();
+    }
+  else
+    {
+      item->m_subQueueIt = m_otherItems.emplace (order, it).first;
+    }
+  item->m_expiryIt = m_expiryIndex.emplace (item->GetTimeStamp (), it);
+}
+
+void
+WifiMacQueue::RemoveFromIndexes (Ptr<WifiMacQueueItem> item)
+{
+  if (item->GetHeader ().IsQosData ())
+    {
+      auto subQueueIt = m_qosSubQueues.find ({item->GetHeader ().GetAddr1 (), item->GetHeader ().GetQosTid ()});
+      NS_ASSERT (subQueueIt != m_qosSubQueues.end ());
+      NS_ASSERT (subQueueIt->second.nBytes >= item->GetSize ());
+
+      subQueueIt->second.items.erase (item->m_subQueueIt);
+      subQueueIt->second.nBytes -= item->GetSize ();
+      if (subQueueIt->second.items.empty ())
+        {
+          // do not keep the pairs of past traffic
+          m_qosSubQueues.erase (subQueueIt);
+        }
+    }
+  else
+    {
+      m_otherItems.erase (item->m_subQueueIt);
+    }
+  m_expiryIndex.erase (item->m_expiryIt);
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueue::PeekIndex (const WifiMacQueueItem::OrderedItems &index, uint64_t order,
+                         const Time& now) const
+{
+  for (auto indexIt = index.lower_bound (order); indexIt != index.end (); indexIt++)
+    {
+      // skip packets that stayed in the queue for too long. They will be
+      // actually removed from the queue by the next call to a non-const method
+      if (now <= (*indexIt->second)->GetTimeStamp () + m_maxDelay)
+        {
+          return indexIt->second;
+        }
+    }
+  return end ();
+}
+
 } //namespace ns3
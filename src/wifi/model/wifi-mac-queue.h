@@ -55,6 +55,14 @@ extern template class Queue<WifiMacQueueItem>;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the list of items, the queue keeps the QoS data frames of each
+ * (receiver address, TID) pair in a sub-queue, sorted by their position in
+ * the list, and all the items sorted by timestamp.  A sub-queue exists only
+ * while it holds frames. Thus, the frames of a
+ * given receiver and TID are peeked and counted without scanning the frames
+ * of the other receivers, and the expired frames are found without scanning
+ * the whole queue.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -171,7 +179,9 @@ public:
    * If <i>pos</i> is a valid iterator, the search starts from the packet pointed
    * to by the given iterator. This method does not remove the packet from the queue.
    * It is typically used by ns3::QosTxop in order to perform correct MSDU aggregation
-   * (A-MSDU).
+   * (A-MSDU). The complexity is logarithmic in the number of packets having the
+   * given TID and destination, if <i>pos</i> is a valid iterator, and constant
+   * otherwise, plus the number of expired packets skipped.
    *
    * \param tid the given TID
    * \param dest the given destination
@@ -182,6 +192,8 @@ public:
   ConstIterator PeekByTidAndAddress (uint8_t tid, Mac48Address dest, ConstIterator pos = EMPTY) const;
   /**
    * Return first available packet for transmission. The packet is not removed from queue.
+   * If the first packet is blocked, the sub-queues of the (destination, TID) pairs
+   * that are not blocked are searched, rather than the whole queue.
    *
    * \param blockedPackets the destination address & TID pairs that are waiting for a BlockAck response
    * \param pos the iterator pointing to the packet the search starts from
@@ -228,8 +240,9 @@ public:
   uint32_t GetNPacketsByAddress (Mac48Address dest);
   /**
    * Return the number of QoS packets having TID equal to <i>tid</i> and
-   * destination address equal to <i>dest</i>.  The complexity is linear in
-   * the size of the queue.
+   * destination address equal to <i>dest</i>, after removing the packets
+   * whose lifetime expired. The complexity is constant, plus the number of
+   * expired packets.
    *
    * \param tid the given TID
    * \param dest the given destination
@@ -328,14 +341,78 @@ private:
    */
   Ptr<WifiMacQueueItem> DoRemove (ConstIterator pos);
 
+  void DoDispose (void) override;
+
+  /**
+   * Remove all the items whose lifetime expired, in the order of the queue,
+   * as a scan of the whole queue would do.
+   *
+   * \param now a copy of Simulator::Now()
+   */
+  void RemoveExpired (const Time& now);
+  /**
+   * \param it an iterator pointing to a queued item
+   * \return the position of the item in the order of the queue
+   */
+  uint64_t GetOrder (ConstIterator it) const;
+  /**
+   * Get a position in the order of the queue for an item that was just
+   * inserted, between those of its neighbors. If there is no room left
+   * between them, the other items are renumbered.
+   *
+   * \param it an iterator pointing to the item
+   * \return the position of the item in the order of the queue
+   */
+  uint64_t GetFreeOrder (ConstIterator it);
+  /**
+   * Assign evenly spaced positions, in the order of the queue, to all the
+   * items but the given one, and index them again.
+   *
+   * \param skip an iterator pointing to the item that is not indexed yet
+   */
+  void Renumber (ConstIterator skip);
+  /**
+   * \param item a queued item
+   * \return the index of the items of the same sub-queue as the given one
+   */
+  WifiMacQueueItem::OrderedItems& GetIndex (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Add an item that was just inserted to the indexes.
+   *
+   * \param it an iterator pointing to the item
+   */
+  void AddToIndexes (ConstIterator it);
+  /**
+   * Remove an item that was just dequeued or dropped from the indexes.
+   *
+   * \param item the item
+   */
+  void RemoveFromIndexes (Ptr<WifiMacQueueItem> item);
+  /**
+   * \param index an index of items
+   * \param order the position the search starts from
+   * \param now a copy of Simulator::Now()
+   * \return an iterator pointing to the first item of the index from the given
+   *         position whose lifetime did not expire, or end() if none
+   */
+  ConstIterator PeekIndex (const WifiMacQueueItem::OrderedItems &index, uint64_t order,
+                           const Time& now) const;
+
+  /// Items of a (MAC address, TID) pair
+  struct QosSubQueue
+  {
+    WifiMacQueueItem::OrderedItems items;  //!< QoS data frames, in the order of the queue
+    uint32_t nBytes {0};                   //!< bytes queued
+  };
+
   Time m_maxDelay;                          //!< Time to live for packets in the queue
   DropPolicy m_dropPolicy;                  //!< Drop behavior of queue
   AcIndex m_ac;                             //!< the access category
 
-  /// Per (MAC address, TID) pair queued packets
-  std::unordered_map<WifiAddressTidPair, uint32_t, WifiAddressTidHash> m_nQueuedPackets;
-  /// Per (MAC address, TID) pair queued bytes
-  std::unordered_map<WifiAddressTidPair, uint32_t, WifiAddressTidHash> m_nQueuedBytes;
+  /// Per (MAC address, TID) pair queued QoS data frames, without empty sub-queues
+  std::unordered_map<WifiAddressTidPair, QosSubQueue, WifiAddressTidHash> m_qosSubQueues;
+  WifiMacQueueItem::OrderedItems m_otherItems;      //!< frames other than QoS data, in the order of the queue
+  WifiMacQueueItem::TimestampedItems m_expiryIndex; //!< all the frames, sorted by timestamp
 
   /// Traced callback: fired when a packet is dropped due to lifetime expiration
   TracedCallback<Ptr<const WifiMacQueueItem> > m_traceExpired;
@@ -35,6 +35,12 @@
 #include "ns3/pointer.h"
 #include "ns3/recipient-block-ack-agreement.h"
 #include "ns3/mac-rx-middle.h"
+#include "ns3/block-ack-manager.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/mgt-headers.h"
+#include "ns3/wifi-utils.h"
+#include "ns3/random-variable-stream.h"
+#include <algorithm>
 #include <list>
 
 using namespace ns3;
@@ -1615,6 +1621,223 @@ BlockAckAggregationDisabledTest::DoRun (void)
     }
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test for the MPDUs in flight of the BlockAckManager
+ *
+ * MPDUs are transmitted under a block ack agreement with a transmit window
+ * of 256 MPDUs starting close to the end of the sequence number space. New
+ * MPDUs and retransmissions are stored in random order (possibly twice), and
+ * are then acknowledged by BlockAck frames with random bitmaps or by Normal
+ * Acks. The test checks that the BlockAckManager reports the MPDUs in flight
+ * in increasing order of sequence number with respect to the starting
+ * sequence number, and that it keeps the number of MPDUs in flight.
+ */
+class BlockAckManagerInFlightTest : public TestCase
+{
+public:
+  BlockAckManagerInFlightTest ();
+
+private:
+  void DoRun (void) override;
+  /**
+   * Callback for the blocked and unblocked destinations
+   * \param recipient the recipient
+   * \param tid the TID
+   */
+  void Block (Mac48Address recipient, uint8_t tid);
+  /**
+   * Callback for the acknowledged and the failed MPDUs
+   * \param mpdu the MPDU
+   */
+  void Notify (Ptr<const WifiMacQueueItem> mpdu);
+  /**
+   * \param seqs sequence numbers
+   * \return the given sequence numbers in increasing order with respect to
+   *         the starting sequence number of the agreement
+   */
+  std::vector<uint16_t> Sort (std::vector<uint16_t> seqs) const;
+
+  Ptr<BlockAckManager> m_manager;  ///< the BlockAckManager
+  Mac48Address m_recipient;        ///< the recipient
+  std::vector<uint16_t> m_notified; ///< sequence numbers of the notified MPDUs
+};
+
+BlockAckManagerInFlightTest::BlockAckManagerInFlightTest ()
+  : TestCase ("Check the MPDUs in flight of the BlockAckManager"),
+    m_recipient (Mac48Address ("00:00:00:00:00:01"))
+{
+}
+
+void
+BlockAckManagerInFlightTest::Block (Mac48Address recipient, uint8_t tid)
+{
+}
+
+void
+BlockAckManagerInFlightTest::Notify (Ptr<const WifiMacQueueItem> mpdu)
+{
+  m_notified.push_back (mpdu->GetHeader ().GetSequenceNumber ());
+}
+
+std::vector<uint16_t>
+BlockAckManagerInFlightTest::Sort (std::vector<uint16_t> seqs) const
+{
+  uint16_t start = m_manager->GetOriginatorStartingSequence (m_recipient, 0);
+  std::sort (seqs.begin (), seqs.end (), [start] (uint16_t a, uint16_t b)
+             { return (a - start + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE
+                      < (b - start + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE; });
+  return seqs;
+}
+
+void
+BlockAckManagerInFlightTest::DoRun (void)
+{
+  Ptr<WifiMacQueue> queue = CreateObject<WifiMacQueue> (AC_BE);
+  queue->SetMaxDelay (Seconds (10));
+  m_manager = CreateObject<BlockAckManager> ();
+  m_manager->SetQueue (queue);
+  m_manager->SetBlockDestinationCallback (MakeCallback (&BlockAckManagerInFlightTest::Block, this));
+  m_manager->SetUnblockDestinationCallback (MakeCallback (&BlockAckManagerInFlightTest::Block, this));
+  m_manager->SetTxOkCallback (MakeCallback (&BlockAckManagerInFlightTest::Notify, this));
+  m_manager->SetTxFailedCallback (MakeCallback (&BlockAckManagerInFlightTest::Notify, this));
+
+  uint16_t startingSeq = 3900;
+  MgtAddBaRequestHeader reqHdr;
+  reqHdr.SetImmediateBlockAck ();
+  reqHdr.SetTid (0);
+  reqHdr.SetBufferSize (256);
+  reqHdr.SetTimeout (0);
+  reqHdr.SetStartingSequence (startingSeq);
+  m_manager->CreateAgreement (&reqHdr, m_recipient);
+
+  MgtAddBaResponseHeader respHdr;
+  StatusCode code;
+  code.SetSuccess ();
+  respHdr.SetStatusCode (code);
+  respHdr.SetAmsduSupport (reqHdr.IsAmsduSupported ());
+  respHdr.SetImmediateBlockAck ();
+  respHdr.SetTid (reqHdr.GetTid ());
+  respHdr.SetBufferSize (255);
+  respHdr.SetTimeout (reqHdr.GetTimeout ());
+  m_manager->UpdateAgreement (&respHdr, m_recipient, startingSeq);
+
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  random->SetStream (1);
+
+  std::map<uint16_t, Ptr<WifiMacQueueItem>> toRetransmit;
+  std::map<uint16_t, Ptr<WifiMacQueueItem>> inFlight;
+  uint16_t nextSeq = startingSeq;
+
+  for (uint32_t round = 0; round < 300; round++)
+    {
+      // retransmit some MPDUs and transmit new ones, within the transmit window
+      std::vector<Ptr<WifiMacQueueItem>> mpdus;
+      for (auto it = toRetransmit.begin (); it != toRetransmit.end (); )
+        {
+          if (random->GetInteger (0, 2) > 0)
+            {
+              mpdus.push_back (it->second);
+              it = toRetransmit.erase (it);
+            }
+          else
+            {
+              it++;
+            }
+        }
+      uint32_t nNew = random->GetInteger (0, 80);
+      uint16_t winStart = m_manager->GetOriginatorStartingSequence (m_recipient, 0);
+      for (uint32_t i = 0; i < nNew && (nextSeq - winStart + SEQNO_SPACE_SIZE) % SEQNO_SPACE_SIZE < 256; i++)
+        {
+          WifiMacHeader hdr;
+          hdr.SetType (WIFI_MAC_QOSDATA);
+          hdr.SetAddr1 (m_recipient);
+          hdr.SetQosTid (0);
+          hdr.SetSequenceNumber (nextSeq);
+          Ptr<WifiMacQueueItem> mpdu = Create<WifiMacQueueItem> (Create<Packet> (100), hdr);
+          queue->Enqueue (mpdu);
+          mpdus.push_back (mpdu);
+          nextSeq = (nextSeq + 1) % SEQNO_SPACE_SIZE;
+        }
+      for (std::size_t i = mpdus.size (); i > 1; i--)
+        {
+          std::swap (mpdus[i - 1], mpdus[random->GetInteger (0, i - 1)]);
+        }
+      for (const auto& mpdu : mpdus)
+        {
+          m_manager->StorePacket (mpdu);
+          inFlight[mpdu->GetHeader ().GetSequenceNumber ()] = mpdu;
+          if (random->GetInteger (0, 9) == 0)
+            {
+              // an MPDU stored twice is in flight once
+              m_manager->StorePacket (mpdu);
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (m_manager->GetNBufferedPackets (m_recipient, 0), inFlight.size (),
+                             "Unexpected number of MPDUs in flight in round " << round);
+
+      if (inFlight.size () == 1 || random->GetInteger (0, 4) == 0)
+        {
+          // acknowledge or miss the MPDUs one by one with Normal Acks
+          for (const auto& mpdu : inFlight)
+            {
+              if (random->GetInteger (0, 1) == 0)
+                {
+                  m_manager->NotifyGotAck (mpdu.second);
+                }
+              else
+                {
+                  m_manager->NotifyMissedAck (mpdu.second);
+                  toRetransmit.insert (mpdu);
+                }
+            }
+        }
+      else
+        {
+          // acknowledge a random subset of the MPDUs with a BlockAck
+          CtrlBAckResponseHeader blockAck;
+          blockAck.SetType (m_manager->GetBlockAckType (m_recipient, 0));
+          blockAck.SetStartingSequence (m_manager->GetOriginatorStartingSequence (m_recipient, 0));
+          std::vector<uint16_t> expected;
+          for (const auto& mpdu : inFlight)
+            {
+              expected.push_back (mpdu.first);
+            }
+          expected = Sort (expected);
+          std::size_t nFailed = 0;
+          for (const auto& seq : expected)
+            {
+              if (random->GetInteger (0, 2) > 0)
+                {
+                  blockAck.SetReceivedPacket (seq);
+                }
+              else
+                {
+                  toRetransmit[seq] = inFlight[seq];
+                  nFailed++;
+                }
+            }
+          m_notified.clear ();
+          auto result = m_manager->NotifyGotBlockAck (blockAck, m_recipient, {0});
+          NS_TEST_EXPECT_MSG_EQ ((m_notified == expected), true,
+                                 "MPDUs not notified in order in round " << round);
+          NS_TEST_EXPECT_MSG_EQ (result.first + result.second, expected.size (),
+                                 "Unexpected number of notified MPDUs in round " << round);
+          NS_TEST_EXPECT_MSG_EQ (result.second, nFailed,
+                                 "Unexpected number of failed MPDUs in round " << round);
+        }
+      inFlight.clear ();
+      NS_TEST_EXPECT_MSG_EQ (m_manager->GetNBufferedPackets (m_recipient, 0), 0,
+                             "Unexpected MPDUs in flight in round " << round);
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), toRetransmit.size (),
+                             "Unexpected number of queued MPDUs in round " << round);
+    }
+  m_manager->Dispose ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1639,6 +1862,7 @@ BlockAckTestSuite::BlockAckTestSuite ()
   AddTestCase (new MultiStaCtrlBAckResponseHeaderTest, TestCase::QUICK);
   AddTestCase (new BlockAckAggregationDisabledTest (false), TestCase::QUICK);
   AddTestCase (new BlockAckAggregationDisabledTest (true), TestCase::QUICK);
+  AddTestCase (new BlockAckManagerInFlightTest, TestCase::QUICK);
 }
 
 static BlockAckTestSuite g_blockAckTestSuite; ///< the test suite
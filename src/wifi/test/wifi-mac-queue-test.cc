@@ -20,6 +20,8 @@
 
 #include "ns3/test.h"
 #include "ns3/wifi-mac-queue.h"
+#include "ns3/qos-blocked-destinations.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simulator.h"
 
 using namespace ns3;
@@ -107,6 +109,293 @@ WifiMacQueueDropOldestTest::DoRun ()
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test the per (receiver, TID) sub-queues.
+ *
+ * Random frames for a few receivers and TIDs are enqueued, pushed to the
+ * front, inserted, dequeued and removed, while some of them expire. After
+ * each operation, the frames peeked and counted by the queue are checked
+ * against a scan of the whole queue, and the frames dropped because their
+ * lifetime expired are checked to be those of such a scan, in the same order.
+ */
+class WifiMacQueueIndexTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  WifiMacQueueIndexTest ();
+
+  void DoRun () override;
+
+private:
+  /**
+   * Perform a random operation on the queue and check the queue.
+   * \param step the number of the operation
+   */
+  void RandomOperation (uint32_t step);
+  /**
+   * Check the queue against a scan of the whole queue.
+   */
+  void CheckQueue (void);
+  /**
+   * \return a new random frame
+   */
+  Ptr<WifiMacQueueItem> CreateItem (void);
+  /**
+   * \return an iterator pointing to a random frame of the queue, or end()
+   */
+  WifiMacQueue::ConstIterator GetRandomPosition (void);
+  /**
+   * \param item the frame
+   * \return whether the frame did not expire
+   */
+  bool IsAlive (Ptr<const WifiMacQueueItem> item) const;
+  /**
+   * Trace sink for the expired frames.
+   * \param item the frame
+   */
+  void Expired (Ptr<const WifiMacQueueItem> item);
+
+  Ptr<WifiMacQueue> m_queue;                         //!< the queue
+  Ptr<UniformRandomVariable> m_random;               //!< random operations
+  std::vector<Mac48Address> m_receivers;             //!< receivers of the frames
+  std::vector<Ptr<const WifiMacQueueItem> > m_expired; //!< frames dropped since the last check
+  uint32_t m_step;                                   //!< number of the current operation
+};
+
+WifiMacQueueIndexTest::WifiMacQueueIndexTest ()
+  : TestCase ("Test the per receiver and TID sub-queues"),
+    m_step (0)
+{
+}
+
+bool
+WifiMacQueueIndexTest::IsAlive (Ptr<const WifiMacQueueItem> item) const
+{
+  return Simulator::Now () <= item->GetTimeStamp () + m_queue->GetMaxDelay ();
+}
+
+void
+WifiMacQueueIndexTest::Expired (Ptr<const WifiMacQueueItem> item)
+{
+  m_expired.push_back (item);
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueueIndexTest::CreateItem (void)
+{
+  WifiMacHeader header;
+  if (m_random->GetInteger (0, 9) == 0)
+    {
+      header.SetType (WIFI_MAC_DATA);
+    }
+  else
+    {
+      header.SetType (WIFI_MAC_QOSDATA);
+      header.SetQosTid (static_cast<uint8_t> (m_random->GetInteger (0, 1)));
+    }
+  header.SetAddr1 (m_receivers[m_random->GetInteger (0, m_receivers.size () - 1)]);
+  // the frames pushed back to the queue may be older than the others
+  Time tstamp = Simulator::Now () - MilliSeconds (m_random->GetInteger (0, 10));
+  return Create<WifiMacQueueItem> (Create<Packet> (m_random->GetInteger (10, 1000)), header,
+                                   Max (tstamp, Seconds (0)));
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueueIndexTest::GetRandomPosition (void)
+{
+  uint32_t n = m_random->GetInteger (0, m_queue->QueueBase::GetNPackets ());
+  WifiMacQueue::ConstIterator it = m_queue->begin ();
+  for (uint32_t i = 0; i < n && it != m_queue->end (); i++)
+    {
+      it++;
+    }
+  return it;
+}
+
+void
+WifiMacQueueIndexTest::CheckQueue (void)
+{
+  const Time now = Simulator::Now ();
+
+  // the expired frames dropped by the queue must be those of a scan of the queue
+  std::vector<Ptr<const WifiMacQueueItem> > expected;
+  for (auto it = m_queue->begin (); it != m_queue->end (); it++)
+    {
+      if (!IsAlive (*it))
+        {
+          expected.push_back (*it);
+        }
+    }
+  m_expired.clear ();
+  uint32_t nPackets = m_queue->GetNPackets ();
+  NS_TEST_EXPECT_MSG_EQ ((m_expired == expected), true, "step " << m_step << ": wrong expired frames");
+  NS_TEST_EXPECT_MSG_EQ (nPackets, m_queue->QueueBase::GetNPackets (), "step " << m_step << ": wrong count");
+
+  Ptr<QosBlockedDestinations> blocked = Create<QosBlockedDestinations> ();
+  for (const auto& receiver : m_receivers)
+    {
+      for (uint8_t tid = 0; tid < 2; tid++)
+        {
+          // counts
+          uint32_t n = 0;
+          uint32_t bytes = 0;
+          for (auto it = m_queue->begin (); it != m_queue->end (); it++)
+            {
+              if ((*it)->GetHeader ().IsQosData () && (*it)->GetHeader ().GetAddr1 () == receiver
+                  && (*it)->GetHeader ().GetQosTid () == tid)
+                {
+                  n++;
+                  bytes += (*it)->GetSize ();
+                }
+            }
+          NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPackets (tid, receiver), n,
+                                 "step " << m_step << ": wrong count for " << receiver << " " << +tid);
+          NS_TEST_EXPECT_MSG_EQ (m_queue->GetNBytes (tid, receiver), bytes,
+                                 "step " << m_step << ": wrong bytes for " << receiver << " " << +tid);
+
+          // peeks from the head of the queue and from a random position
+          WifiMacQueue::ConstIterator pos = GetRandomPosition ();
+          WifiMacQueue::ConstIterator first = m_queue->end ();
+          WifiMacQueue::ConstIterator firstFromPos = m_queue->end ();
+          bool afterPos = false;
+          for (auto it = m_queue->begin (); it != m_queue->end (); it++)
+            {
+              afterPos = afterPos || (it == pos);
+              if (IsAlive (*it) && (*it)->GetHeader ().IsQosData ()
+                  && (*it)->GetHeader ().GetAddr1 () == receiver && (*it)->GetHeader ().GetQosTid () == tid)
+                {
+                  if (first == m_queue->end ())
+                    {
+                      first = it;
+                    }
+                  if (afterPos && firstFromPos == m_queue->end ())
+                    {
+                      firstFromPos = it;
+                    }
+                }
+            }
+          NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekByTidAndAddress (tid, receiver) == first), true,
+                                 "step " << m_step << ": wrong frame peeked for " << receiver << " " << +tid);
+          NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekByTidAndAddress (tid, receiver, pos) == firstFromPos), true,
+                                 "step " << m_step << ": wrong frame peeked from a position for "
+                                 << receiver << " " << +tid);
+
+          if (m_random->GetInteger (0, 1) == 0)
+            {
+              blocked->Block (receiver, tid);
+            }
+        }
+    }
+
+  // first available frame, from the head of the queue and from a random position
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      WifiMacQueue::ConstIterator pos = (i == 0 ? m_queue->begin () : GetRandomPosition ());
+      WifiMacQueue::ConstIterator first = m_queue->end ();
+      for (auto it = pos; it != m_queue->end (); it++)
+        {
+          if (IsAlive (*it) && (!(*it)->GetHeader ().IsQosData ()
+                                || !blocked->IsBlocked ((*it)->GetHeader ().GetAddr1 (),
+                                                        (*it)->GetHeader ().GetQosTid ())))
+            {
+              first = it;
+              break;
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekFirstAvailable (blocked, (i == 0 ? WifiMacQueue::EMPTY : pos)) == first),
+                             true, "step " << m_step << ": wrong first available frame");
+    }
+}
+
+void
+WifiMacQueueIndexTest::RandomOperation (uint32_t step)
+{
+  m_step = step;
+  switch (m_random->GetInteger (0, 5))
+    {
+    case 0:
+      m_queue->Enqueue (CreateItem ());
+      break;
+    case 1:
+      m_queue->PushFront (CreateItem ());
+      break;
+    case 2:
+      m_queue->Insert (GetRandomPosition (), CreateItem ());
+      break;
+    case 3:
+      {
+        WifiMacQueue::ConstIterator pos = GetRandomPosition ();
+        if (pos != m_queue->end ())
+          {
+            m_queue->Remove (pos, m_random->GetInteger (0, 1) == 0);
+          }
+        break;
+      }
+    case 4:
+      m_queue->Dequeue ();
+      break;
+    default:
+      {
+        WifiMacQueue::ConstIterator pos = GetRandomPosition ();
+        if (pos != m_queue->end ())
+          {
+            m_queue->DequeueIfQueued (*pos);
+          }
+        break;
+      }
+    }
+  if (step % 10 == 0)
+    {
+      CheckQueue ();
+    }
+  else
+    {
+      m_expired.clear ();
+    }
+}
+
+void
+WifiMacQueueIndexTest::DoRun ()
+{
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_random->SetStream (1);
+  for (uint32_t i = 1; i <= 5; i++)
+    {
+      m_receivers.push_back (Mac48Address::Allocate ());
+    }
+
+  m_queue = CreateObject<WifiMacQueue> (AC_BE);
+  m_queue->SetMaxSize (QueueSize ("40p"));
+  m_queue->SetMaxDelay (MilliSeconds (20));
+  m_queue->TraceConnectWithoutContext ("Expired", MakeCallback (&WifiMacQueueIndexTest::Expired, this));
+
+  for (uint32_t step = 0; step < 2000; step++)
+    {
+      Simulator::Schedule (MicroSeconds (100 * step), &WifiMacQueueIndexTest::RandomOperation, this, step);
+    }
+  Simulator::Run ();
+
+  // insert many frames at the same position, so that the frames of the
+  // queue are renumbered
+  m_queue->SetMaxSize (QueueSize ("500p"));
+  m_queue->Enqueue (CreateItem ());
+  m_queue->Enqueue (CreateItem ());
+  WifiMacQueue::ConstIterator pos = std::prev (m_queue->end ());
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      m_queue->Insert (pos, CreateItem ());
+    }
+  m_step = 2000;
+  CheckQueue ();
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -123,6 +412,7 @@ WifiMacQueueTestSuite::WifiMacQueueTestSuite ()
   : TestSuite ("wifi-mac-queue", UNIT)
 {
   AddTestCase (new WifiMacQueueDropOldestTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueIndexTest, TestCase::QUICK);
 }
 
 static WifiMacQueueTestSuite g_wifiMacQueueTestSuite; ///< the test suite
@@ -26,6 +26,7 @@
 #include "ns3/system-wall-clock-ms.h"
 #include "ns3/packet.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/traced-callback.h"
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -328,6 +329,64 @@ benchByteTags (uint32_t n)
     }
 }
 
+/// Number of trace sources fired for each packet
+static const uint32_t N_TRACES = 16;
+/// Trace sources, as those fired by the devices, queues and IP layers along a path
+static TracedCallback<Ptr<const Packet> > g_traces[N_TRACES];
+/// Number of bytes seen by the trace sinks
+static uint64_t g_tracedBytes = 0;
+
+/**
+ * Trace sink.
+ * \param p the packet
+ */
+static void
+TraceSink (Ptr<const Packet> p)
+{
+  g_tracedBytes += p->GetSize ();
+}
+
+/**
+ * Fire the trace sources for each packet.
+ * \param n the number of packets
+ */
+static void
+benchTraces (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (2000);
+      p->AddHeader (udp);
+      p->AddHeader (ipv4);
+      for (uint32_t j = 0; j < N_TRACES; j++)
+        {
+          g_traces[j] (p);
+        }
+    }
+}
+
+/**
+ * Fire the trace sources for each packet, with a trace sink connected
+ * to each of them.
+ * \param n the number of packets
+ */
+static void
+benchConnectedTraces (uint32_t n)
+{
+  for (uint32_t j = 0; j < N_TRACES; j++)
+    {
+      g_traces[j].ConnectWithoutContext (MakeCallback (&TraceSink));
+    }
+  benchTraces (n);
+  for (uint32_t j = 0; j < N_TRACES; j++)
+    {
+      g_traces[j].DisconnectWithoutContext (MakeCallback (&TraceSink));
+    }
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -385,6 +444,8 @@ int main (int argc, char *argv[])
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+  runBench (&benchTraces, n, minIterations, "Fire disconnected trace sources");
+  runBench (&benchConnectedTraces, n, minIterations, "Fire connected trace sources");
 
   return 0;
 }